@@ -0,0 +1,106 @@
+// AdaptiveCache 的影子模拟开销和命中率(单线程)：
+// 同一条 key 序列都经由 ICachePolicy& 驱动，对比固定策略的
+// CachePolicyAdaptor<Cache<...>>(std::mutex，与 AdaptiveCache 同样一把锁)
+// 和 AdaptiveCache；序列前半段偏斜(LFU 好)，后半段工作集漂移(LRU/ARC 好)
+#include "AdaptiveCache.h"
+#include "Cache.h"
+#include "ICachePolicy.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kCapacity = 100000;
+constexpr int kOps = 8000000;
+
+std::vector<int> makeKeys() {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> u;
+  std::vector<int> keys(kOps);
+  for (int i = 0; i < kOps; ++i) {
+    if (i < kOps / 2) {
+      keys[i] = static_cast<int>(1000000 * u(gen) * u(gen) * u(gen));
+    } else {
+      keys[i] = 10000000 + i / 4 + static_cast<int>(gen() % 80000);
+    }
+  }
+  return keys;
+}
+
+struct Result {
+  double ns = 0;
+  double hitRate = 0;
+};
+
+// 按需回填：未命中就 put。不内联，各缓存都走虚调用
+[[gnu::noinline]] Result run(ICachePolicy<int, int> &cache,
+                             const std::vector<int> &keys) {
+  int out = 0;
+  std::uint64_t hits = 0;
+  const auto begin = std::chrono::steady_clock::now();
+  for (const int key : keys) {
+    if (cache.get(key, out)) {
+      ++hits;
+    } else {
+      cache.put(key, key);
+    }
+  }
+  const double ns = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - begin)
+          .count());
+  return {ns / static_cast<double>(keys.size()),
+          100.0 * static_cast<double>(hits) / static_cast<double>(keys.size())};
+}
+
+void printRow(const std::string &name, const Result &r) {
+  std::cout << std::left << std::setw(32) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(8) << r.ns << " ns/op"
+            << std::setw(9) << std::setprecision(2) << r.hitRate << "% hit\n";
+}
+
+} // namespace
+
+int main() {
+  const std::vector<int> keys = makeKeys();
+  std::cout << "capacity " << kCapacity << ", " << kOps
+            << " get-or-put ops (skewed, then drifting)\n";
+  {
+    CachePolicyAdaptor<Cache<int, int, LruEviction>> cache(kCapacity);
+    printRow("LRU", run(cache, keys));
+  }
+  {
+    CachePolicyAdaptor<Cache<int, int, LfuEviction>> cache(kCapacity);
+    printRow("LFU", run(cache, keys));
+  }
+  {
+    CachePolicyAdaptor<Cache<int, int, ArcEviction>> cache(kCapacity);
+    printRow("ARC", run(cache, keys));
+  }
+  {
+    CachePolicyAdaptor<Cache<int, int, LruEviction, LruKAdmission<int, 2>>>
+        cache(kCapacity);
+    printRow("LRU-K", run(cache, keys));
+  }
+  {
+    AdaptiveOptions options;
+    options.autoSwitch = false;
+    AdaptiveCache<int, int> cache(kCapacity, options);
+    printRow("AdaptiveCache, simulate only", run(cache, keys));
+  }
+  {
+    AdaptiveCache<int, int> cache(kCapacity);
+    const Result r = run(cache, keys);
+    printRow("AdaptiveCache", r);
+    std::cout << "  switches " << cache.switches() << ", ends on "
+              << adaptivePolicyName(cache.policy()) << ", sampled gets "
+              << cache.sampledGets() << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,85 @@
+// 预热一个空缓存的耗时：逐个 put、putMany(按分片分组，单线程)与
+// bulkLoad(按分片分组后并行导入、预留索引)，以及 removeIf 的分片并行失效
+#include "LfuCache.h"
+#include "LruCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int kItems = 2000000;
+constexpr int kShards = 16;
+
+template <typename Fn> double timeMs(Fn &&fn) {
+  const auto begin = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - begin)
+      .count();
+}
+
+void printRow(const std::string &name, double ms) {
+  std::cout << std::left << std::setw(36) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(10) << ms << " ms"
+            << std::setw(10) << std::setprecision(2) << kItems / ms / 1e3
+            << " Mitems/s\n";
+}
+
+template <typename Cache>
+void runSuite(const std::string &name,
+              const std::vector<std::pair<int, int>> &items,
+              const std::vector<int> &keys, const std::vector<int> &values,
+              unsigned threads) {
+  {
+    Cache cache(kItems, kShards);
+    printRow(name + " put loop", timeMs([&] {
+               for (const auto &[key, value] : items) {
+                 cache.put(key, value);
+               }
+             }));
+  }
+  {
+    Cache cache(kItems, kShards);
+    printRow(name + " putMany", timeMs([&] { cache.putMany(keys, values); }));
+  }
+  {
+    Cache cache(kItems, kShards);
+    printRow(name + " bulkLoad x" + std::to_string(threads),
+             timeMs([&] { cache.bulkLoad(items, static_cast<int>(threads)); }));
+    printRow(name + " removeIf (half) x" + std::to_string(threads),
+             timeMs([&] {
+               cache.removeIf([](const int &key, const int &) { return key & 1; },
+                              static_cast<int>(threads));
+             }));
+  }
+}
+
+} // namespace
+
+int main() {
+  std::vector<std::pair<int, int>> items;
+  std::vector<int> keys;
+  std::vector<int> values;
+  items.reserve(kItems);
+  for (int i = 0; i < kItems; ++i) {
+    // 乘奇数在 2^32 上是双射：key 互不相同且不按顺序
+    const int key = static_cast<int>(static_cast<unsigned>(i) * 7919u);
+    items.emplace_back(key, i);
+    keys.push_back(key);
+    values.push_back(i);
+  }
+  const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  std::cout << "items=" << kItems << " shards=" << kShards
+            << " threads=" << threads << '\n';
+
+  runSuite<KHashLruCaches<int, int>>("lru", items, keys, values, threads);
+  runSuite<KHashLfuCache<int, int>>("lfu", items, keys, values, threads);
+  return 0;
+}
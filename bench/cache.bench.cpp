@@ -0,0 +1,476 @@
+// 缓存策略的吞吐/延迟基准(cache_bench)：
+// 工作负载 get_hit / get_miss / put_insert / put_evict / mixed_90_10 / mixed_50_50，
+// 按容量、value 大小、线程数、策略(含 KHash 分片版本)做笛卡尔积扫描，
+// 输出 ops/s 与 p50/p99/p999 延迟，--json=<file> 时另写一份机器可读结果。
+//
+// 用法示例：
+//   cache_bench --capacities=100,10000 --value-sizes=16 --threads=1,4
+//               --policies=lru,khash-lru --json=bench.json
+#include "ClockCache.h"
+#include "LfuCache.h"
+#include "LfuDaCache.h"
+#include "LruCache.h"
+#include "SlruCache.h"
+#include "TinyLfuCache.h"
+#include "arc/ArcCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 每隔 kSampleEvery 个操作计一次时，避免每个操作都读时钟拖慢吞吐
+constexpr std::size_t kSampleEvery = 16;
+// 粗略估计的单条目额外开销(结点 + 控制块 + 哈希索引)，用于跳过放不下的组合
+constexpr std::size_t kEntryOverheadBytes = 160;
+
+struct Options {
+  std::vector<std::size_t> capacities = {100,    1000,    10000,
+                                         100000, 1000000, 10000000};
+  std::vector<std::size_t> valueSizes = {16, 256};
+  std::vector<int> threads = {1, 4};
+  std::vector<std::string> policies = {"lru",       "lfu",       "arc",
+                                       "khash-lru", "khash-lfu", "khash-arc",
+                                       "clock",     "tinylfu",   "slru",
+                                       "lfu-da"};
+  std::vector<std::string> workloads = {"put_insert", "get_hit",
+                                        "get_miss",   "mixed_90_10",
+                                        "mixed_50_50", "put_evict"};
+  std::size_t ops = 1000000;              // 每个用例的总操作数
+  int shards = 16;                        // KHash 版本的分片数
+  std::size_t maxBytes = std::size_t{3} << 30; // 单个用例的内存上限估计
+  std::string jsonPath;
+};
+
+struct Result {
+  std::string policy;
+  std::string workload;
+  std::size_t capacity = 0;
+  std::size_t valueSize = 0;
+  int threads = 0;
+  std::size_t ops = 0;
+  double seconds = 0;
+  double hitRatio = -1; // 只有读操作的负载才有意义
+  double p50 = 0, p99 = 0, p999 = 0;
+
+  std::string name() const {
+    return policy + "/" + workload + "/capacity:" + std::to_string(capacity) +
+           "/value_size:" + std::to_string(valueSize) +
+           "/threads:" + std::to_string(threads);
+  }
+  double opsPerSec() const { return static_cast<double>(ops) / seconds; }
+};
+
+// 各线程的操作序列：提前生成好，计时区间内不跑随机数
+struct Op {
+  int key;
+  bool isPut;
+};
+
+double percentile(std::vector<std::uint32_t> &samples, double q) {
+  if (samples.empty())
+    return 0;
+  const std::size_t idx = std::min(
+      samples.size() - 1,
+      static_cast<std::size_t>(q * static_cast<double>(samples.size())));
+  std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+  return samples[idx];
+}
+
+// 统一不同策略的调用方式(KHash 版本没有继承 ICachePolicy)，
+// 直接按具体类型实例化，不引入虚调用开销
+template <typename Cache> struct Target {
+  std::unique_ptr<Cache> cache;
+  void put(int key, const std::string &value) { cache->put(key, value); }
+  bool get(int key, std::string &out) { return cache->get(key, out); }
+};
+
+template <typename Cache>
+Result runOps(Target<Cache> &target, const std::vector<std::vector<Op>> &plan,
+              const std::string &value) {
+  const int threads = static_cast<int>(plan.size());
+  std::vector<std::vector<std::uint32_t>> samples(threads);
+  std::vector<std::size_t> gets(threads, 0), hits(threads, 0);
+  std::atomic<int> ready{0};
+  std::atomic<bool> start{false};
+
+  auto worker = [&](int t) {
+    const auto &ops = plan[t];
+    auto &lat = samples[t];
+    lat.reserve(ops.size() / kSampleEvery + 1);
+    std::string out;
+    std::size_t localGets = 0, localHits = 0;
+
+    ready.fetch_add(1, std::memory_order_acq_rel);
+    while (!start.load(std::memory_order_acquire)) {
+    }
+    for (std::size_t i = 0; i < ops.size(); ++i) {
+      const Op op = ops[i];
+      const bool sample = i % kSampleEvery == 0;
+      const auto begin = sample ? Clock::now() : Clock::time_point{};
+      if (op.isPut) {
+        target.put(op.key, value);
+      } else {
+        ++localGets;
+        localHits += target.get(op.key, out) ? 1 : 0;
+      }
+      if (sample) {
+        lat.push_back(static_cast<std::uint32_t>(std::min<std::int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                 begin)
+                .count(),
+            UINT32_MAX)));
+      }
+    }
+    gets[t] = localGets;
+    hits[t] = localHits;
+  };
+
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; ++t) {
+    pool.emplace_back(worker, t);
+  }
+  while (ready.load(std::memory_order_acquire) < threads) {
+  }
+  const auto begin = Clock::now();
+  start.store(true, std::memory_order_release);
+  for (auto &th : pool) {
+    th.join();
+  }
+  const auto end = Clock::now();
+
+  Result r;
+  r.threads = threads;
+  r.seconds = std::chrono::duration<double>(end - begin).count();
+  std::vector<std::uint32_t> all;
+  std::size_t totalGets = 0, totalHits = 0;
+  for (int t = 0; t < threads; ++t) {
+    r.ops += plan[t].size();
+    all.insert(all.end(), samples[t].begin(), samples[t].end());
+    totalGets += gets[t];
+    totalHits += hits[t];
+  }
+  if (totalGets > 0)
+    r.hitRatio = static_cast<double>(totalHits) / totalGets;
+  r.p50 = percentile(all, 0.50);
+  r.p99 = percentile(all, 0.99);
+  r.p999 = percentile(all, 0.999);
+  return r;
+}
+
+// 按负载生成每个线程的操作序列。
+// - put_insert：空缓存里写入 capacity 个新 key(各线程分段)
+// - get_hit / get_miss：在已写满的 key 区间 [0, capacity) 内 / 外读取
+// - mixed_x_y：key 取自 [0, 2*capacity)，x% 读 y% 写
+// - put_evict：写入从未出现过的 key，每次都会淘汰
+std::vector<std::vector<Op>> makePlan(const std::string &workload,
+                                      std::size_t capacity, std::size_t ops,
+                                      int threads) {
+  std::vector<std::vector<Op>> plan(threads);
+  const int cap = static_cast<int>(capacity);
+  for (int t = 0; t < threads; ++t) {
+    std::mt19937 gen(static_cast<unsigned>(t) * 7919u + 17u);
+    auto &seq = plan[t];
+
+    if (workload == "put_insert") {
+      for (int k = t; k < cap; k += threads) {
+        seq.push_back({k, true});
+      }
+      continue;
+    }
+
+    const std::size_t n = ops / static_cast<std::size_t>(threads);
+    seq.reserve(n);
+    std::uniform_int_distribution<int> inCache(0, cap - 1);
+    std::uniform_int_distribution<int> wide(0, 2 * cap - 1);
+    std::uniform_int_distribution<int> pct(0, 99);
+    for (std::size_t i = 0; i < n; ++i) {
+      if (workload == "get_hit") {
+        seq.push_back({inCache(gen), false});
+      } else if (workload == "get_miss") {
+        seq.push_back({cap + inCache(gen), false});
+      } else if (workload == "put_evict") {
+        // 每个线程占一段互不重叠、从未写入过的 key
+        seq.push_back({2 * cap + static_cast<int>(i) * threads + t, true});
+      } else {
+        const int readPct = workload == "mixed_90_10" ? 90 : 50;
+        seq.push_back({wide(gen), pct(gen) >= readPct});
+      }
+    }
+  }
+  return plan;
+}
+
+void printResult(const Result &r) {
+  std::cout << std::left << std::setw(64) << r.name() << std::right
+            << std::fixed << std::setprecision(2) << std::setw(10)
+            << r.opsPerSec() / 1e6 << " Mops/s" << std::setprecision(0)
+            << "  p50=" << std::setw(6) << r.p50 << "ns"
+            << "  p99=" << std::setw(7) << r.p99 << "ns"
+            << "  p999=" << std::setw(8) << r.p999 << "ns";
+  if (r.hitRatio >= 0)
+    std::cout << std::setprecision(3) << "  hit=" << r.hitRatio;
+  std::cout << "\n";
+}
+
+// 同一个缓存实例上依次跑各负载：put_insert 顺便完成预热，put_evict 会改变
+// 缓存内容，所以放在最后
+template <typename Cache>
+void runSuite(const std::string &policy, const Options &opt,
+              std::size_t capacity, std::size_t valueSize, int threads,
+              const std::function<std::unique_ptr<Cache>()> &make,
+              std::vector<Result> &results) {
+  Target<Cache> target{make()};
+  const std::string value(valueSize, 'v');
+
+  auto wants = [&](const std::string &w) {
+    return std::find(opt.workloads.begin(), opt.workloads.end(), w) !=
+           opt.workloads.end();
+  };
+  // 读负载需要一个已写满的缓存；没有显式测 put_insert 时也要先写满
+  const std::vector<std::string> order = {"put_insert", "get_hit",
+                                          "get_miss",   "mixed_90_10",
+                                          "mixed_50_50", "put_evict"};
+  for (const auto &workload : order) {
+    const bool measured = wants(workload);
+    if (!measured && workload != "put_insert")
+      continue;
+
+    auto plan = makePlan(workload, capacity, opt.ops, threads);
+    Result r = runOps(target, plan, value);
+    if (!measured)
+      continue;
+    r.policy = policy;
+    r.workload = workload;
+    r.capacity = capacity;
+    r.valueSize = valueSize;
+    printResult(r);
+    results.push_back(r);
+  }
+}
+
+void runPolicy(const std::string &policy, const Options &opt,
+               std::size_t capacity, std::size_t valueSize, int threads,
+               std::vector<Result> &results) {
+  const int cap = static_cast<int>(capacity);
+  const int shards = opt.shards;
+  if (policy == "lru") {
+    runSuite<LruCache<int, std::string>>(
+        policy, opt, capacity, valueSize, threads,
+        [&] { return std::make_unique<LruCache<int, std::string>>(cap); },
+        results);
+  } else if (policy == "lfu") {
+    runSuite<LfuCache<int, std::string>>(
+        policy, opt, capacity, valueSize, threads,
+        [&] { return std::make_unique<LfuCache<int, std::string>>(cap); },
+        results);
+  } else if (policy == "arc") {
+    runSuite<ArcCache<int, std::string>>(
+        policy, opt, capacity, valueSize, threads,
+        [&] { return std::make_unique<ArcCache<int, std::string>>(capacity); },
+        results);
+  } else if (policy == "khash-lru") {
+    runSuite<KHashLruCaches<int, std::string>>(
+        policy, opt, capacity, valueSize, threads,
+        [&] {
+          return std::make_unique<KHashLruCaches<int, std::string>>(capacity,
+                                                                    shards);
+        },
+        results);
+  } else if (policy == "khash-lfu") {
+    runSuite<KHashLfuCache<int, std::string>>(
+        policy, opt, capacity, valueSize, threads,
+        [&] {
+          return std::make_unique<KHashLfuCache<int, std::string>>(capacity,
+                                                                   shards);
+        },
+        results);
+  } else if (policy == "khash-arc") {
+    runSuite<KHashArcCache<int, std::string>>(
+        policy, opt, capacity, valueSize, threads,
+        [&] {
+          return std::make_unique<KHashArcCache<int, std::string>>(capacity,
+                                                                   shards);
+        },
+        results);
+  } else if (policy == "clock") {
+    runSuite<ClockCache<int, std::string>>(
+        policy, opt, capacity, valueSize, threads,
+        [&] { return std::make_unique<ClockCache<int, std::string>>(cap); },
+        results);
+  } else if (policy == "tinylfu") {
+    runSuite<TinyLfuCache<int, std::string>>(
+        policy, opt, capacity, valueSize, threads,
+        [&] { return std::make_unique<TinyLfuCache<int, std::string>>(cap); },
+        results);
+  } else if (policy == "slru") {
+    runSuite<SlruCache<int, std::string>>(
+        policy, opt, capacity, valueSize, threads,
+        [&] { return std::make_unique<SlruCache<int, std::string>>(cap); },
+        results);
+  } else if (policy == "lfu-da") {
+    runSuite<LfuDaCache<int, std::string>>(
+        policy, opt, capacity, valueSize, threads,
+        [&] { return std::make_unique<LfuDaCache<int, std::string>>(cap); },
+        results);
+  } else {
+    std::cerr << "unknown policy: " << policy << "\n";
+  }
+}
+
+std::string jsonEscape(const std::string &s) {
+  std::string out;
+  for (char c : s) {
+    if (c == '"' || c == '\\')
+      out.push_back('\\');
+    out.push_back(c);
+  }
+  return out;
+}
+
+// 字段命名参照 Google Benchmark 的 JSON 输出，便于接入现有的看板
+void writeJson(const std::string &path, const std::vector<Result> &results) {
+  std::ofstream out(path);
+  if (!out) {
+    std::cerr << "cannot write " << path << "\n";
+    return;
+  }
+
+  char date[32] = {0};
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  out << "{\n  \"context\": {\n"
+      << "    \"date\": \"" << date << "\",\n"
+      << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+      << "    \"latency_sample_every\": " << kSampleEvery << "\n  },\n"
+      << "  \"benchmarks\": [\n";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const Result &r = results[i];
+    out << "    {\"name\": \"" << jsonEscape(r.name()) << "\", "
+        << "\"policy\": \"" << jsonEscape(r.policy) << "\", "
+        << "\"workload\": \"" << r.workload << "\", "
+        << "\"capacity\": " << r.capacity << ", "
+        << "\"value_size\": " << r.valueSize << ", "
+        << "\"threads\": " << r.threads << ", "
+        << "\"iterations\": " << r.ops << ", "
+        << "\"real_time_s\": " << r.seconds << ", "
+        << "\"ops_per_second\": " << r.opsPerSec() << ", "
+        << "\"p50_ns\": " << r.p50 << ", "
+        << "\"p99_ns\": " << r.p99 << ", "
+        << "\"p999_ns\": " << r.p999;
+    if (r.hitRatio >= 0)
+      out << ", \"hit_ratio\": " << r.hitRatio;
+    out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n}\n";
+}
+
+template <typename T> std::vector<T> parseList(const std::string &s) {
+  std::vector<T> items;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty())
+      continue;
+    if constexpr (std::is_same_v<T, std::string>) {
+      items.push_back(item);
+    } else {
+      // 允许 1e6 这类写法
+      items.push_back(static_cast<T>(std::stod(item)));
+    }
+  }
+  return items;
+}
+
+bool parseArgs(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const auto eq = arg.find('=');
+    const std::string key = arg.substr(0, eq);
+    const std::string val = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+    if (key == "--capacities")
+      opt.capacities = parseList<std::size_t>(val);
+    else if (key == "--value-sizes")
+      opt.valueSizes = parseList<std::size_t>(val);
+    else if (key == "--threads")
+      opt.threads = parseList<int>(val);
+    else if (key == "--policies")
+      opt.policies = parseList<std::string>(val);
+    else if (key == "--workloads")
+      opt.workloads = parseList<std::string>(val);
+    else if (key == "--ops")
+      opt.ops = static_cast<std::size_t>(std::stod(val));
+    else if (key == "--shards")
+      opt.shards = std::stoi(val);
+    else if (key == "--max-bytes")
+      opt.maxBytes = static_cast<std::size_t>(std::stod(val));
+    else if (key == "--json")
+      opt.jsonPath = val;
+    else {
+      std::cerr
+          << "usage: cache_bench [--capacities=100,1e4] [--value-sizes=16]\n"
+             "                   [--threads=1,4] [--policies=lru,khash-lru]\n"
+             "                   [--workloads=get_hit,mixed_90_10] "
+             "[--ops=1e6]\n"
+             "                   [--shards=16] [--max-bytes=3e9] "
+             "[--json=out.json]\n"
+             "policies:  lru lfu arc khash-lru khash-lfu khash-arc clock tinylfu slru lfu-da\n"
+             "workloads: put_insert get_hit get_miss mixed_90_10 "
+             "mixed_50_50 put_evict\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt))
+    return 1;
+
+  std::vector<Result> results;
+  for (std::size_t capacity : opt.capacities) {
+    for (std::size_t valueSize : opt.valueSizes) {
+      const std::size_t estimate =
+          capacity * (valueSize + kEntryOverheadBytes);
+      if (estimate > opt.maxBytes) {
+        std::cout << "skip capacity=" << capacity
+                  << " value_size=" << valueSize << " (~" << (estimate >> 20)
+                  << " MiB > --max-bytes)\n";
+        continue;
+      }
+      for (int threads : opt.threads) {
+        for (const auto &policy : opt.policies) {
+          runPolicy(policy, opt, capacity, valueSize, threads, results);
+        }
+      }
+    }
+  }
+
+  if (!opt.jsonPath.empty()) {
+    writeJson(opt.jsonPath, results);
+    std::cout << "wrote " << results.size() << " results to " << opt.jsonPath
+              << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,105 @@
+// ClockCache (命中只置引用位，get 只拿条带共享锁)、KHashLruCaches
+// 及其读缓冲模式(get 只拿共享锁，命中批量补到链表上)的多线程对比
+#include "ClockCache.h"
+#include "LruCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Result {
+  double mops;
+  double hitRate;
+};
+
+// 95% 读 / 5% 写，key 服从偏斜分布(80% 请求落在 20% 的 key 上)
+template <typename Cache>
+Result run(Cache &cache, int threads, int opsPerThread, int keySpace) {
+  std::atomic<bool> start{false};
+  std::atomic<std::uint64_t> hits{0}, gets{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      std::mt19937 gen(static_cast<unsigned>(t) * 7919u + 1);
+      std::uniform_int_distribution<int> hot(0, keySpace / 5 - 1);
+      std::uniform_int_distribution<int> all(0, keySpace - 1);
+      std::uniform_int_distribution<int> pct(0, 99);
+      std::uint64_t localHits = 0, localGets = 0;
+      while (!start.load(std::memory_order_acquire)) {
+      }
+      int out = 0;
+      for (int i = 0; i < opsPerThread; ++i) {
+        const int key = pct(gen) < 80 ? hot(gen) : all(gen);
+        if (pct(gen) < 5) {
+          cache.put(key, key);
+        } else {
+          ++localGets;
+          if (cache.get(key, out))
+            ++localHits;
+          else
+            cache.put(key, key); // 未命中回源后写入
+        }
+      }
+      hits += localHits;
+      gets += localGets;
+    });
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  for (auto &w : workers) {
+    w.join();
+  }
+  const double ns = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - begin)
+          .count());
+  return {static_cast<double>(threads) * opsPerThread * 1e3 / ns,
+          100.0 * static_cast<double>(hits) / static_cast<double>(gets)};
+}
+
+void printRow(const std::string &name, int threads, const Result &r) {
+  std::cout << std::left << std::setw(16) << name << "threads=" << std::setw(4)
+            << threads << std::right << std::fixed << std::setprecision(2)
+            << std::setw(9) << r.mops << " Mops/s" << std::setw(8)
+            << r.hitRate << "% hit\n";
+}
+
+} // namespace
+
+int main() {
+  constexpr int CAPACITY = 20000;
+  constexpr int KEY_SPACE = 100000;
+  constexpr int TOTAL_OPS = 2000000;
+  const int shards = static_cast<int>(std::thread::hardware_concurrency());
+
+  std::cout << "capacity=" << CAPACITY << " keys=" << KEY_SPACE
+            << " (95% get / 5% put, 80/20 skew)\n";
+  for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+    {
+      KHashLruCaches<int, int> lru(CAPACITY, shards);
+      printRow("KHashLruCaches", threads,
+               run(lru, threads, TOTAL_OPS / threads, KEY_SPACE));
+    }
+    {
+      KHashLruCaches<int, int> buffered(CAPACITY, shards);
+      buffered.setBufferedRecency(true);
+      printRow("LRU (buffered)", threads,
+               run(buffered, threads, TOTAL_OPS / threads, KEY_SPACE));
+    }
+    {
+      ClockCache<int, int> clock(CAPACITY);
+      printRow("ClockCache", threads,
+               run(clock, threads, TOTAL_OPS / threads, KEY_SPACE));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,118 @@
+// 集群层在回环地址上的开销(单线程)：3 个节点在同一进程里互联，
+// 对比本地 key、逐个访问远端 key、getMany 一次往返取一批，以及近端缓存命中
+#include "LruCache.h"
+#include "cluster/ClusterCache.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Node = ClusterCache<int, std::string, KHashLruCaches<int, std::string>>;
+
+constexpr int kKeys = 30000;
+constexpr int kBatch = 1000;
+
+template <typename Fn> double nsPerKey(std::size_t keys, Fn &&fn) {
+  const auto begin = std::chrono::steady_clock::now();
+  fn();
+  const double ns = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - begin)
+          .count());
+  return ns / static_cast<double>(keys);
+}
+
+void printRow(const std::string &name, double ns, const ClusterStats &before,
+              const ClusterStats &after) {
+  std::cout << std::left << std::setw(34) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(10) << ns << " ns/key"
+            << std::setw(10) << after.roundTrips - before.roundTrips
+            << " round trips\n";
+}
+
+} // namespace
+
+int main() {
+  std::vector<std::unique_ptr<Node>> nodes;
+  for (ClusterNodeId id = 0; id < 3; ++id) {
+    ClusterOptions options;
+    options.self = id;
+    nodes.push_back(std::make_unique<Node>(options, kKeys * 2, 8));
+    if (!nodes.back()->ok()) {
+      std::cerr << "listen failed\n";
+      return 1;
+    }
+  }
+  for (auto &node : nodes) {
+    for (auto &peer : nodes) {
+      node->addPeer(ClusterPeer{peer->self(), "127.0.0.1", peer->port()});
+    }
+  }
+
+  Node &client = *nodes[0];
+  std::vector<int> local, remote;
+  for (int k = 0; k < kKeys; ++k) {
+    (client.isLocal(k) ? local : remote).push_back(k);
+  }
+  std::vector<std::string> values(remote.size(), std::string(64, 'v'));
+  client.putMany(remote, values);
+  for (int k : local) {
+    client.put(k, std::string(64, 'v'));
+  }
+  std::cout << "3 nodes on loopback, " << kKeys << " keys, 64-byte values, "
+            << remote.size() << " remote\n";
+
+  std::string out;
+  std::uint64_t sink = 0;
+  ClusterStats before = client.stats();
+  double ns = nsPerKey(local.size(), [&] {
+    for (int k : local) {
+      sink += client.get(k, out);
+    }
+  });
+  printRow("get, local key", ns, before, client.stats());
+
+  before = client.stats();
+  ns = nsPerKey(remote.size(), [&] {
+    for (int k : remote) {
+      sink += client.get(k, out);
+    }
+  });
+  printRow("get, remote key", ns, before, client.stats());
+
+  std::vector<std::string> batchOut(kBatch);
+  std::unique_ptr<bool[]> found(new bool[kBatch]);
+  const std::size_t batches = remote.size() / kBatch;
+  before = client.stats();
+  ns = nsPerKey(batches * kBatch, [&] {
+    for (std::size_t b = 0; b < batches; ++b) {
+      sink += client.getMany(
+          std::span<const int>(remote).subspan(b * kBatch, kBatch), batchOut,
+          std::span<bool>(found.get(), kBatch));
+    }
+  });
+  printRow("getMany x1000, remote keys", ns, before, client.stats());
+
+  client.enableNearCache(
+      std::make_unique<LruCache<int, NearEntry<std::string>>>(kKeys));
+  for (int k : remote) {
+    client.get(k, out); // 填充近端缓存
+  }
+  before = client.stats();
+  ns = nsPerKey(remote.size(), [&] {
+    for (int k : remote) {
+      sink += client.get(k, out);
+    }
+  });
+  printRow("get, remote key, near-cache hit", ns, before, client.stats());
+
+  if (sink == 42) // 防止循环被优化掉
+    std::cout << "";
+  return 0;
+}
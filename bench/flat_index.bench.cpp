@@ -0,0 +1,166 @@
+// 扁平索引的内存与查找开销：LruCache(NodeSlab + FlatIndex) 对照
+// 以前的 unordered_map<Key, shared_ptr<Node>> + 双向链表结构，
+// 报告每个条目占用的字节数(按 RSS 增量计)和随机命中查找的 ns/lookup。
+// 分片包装一行检查分片选择和控制字节标签用的哈希位互不重叠：
+// 重叠时同一分片里的标签只剩几位在变，候选变多，查找随分片数变慢
+#include "LruCache.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 当前进程的常驻内存(字节)
+std::size_t residentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  std::size_t pages = 0, resident = 0;
+  statm >> pages >> resident;
+  return resident * 4096;
+}
+
+// 旧实现的结点布局：shared_ptr 后继 + weak_ptr 前驱
+struct ChainedNode {
+  std::uint64_t key;
+  std::uint64_t value;
+  std::shared_ptr<ChainedNode> next;
+  std::weak_ptr<ChainedNode> prev;
+};
+
+struct ChainedLru {
+  std::unordered_map<std::uint64_t, std::shared_ptr<ChainedNode>> map;
+  std::shared_ptr<ChainedNode> head = std::make_shared<ChainedNode>();
+  std::mutex mutex;
+
+  // 逐个断开链表，避免 shared_ptr 链递归析构撑爆栈
+  ~ChainedLru() {
+    map.clear();
+    while (head) {
+      head = std::move(head->next);
+    }
+  }
+
+  void put(std::uint64_t key, std::uint64_t value) {
+    auto node = std::make_shared<ChainedNode>();
+    node->key = key;
+    node->value = value;
+    node->next = head->next;
+    node->prev = head;
+    if (head->next)
+      head->next->prev = node;
+    head->next = node;
+    map.emplace(key, std::move(node));
+  }
+
+  // 与缓存一样加锁，并把命中的结点移到链表头部
+  bool get(std::uint64_t key, std::uint64_t &value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = map.find(key);
+    if (it == map.end())
+      return false;
+    const std::shared_ptr<ChainedNode> &node = it->second;
+    if (head->next != node) {
+      auto prev = node->prev.lock();
+      prev->next = node->next;
+      if (node->next)
+        node->next->prev = prev;
+      node->next = head->next;
+      node->prev = head;
+      head->next->prev = node;
+      head->next = node;
+    }
+    value = node->value;
+    return true;
+  }
+};
+
+template <typename Cache>
+void report(const char *name, std::size_t n, Cache &cache,
+            const std::vector<std::uint64_t> &probes, std::size_t before) {
+  const std::size_t bytes = residentBytes() - before;
+
+  std::uint64_t sum = 0, out = 0;
+  const auto begin = Clock::now();
+  for (std::uint64_t key : probes) {
+    if (cache.get(key, out))
+      sum += out;
+  }
+  const double ns = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin)
+          .count());
+
+  std::cout << std::left << std::setw(26) << name << std::right
+            << std::setw(12) << n << std::fixed << std::setprecision(1)
+            << std::setw(14)
+            << static_cast<double>(bytes) / static_cast<double>(n)
+            << std::setw(14) << ns / static_cast<double>(probes.size())
+            << "   (checksum " << sum % 1000 << ")\n";
+}
+
+void bench(std::size_t n) {
+  std::mt19937_64 gen(7);
+  std::uniform_int_distribution<std::uint64_t> pick(0, n - 1);
+  std::vector<std::uint64_t> probes(2000000);
+  for (auto &key : probes) {
+    key = pick(gen) * 0x9E3779B97F4A7C15ULL; // 打散 key，避免顺序访问
+  }
+
+  {
+    const std::size_t before = residentBytes();
+    ChainedLru cache;
+    for (std::uint64_t k = 0; k < n; ++k) {
+      cache.put(k * 0x9E3779B97F4A7C15ULL, k);
+    }
+    report("unordered_map+shared_ptr", n, cache, probes, before);
+  }
+  malloc_trim(0); // 把释放的内存还给系统，下一组的 RSS 增量才可比
+  {
+    const std::size_t before = residentBytes();
+    LruCache<std::uint64_t, std::uint64_t> cache(static_cast<std::int64_t>(n));
+    for (std::uint64_t k = 0; k < n; ++k) {
+      cache.put(k * 0x9E3779B97F4A7C15ULL, k);
+    }
+    report("LruCache (flat index)", n, cache, probes, before);
+    std::cout << std::left << std::setw(26) << "  memoryBytes()/entry"
+              << std::right << std::setw(26) << std::fixed
+              << std::setprecision(1)
+              << static_cast<double>(cache.memoryBytes()) /
+                     static_cast<double>(n)
+              << "\n";
+  }
+  malloc_trim(0);
+  for (int shards : {16, 64}) {
+    const std::size_t before = residentBytes();
+    // 各分片的条目数有波动，留 1/4 余量，保证和上面一样不发生淘汰
+    KHashLruCaches<std::uint64_t, std::uint64_t> cache(n + n / 4, shards);
+    for (std::uint64_t k = 0; k < n; ++k) {
+      cache.put(k * 0x9E3779B97F4A7C15ULL, k);
+    }
+    const std::string name = "KHashLruCaches x" + std::to_string(shards);
+    report(name.c_str(), n, cache, probes, before);
+  }
+  malloc_trim(0);
+}
+
+} // namespace
+
+int main() {
+  std::cout << std::left << std::setw(26) << "structure" << std::right
+            << std::setw(12) << "entries" << std::setw(14) << "bytes/entry"
+            << std::setw(14) << "ns/lookup" << "\n";
+  for (std::size_t n : {100000u, 1000000u, 10000000u}) {
+    bench(n);
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+// LFU 老化的尾延迟：maxAverageNum 很小时(KHashLfuCache 默认 10)老化频繁触发，
+// 逐个操作计时，看 p999 / max 有没有被老化拖出尖刺；maxAverageNum 很大时不老化，作为对照
+#include "LfuCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double percentile(std::vector<std::uint32_t> &samples, double q) {
+  const std::size_t idx = std::min(
+      samples.size() - 1,
+      static_cast<std::size_t>(q * static_cast<double>(samples.size())));
+  std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+  return samples[idx];
+}
+
+void benchAging(int capacity, int maxAverageNum, const std::vector<int> &keys) {
+  LfuCache<int, int> cache(capacity, maxAverageNum);
+  for (int k = 0; k < capacity; ++k) {
+    cache.put(k, k);
+  }
+
+  std::vector<std::uint32_t> samples;
+  samples.reserve(keys.size());
+  int out = 0;
+  const auto begin = Clock::now();
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    const auto start = Clock::now();
+    // 80% 读(未命中回填) / 20% 写
+    if (i % 5 == 0 || !cache.get(keys[i], out))
+      cache.put(keys[i], static_cast<int>(i));
+    samples.push_back(static_cast<std::uint32_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                             start)
+            .count()));
+  }
+  const double totalNs = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin)
+          .count());
+
+  const double maxNs = *std::max_element(samples.begin(), samples.end());
+  std::cout << std::left << std::setw(12) << capacity << std::setw(16)
+            << maxAverageNum << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << totalNs / static_cast<double>(keys.size())
+            << std::setprecision(0) << std::setw(10)
+            << percentile(samples, 0.50) << std::setw(10)
+            << percentile(samples, 0.99) << std::setw(10)
+            << percentile(samples, 0.999) << std::setw(10)
+            << percentile(samples, 0.9999) << std::setw(12) << maxNs << "\n";
+}
+
+} // namespace
+
+int main() {
+  constexpr std::size_t OPS = 1000000;
+  std::cout << std::left << std::setw(12) << "capacity" << std::setw(16)
+            << "maxAverageNum" << std::right << std::setw(10) << "ns/op"
+            << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10)
+            << "p999" << std::setw(10) << "p9999" << std::setw(12) << "max"
+            << "\n";
+
+  for (int capacity : {10000, 100000}) {
+    // 一半请求落在 10% 的热点上，其余分布在 2 倍容量的 key 空间
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> hot(0, capacity / 10);
+    std::uniform_int_distribution<int> wide(0, capacity * 2 - 1);
+    std::vector<int> keys(OPS);
+    for (int &key : keys) {
+      key = (gen() & 1) ? hot(gen) : wide(gen);
+    }
+
+    for (int maxAverageNum : {10, 100, 1000000}) {
+      benchAging(capacity, maxAverageNum, keys);
+    }
+  }
+  return 0;
+}
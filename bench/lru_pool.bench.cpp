@@ -0,0 +1,132 @@
+// LruCache (shared_ptr 结点) 与 PoolLruCache (预分配槽位 + 下标链表) 的对比
+#include "LruCache.h"
+#include "PoolLruCache.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+class Timer {
+public:
+  Timer() noexcept : start_(std::chrono::steady_clock::now()) {}
+
+  double elapsed_ns() const noexcept {
+    const auto now = std::chrono::steady_clock::now();
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_)
+            .count());
+  }
+
+private:
+  std::chrono::time_point<std::chrono::steady_clock> start_;
+};
+
+void printRow(const std::string &scenario, const std::string &name,
+              std::size_t ops, double ns) {
+  std::cout << std::left << std::setw(28) << scenario << std::setw(14) << name
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << ns / static_cast<double>(ops) << " ns/op"
+            << std::setw(12) << static_cast<double>(ops) * 1e3 / ns
+            << " Mops/s\n";
+}
+
+template <typename Cache, typename Value>
+void benchGetHit(const std::string &name, int capacity,
+                 const std::vector<int> &keys, const Value &value) {
+  Cache cache(capacity);
+  for (int k = 0; k < capacity; ++k) {
+    cache.put(k, value);
+  }
+
+  Value out{};
+  std::size_t hits = 0;
+  Timer timer;
+  for (int key : keys) {
+    hits += cache.get(key % capacity, out) ? 1 : 0;
+  }
+  const double ns = timer.elapsed_ns();
+  if (hits != keys.size())
+    std::cerr << "unexpected miss in " << name << "\n";
+  printRow("get-hit cap=" + std::to_string(capacity), name, keys.size(), ns);
+}
+
+template <typename Cache, typename Value>
+void benchPutEvict(const std::string &name, int capacity,
+                   const std::vector<int> &keys, const Value &value) {
+  Cache cache(capacity);
+  for (int k = 0; k < capacity; ++k) {
+    cache.put(k, value);
+  }
+
+  // key 空间是容量的 4 倍，大部分 put 都会触发淘汰
+  Timer timer;
+  for (int key : keys) {
+    cache.put(key, value);
+  }
+  printRow("put-evict cap=" + std::to_string(capacity), name, keys.size(),
+           timer.elapsed_ns());
+}
+
+template <typename Cache, typename Value>
+void benchMixed(const std::string &name, int capacity,
+                const std::vector<int> &keys, const Value &value) {
+  Cache cache(capacity);
+  Value out{};
+  std::size_t i = 0;
+  Timer timer;
+  for (int key : keys) {
+    // 80% 读 / 20% 写
+    if (++i % 5 == 0)
+      cache.put(key, value);
+    else if (!cache.get(key, out))
+      cache.put(key, value);
+  }
+  printRow("mixed 80/20 cap=" + std::to_string(capacity), name, keys.size(),
+           timer.elapsed_ns());
+}
+
+template <typename Value>
+void runAll(const std::string &valueName, const Value &value) {
+  constexpr std::size_t OPS = 2000000;
+  std::cout << "\n=== value = " << valueName << " ===\n";
+
+  for (int capacity : {1000, 100000}) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> inCap(0, capacity - 1);
+    std::uniform_int_distribution<int> wide(0, capacity * 4 - 1);
+    // 混合负载用偏斜分布：一半请求落在 10% 的热点上
+    std::uniform_int_distribution<int> hot(0, capacity / 10);
+
+    std::vector<int> hitKeys(OPS), evictKeys(OPS), mixedKeys(OPS);
+    for (std::size_t i = 0; i < OPS; ++i) {
+      hitKeys[i] = inCap(gen);
+      evictKeys[i] = wide(gen);
+      mixedKeys[i] = (gen() & 1) ? hot(gen) : wide(gen);
+    }
+
+    benchGetHit<LruCache<int, Value>>("LruCache", capacity, hitKeys, value);
+    benchGetHit<PoolLruCache<int, Value>>("PoolLruCache", capacity, hitKeys,
+                                          value);
+    benchPutEvict<LruCache<int, Value>>("LruCache", capacity, evictKeys,
+                                        value);
+    benchPutEvict<PoolLruCache<int, Value>>("PoolLruCache", capacity,
+                                            evictKeys, value);
+    benchMixed<LruCache<int, Value>>("LruCache", capacity, mixedKeys, value);
+    benchMixed<PoolLruCache<int, Value>>("PoolLruCache", capacity, mixedKeys,
+                                         value);
+  }
+}
+
+} // namespace
+
+int main() {
+  runAll<int>("int", 7);
+  runAll<std::string>("string(64B)", std::string(64, 'x'));
+  return 0;
+}
@@ -0,0 +1,87 @@
+// 分片 LRU 在多线程下的吞吐：普通 KHashLruCaches 与 NumaLruCaches 的
+// Partitioned / Replicated 两种方式，读多写少(95% get)，一半请求落在热点上。
+// 单节点机器上三者只差路由开销；多 socket 机器上能看到跨节点访问的代价
+#include "LruCache.h"
+#include "NumaCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kCapacity = 4096;
+constexpr int kKeySpace = 8192;
+constexpr int kOpsPerThread = 1000000;
+
+template <typename Cache> double runThreads(Cache &cache, int threads) {
+  for (int key = 0; key < kKeySpace; ++key) {
+    cache.put(key, key);
+  }
+  std::atomic<bool> start{false};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      std::mt19937 gen(static_cast<unsigned>(t) + 1);
+      std::uniform_int_distribution<int> hot(0, kKeySpace / 20);
+      std::uniform_int_distribution<int> all(0, kKeySpace - 1);
+      std::uniform_int_distribution<int> pct(0, 99);
+      while (!start.load(std::memory_order_acquire)) {
+      }
+      int out = 0;
+      for (int i = 0; i < kOpsPerThread; ++i) {
+        const int key = (i & 1) ? hot(gen) : all(gen);
+        if (pct(gen) < 5)
+          cache.put(key, i);
+        else
+          cache.get(key, out);
+      }
+    });
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  for (auto &w : workers) {
+    w.join();
+  }
+  const double ns = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - begin)
+          .count());
+  return static_cast<double>(threads) * kOpsPerThread * 1e3 / ns; // Mops/s
+}
+
+} // namespace
+
+int main() {
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  std::cout << "nodes=" << NumaTopology::system().nodeCount()
+            << " mbind=" << (numaBindingSupported() ? "yes" : "no")
+            << " capacity=" << kCapacity << " keys=" << kKeySpace
+            << " (95% get / 5% put), Mops/s\n";
+  std::cout << std::left << std::setw(10) << "threads" << std::right
+            << std::setw(12) << "khash" << std::setw(14) << "partitioned"
+            << std::setw(14) << "replicated" << '\n';
+
+  for (unsigned threads = 1; threads <= hw * 2; threads *= 2) {
+    KHashLruCaches<int, int> khash(kCapacity, 0);
+    NumaLruCaches<int, int> partitioned(kCapacity);
+    NumaOptions replica;
+    replica.mode = NumaMode::Replicated;
+    NumaLruCaches<int, int> replicated(kCapacity, replica);
+
+    const int n = static_cast<int>(threads);
+    std::cout << std::left << std::setw(10) << threads << std::right
+              << std::fixed << std::setprecision(2) << std::setw(12)
+              << runThreads(khash, n) << std::setw(14)
+              << runThreads(partitioned, n) << std::setw(14)
+              << runThreads(replicated, n) << '\n';
+  }
+  return 0;
+}
@@ -0,0 +1,117 @@
+// 静态组合的 Cache<...> 与经由 ICachePolicy 虚调用的对比(单线程)：
+// 同一个 LRU 分别通过 ICachePolicy*(LruCache、CachePolicyAdaptor)、
+// 直接调用(std::mutex / SpinLock / NoLock)驱动，工作负载相同
+#include "Cache.h"
+#include "LruCache.h"
+#include "arc/ArcCache.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kCapacity = 4096;
+constexpr int kKeySpace = 16384;
+constexpr int kOps = 4000000;
+
+// 90% get / 10% put，80% 的请求落在 20% 的 key 上；key 序列预先生成
+std::vector<int> makeKeys() {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> hot(0, kKeySpace / 5 - 1);
+  std::uniform_int_distribution<int> all(0, kKeySpace - 1);
+  std::uniform_int_distribution<int> pct(0, 99);
+  std::vector<int> keys(kOps);
+  for (int &key : keys) {
+    key = pct(gen) < 80 ? hot(gen) : all(gen);
+  }
+  return keys;
+}
+
+template <typename Cache>
+double run(Cache &cache, const std::vector<int> &keys) {
+  int out = 0;
+  std::uint64_t sink = 0;
+  const auto begin = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    const int key = keys[i];
+    if (i % 10 == 0) {
+      cache.put(key, key);
+    } else if (cache.get(key, out)) {
+      sink += static_cast<std::uint64_t>(out);
+    } else {
+      cache.put(key, key);
+    }
+  }
+  const double ns = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - begin)
+          .count());
+  if (sink == 42) // 防止整个循环被优化掉
+    std::cout << "";
+  return ns / static_cast<double>(keys.size());
+}
+
+// 经由基类指针调用：放在不内联的函数里，编译器看不到动态类型，无法去虚化
+[[gnu::noinline]] double runVirtual(ICachePolicy<int, int> &cache,
+                                    const std::vector<int> &keys) {
+  return run(cache, keys);
+}
+
+void printRow(const std::string &name, double nsPerOp) {
+  std::cout << std::left << std::setw(44) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(8) << nsPerOp << " ns/op"
+            << std::setw(9) << std::setprecision(2) << 1e3 / nsPerOp
+            << " Mops/s\n";
+}
+
+} // namespace
+
+int main() {
+  const std::vector<int> keys = makeKeys();
+  std::cout << "capacity=" << kCapacity << " keys=" << kKeySpace
+            << " ops=" << kOps << " (90% get / 10% put, 80/20 skew)\n";
+
+  {
+    auto cache = std::make_unique<LruCache<int, int>>(kCapacity);
+    printRow("LruCache via ICachePolicy*", runVirtual(*cache, keys));
+  }
+  {
+    auto cache =
+        std::make_unique<CachePolicyAdaptor<Cache<int, int, LruEviction>>>(
+            kCapacity);
+    printRow("Cache<Lru, mutex> via CachePolicyAdaptor",
+             runVirtual(*cache, keys));
+  }
+  {
+    Cache<int, int, LruEviction> cache(kCapacity);
+    printRow("Cache<Lru, mutex>", run(cache, keys));
+  }
+  {
+    Cache<int, int, LruEviction, AlwaysAdmit<int>, SpinLock> cache(kCapacity);
+    printRow("Cache<Lru, SpinLock>", run(cache, keys));
+  }
+  {
+    Cache<int, int, LruEviction, AlwaysAdmit<int>, NoLock> cache(kCapacity);
+    printRow("Cache<Lru, NoLock>", run(cache, keys));
+  }
+  {
+    auto cache = std::make_unique<ArcCache<int, int>>(kCapacity);
+    printRow("ArcCache via ICachePolicy*", runVirtual(*cache, keys));
+  }
+  {
+    Cache<int, int, ArcEviction, AlwaysAdmit<int>, NoLock> cache(kCapacity);
+    printRow("Cache<Arc, NoLock>", run(cache, keys));
+  }
+  {
+    Cache<int, int, LruEviction, TinyLfuAdmission<int>, NoLock> cache(
+        kCapacity);
+    printRow("Cache<Lru + TinyLFU admission, NoLock>", run(cache, keys));
+  }
+  return 0;
+}
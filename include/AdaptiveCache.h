@@ -0,0 +1,359 @@
+#pragma once
+
+#include "Cache.h"
+#include "FlatIndex.h"
+#include "HashUtil.h"
+#include "ICachePolicy.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <variant>
+
+// AdaptiveCache 可以切换到的策略(枚举值即影子模拟器的下标)
+enum class AdaptivePolicy : std::uint8_t { Lru, Lfu, Arc, LruK };
+
+inline constexpr std::size_t kAdaptivePolicyCount = 4;
+
+inline const char *adaptivePolicyName(AdaptivePolicy policy) {
+  switch (policy) {
+  case AdaptivePolicy::Lru:
+    return "LRU";
+  case AdaptivePolicy::Lfu:
+    return "LFU";
+  case AdaptivePolicy::Arc:
+    return "ARC";
+  case AdaptivePolicy::LruK:
+    return "LRU-K";
+  }
+  return "?";
+}
+
+struct AdaptiveOptions {
+  AdaptivePolicy initial = AdaptivePolicy::Lru;
+  // 进入影子模拟的 key 比例(按 key 哈希抽样，同一个 key 要么总是被抽中要么从不)
+  double sampleRate = 0.01;
+  // 影子容量的下限：capacity × sampleRate 小于它时提高抽样率，
+  // 否则影子太小，模拟出来的未命中率和全量缓存差得远
+  std::size_t minShadowCapacity = 64;
+  // 一个评估窗口包含的抽样 get 次数
+  std::size_t window = 1024;
+  // 某个影子的窗口未命中率比当前策略的影子低 margin(绝对值)以上才算更好
+  double margin = 0.02;
+  // 同一个影子连续 patience 个窗口都更好才切换，避免在噪声上来回切
+  unsigned patience = 3;
+  // false 时只模拟和统计，由调用方 select()
+  bool autoSwitch = true;
+};
+
+// 在线选择淘汰策略的缓存：对外是一个普通缓存，内部同时跑 LRU、LFU、ARC、LRU-K
+// 四个影子模拟器，按窗口比较它们的未命中率，持续更好时把线上策略换过去。
+// - 空间抽样：只有 mixHash(key) 落在 sampleRate 以内的 key 进入影子，
+//   影子容量按同样比例缩小(SHARDS 的做法)，只存 64 位哈希，不存 value；
+//   未抽中的操作只多一次哈希和比较，抽中的操作多 4 次小缓存操作
+// - 影子和线上策略看到同样的 get/put 序列，各影子之间互相比较，
+//   不拿影子和线上的真实未命中率比(两者抽样误差不同)
+// - 切换时不清空：旧策略留作后备，新策略未命中时到旧策略里找，
+//   找到就写进新策略；put/remove 同时作用于旧策略的副本(put 删掉旧副本)，
+//   不会读到旧值。切换后再经过 2 × capacity 次操作丢掉旧策略，
+//   这段时间内存最多是两份
+// 一把 std::mutex 保护全部状态，线上策略与影子本身都不加锁。
+// 线上策略和影子都是 Cache<> 引擎，LRU-K 为 LruEviction + LruKAdmission<Key, 2>
+template <typename Key, typename Value>
+class AdaptiveCache : public ICachePolicy<Key, Value> {
+public:
+  explicit AdaptiveCache(std::size_t capacity, AdaptiveOptions options = {})
+      : threshold_(sampleThreshold(capacity, options)),
+        live_(makeLive(options.initial, capacity)), capacity_(capacity),
+        policy_(options.initial), options_(options),
+        shadowLru_(shadowCapacity(capacity, options)),
+        shadowLfu_(shadowCapacity(capacity, options)),
+        shadowArc_(shadowCapacity(capacity, options)),
+        shadowLruK_(shadowCapacity(capacity, options)) {
+    if (options_.window == 0)
+      options_.window = 1;
+  }
+
+  AdaptiveCache(const AdaptiveCache &) = delete;
+  AdaptiveCache &operator=(const AdaptiveCache &) = delete;
+
+  void put(const Key &key, const Value &value) override {
+    const std::uint64_t hash = hashOf(key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    withEngine(live_, [&](auto &live) { live.put(key, value); });
+    if (previous_) [[unlikely]]
+      handoffPut(key);
+    if (hash < threshold_) [[unlikely]]
+      simulatePut(hash);
+  }
+
+  bool get(const Key &key, Value &value) override {
+    const std::uint64_t hash = hashOf(key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool hit =
+        withEngine(live_, [&](auto &live) { return live.get(key, value); });
+    if (previous_) [[unlikely]]
+      hit = handoffGet(key, value, hit);
+    if (hash < threshold_) [[unlikely]]
+      simulateGet(hash);
+    return hit;
+  }
+
+  Value get(const Key &key) override {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  // 删除指定元素，返回是否存在(影子不受影响：删除不是访问)
+  bool remove(const Key &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool found =
+        withEngine(live_, [&](auto &live) { return live.remove(key); });
+    if (previous_)
+      found = withEngine(*previous_,
+                         [&](auto &prev) { return prev.remove(key); }) ||
+              found;
+    return found;
+  }
+
+  // 人工切换线上策略(与自动切换走同样的交接流程)
+  void select(AdaptivePolicy policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    switchLocked(policy);
+  }
+
+  AdaptivePolicy policy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+  }
+
+  std::uint64_t switches() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return switches_;
+  }
+
+  // 是否还在交接期(旧策略尚未丢弃)
+  bool handingOff() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return previous_.has_value();
+  }
+
+  // 上一个完整窗口里影子 policy 的未命中率；还没有完整窗口时为 0
+  double windowMissRatio(AdaptivePolicy policy) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastMissRatio_[index(policy)];
+  }
+
+  // 进入影子模拟的 get 次数(可以用来核对实际抽样率)
+  std::uint64_t sampledGets() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sampledGets_;
+  }
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t n =
+        withEngine(live_, [](const auto &live) { return live.size(); });
+    if (previous_)
+      n += withEngine(*previous_,
+                      [](const auto &prev) { return prev.size(); });
+    return n;
+  }
+
+  std::size_t capacity() const { return capacity_; }
+
+private:
+  template <typename E, typename A = AlwaysAdmit<Key>>
+  using Engine = Cache<Key, Value, E, A, NoLock>;
+  // 下标与 AdaptivePolicy 一致
+  using Live = std::variant<std::unique_ptr<Engine<LruEviction>>,
+                            std::unique_ptr<Engine<LfuEviction>>,
+                            std::unique_ptr<Engine<ArcEviction>>,
+                            std::unique_ptr<Engine<LruEviction,
+                                                   LruKAdmission<Key, 2>>>>;
+
+  template <typename E, typename A = AlwaysAdmit<std::uint64_t>>
+  using Shadow = Cache<std::uint64_t, std::uint8_t, E, A, NoLock>;
+
+  // 用 switch 分派而不是 std::visit：GCC 对 std::visit 生成函数指针表，
+  // 引擎调用就内联不进来了
+  template <typename L, typename Fn>
+  static decltype(auto) withEngine(L &live, Fn &&fn) {
+    switch (live.index()) {
+    case 1:
+      return fn(**std::get_if<1>(&live));
+    case 2:
+      return fn(**std::get_if<2>(&live));
+    case 3:
+      return fn(**std::get_if<3>(&live));
+    default:
+      return fn(**std::get_if<0>(&live));
+    }
+  }
+
+  static constexpr std::size_t index(AdaptivePolicy policy) {
+    return static_cast<std::size_t>(policy);
+  }
+
+  static std::uint64_t hashOf(const Key &key) {
+    return mixHash(static_cast<std::uint64_t>(TransparentHash<Key>{}(key)));
+  }
+
+  static double effectiveRate(std::size_t capacity,
+                              const AdaptiveOptions &options) {
+    double rate = options.sampleRate;
+    if (capacity > 0 &&
+        static_cast<double>(capacity) * rate <
+            static_cast<double>(options.minShadowCapacity))
+      rate = static_cast<double>(options.minShadowCapacity) /
+             static_cast<double>(capacity);
+    return rate < 1.0 ? rate : 1.0;
+  }
+
+  static std::uint64_t sampleThreshold(std::size_t capacity,
+                                       const AdaptiveOptions &options) {
+    const double rate = effectiveRate(capacity, options);
+    if (rate >= 1.0)
+      return std::numeric_limits<std::uint64_t>::max();
+    if (rate <= 0.0)
+      return 0;
+    return static_cast<std::uint64_t>(
+        rate * static_cast<double>(std::numeric_limits<std::uint64_t>::max()));
+  }
+
+  static std::size_t shadowCapacity(std::size_t capacity,
+                                    const AdaptiveOptions &options) {
+    const double scaled =
+        static_cast<double>(capacity) * effectiveRate(capacity, options);
+    const auto n = static_cast<std::size_t>(scaled + 0.5);
+    return n > 0 ? n : 1;
+  }
+
+  static Live makeLive(AdaptivePolicy policy, std::size_t capacity) {
+    switch (policy) {
+    case AdaptivePolicy::Lfu:
+      return Live(std::in_place_index<1>,
+                  std::make_unique<Engine<LfuEviction>>(capacity));
+    case AdaptivePolicy::Arc:
+      return Live(std::in_place_index<2>,
+                  std::make_unique<Engine<ArcEviction>>(capacity));
+    case AdaptivePolicy::LruK:
+      return Live(std::in_place_index<3>,
+                  std::make_unique<
+                      Engine<LruEviction, LruKAdmission<Key, 2>>>(capacity));
+    case AdaptivePolicy::Lru:
+      break;
+    }
+    return Live(std::in_place_index<0>,
+                std::make_unique<Engine<LruEviction>>(capacity));
+  }
+
+  template <typename Fn> void forEachShadow(Fn &&fn) {
+    fn(index(AdaptivePolicy::Lru), shadowLru_);
+    fn(index(AdaptivePolicy::Lfu), shadowLfu_);
+    fn(index(AdaptivePolicy::Arc), shadowArc_);
+    fn(index(AdaptivePolicy::LruK), shadowLruK_);
+  }
+
+  // 交接期和影子模拟都是冷路径，单独成函数不内联，
+  // 免得四种引擎的代码全部展开进 get/put，拖慢未抽中的常规路径
+  [[gnu::noinline]] void handoffPut(const Key &key) {
+    withEngine(*previous_, [&](auto &prev) { prev.remove(key); });
+    tickHandoff();
+  }
+
+  [[gnu::noinline]] bool handoffGet(const Key &key, Value &value, bool hit) {
+    if (!hit) {
+      hit = withEngine(*previous_,
+                       [&](auto &prev) { return prev.get(key, value); });
+      if (hit)
+        withEngine(live_, [&](auto &live) { live.put(key, value); });
+    }
+    tickHandoff();
+    return hit;
+  }
+
+  [[gnu::noinline]] void simulatePut(std::uint64_t hash) {
+    forEachShadow([hash](std::size_t, auto &shadow) { shadow.put(hash, 0); });
+  }
+
+  [[gnu::noinline]] void simulateGet(std::uint64_t hash) {
+    forEachShadow([this, hash](std::size_t i, auto &shadow) {
+      std::uint8_t dummy = 0;
+      if (!shadow.get(hash, dummy))
+        ++windowMisses_[i];
+    });
+    ++sampledGets_;
+    if (++windowGets_ >= options_.window)
+      endWindow();
+  }
+
+  void endWindow() {
+    std::size_t best = index(policy_);
+    for (std::size_t i = 0; i < kAdaptivePolicyCount; ++i) {
+      lastMissRatio_[i] = static_cast<double>(windowMisses_[i]) /
+                          static_cast<double>(windowGets_);
+      windowMisses_[i] = 0;
+      if (lastMissRatio_[i] < lastMissRatio_[best])
+        best = i;
+    }
+    windowGets_ = 0;
+
+    const std::size_t current = index(policy_);
+    if (best == current ||
+        lastMissRatio_[best] + options_.margin > lastMissRatio_[current]) {
+      streak_ = 0;
+      return;
+    }
+    if (best != candidate_) {
+      candidate_ = best;
+      streak_ = 0;
+    }
+    if (++streak_ >= options_.patience && options_.autoSwitch)
+      switchLocked(static_cast<AdaptivePolicy>(best));
+  }
+
+  void switchLocked(AdaptivePolicy policy) {
+    streak_ = 0;
+    if (policy == policy_)
+      return;
+    // 上一次交接还没结束：直接丢掉更早的那份
+    previous_.emplace(std::move(live_));
+    live_ = makeLive(policy, capacity_);
+    policy_ = policy;
+    handoffOps_ = 0;
+    ++switches_;
+  }
+
+  void tickHandoff() {
+    if (++handoffOps_ >= 2 * capacity_)
+      previous_.reset();
+  }
+
+  // 每次操作都要碰的成员放在一起，影子放后面
+  mutable std::mutex mutex_;
+  const std::uint64_t threshold_;
+  Live live_;
+  std::optional<Live> previous_;
+  std::size_t handoffOps_ = 0;
+  const std::size_t capacity_;
+  AdaptivePolicy policy_;
+  std::uint64_t switches_ = 0;
+
+  AdaptiveOptions options_;
+  Shadow<LruEviction> shadowLru_;
+  Shadow<LfuEviction> shadowLfu_;
+  Shadow<ArcEviction> shadowArc_;
+  Shadow<LruEviction, LruKAdmission<std::uint64_t, 2>> shadowLruK_;
+  std::array<std::uint64_t, kAdaptivePolicyCount> windowMisses_{};
+  std::array<double, kAdaptivePolicyCount> lastMissRatio_{};
+  std::size_t windowGets_ = 0;
+  std::uint64_t sampledGets_ = 0;
+  std::size_t candidate_ = kAdaptivePolicyCount;
+  unsigned streak_ = 0;
+};
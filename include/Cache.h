@@ -0,0 +1,167 @@
+#pragma once
+
+#include "CacheStats.h"
+#include "ICachePolicy.h"
+#include "policy/Admission.h"
+#include "policy/Eviction.h"
+#include "policy/Locking.h"
+#include "policy/Storage.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+// 编译期组合的缓存引擎：淘汰、准入、加锁、统计、存储各是一个模板参数，
+// 由 concept 约束(见 policy/ 下各头文件)，全部静态分派，
+// 一次 get/put 里的哈希、查找和链表操作都能内联到调用点。
+//   Cache<std::string, int, LruEviction>                                   普通 LRU
+//   Cache<int, int, ArcEviction, TinyLfuAdmission<int>, SpinLock>          ARC + TinyLFU 准入
+//   Cache<int, int, LfuEviction, AlwaysAdmit<int>, NoLock, AtomicStats>    单线程 LFU，带统计
+// 需要 ICachePolicy 的地方用 CachePolicyAdaptor 包一层。
+// 容量按条目数计(没有 Weigher)
+template <typename Key, typename Value, EvictionPolicy Eviction,
+          typename Admission = AlwaysAdmit<Key>, CacheLock Lock = std::mutex,
+          typename Stats = NullStats,
+          typename Storage = SlabStorage<Key, Value>>
+  requires AdmissionPolicy<Admission, Key> &&
+           CacheStorage<Storage, Key, Value>
+class Cache {
+public:
+  using KeyType = Key;
+  using ValueType = Value;
+
+  explicit Cache(std::size_t capacity)
+      : capacity_(capacity), storage_(capacity), eviction_(capacity),
+        admission_(capacity) {}
+
+  Cache(const Cache &) = delete;
+  Cache &operator=(const Cache &) = delete;
+
+  void put(const Key &key, const Value &value) {
+    StatsLockGuard<Stats, Lock> lock(lock_, stats_);
+    putLocked(key, value);
+  }
+
+  // 右值版本：key/value 直接移动进结点
+  void put(Key &&key, Value &&value) {
+    StatsLockGuard<Stats, Lock> lock(lock_, stats_);
+    putLocked(std::move(key), std::move(value));
+  }
+
+  bool get(const Key &key, Value &value) {
+    StatsLockGuard<Stats, Lock> lock(lock_, stats_);
+    const std::uint64_t hash = storage_.hashOf(key);
+    const Index i = storage_.find(key, hash);
+    admission_.onAccess(key, i != kNil);
+    stats_.record(i != kNil ? CacheCounter::Hit : CacheCounter::Miss);
+    if (i == kNil)
+      return false;
+
+    eviction_.onAccess(i);
+    value = storage_.value(i);
+    return true;
+  }
+
+  Value get(const Key &key) {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  // 删除指定元素，返回是否存在
+  bool remove(const Key &key) {
+    StatsLockGuard<Stats, Lock> lock(lock_, stats_);
+    const std::uint64_t hash = storage_.hashOf(key);
+    const Index i = storage_.find(key, hash);
+    if (i == kNil)
+      return false;
+    eviction_.onErase(i, hash, false);
+    storage_.erase(i, hash);
+    return true;
+  }
+
+  std::size_t size() const {
+    std::lock_guard<Lock> lock(lock_);
+    return storage_.size();
+  }
+
+  std::size_t capacity() const { return capacity_; }
+
+  // 统计快照(Stats 为 NullStats 时全为 0)
+  CacheStats stats() const { return stats_.snapshot(); }
+
+  // 淘汰策略的只读视图(例如 ArcEviction::target())，调用方自行同步
+  const Eviction &eviction() const { return eviction_; }
+
+private:
+  using Index = std::uint32_t;
+  static constexpr Index kNil = policy_detail::kNil;
+
+  template <typename K, typename V> void putLocked(K &&key, V &&value) {
+    if (capacity_ == 0)
+      return;
+
+    const std::uint64_t hash = storage_.hashOf(key);
+    Index i = storage_.find(key, hash);
+    if (i != kNil) {
+      admission_.onAccess(key, true);
+      storage_.value(i) = std::forward<V>(value);
+      eviction_.onAccess(i);
+      return;
+    }
+
+    if constexpr (requires { eviction_.beforeInsert(hash); })
+      eviction_.beforeInsert(hash);
+    const Index victim =
+        storage_.size() >= capacity_ ? eviction_.victim() : kNil;
+    if (!admission_.admit(key, victim != kNil ? &storage_.key(victim)
+                                              : nullptr))
+      return;
+
+    if (victim != kNil) {
+      const std::uint64_t victimHash = storage_.hashOf(storage_.key(victim));
+      eviction_.onErase(victim, victimHash, true);
+      storage_.erase(victim, victimHash);
+      stats_.record(CacheCounter::Eviction);
+    }
+    i = storage_.insert(hash, std::forward<K>(key), std::forward<V>(value));
+    eviction_.onInsert(i, hash);
+    stats_.record(CacheCounter::Insert);
+  }
+
+  std::size_t capacity_;
+  Storage storage_;
+  [[no_unique_address]] Eviction eviction_;
+  [[no_unique_address]] Admission admission_;
+  mutable Lock lock_;
+  mutable Stats stats_;
+};
+
+// 把静态组合的 Cache 接到 ICachePolicy 上(虚调用)，构造参数原样转给 Cache
+template <typename Engine>
+class CachePolicyAdaptor
+    : public ICachePolicy<typename Engine::KeyType, typename Engine::ValueType> {
+  using Key = typename Engine::KeyType;
+  using Value = typename Engine::ValueType;
+
+public:
+  template <typename... Args>
+  explicit CachePolicyAdaptor(Args &&...args)
+      : engine_(std::forward<Args>(args)...) {}
+
+  void put(const Key &key, const Value &value) override {
+    engine_.put(key, value);
+  }
+
+  bool get(const Key &key, Value &value) override {
+    return engine_.get(key, value);
+  }
+
+  Value get(const Key &key) override { return engine_.get(key); }
+
+  Engine &engine() { return engine_; }
+  const Engine &engine() const { return engine_; }
+
+private:
+  Engine engine_;
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "HashUtil.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// 缓存统计，作为模板参数在编译期选择：
+// - NullStats：默认值，所有记录函数都是空的，不占用任何运行时开销
+// - AtomicStats：按线程分条带的 relaxed 原子计数器，stats() 时汇总
+// 缓存里统一通过 stats_.record(CacheCounter::X) 记录，NullStats 下会被完全优化掉。
+enum class CacheCounter : std::size_t {
+  Hit,
+  Miss,
+  Insert,
+  Eviction,
+  Expiration,    // TTL 到期被回收
+  Promotion,     // LRU-K：从历史队列晋升到主缓存；SLRU：试用段晋升到保护段
+  Migration,     // ARC：T1(LRU 部分) -> T2(LFU 部分)
+  GhostHit,      // ARC：命中幽灵链表；SLRU：写入时命中 A1out
+  PAdjustment,   // ARC：两部分之间的容量(p)调整
+  LockAcquire,   // 加锁次数
+  LockContended, // 其中需要等待的次数
+  LockWaitNs,    // 等待锁的总纳秒数
+  kCount
+};
+
+// 某一时刻的统计快照(各字段为累计值)
+struct CacheStats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t inserts = 0;
+  std::uint64_t evictions = 0;
+  std::uint64_t expirations = 0;
+  std::uint64_t promotions = 0;
+  std::uint64_t migrations = 0;
+  std::uint64_t ghostHits = 0;
+  std::uint64_t pAdjustments = 0;
+  std::uint64_t lockAcquires = 0;
+  std::uint64_t lockContended = 0;
+  std::uint64_t lockWaitNs = 0;
+
+  double hitRatio() const {
+    const std::uint64_t total = hits + misses;
+    return total == 0 ? 0.0
+                      : static_cast<double>(hits) / static_cast<double>(total);
+  }
+
+  CacheStats &operator+=(const CacheStats &other) {
+    hits += other.hits;
+    misses += other.misses;
+    inserts += other.inserts;
+    evictions += other.evictions;
+    expirations += other.expirations;
+    promotions += other.promotions;
+    migrations += other.migrations;
+    ghostHits += other.ghostHits;
+    pAdjustments += other.pAdjustments;
+    lockAcquires += other.lockAcquires;
+    lockContended += other.lockContended;
+    lockWaitNs += other.lockWaitNs;
+    return *this;
+  }
+};
+
+struct NullStats {
+  static constexpr bool kEnabled = false;
+
+  void record(CacheCounter, std::uint64_t = 1) noexcept {}
+
+  template <typename Mutex> void lock(Mutex &mutex) { mutex.lock(); }
+
+  CacheStats snapshot() const { return {}; }
+};
+
+class AtomicStats {
+public:
+  static constexpr bool kEnabled = true;
+
+  void record(CacheCounter counter, std::uint64_t n = 1) noexcept {
+    stripes_[stripeIndex()]
+        .counters[static_cast<std::size_t>(counter)]
+        .fetch_add(n, std::memory_order_relaxed);
+  }
+
+  // 先 try_lock；拿不到说明发生了竞争，只在这条慢路径上计时
+  template <typename Mutex> void lock(Mutex &mutex) {
+    record(CacheCounter::LockAcquire);
+    if (mutex.try_lock())
+      return;
+
+    const auto begin = std::chrono::steady_clock::now();
+    mutex.lock();
+    const auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - begin)
+                            .count();
+    record(CacheCounter::LockContended);
+    record(CacheCounter::LockWaitNs, static_cast<std::uint64_t>(waited));
+  }
+
+  CacheStats snapshot() const {
+    std::array<std::uint64_t, kCounters> sum{};
+    for (const Stripe &stripe : stripes_) {
+      for (std::size_t i = 0; i < kCounters; ++i) {
+        sum[i] += stripe.counters[i].load(std::memory_order_relaxed);
+      }
+    }
+    auto at = [&sum](CacheCounter c) {
+      return sum[static_cast<std::size_t>(c)];
+    };
+
+    CacheStats s;
+    s.hits = at(CacheCounter::Hit);
+    s.misses = at(CacheCounter::Miss);
+    s.inserts = at(CacheCounter::Insert);
+    s.evictions = at(CacheCounter::Eviction);
+    s.expirations = at(CacheCounter::Expiration);
+    s.promotions = at(CacheCounter::Promotion);
+    s.migrations = at(CacheCounter::Migration);
+    s.ghostHits = at(CacheCounter::GhostHit);
+    s.pAdjustments = at(CacheCounter::PAdjustment);
+    s.lockAcquires = at(CacheCounter::LockAcquire);
+    s.lockContended = at(CacheCounter::LockContended);
+    s.lockWaitNs = at(CacheCounter::LockWaitNs);
+    return s;
+  }
+
+private:
+  static constexpr std::size_t kCounters =
+      static_cast<std::size_t>(CacheCounter::kCount);
+  static constexpr std::size_t kStripes = 8; // 2 的幂
+
+  // 每个条带独占缓存行，不同线程的计数互不干扰
+  struct alignas(kCacheLineSize) Stripe {
+    std::array<std::atomic<std::uint64_t>, kCounters> counters{};
+  };
+
+  // 线程首次记录时按轮转分配条带
+  static std::size_t stripeIndex() noexcept {
+    static std::atomic<std::size_t> nextThread{0};
+    thread_local const std::size_t index =
+        nextThread.fetch_add(1, std::memory_order_relaxed) & (kStripes - 1);
+    return index;
+  }
+
+  std::array<Stripe, kStripes> stripes_;
+};
+
+// 通过统计策略加锁的 lock_guard；NullStats 下等价于 std::lock_guard
+template <typename Stats, typename Mutex> class StatsLockGuard {
+public:
+  StatsLockGuard(Mutex &mutex, Stats &stats) : mutex_(mutex) {
+    stats.lock(mutex_);
+  }
+  ~StatsLockGuard() { mutex_.unlock(); }
+
+  StatsLockGuard(const StatsLockGuard &) = delete;
+  StatsLockGuard &operator=(const StatsLockGuard &) = delete;
+
+private:
+  Mutex &mutex_;
+};
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "HashUtil.h"
+#include "ICachePolicy.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// CLOCK 近似 LRU：
+// - 结点放在定长数组里，命中只把引用位原子地置 1，不改链表
+// - 索引按 key 的哈希分成多个条带，每个条带一把读写锁，get 只拿共享锁
+// - 淘汰时时钟指针扫过数组：引用位为 1 的清零放过，为 0 的作为牺牲者
+// 插入/淘汰由 insertMutex_ 串行化；锁顺序固定为 insertMutex_ -> 条带锁。
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ClockCache : public ICachePolicy<Key, Value> {
+public:
+  explicit ClockCache(int capacity, int stripeNum = 0)
+      : capacity_(capacity > 0 ? static_cast<std::size_t>(capacity) : 0),
+        slots_(std::make_unique<Slot[]>(capacity_)) {
+    // 条带数取 2 的幂，默认是硬件线程数的 4 倍
+    std::size_t want =
+        stripeNum > 0
+            ? static_cast<std::size_t>(stripeNum)
+            : std::max<std::size_t>(1, std::thread::hardware_concurrency()) * 4;
+    stripeNum_ = roundUpPow2(want);
+    stripes_ = std::make_unique<Stripe[]>(stripeNum_);
+  }
+
+  ~ClockCache() override = default;
+
+  void put(const Key &key, const Value &value) override {
+    if (capacity_ == 0)
+      return;
+
+    Stripe &stripe = stripeFor(key);
+    if (updateExisting(stripe, key, value))
+      return;
+
+    std::lock_guard<std::mutex> insertLock(insertMutex_);
+    // 拿到插入锁后再确认一次，防止并发插入同一个 key
+    if (updateExisting(stripe, key, value))
+      return;
+
+    std::uint32_t index = acquireSlot();
+    // 槽位此时不在任何索引中，读者看不到它，可以不加条带锁直接写
+    Slot &slot = slots_[index];
+    slot.key = key;
+    slot.value = value;
+    slot.ref.store(0, std::memory_order_relaxed);
+
+    std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+    stripe.index.emplace(key, index);
+  }
+
+  bool get(const Key &key, Value &value) override {
+    Stripe &stripe = stripeFor(key);
+    std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+    auto it = stripe.index.find(key);
+    if (it == stripe.index.end())
+      return false;
+
+    Slot &slot = slots_[it->second];
+    // 先读后写，已置位时不再写，避免热点 key 的缓存行来回失效
+    if (slot.ref.load(std::memory_order_relaxed) == 0)
+      slot.ref.store(1, std::memory_order_relaxed);
+    value = slot.value;
+    return true;
+  }
+
+  Value get(const Key &key) override {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  // 删除指定元素
+  void remove(const Key &key) {
+    std::lock_guard<std::mutex> insertLock(insertMutex_);
+    Stripe &stripe = stripeFor(key);
+    std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+    auto it = stripe.index.find(key);
+    if (it == stripe.index.end())
+      return;
+
+    slots_[it->second].value = Value{};
+    freeSlots_.push_back(it->second);
+    stripe.index.erase(it);
+  }
+
+  std::size_t size() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < stripeNum_; ++i) {
+      std::shared_lock<std::shared_mutex> lock(stripes_[i].mutex);
+      total += stripes_[i].index.size();
+    }
+    return total;
+  }
+
+private:
+  struct Slot {
+    Key key{};
+    Value value{};
+    std::atomic<std::uint8_t> ref{0}; // 引用位
+  };
+
+  // 每个条带独占缓存行，避免相邻条带的锁互相伪共享
+  struct alignas(kCacheLineSize) Stripe {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<Key, std::uint32_t, Hash> index; // key -> 槽位下标
+  };
+
+  Stripe &stripeFor(const Key &key) const {
+    const std::uint64_t h = mixHash(static_cast<std::uint64_t>(hash_(key)));
+    return stripes_[static_cast<std::size_t>(h) & (stripeNum_ - 1)];
+  }
+
+  bool updateExisting(Stripe &stripe, const Key &key, const Value &value) {
+    std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+    auto it = stripe.index.find(key);
+    if (it == stripe.index.end())
+      return false;
+
+    Slot &slot = slots_[it->second];
+    slot.value = value;
+    slot.ref.store(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // 需持有 insertMutex_：优先使用从未用过或被删除的槽位，否则走时钟淘汰
+  std::uint32_t acquireSlot() {
+    if (!freeSlots_.empty()) {
+      std::uint32_t index = freeSlots_.back();
+      freeSlots_.pop_back();
+      return index;
+    }
+    if (used_ < capacity_) {
+      return static_cast<std::uint32_t>(used_++);
+    }
+    return evict();
+  }
+
+  std::uint32_t evict() {
+    for (;;) {
+      Slot &slot = slots_[hand_];
+      const std::uint32_t index = static_cast<std::uint32_t>(hand_);
+      hand_ = (hand_ + 1) % capacity_;
+
+      // 引用位为 1：给第二次机会
+      if (slot.ref.exchange(0, std::memory_order_relaxed) != 0)
+        continue;
+
+      // 先从索引摘除，拿写锁时会等正在读这个槽位的读者退出
+      Stripe &stripe = stripeFor(slot.key);
+      std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+      stripe.index.erase(slot.key);
+      return index;
+    }
+  }
+
+private:
+  std::size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  std::size_t stripeNum_ = 1;
+  std::unique_ptr<Stripe[]> stripes_;
+  Hash hash_;
+
+  std::mutex insertMutex_; // 串行化插入与淘汰
+  std::size_t used_ = 0;   // 已经启用过的槽位数
+  std::size_t hand_ = 0;   // 时钟指针
+  std::vector<std::uint32_t> freeSlots_;
+};
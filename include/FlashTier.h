@@ -0,0 +1,448 @@
+#pragma once
+
+#include "FlatIndex.h"
+#include "HashUtil.h"
+#include "NodeSlab.h"
+#include "Snapshot.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// 闪存(SSD/NVMe)上的第二级缓存，只用于 POSIX 平台(pread/pwrite)：
+// - 数据按日志结构追加写进固定大小的段文件(segment-N.log)，不原地覆盖
+// - 内存里只有 key 指纹 -> (段, 偏移, 长度) 的紧凑索引，key/value 都在盘上，
+//   读出后校验和与 key 都对得上才算命中(指纹碰撞按未命中处理)
+// - 写入先在内存里攒成批，由一个后台 I/O 线程顺序写盘，put 不做任何系统调用；
+//   排队的字节超过上限时直接丢弃新条目，不让上一级缓存的锁等磁盘
+// - 段数达到上限时回收一个旧段(GC)：其中仍然有效的条目一起丢弃
+// - 读盘在锁外进行，多个读者可以同时 pread
+// 只作为缓存使用：索引不落盘，重启后段文件作废(构造时清空)。
+// 编码方式与快照相同(SnapshotCodec)，key/value 必须可编码
+
+// GC 挑选回收段的方式
+enum class FlashGc {
+  Fifo,      // 最早写满的段(闪存缓存的常见做法，写放大最小)
+  LeastLive, // 有效字节最少的段(覆盖、删除、回填较多时少丢有效数据)
+};
+
+struct FlashOptions {
+  std::string directory;                  // 段文件所在的目录(需已存在)
+  std::size_t segmentBytes = 64u << 20;   // 单个段的大小(不超过 4 GiB)
+  std::size_t maxSegments = 16;           // 段数上限，容量约为二者之积
+  std::size_t writeBatchBytes = 1u << 20; // 攒够这么多字节交给 I/O 线程写一次
+  std::size_t maxQueuedBytes = 16u << 20; // 等待写盘的字节上限，超过后丢弃新条目
+  FlashGc gc = FlashGc::Fifo;
+};
+
+// 累计统计
+struct FlashStats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t inserts = 0;        // 写入(排队)的条目数
+  std::uint64_t dropped = 0;        // 写盘队列已满或条目超过段大小而丢弃的条目数
+  std::uint64_t bytesWritten = 0;   // 已经写到盘上的字节数
+  std::uint64_t segmentsReclaimed = 0;
+  std::uint64_t gcEvictions = 0;    // 随回收段一起丢弃的有效条目数
+};
+
+template <typename Key, typename Value> class FlashTier {
+public:
+  explicit FlashTier(FlashOptions options) : options_(std::move(options)) {
+    options_.segmentBytes = std::clamp<std::size_t>(
+        options_.segmentBytes, 64, std::numeric_limits<std::uint32_t>::max());
+    options_.maxSegments = std::max<std::size_t>(options_.maxSegments, 2);
+    options_.writeBatchBytes =
+        std::clamp<std::size_t>(options_.writeBatchBytes, 1,
+                                options_.segmentBytes);
+    ok_ = openSegment();
+    if (ok_)
+      writer_ = std::thread([this] { writeLoop(); });
+  }
+
+  FlashTier(const FlashTier &) = delete;
+  FlashTier &operator=(const FlashTier &) = delete;
+
+  // 丢弃还没写盘的批次，删除所有段文件
+  ~FlashTier() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    queueCv_.notify_all();
+    if (writer_.joinable())
+      writer_.join();
+  }
+
+  // 段文件创建失败时为 false，此时 put 什么都不做，get 总是未命中
+  bool ok() const { return ok_; }
+
+  // 写入(通常是上一级缓存淘汰的条目)。只在内存里编码和排队，不等磁盘
+  void put(const Key &key, const Value &value) {
+    if (!ok_)
+      return;
+    const std::uint64_t fp = fingerprintOf(key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    scratch_.clear();
+    scratch_.u64(0); // 校验和占位
+    scratch_.value(key);
+    scratch_.value(value);
+    const std::size_t size = scratch_.size();
+    scratch_.patch(0, snapshotChecksum(scratch_.data() + sizeof(std::uint64_t),
+                                       size - sizeof(std::uint64_t)));
+    if (size > options_.segmentBytes ||
+        queuedBytes_ + buffer_.size() + size > options_.maxQueuedBytes) {
+      ++stats_.dropped;
+      eraseLocked(fp);
+      return;
+    }
+
+    if (activeOffset_ + buffer_.size() + size > options_.segmentBytes &&
+        !sealActiveLocked()) {
+      ++stats_.dropped;
+      eraseLocked(fp);
+      return;
+    }
+    const auto offset =
+        static_cast<std::uint32_t>(activeOffset_ + buffer_.size());
+    buffer_.append(scratch_.data(), size);
+
+    Segment &segment = *segments_.at(activeId_);
+    segment.liveBytes += size;
+    segment.fingerprints.push_back(fp);
+    const Loc loc{activeId_, offset, static_cast<std::uint32_t>(size)};
+    const Index i = findLocked(fp);
+    if (i != kNil) {
+      killLocked(entries_[i].loc);
+      entries_[i].loc = loc;
+    } else {
+      const Index j = entries_.create(Entry{fp, loc});
+      index_.insert(index_.hashOf(fp), j,
+                    [this](Index k) { return index_.hashOf(entries_[k].fp); });
+    }
+    ++stats_.inserts;
+    if (buffer_.size() >= options_.writeBatchBytes)
+      submitLocked();
+  }
+
+  // 查找；盘上的数据在锁外读取
+  bool get(const Key &key, Value &value) { return read(key, value, false); }
+
+  // 查找并在命中时删除(回填到上一级缓存时用，避免两级各留一份)
+  bool take(const Key &key, Value &value) { return read(key, value, true); }
+
+  // 删除 key(上一级缓存写入了新值时调用，旧值不能再被读到)
+  void erase(const Key &key) {
+    const std::uint64_t fp = fingerprintOf(key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    eraseLocked(fp);
+  }
+
+  // 把攒着的批次交给 I/O 线程并等它写完
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    submitLocked();
+    idleCv_.wait(lock, [this] { return queue_.empty(); });
+  }
+
+  // 当前索引的条目数
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  std::size_t segmentCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segments_.size();
+  }
+
+  // 内存索引占用的字节数(每个条目 24 字节的结点加索引槽位，外加每段的指纹列表)
+  std::size_t memoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t bytes = entries_.memoryBytes() + index_.memoryBytes();
+    for (const auto &[id, segment] : segments_) {
+      bytes += segment->fingerprints.capacity() * sizeof(std::uint64_t);
+    }
+    return bytes;
+  }
+
+  FlashStats stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+private:
+  using Index = std::uint32_t;
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
+
+  struct Loc {
+    std::uint32_t segment;
+    std::uint32_t offset;
+    std::uint32_t size;
+  };
+
+  struct Entry {
+    std::uint64_t fp;
+    Loc loc;
+  };
+
+  // 一个段文件。回收时先删除文件名，读者手里的 shared_ptr 释放后才关闭 fd
+  struct Segment {
+    int fd = -1;
+    std::string path;
+    std::size_t durable = 0;   // 已写到盘上的字节数(按顺序写，前缀有效)
+    std::size_t liveBytes = 0; // 仍被索引引用的字节数
+    std::vector<std::uint64_t> fingerprints; // 写进这个段的条目指纹(回收时清索引)
+
+    ~Segment() {
+      if (fd >= 0)
+        ::close(fd);
+    }
+  };
+
+  // 交给 I/O 线程的一批连续记录
+  struct Job {
+    std::shared_ptr<Segment> segment;
+    std::size_t offset;
+    std::string data;
+  };
+
+  static std::uint64_t fingerprintOf(const Key &key) {
+    return mixHash(static_cast<std::uint64_t>(TransparentHash<Key>{}(key)));
+  }
+
+  bool read(const Key &key, Value &value, bool remove) {
+    if (!ok_)
+      return false;
+    const std::uint64_t fp = fingerprintOf(key);
+    std::string bytes;
+    std::shared_ptr<Segment> segment;
+    Loc loc{};
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const Index i = findLocked(fp);
+      if (i == kNil) {
+        ++stats_.misses;
+        return false;
+      }
+      loc = entries_[i].loc;
+      segment = segments_.at(loc.segment);
+      if (!copyUnwrittenLocked(loc, *segment, bytes))
+        bytes.resize(loc.size); // 已经在盘上，下面在锁外读
+      else
+        segment.reset();
+    }
+
+    if (segment) {
+      const ssize_t n = ::pread(segment->fd, bytes.data(), loc.size,
+                                static_cast<off_t>(loc.offset));
+      if (n != static_cast<ssize_t>(loc.size))
+        bytes.clear();
+    }
+
+    const bool hit = decode(bytes, key, value);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++(hit ? stats_.hits : stats_.misses);
+    if (remove && hit) {
+      // 读盘期间这个 key 可能已被覆盖，只删我们读到的那一份
+      const Index i = findLocked(fp);
+      if (i != kNil && entries_[i].loc.segment == loc.segment &&
+          entries_[i].loc.offset == loc.offset)
+        eraseLocked(fp);
+    }
+    return hit;
+  }
+
+  // 记录还在内存里(当前批次或写盘队列)时拷贝出来并返回 true
+  bool copyUnwrittenLocked(const Loc &loc, const Segment &segment,
+                           std::string &out) const {
+    if (loc.offset + loc.size <= segment.durable)
+      return false;
+    if (loc.segment == activeId_ && loc.offset >= activeOffset_) {
+      out.assign(buffer_, loc.offset - activeOffset_, loc.size);
+      return true;
+    }
+    for (const Job &job : queue_) {
+      if (job.segment.get() == &segment && loc.offset >= job.offset &&
+          loc.offset + loc.size <= job.offset + job.data.size()) {
+        out.assign(job.data, loc.offset - job.offset, loc.size);
+        return true;
+      }
+    }
+    return false; // 刚写完：durable 已更新，按盘上的读
+  }
+
+  static bool decode(const std::string &bytes, const Key &key, Value &value) {
+    if (bytes.size() < sizeof(std::uint64_t))
+      return false;
+    SnapshotReader in(bytes.data(), bytes.size());
+    std::uint64_t checksum = 0;
+    in.u64(checksum);
+    if (checksum != snapshotChecksum(bytes.data() + sizeof(std::uint64_t),
+                                     bytes.size() - sizeof(std::uint64_t)))
+      return false;
+    Key stored{};
+    if (!in.value(stored) || !(stored == key))
+      return false;
+    return in.value(value);
+  }
+
+  // 以下方法要求调用方已持有 mutex_
+  Index findLocked(std::uint64_t fp) const {
+    return index_.find(fp, index_.hashOf(fp),
+                       [this](Index i) -> const std::uint64_t & {
+                         return entries_[i].fp;
+                       });
+  }
+
+  void eraseLocked(std::uint64_t fp) {
+    const Index i = findLocked(fp);
+    if (i == kNil)
+      return;
+    killLocked(entries_[i].loc);
+    index_.erase(index_.hashOf(fp), i);
+    entries_.destroy(i);
+  }
+
+  void killLocked(const Loc &loc) {
+    auto it = segments_.find(loc.segment);
+    if (it != segments_.end())
+      it->second->liveBytes -= loc.size;
+  }
+
+  void submitLocked() {
+    if (buffer_.empty())
+      return;
+    queuedBytes_ += buffer_.size();
+    const std::size_t size = buffer_.size();
+    queue_.push_back(Job{segments_.at(activeId_), activeOffset_,
+                         std::move(buffer_)});
+    buffer_.clear();
+    activeOffset_ += size;
+    queueCv_.notify_one();
+  }
+
+  // 当前段写满：提交剩下的批次，段数到上限时先回收一个旧段，再开新段
+  // 开新段失败时返回 false，之后不再接受写入
+  bool sealActiveLocked() {
+    submitLocked();
+    if (segments_.size() >= options_.maxSegments)
+      reclaimLocked();
+    if (!openSegment())
+      ok_ = false;
+    return ok_;
+  }
+
+  void reclaimLocked() {
+    auto victim = segments_.end();
+    for (auto it = segments_.begin(); it != segments_.end(); ++it) {
+      if (it->first == activeId_)
+        continue;
+      if (victim == segments_.end())
+        victim = it;
+      else if (options_.gc == FlashGc::Fifo ? it->first < victim->first
+                                            : it->second->liveBytes <
+                                                  victim->second->liveBytes)
+        victim = it;
+    }
+    if (victim == segments_.end())
+      return;
+
+    const std::uint32_t id = victim->first;
+    for (const std::uint64_t fp : victim->second->fingerprints) {
+      const Index i = findLocked(fp);
+      if (i != kNil && entries_[i].loc.segment == id) {
+        index_.erase(index_.hashOf(fp), i);
+        entries_.destroy(i);
+        ++stats_.gcEvictions;
+      }
+    }
+    ::unlink(victim->second->path.c_str());
+    segments_.erase(victim);
+    ++stats_.segmentsReclaimed;
+  }
+
+  // 构造时和持锁时调用
+  bool openSegment() {
+    const std::uint32_t id = nextId_++;
+    auto segment = std::make_shared<Segment>();
+    segment->path =
+        options_.directory + "/segment-" + std::to_string(id) + ".log";
+    segment->fd =
+        ::open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (segment->fd < 0)
+      return false;
+    segments_.emplace(id, std::move(segment));
+    activeId_ = id;
+    activeOffset_ = 0;
+    return true;
+  }
+
+  // I/O 线程：按提交顺序写盘。写的时候不持锁，Job 在写完之前留在队列里供读者拷贝
+  void writeLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      queueCv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (stop_)
+        break;
+      Job &job = queue_.front(); // 只有本线程出队，deque 尾部追加不影响这个引用
+      lock.unlock();
+      std::size_t written = 0;
+      while (written < job.data.size()) {
+        const ssize_t n =
+            ::pwrite(job.segment->fd, job.data.data() + written,
+                     job.data.size() - written,
+                     static_cast<off_t>(job.offset + written));
+        if (n <= 0)
+          break; // 写失败：这批记录读出来校验不过，按未命中处理
+        written += static_cast<std::size_t>(n);
+      }
+      lock.lock();
+      job.segment->durable = job.offset + job.data.size();
+      stats_.bytesWritten += written;
+      queuedBytes_ -= job.data.size();
+      queue_.pop_front();
+      if (queue_.empty())
+        idleCv_.notify_all();
+    }
+
+    // 退出时删掉所有段文件
+    for (auto &[id, segment] : segments_) {
+      ::unlink(segment->path.c_str());
+    }
+  }
+
+  FlashOptions options_;
+  std::atomic<bool> ok_{false}; // 开新段失败后置为 false
+
+  mutable std::mutex mutex_;
+  NodeSlab<Entry> entries_;        // 索引条目
+  FlatIndex<std::uint64_t> index_; // key 指纹 -> 条目下标
+  std::unordered_map<std::uint32_t, std::shared_ptr<Segment>> segments_;
+  std::uint32_t nextId_ = 0;
+  std::uint32_t activeId_ = 0;     // 正在追加的段
+  std::size_t activeOffset_ = 0;   // 当前批次在活动段里的起始偏移
+  std::string buffer_;             // 当前批次
+  SnapshotWriter scratch_;         // 编码单条记录
+  std::deque<Job> queue_;          // 等待写盘的批次
+  std::size_t queuedBytes_ = 0;
+  FlashStats stats_;
+  bool stop_ = false;
+  std::condition_variable queueCv_; // 有新批次或要退出
+  std::condition_variable idleCv_;  // 队列写空
+  std::thread writer_;
+};
@@ -0,0 +1,344 @@
+#pragma once
+
+#include "HashUtil.h"
+#include "NumaTopology.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CPP_CACHE_FLAT_INDEX_SSE2 1
+#endif
+
+// Swiss table 风格的开放寻址索引：只保存 32 位结点下标，key 留在结点里。
+// - 每个槽位一个控制字节(空 / 已删除 / 哈希高 7 位)，16 个槽位一组，
+//   一次 SSE2 比较筛出整组里高 7 位相同的候选，绝大多数查找只比较一次 key。
+//   分片包装(ShardSet、NumaCache)用同一个哈希的低位选分片，同一分片里
+//   低位都相同，所以标签取高位
+// - 槽位按组对齐，组间用三角数探测，能遍历所有组；负载因子上限 7/8
+// - 每个条目约 5~11 字节(控制字节 + 下标)，没有逐条目的堆分配
+// 哈希值由调用方算好传入(见 hashOf)，比较 key / 扩容重算哈希通过回调向结点取 key，
+// 所以索引本身不知道结点放在哪里。本身不加锁，由使用它的缓存负责同步。
+template <typename Key, typename Hash = TransparentHash<Key>,
+          typename Equal = TransparentEqual>
+class FlatIndex {
+public:
+  using Index = std::uint32_t;
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
+
+  explicit FlatIndex(std::size_t expected = 0) {
+    if (expected > 0)
+      rehash(groupsFor(expected));
+  }
+
+  FlatIndex(FlatIndex &&other) noexcept { swap(other); }
+  FlatIndex &operator=(FlatIndex &&other) noexcept {
+    FlatIndex(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  void swap(FlatIndex &other) noexcept {
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(slots_, other.slots_);
+    std::swap(groupCount_, other.groupCount_);
+    std::swap(groupMask_, other.groupMask_);
+    std::swap(size_, other.size_);
+    std::swap(growthLeft_, other.growthLeft_);
+    std::swap(homeNode_, other.homeNode_);
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::size_t slotCount() const { return groupCount_ * kGroupWidth; }
+
+  // 索引自身占用的字节数(不含结点)
+  std::size_t memoryBytes() const {
+    return slotCount() * (sizeof(std::int8_t) + sizeof(Index));
+  }
+
+  // 把槽位数组(现在的和以后扩容出来的)放到 NUMA 节点 node 上(node < 0 取消)，
+  // 返回现有数组是否绑定成功；表很小不足一页时返回 false
+  bool setHomeNode(int node) {
+    homeNode_ = node;
+    return node >= 0 && groupCount_ > 0 && bindTables();
+  }
+  int homeNode() const { return homeNode_; }
+
+  // 与 find / insert 配合使用的哈希值；K 可以是异构查找的类型
+  template <typename K> std::uint64_t hashOf(const K &key) const {
+    return mixHash(static_cast<std::uint64_t>(hash_(key)));
+  }
+
+  // 查找 key 对应的结点下标，找不到返回 kNil。keyAt(i) 返回下标 i 的结点的 key
+  template <typename K, typename KeyAt>
+  Index find(const K &key, std::uint64_t hash, KeyAt &&keyAt) const {
+    if (groupCount_ == 0)
+      return kNil;
+    Probe probe(h1(hash), groupMask_);
+    const std::int8_t tag = h2(hash);
+    while (true) {
+      const Group group(ctrl_.get() + probe.offset());
+      for (std::uint32_t bits = group.match(tag); bits != 0; bits &= bits - 1) {
+        const std::size_t slot =
+            probe.offset() + static_cast<unsigned>(std::countr_zero(bits));
+        if (equal_(keyAt(slots_[slot]), key))
+          return slots_[slot];
+      }
+      if (group.matchEmpty() != 0)
+        return kNil;
+      probe.next();
+    }
+  }
+
+  // 预取 key 所在的第一组控制字节和槽位
+  void prefetch(std::uint64_t hash) const {
+    if (groupCount_ == 0)
+      return;
+    const std::size_t offset = (h1(hash) & groupMask_) * kGroupWidth;
+    prefetchRead(ctrl_.get() + offset);
+    prefetchRead(slots_.get() + offset);
+  }
+
+  // 登记下标 index(调用方保证 key 不在索引中)。
+  // 需要扩容时用 hashAt(i) 重新计算已有下标的哈希
+  template <typename HashAt>
+  void insert(std::uint64_t hash, Index index, HashAt &&hashAt) {
+    if (growthLeft_ == 0)
+      grow(hashAt);
+    const std::size_t slot = findInsertSlot(hash);
+    if (ctrl_[slot] == kEmpty)
+      --growthLeft_;
+    setCtrl(slot, h2(hash));
+    slots_[slot] = index;
+    ++size_;
+  }
+
+  // 预留至少能放 expected 个下标的空间，之后插入到这个数目都不会再扩容(批量导入用)
+  template <typename HashAt> void reserve(std::size_t expected, HashAt &&hashAt) {
+    const std::size_t groups = groupsFor(expected);
+    if (groups > groupCount_)
+      rebuild(groups, hashAt);
+  }
+
+  // 注销下标 index：只比对控制字节和下标，不需要比较 key
+  void erase(std::uint64_t hash, Index index) {
+    const std::size_t slot = slotOf(hash, index);
+    if (slot == kNoSlot)
+      return;
+    --size_;
+    // 所在组里还有空槽位时，任何探测到这一组都会在这里停下，直接置空即可；
+    // 否则置为已删除，保持探测链不断
+    const std::size_t groupStart = slot & ~(kGroupWidth - 1);
+    if (Group(ctrl_.get() + groupStart).matchEmpty() != 0) {
+      setCtrl(slot, kEmpty);
+      ++growthLeft_;
+    } else {
+      setCtrl(slot, kDeleted);
+    }
+  }
+
+  // 结点搬到新下标时更新索引(例如稠密数组删除时把末尾元素挪进空位)
+  void replace(std::uint64_t hash, Index from, Index to) {
+    const std::size_t slot = slotOf(hash, from);
+    if (slot != kNoSlot)
+      slots_[slot] = to;
+  }
+
+  void clear() {
+    if (groupCount_ == 0)
+      return;
+    std::memset(ctrl_.get(), static_cast<unsigned char>(kEmpty), slotCount());
+    size_ = 0;
+    growthLeft_ = capacityFor(groupCount_);
+  }
+
+  // 遍历所有下标(顺序不确定)
+  template <typename Fn> void forEach(Fn &&fn) const {
+    for (std::size_t slot = 0; slot < slotCount(); ++slot) {
+      if (ctrl_[slot] >= 0)
+        fn(slots_[slot]);
+    }
+  }
+
+private:
+  static constexpr std::size_t kGroupWidth = 16;
+  static constexpr std::size_t kNoSlot = std::numeric_limits<std::size_t>::max();
+  static constexpr std::int8_t kEmpty = -128;  // 0b10000000
+  static constexpr std::int8_t kDeleted = -2;  // 0b11111110
+
+  // 一组 16 个控制字节；匹配结果是低 16 位的位图，第 i 位对应组内第 i 个槽位
+  struct Group {
+#ifdef CPP_CACHE_FLAT_INDEX_SSE2
+    explicit Group(const std::int8_t *ctrl)
+        : ctrl(_mm_load_si128(reinterpret_cast<const __m128i *>(ctrl))) {}
+
+    std::uint32_t match(std::int8_t tag) const {
+      return static_cast<std::uint32_t>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl)));
+    }
+    std::uint32_t matchEmpty() const { return match(kEmpty); }
+    // 空或已删除：两者的最高位都是 1 且不是 -1
+    std::uint32_t matchFree() const {
+      return static_cast<std::uint32_t>(
+          _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl)));
+    }
+
+    __m128i ctrl;
+#else
+    explicit Group(const std::int8_t *ctrl) : ctrl(ctrl) {}
+
+    std::uint32_t match(std::int8_t tag) const {
+      std::uint32_t bits = 0;
+      for (std::size_t i = 0; i < kGroupWidth; ++i) {
+        bits |= static_cast<std::uint32_t>(ctrl[i] == tag) << i;
+      }
+      return bits;
+    }
+    std::uint32_t matchEmpty() const { return match(kEmpty); }
+    std::uint32_t matchFree() const {
+      std::uint32_t bits = 0;
+      for (std::size_t i = 0; i < kGroupWidth; ++i) {
+        bits |= static_cast<std::uint32_t>(ctrl[i] < -1) << i;
+      }
+      return bits;
+    }
+
+    const std::int8_t *ctrl;
+#endif
+  };
+
+  // 三角数探测：第 i 次跳过 i 组，组数为 2 的幂时能遍历所有组
+  class Probe {
+  public:
+    Probe(std::size_t h1, std::size_t mask) : mask_(mask), group_(h1 & mask) {}
+    std::size_t offset() const { return group_ * kGroupWidth; }
+    void next() {
+      ++stride_;
+      group_ = (group_ + stride_) & mask_;
+    }
+
+  private:
+    std::size_t mask_;
+    std::size_t group_;
+    std::size_t stride_ = 0;
+  };
+
+  static std::size_t h1(std::uint64_t hash) {
+    return static_cast<std::size_t>(hash >> 7);
+  }
+  static std::int8_t h2(std::uint64_t hash) {
+    return static_cast<std::int8_t>(hash >> 57);
+  }
+
+  // 一组最多装 14 个(7/8)，组数取 2 的幂
+  static std::size_t capacityFor(std::size_t groups) {
+    return groups * kGroupWidth / 8 * 7;
+  }
+  static std::size_t groupsFor(std::size_t expected) {
+    return roundUpPow2((expected * 8 / 7 + kGroupWidth) / kGroupWidth);
+  }
+
+  std::size_t slotOf(std::uint64_t hash, Index index) const {
+    if (groupCount_ == 0)
+      return kNoSlot;
+    Probe probe(h1(hash), groupMask_);
+    const std::int8_t tag = h2(hash);
+    while (true) {
+      const Group group(ctrl_.get() + probe.offset());
+      for (std::uint32_t bits = group.match(tag); bits != 0; bits &= bits - 1) {
+        const std::size_t slot =
+            probe.offset() + static_cast<unsigned>(std::countr_zero(bits));
+        if (slots_[slot] == index)
+          return slot;
+      }
+      if (group.matchEmpty() != 0)
+        return kNoSlot;
+      probe.next();
+    }
+  }
+
+  // 第一个空或已删除的槽位
+  std::size_t findInsertSlot(std::uint64_t hash) const {
+    Probe probe(h1(hash), groupMask_);
+    while (true) {
+      const std::uint32_t bits = Group(ctrl_.get() + probe.offset()).matchFree();
+      if (bits != 0)
+        return probe.offset() + static_cast<unsigned>(std::countr_zero(bits));
+      probe.next();
+    }
+  }
+
+  void setCtrl(std::size_t slot, std::int8_t value) { ctrl_[slot] = value; }
+
+  // 已删除的槽位占了一半以上的余量时原地重建即可，否则容量翻倍
+  template <typename HashAt> void grow(HashAt &hashAt) {
+    const std::size_t groups =
+        groupCount_ == 0 ? 1
+        : size_ * 2 <= capacityFor(groupCount_) ? groupCount_
+                                                : groupCount_ * 2;
+    rebuild(groups, hashAt);
+  }
+
+  // 换成 groups 组的新表，把原有下标重新插入
+  template <typename HashAt> void rebuild(std::size_t groups, HashAt &hashAt) {
+    std::unique_ptr<std::int8_t[], AlignedDelete> oldCtrl = std::move(ctrl_);
+    std::unique_ptr<Index[]> oldSlots = std::move(slots_);
+    const std::size_t oldCount = slotCount();
+    rehash(groups);
+    for (std::size_t slot = 0; slot < oldCount; ++slot) {
+      if (oldCtrl[slot] < 0)
+        continue;
+      const std::uint64_t hash = hashAt(oldSlots[slot]);
+      const std::size_t to = findInsertSlot(hash);
+      setCtrl(to, h2(hash));
+      slots_[to] = oldSlots[slot];
+      --growthLeft_;
+      ++size_;
+    }
+  }
+
+  // 分配 groups 组空槽位(原有内容由调用方负责搬迁)
+  void rehash(std::size_t groups) {
+    groupCount_ = groups;
+    groupMask_ = groups - 1;
+    ctrl_.reset(static_cast<std::int8_t *>(::operator new[](
+        slotCount(), std::align_val_t{kGroupWidth})));
+    std::memset(ctrl_.get(), static_cast<unsigned char>(kEmpty), slotCount());
+    slots_ = std::make_unique_for_overwrite<Index[]>(slotCount());
+    size_ = 0;
+    growthLeft_ = capacityFor(groups);
+    if (homeNode_ >= 0)
+      bindTables();
+  }
+
+  bool bindTables() {
+    const bool ctrl = bindMemoryToNode(ctrl_.get(), slotCount(), homeNode_);
+    const bool slots =
+        bindMemoryToNode(slots_.get(), slotCount() * sizeof(Index), homeNode_);
+    return ctrl && slots;
+  }
+
+  // 控制字节按 16 字节对齐，SSE2 可以直接对齐加载
+  struct AlignedDelete {
+    void operator()(std::int8_t *p) const {
+      ::operator delete[](p, std::align_val_t{kGroupWidth});
+    }
+  };
+
+  std::unique_ptr<std::int8_t[], AlignedDelete> ctrl_;
+  std::unique_ptr<Index[]> slots_;
+  std::size_t groupCount_ = 0;
+  std::size_t groupMask_ = 0;
+  std::size_t size_ = 0;
+  std::size_t growthLeft_ = 0; // 还能占用的空槽位数
+  int homeNode_ = -1;          // 槽位数组所在的 NUMA 节点，-1 为不指定
+  [[no_unique_address]] Hash hash_;
+  [[no_unique_address]] Equal equal_;
+};
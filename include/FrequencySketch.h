@@ -0,0 +1,93 @@
+#pragma once
+
+#include "HashUtil.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// 4 位计数的 Count-Min Sketch，用来估计 key 最近的访问频率(W-TinyLFU 的准入依据)。
+// - 每个 u64 字装 16 个 4 位计数器，分成 4 组，第 i 个哈希函数只落在第 i 组里
+// - 表大小取不小于容量的 2 的幂(个字)，即每个缓存条目约 8 字节
+// - 累计增加次数达到 10 倍容量时把所有计数减半，让旧的热度逐渐衰减
+// 本身不加锁，由使用它的缓存负责同步。
+template <typename Key, typename Hash = std::hash<Key>> class FrequencySketch {
+public:
+  static constexpr std::uint32_t kMaxCount = 15;
+
+  explicit FrequencySketch(std::size_t capacity)
+      : table_(roundUpPow2(capacity > 0 ? capacity : 1)),
+        mask_(table_.size() - 1),
+        sampleSize_(10 * (capacity > 0 ? capacity : 1)) {}
+
+  // 估计频率：4 个计数器中的最小值
+  std::uint32_t frequency(const Key &key) const {
+    const std::uint64_t h = mixHash(static_cast<std::uint64_t>(hash_(key)));
+    std::uint32_t freq = kMaxCount;
+    for (unsigned i = 0; i < kDepth; ++i) {
+      const std::uint32_t count =
+          static_cast<std::uint32_t>(table_[indexOf(h, i)] >> offsetOf(h, i)) &
+          0xF;
+      if (count < freq)
+        freq = count;
+    }
+    return freq;
+  }
+
+  // 记一次访问；4 个计数器都已饱和时不计入采样次数
+  void increment(const Key &key) {
+    const std::uint64_t h = mixHash(static_cast<std::uint64_t>(hash_(key)));
+    bool added = false;
+    for (unsigned i = 0; i < kDepth; ++i) {
+      added |= incrementAt(indexOf(h, i), offsetOf(h, i));
+    }
+    if (added && ++size_ >= sampleSize_)
+      reset();
+  }
+
+  // 所有计数减半(衰减)
+  void reset() {
+    std::size_t odd = 0;
+    for (std::uint64_t &word : table_) {
+      odd += static_cast<std::size_t>(std::popcount(word & kOneMask));
+      word = (word >> 1) & kResetMask;
+    }
+    // 奇数计数减半时各丢掉 0.5，每个 key 占 4 个计数器
+    size_ = (size_ - (odd >> 2)) >> 1;
+  }
+
+  std::size_t sampleSize() const { return sampleSize_; }
+  std::size_t tableBytes() const { return table_.size() * sizeof(std::uint64_t); }
+
+private:
+  static constexpr unsigned kDepth = 4;
+  static constexpr std::uint64_t kOneMask = 0x1111111111111111ULL;
+  static constexpr std::uint64_t kResetMask = 0x7777777777777777ULL;
+
+  // 双重哈希：低 32 位作起点，高 32 位(置为奇数)作步长
+  std::size_t indexOf(std::uint64_t h, unsigned i) const {
+    const std::uint64_t step = (h >> 32) | 1;
+    return static_cast<std::size_t>((h + i * step) & mask_);
+  }
+
+  // 第 i 组的 4 个计数器里选一个，返回其在字内的位偏移
+  static unsigned offsetOf(std::uint64_t h, unsigned i) {
+    const unsigned slot = static_cast<unsigned>(h >> (56 + 2 * i)) & 3;
+    return (i * 4 + slot) * 4;
+  }
+
+  bool incrementAt(std::size_t index, unsigned offset) {
+    const std::uint64_t mask = 0xFULL << offset;
+    if ((table_[index] & mask) == mask)
+      return false;
+    table_[index] += 1ULL << offset;
+    return true;
+  }
+
+  std::vector<std::uint64_t> table_;
+  std::size_t mask_;
+  std::size_t sampleSize_;
+  std::size_t size_ = 0; // 自上次衰减以来的增加次数
+  Hash hash_;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// 一般按 64 字节缓存行对齐，用于隔开不同线程频繁写的数据
+inline constexpr std::size_t kCacheLineSize = 64;
+
+// 64 位哈希终结器(MurmurHash3 fmix64)。
+// std::hash 对整数是恒等映射，顺序 key 的低位分布很差，取掩码前先打散
+inline std::uint64_t mixHash(std::uint64_t h) noexcept {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// 向上取整到 2 的幂(n 为 0 时返回 1)
+inline std::size_t roundUpPow2(std::size_t n) noexcept {
+  std::size_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+// 预取只读数据到缓存(不支持的编译器上退化为空操作)
+inline void prefetchRead(const void *p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(p, 0, 3);
+#else
+  (void)p;
+#endif
+}
+
+// 支持异构查找(C++20 is_transparent)的哈希：std::string 的 key 可以直接用
+// std::string_view / const char* 查找，不必先构造临时 std::string。
+// 其余类型沿用 std::hash，结果与 std::hash<Key> 一致
+template <typename Key> struct TransparentHash : std::hash<Key> {
+  using is_transparent = void;
+};
+
+template <> struct TransparentHash<std::string> {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view s) const noexcept {
+    return std::hash<std::string_view>{}(s);
+  }
+};
+
+using TransparentEqual = std::equal_to<>;
+
+// K 不是 Key，但可以不构造 Key 直接在 Key 的索引里查找
+template <typename K, typename Key>
+concept HeterogeneousKey =
+    !std::same_as<std::remove_cvref_t<K>, Key> &&
+    requires(const TransparentHash<Key> &hash, const K &k, const Key &key) {
+      { hash(k) } -> std::convertible_to<std::size_t>;
+      { key == k } -> std::convertible_to<bool>;
+    };
+
+// 用 args 更新已有的 value：单个可赋值参数直接赋值(std::string 可复用缓冲区)，
+// 否则先构造一个新值再移动过去
+template <typename Value, typename Arg>
+  requires std::is_assignable_v<Value &, Arg>
+void assignValue(Value &value, Arg &&arg) {
+  value = std::forward<Arg>(arg);
+}
+
+template <typename Value, typename... Args>
+void assignValue(Value &value, Args &&...args) {
+  value = Value(std::forward<Args>(args)...);
+}
@@ -1,5 +1,31 @@
 #pragma once
 
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <string_view>
+
+// 容量淘汰回调：结点释放前在缓存的锁内调用(TTL 过期和 remove 不算淘汰)。
+// 回调里不能再访问同一个缓存；分片缓存的各分片会并发调用它
+template <typename Key, typename Value>
+using EvictionListener = std::function<void(const Key &, const Value &)>;
+
+// bulkLoad 的输入：可随机访问的 (key, value) 序列，
+// 例如 std::vector<std::pair<Key, Value>>；分片缓存按下标把它分给各分片
+template <typename R, typename Key, typename Value>
+concept BulkLoadRange =
+    std::ranges::random_access_range<R> &&
+    requires(std::ranges::range_reference_t<R> item) {
+      { item.first } -> std::convertible_to<const Key &>;
+      { item.second } -> std::convertible_to<const Value &>;
+    };
+
+// 可以按前缀批量失效的 key(std::string 等能看作 std::string_view 的类型)
+template <typename Key>
+concept PrefixKey = std::convertible_to<const Key &, std::string_view>;
+
 template <typename Key, typename Value> class ICachePolicy {
 public:
   virtual ~ICachePolicy() = default;
@@ -11,4 +37,24 @@ public:
   virtual bool get(const Key &key, Value &value) = 0;
   // 如果缓存中能找到key，则直接返回value
   virtual Value get(const Key &key) = 0;
+
+  // 批量查询：values[i]、found[i] 对应 keys[i] | 返回命中个数
+  // 默认逐个调用 get，具体策略可以重写为只加一次锁
+  virtual std::size_t getMany(std::span<const Key> keys,
+                              std::span<Value> values, std::span<bool> found) {
+    std::size_t hits = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      found[i] = get(keys[i], values[i]);
+      hits += found[i] ? 1 : 0;
+    }
+    return hits;
+  }
+
+  // 批量写入：keys[i] 对应 values[i]
+  virtual void putMany(std::span<const Key> keys,
+                       std::span<const Value> values) {
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      put(keys[i], values[i]);
+    }
+  }
 };
@@ -1,84 +1,80 @@
 #pragma once
 
+#include "CacheStats.h"
+#include "FlatIndex.h"
+#include "HashUtil.h"
 #include "ICachePolicy.h"
+#include "NodeSlab.h"
+#include "ReadBuffer.h"
+#include "ShardSet.h"
+#include "SingleFlight.h"
+#include "Snapshot.h"
+#include "TimingWheel.h"
+#include "Weigher.h"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <ranges>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
-template <typename Key, typename Value> class LfuCache;
-
-template <typename Key, typename Value> class FreqList {
-private:
-  struct Node {
-    int freq; // 访问频次
-    Key key;
-    Value value;
-    std::weak_ptr<Node> pre; // 上一结点改为weak_ptr打破循环引用
-    std::shared_ptr<Node> next;
-
-    Node() : freq(1), next(nullptr) {}
-    Node(Key key, Value value)
-        : freq(1), key(key), value(value), next(nullptr) {}
-  };
-
-  using NodePtr = std::shared_ptr<Node>;
-  int freq_;     // 访问频率
-  NodePtr head_; // 假头结点
-  NodePtr tail_; // 假尾结点
+// Stats 为统计策略(见 CacheStats.h)，默认的 NullStats 不产生任何开销。
+// Weigher 决定每个条目占多少容量(见 Weigher.h)，默认每个条目 1 个单位
+template <typename Key, typename Value, typename Stats = NullStats,
+          WeigherFor<Key, Value> Weigher = UnitWeigher>
+class LfuCache;
 
+// 同一访问频次的结点链表。结点存放在 LfuCache 的 NodeSlab 中，
+// 这里只记录首尾下标，链接由 LfuCache 维护
+class FreqList {
 public:
-  explicit FreqList(int n) : freq_(n) {
-    head_ = std::make_shared<Node>();
-    tail_ = std::make_shared<Node>();
-    head_->next = tail_;
-    tail_->pre = head_;
-  }
-
-  bool isEmpty() const { return head_->next == tail_; }
+  using Freq = std::int64_t;
+  using Index = std::uint32_t;
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
 
-  // 提那家结点管理方法
-  void addNode(NodePtr node) {
-    if (!node || !head_ || !tail_)
-      return;
+  explicit FreqList(Freq n) : freq_(n) {}
 
-    node->pre = tail_->pre;
-    node->next = tail_;
-    tail_->pre.lock()->next = node; // 使用lock()获取shared_ptr
-    tail_->pre = node;
-  }
-
-  void removeNode(NodePtr node) {
-    if (!node || !head_ || !tail_)
-      return;
-    if (node->pre.expired() || !node->next)
-      return;
+  bool isEmpty() const { return head_ == kNil; }
+  Index getFirstNode() const { return head_; }
 
-    auto pre = node->pre.lock(); // 使用lock()获取shared_ptr
-    pre->next = node->next;
-    node->next->pre = pre;
-    node->next = nullptr; // 确保显式置空next指针，彻底断开节点与链表的连接
-  }
-
-  NodePtr getFirstNode() const { return head_->next; }
+private:
+  Freq freq_;          // 访问频率
+  Index head_ = kNil;  // 最早进入的结点
+  Index tail_ = kNil;  // 最近进入的结点
+  // 所有非空链表按频次升序串成双向链表(由 LfuCache 维护)
+  FreqList *prev_ = nullptr;
+  FreqList *next_ = nullptr;
 
-  friend class LfuCache<Key, Value>;
+  template <typename K, typename V, typename S, WeigherFor<K, V> W>
+  friend class LfuCache;
 };
 
-template <typename Key, typename Value>
+// 结点按块存放在 NodeSlab 中、用 32 位下标链接，索引为 FlatIndex：
+// 每个条目没有单独的堆分配，也没有 shared_ptr 的控制块
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
 class LfuCache : public ICachePolicy<Key, Value> {
 public:
-  using Node = typename FreqList<Key, Value>::Node;
-  using NodePtr = std::shared_ptr<Node>;
-  using NodeMap = std::unordered_map<Key, NodePtr>;
+  using List = FreqList;
+  using Freq = FreqList::Freq;
 
-  LfuCache(int capacity, int maxAverageNum = 1000000)
-      : capacity_(capacity), minFreq_(std::numeric_limits<int>::max()),
-        maxAverageNum_(maxAverageNum), curAverageNum_(0), curTotalNum_(0) {}
+  // capacity 以 Weigher 的单位计：默认为条目数，SizeofWeigher 时为字节数
+  LfuCache(std::int64_t capacity, int maxAverageNum = 1000000,
+           Weigher weigher = Weigher())
+      : capacity_(capacity > 0 ? static_cast<std::size_t>(capacity) : 0),
+        weigher_(std::move(weigher)), maxAverageNum_(maxAverageNum),
+        curAverageNum_(0), curTotalNum_(0) {}
 
   ~LfuCache() override = default;
 
@@ -86,32 +82,55 @@ public:
     if (capacity_ == 0)
       return;
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = nodeMap_.find(key);
-    if (it != nodeMap_.end()) {
-      // 重置其value值
-      it->second->value = value;
-      // 找到了直接调整就好了，不用再去get中再找一遍，但其实影响不大
-      Value tmp = value;
-      getInternal(it->second, tmp);
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    putLocked(key, value);
+  }
 
+  // 右值版本：key/value 直接移动进结点
+  void put(Key &&key, Value &&value) {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    putLocked(std::move(key), std::move(value));
+  }
+
+  // 带过期时间的写入：ttl 之后该条目视为不存在，并优先于未过期的条目让出容量。
+  // 不带 ttl 的 put 会清除已有的过期时间
+  void put(const Key &key, const Value &value, TtlClock::duration ttl) {
+    if (capacity_ == 0)
       return;
-    }
 
-    putInternal(key, value);
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    putLocked(key, value);
+    scheduleLocked(key, ttl);
+  }
+
+  // 用 args 原地构造 value；key 已存在时同样覆盖并增加访问频次
+  template <typename K, typename... Args>
+    requires std::constructible_from<Key, K>
+  void emplace(K &&key, Args &&...args) {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    putLocked(std::forward<K>(key), std::forward<Args>(args)...);
   }
 
   // value值为传出参数
   bool get(const Key &key, Value &value) override {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = nodeMap_.find(key);
-    if (it != nodeMap_.end()) {
-      Value tmp = value;
-      getInternal(it->second, tmp);
-      return true;
-    }
+    if (readBuffer_)
+      return getBuffered(key, value);
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    return getLocked(key, value);
+  }
 
-    return false;
+  // 异构查找：例如 Key 为 std::string 时用 std::string_view 查找，不构造临时 key
+  template <HeterogeneousKey<Key> K> bool get(const K &key, Value &value) {
+    if (readBuffer_)
+      return getBuffered(key, value);
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    return getLocked(key, value);
   }
 
   Value get(const Key &key) override {
@@ -120,237 +139,973 @@ public:
     return value;
   }
 
-  // 清空缓存,回收资源
-  void purge() {
-    nodeMap_.clear();
+  // 命中时同时取出剩余 ttl(没有 ttl 时为 0)，getOrLoad 据此决定是否提前刷新
+  bool get(const Key &key, Value &value, TtlClock::duration &ttl) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    if (!getLocked(key, value))
+      return false;
+    const Index timer = nodes_[findLocked(key)].timer;
+    ttl = timer != ExpiryTimers::kNone ? timers_.remaining(timer)
+                                       : TtlClock::duration::zero();
+    return true;
+  }
+
+  // 读穿加载(见 SingleFlight.h)：未命中时调用 loader(key, value) 取值并写回缓存，
+  // 同一个 key 同时只有一次 loader 在执行，其余调用者等待它的结果
+  template <typename Loader>
+  bool getOrLoad(const Key &key, Value &value, Loader &&loader,
+                 const LoadOptions &options = {}) {
+    return loadThrough(*this, loads_, key, value, loader, options);
+  }
+
+  template <typename Loader>
+  Value getOrLoad(const Key &key, Loader &&loader,
+                  const LoadOptions &options = {}) {
+    Value value{};
+    getOrLoad(key, value, loader, options);
+    return value;
+  }
+
+  // 异步版本：命中时返回已就绪的 future，未命中时在后台线程里加载
+  template <typename Loader>
+  typename SingleFlight<Key, Value>::Future
+  getOrLoadAsync(const Key &key, Loader loader,
+                 const LoadOptions &options = {}) {
+    return loadThroughAsync(*this, loads_, key, std::move(loader), options);
+  }
+
+  // 等待已发起的后台加载(异步 getOrLoad、refresh-ahead)全部完成
+  void drainLoads() { loads_.drain(); }
+
+  // 零拷贝读取：命中时在锁内以 const Value& 调用 fn，返回是否命中。
+  // fn 执行期间持有缓存锁，不要在 fn 里再访问同一个缓存
+  template <typename K, typename Fn> bool withValue(const K &key, Fn &&fn) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    expireLocked();
+    const Index i = findLocked(key);
+    stats_.record(i != kNil ? CacheCounter::Hit : CacheCounter::Miss);
+    if (i == kNil)
+      return false;
+
+    getInternal(i);
+    std::forward<Fn>(fn)(static_cast<const Value &>(nodes_[i].value));
+    return true;
+  }
+
+  // 删除指定元素(不计为淘汰)
+  void remove(const Key &key) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    const Index i = findLocked(key);
+    if (i != kNil)
+      removeLocked(i);
+  }
+
+  // 包含已过期但还没被回收的条目
+  std::size_t size() const {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    return nodes_.size();
+  }
+
+  // 当前所有条目的权重之和(不超过 capacity())
+  std::size_t weight() const {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    return totalWeight_;
+  }
+
+  std::size_t capacity() const { return capacity_; }
+
+  // 结点存储与索引实际占用的字节数(不含 key/value 自己在堆上的部分)
+  std::size_t memoryBytes() const {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    return nodes_.memoryBytes() + index_.memoryBytes() +
+           timers_.memoryBytes();
+  }
+
+  // 回收所有已过期的条目(后台清理线程见 PeriodicReaper)；
+  // 不调用时，过期条目在下一次访问这个缓存时回收
+  void purgeExpired() {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    expireLocked();
+  }
+
+  // 统计快照(Stats 为 NullStats 时全为 0)
+  CacheStats stats() const { return stats_.snapshot(); }
+
+  // 读缓冲模式(见 ReadBuffer.h)：get 只拿共享锁查索引、拷贝 value，命中记进读缓冲，
+  // 由之后拿写锁的操作批量补上频次；多个读者之间不再互斥。
+  // 还没补上的少量访问暂不计入频次。要在并发使用缓存之前设置
+  void setBufferedRecency(bool enabled, int stripes = 0) {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    applyReadsLocked();
+    readBuffer_ = enabled ? std::make_unique<ReadBuffer>(stripes) : nullptr;
+  }
+
+  // 容量淘汰时回调 listener(key, value)，例如把条目写到下一级缓存(见 TieredCache.h)。
+  // 传空的 listener 取消
+  void setEvictionListener(EvictionListener<Key, Value> listener) {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    onEvict_ = std::move(listener);
+  }
+
+  // 快照(见 SnapshotFile.h)：按淘汰顺序的逆序(最不该淘汰的在前)写出
+  // key、value、有效频次和剩余 ttl(ns，0 表示没有)，已过期的条目不写
+  static constexpr SnapshotPolicy kSnapshotPolicy = SnapshotPolicy::Lfu;
+  std::size_t snapshotSections() const { return 1; }
+
+  void writeSnapshotSection(std::size_t, SnapshotWriter &out) const
+    requires SnapshotEncodable<Key> && SnapshotEncodable<Value>
+  {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    writeSnapshotTypes<Key, Value>(out);
+    const std::size_t countAt = out.size();
+    out.u64(0);
+    std::uint64_t count = 0;
+
+    const List *list = minList_;
+    while (list && list->next_)
+      list = list->next_;
+    for (; list; list = list->prev_) {
+      for (Index i = list->tail_; i != kNil; i = nodes_[i].pre) {
+        const Node &node = nodes_[i];
+        std::uint64_t ttl = 0;
+        if (node.timer != ExpiryTimers::kNone) {
+          ttl = static_cast<std::uint64_t>(
+              std::chrono::nanoseconds(timers_.remaining(node.timer)).count());
+          if (ttl == 0)
+            continue;
+        }
+        out.value(node.key);
+        out.value(node.value);
+        out.u64(static_cast<std::uint64_t>(effectiveFreq(node)));
+        out.u64(ttl);
+        ++count;
+      }
+    }
+    out.patch(countAt, count);
+  }
+
+  // 恢复到空缓存：一次加锁内按写出的顺序把结点依次放到淘汰端，
+  // 保留各自的频次；放不下时丢弃剩下(更该淘汰)的条目，不触发淘汰
+  bool restoreSnapshotSection(std::size_t, SnapshotReader &in)
+    requires SnapshotEncodable<Key> && SnapshotEncodable<Value>
+  {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    std::uint64_t count = 0;
+    if (nodes_.size() != 0 || !checkSnapshotTypes<Key, Value>(in) ||
+        !in.u64(count))
+      return false;
+
+    agingOffset_ = 0; // 恢复出的频次都是有效频次
+    index_ = FlatIndex<Key>(static_cast<std::size_t>(
+        std::min<std::uint64_t>(count, capacity_)));
+    for (std::uint64_t n = 0; n < count; ++n) {
+      Key key{};
+      Value value{};
+      std::uint64_t freq = 0, ttl = 0;
+      if (!in.value(key) || !in.value(value) || !in.u64(freq) ||
+          !in.u64(ttl))
+        return false;
+      if (!appendLeastLocked(std::move(key), std::move(value),
+                             static_cast<Freq>(freq), ttl))
+        break;
+    }
+    curAverageNum_ =
+        index_.empty() ? 0 : curTotalNum_ / static_cast<Freq>(index_.size());
+    return true;
+  }
+
+  // 批量查询：整批只加一次锁
+  std::size_t getMany(std::span<const Key> keys, std::span<Value> values,
+                      std::span<bool> found) override {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    std::size_t hits = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      found[i] = getLocked(keys[i], values[i]);
+      hits += found[i] ? 1 : 0;
+    }
+    return hits;
+  }
+
+  // 只处理 keys 中 positions 指定的那些下标(分片包装按分片分组后调用)
+  std::size_t getManyAt(std::span<const Key> keys,
+                        std::span<const std::uint32_t> positions,
+                        std::span<Value> values, std::span<bool> found) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    std::size_t hits = 0;
+    for (std::uint32_t i : positions) {
+      found[i] = getLocked(keys[i], values[i]);
+      hits += found[i] ? 1 : 0;
+    }
+    return hits;
+  }
+
+  void putMany(std::span<const Key> keys,
+               std::span<const Value> values) override {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      putLocked(keys[i], values[i]);
+    }
+  }
+
+  void putManyAt(std::span<const Key> keys, std::span<const Value> values,
+                 std::span<const std::uint32_t> positions) {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    for (std::uint32_t i : positions) {
+      putLocked(keys[i], values[i]);
+    }
+  }
+
+  // 清空缓存,回收资源：不计为淘汰，也不回调淘汰监听
+  void clear() {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    if (readBuffer_)
+      readBuffer_->drain([](Index) {});
+    timers_.clear();
+    index_.clear();
+    nodes_.clear();
     freqToFreqList_.clear();
-    minFreq_ = std::numeric_limits<int>::max();
+    minList_ = nullptr;
+    agedTail_ = nullptr;
+    agingOffset_ = 0;
     curAverageNum_ = 0;
     curTotalNum_ = 0;
+    totalWeight_ = 0;
+  }
+
+  // 同 clear()(旧名字)
+  void purge() { clear(); }
+
+  // 删除所有 pred(key, value) 为真的条目，返回删除的个数(一次加锁内遍历全部条目)
+  template <typename Pred> std::size_t removeIf(Pred &&pred) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    expireLocked();
+    // 先收集再删除：删除会回收空的频次链表，不能边遍历边删
+    std::vector<Index> matched;
+    index_.forEach([&](Index i) {
+      if (pred(std::as_const(nodes_[i].key), std::as_const(nodes_[i].value)))
+        matched.push_back(i);
+    });
+    for (Index i : matched) {
+      removeLocked(i);
+    }
+    return matched.size();
+  }
+
+  // 删除 key 以 prefix 开头的条目(见 LruCache::removePrefix)
+  std::size_t removePrefix(std::string_view prefix)
+    requires PrefixKey<Key>
+  {
+    return removeIf([prefix](const Key &key, const Value &) {
+      return std::string_view(key).starts_with(prefix);
+    });
+  }
+
+  // 批量导入：一次加锁，按条数预留好索引后依次写入，新条目从频次 1 开始
+  template <BulkLoadRange<Key, Value> R> void bulkLoad(const R &items) {
+    bulkLoadImpl(items, [](std::size_t j) { return j; },
+                 static_cast<std::size_t>(std::ranges::size(items)));
+  }
+
+  // 只导入 items 中 positions 指定的条目(分片包装按分片分组后调用)
+  template <BulkLoadRange<Key, Value> R>
+  void bulkLoadAt(const R &items, std::span<const std::uint32_t> positions) {
+    bulkLoadImpl(items, [positions](std::size_t j) { return positions[j]; },
+                 positions.size());
   }
 
 private:
-  void putInternal(Key key, Value value);       // 添加缓存
-  void getInternal(NodePtr node, Value &value); // 获取缓存
+  using Index = FreqList::Index;
+  static constexpr Index kNil = FreqList::kNil;
+
+  struct Node {
+    Freq freq = 1; // 访问频次(含全局衰减量，见 agingOffset_)
+    Key key;
+    Value value;
+    std::size_t weight = 0; // 写入时由 Weigher 算出
+    Index pre = kNil;       // 同一频次链表中更早进入的结点
+    Index next = kNil;
+    Index timer = ExpiryTimers::kNone; // 只有带 ttl 写入时才分配定时器
+
+    template <typename K, typename... Args>
+    explicit Node(K &&k, Args &&...args)
+        : key(std::forward<K>(k)), value(std::forward<Args>(args)...) {}
+  };
+
+  template <typename R, typename IndexOf>
+  void bulkLoadImpl(const R &items, IndexOf indexOf, std::size_t n) {
+    if (capacity_ == 0 || n == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    index_.reserve(std::min(nodes_.size() + n, capacity_), [this](Index j) {
+      return index_.hashOf(nodes_[j].key);
+    });
+    const auto first = std::ranges::begin(items);
+    for (std::size_t j = 0; j < n; ++j) {
+      const auto &item = first[static_cast<std::ptrdiff_t>(indexOf(j))];
+      putLocked(item.first, item.second);
+    }
+  }
+
+  // 需已持有 mutex_
+  template <typename K, typename... Args> void putLocked(K &&key, Args &&...args);
+  template <typename K> bool getLocked(const K &key, Value &value);
+
+  template <typename K> Index findLocked(const K &key) const {
+    return findLocked(key, index_.hashOf(key));
+  }
+  template <typename K> Index findLocked(const K &key, std::uint64_t hash) const {
+    return index_.find(key, hash,
+                       [this](Index i) -> const Key & { return nodes_[i].key; });
+  }
 
-  void kickOut(); // 移除缓存中的过期数据
+  template <typename K, typename... Args>
+  void putInternal(std::uint64_t hash, K &&key, Args &&...args); // 添加缓存
+  void getInternal(Index i); // 访问结点：频次 +1，不拷贝 value
+
+  void kickOut();               // 淘汰最不常访问的结点
+  void removeLocked(Index i);   // 从频次链表和索引中摘掉结点
+  void scheduleLocked(const Key &key, TtlClock::duration ttl);
+  void expireLocked();          // 补上读缓冲里的访问，再摘掉所有已到期的结点
+  void applyReadsLocked();      // 把读缓冲里的访问补到频次结构上
+  template <typename K> bool getBuffered(const K &key, Value &value);
+  bool expiredLocked(Index i) const {
+    const Index timer = nodes_[i].timer;
+    return timer != ExpiryTimers::kNone &&
+           timers_.remaining(timer) == TtlClock::duration::zero();
+  }
 
-  void removeFromFreqList(NodePtr node); // 从频率列表中移除节点
-  void addToFreqList(NodePtr node);      // 添加到频率列表
+  // 有效频次：被全局衰减量扣到 1 以下的按 1 计
+  Freq effectiveFreq(const Node &node) const {
+    return std::max<Freq>(1, node.freq - agingOffset_);
+  }
+  List *listOf(const Node &node) {
+    return freqToFreqList_.find(node.freq)->second.get();
+  }
+  List *insertListAfter(List *pos, Freq freq); // pos 为空表示插到最前面
+  void eraseList(List *list);
+  void addNode(List *list, Index i);    // 追加到链表尾部
+  void addNodeFront(List *list, Index i); // 插到链表头部(最先淘汰)
+  // 快照恢复用：放到淘汰端，容量不够时返回 false
+  bool appendLeastLocked(Key &&key, Value &&value, Freq freq,
+                         std::uint64_t ttlNs);
+  void removeNode(List *list, Index i); // 从链表中摘下
 
-  void addFreqNum();              // 增加平均访问等频率
-  void decreaseFreqNum(int num);  // 减少平均访问等频率
-  void handleOverMaxAverageNum(); // 处理当前平均访问频率超过上限的情况
-  void updateMinFreq();
+  void addFreqNum();               // 增加平均访问等频率
+  void decreaseFreqNum(Freq num);  // 减少平均访问等频率
+  void handleOverMaxAverageNum();  // 处理当前平均访问频率超过上限的情况
 
 private:
-  std::size_t capacity_; // 缓存容量
-  int minFreq_;          // 最小访问频次(用于找到最小访问频次结点)
-  int maxAverageNum_;    // 最大平均访问频次
-  int curAverageNum_;    // 当前平均访问频次
-  int curTotalNum_;      // 当前访问所有缓存次数总数
-  std::mutex mutex_;     // 互斥锁
-  NodeMap nodeMap_;      // key 到 缓存节点的映射
-  std::unordered_map<int, std::unique_ptr<FreqList<Key, Value>>>
-      freqToFreqList_; // 访问频次到该频次链表的映射
+  static constexpr std::size_t kMaxSpareLists = 8;
+
+  std::size_t capacity_;        // 缓存容量(Weigher 的单位)
+  std::size_t totalWeight_ = 0; // 当前条目的权重之和
+  [[no_unique_address]] Weigher weigher_;
+  Freq maxAverageNum_;       // 最大平均访问频次
+  Freq curAverageNum_;       // 当前平均访问频次
+  Freq curTotalNum_;         // 当前所有结点有效频次之和(老化后为估计值)
+  // 老化不再逐个结点减频次，而是累加到全局衰减量上：
+  // 结点保存的 freq 不变，有效频次为 max(1, freq - agingOffset_)，
+  // 相对次序不变，被扣到 1 的结点在下次访问时才按 1 重新计数
+  Freq agingOffset_ = 0;
+  mutable std::shared_mutex mutex_; // 互斥锁
+  mutable Stats stats_;      // 统计策略
+  NodeSlab<Node> nodes_;     // 结点存储
+  FlatIndex<Key> index_;     // key -> 结点下标
+  std::unordered_map<Freq, std::unique_ptr<List>>
+      freqToFreqList_;    // 访问频次到该频次链表的映射(只保存非空链表)
+  List *minList_ = nullptr; // 频次最小的链表，即淘汰位置
+  // 有效频次为 1 的链表中频次最大的一个(freq <= agingOffset_ + 1)，
+  // 新结点和被扣到 1 的结点都从它之后进入
+  List *agedTail_ = nullptr;
+  std::vector<std::unique_ptr<List>> spareLists_; // 复用已清空的链表
+  ExpiryTimers timers_; // 过期时间轮
+  std::unique_ptr<ReadBuffer> readBuffer_; // 读缓冲模式下才有
+  EvictionListener<Key, Value> onEvict_;   // 容量淘汰回调，可为空
+  // 最后声明、最先析构：析构时等后台加载写完，其余成员仍然有效
+  SingleFlight<Key, Value> loads_; // getOrLoad 正在进行的加载
 };
 
-template <typename Key, typename Value>
-void LfuCache<Key, Value>::getInternal(NodePtr node, Value &value) {
-  // 找到之后需要将其从低访问频次的链表中删除，并且添加到+1的访问频次链表中，
-  // 访问频次+1, 然后把value值返回
-  value = node->value;
-  // 从原有访问频次的链表中删除节点
-  removeFromFreqList(node);
-  node->freq++;
-  addToFreqList(node);
-  // 如果当前node的访问频次如果等于minFreq+1，并且其前驱链表为空，则说明
-  // freqToFreqList_[node->freq -
-  // 1]链表因node的迁移已经空了，需要更新最小访问频次
-  if (node->freq - 1 == minFreq_ && freqToFreqList_[node->freq - 1]->isEmpty())
-    minFreq_++;
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+template <typename K, typename... Args>
+void LfuCache<Key, Value, Stats, Weigher>::putLocked(K &&key, Args &&...args) {
+  expireLocked();
+  const std::uint64_t hash = index_.hashOf(key);
+  const Index i = findLocked(key, hash);
+  if (i != kNil) {
+    // 重置其value值，并清除原有的过期时间
+    Node &node = nodes_[i];
+    assignValue(node.value, std::forward<Args>(args)...);
+    timers_.cancel(node.timer);
+    const std::size_t weight = weigher_(node.key, node.value);
+    if (weight > capacity_) {
+      // 新值单独就超过容量：不再缓存，也不为它淘汰别的条目。
+      // 和新插入超重一样算作被拒绝的写入，不计淘汰，也不通知监听者
+      removeLocked(i);
+      return;
+    }
+    totalWeight_ = totalWeight_ - node.weight + weight;
+    node.weight = weight;
+    // 找到了直接调整就好了，不用再去get中再找一遍
+    getInternal(i);
+    // 新值变重时按频次淘汰，直到总权重重新放得下
+    while (totalWeight_ > capacity_) {
+      kickOut();
+    }
+
+    return;
+  }
+
+  putInternal(hash, std::forward<K>(key), std::forward<Args>(args)...);
+}
+
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+template <typename K>
+bool LfuCache<Key, Value, Stats, Weigher>::getLocked(const K &key,
+                                                     Value &value) {
+  expireLocked();
+  const Index i = findLocked(key);
+  if (i != kNil) {
+    stats_.record(CacheCounter::Hit);
+    getInternal(i);
+    value = nodes_[i].value;
+    return true;
+  }
+
+  stats_.record(CacheCounter::Miss);
+  return false;
+}
+
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::getInternal(Index i) {
+  // 将结点从原频次链表移到 +1 的链表，value 由调用方按需读取。
+  // 被衰减到 1 的结点按有效频次 1 计，移到 agingOffset_ + 2
+  Node &node = nodes_[i];
+  List *from = listOf(node);
+  List *anchor = node.freq > agingOffset_ ? from : agedTail_;
+  const Freq newFreq = std::max(node.freq, agingOffset_ + 1) + 1;
+
+  // 目标链表只可能紧跟在 anchor 之后，不存在则在其后新建
+  List *to = anchor->next_;
+  if (!to || to->freq_ != newFreq)
+    to = insertListAfter(anchor, newFreq);
+
+  removeNode(from, i);
+  node.freq = newFreq;
+  addNode(to, i);
+  if (from->isEmpty())
+    eraseList(from);
 
   // 总访问频次和当前平均访问频次都随之增加
   addFreqNum();
 }
 
-template <typename Key, typename Value>
-void LfuCache<Key, Value>::putInternal(Key key, Value value) {
-  // 如果不在缓存中，则需要判断缓存是否已满
-  if (nodeMap_.size() == capacity_) {
-    // 缓存已满，删除最不常访问的结点，更新当前平均访问频次和总访问频次
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+template <typename K, typename... Args>
+void LfuCache<Key, Value, Stats, Weigher>::putInternal(std::uint64_t hash,
+                                                       K &&key,
+                                                       Args &&...args) {
+  const Index i =
+      nodes_.create(std::forward<K>(key), std::forward<Args>(args)...);
+  Node &node = nodes_[i];
+  node.weight = weigher_(node.key, node.value);
+  if (node.weight > capacity_) {
+    nodes_.destroy(i); // 单个条目超过整个容量，淘汰谁都放不下
+    return;
+  }
+
+  // 放不下时删除最不常访问的结点(默认权重下就是满了淘汰一个)，
+  // 同时更新当前平均访问频次和总访问频次
+  while (totalWeight_ + node.weight > capacity_) {
     kickOut();
   }
+  totalWeight_ += node.weight;
+
+  // 新结点有效频次为 1，排在所有有效频次为 1 的结点之后
+  node.freq = agingOffset_ + 1;
+  List *list = agedTail_;
+  if (!list || list->freq_ != node.freq)
+    list = insertListAfter(agedTail_, node.freq);
 
-  // 创建新结点，将新结点添加进入，更新最小访问频次
-  NodePtr node = std::make_shared<Node>(key, value);
-  nodeMap_[key] = node;
-  addToFreqList(node);
+  index_.insert(hash, i,
+                [this](Index j) { return index_.hashOf(nodes_[j].key); });
+  stats_.record(CacheCounter::Insert);
+  addNode(list, i);
   addFreqNum();
-  minFreq_ = std::min(minFreq_, 1);
 }
 
-template <typename Key, typename Value> void LfuCache<Key, Value>::kickOut() {
-  NodePtr node = freqToFreqList_[minFreq_]->getFirstNode();
-  removeFromFreqList(node);
-  nodeMap_.erase(node->key);
-  decreaseFreqNum(node->freq);
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::kickOut() {
+  // 最小频次链表的头部是该频次中最早进入的结点
+  const Index victim = minList_->getFirstNode();
+  if (onEvict_)
+    onEvict_(nodes_[victim].key, nodes_[victim].value);
+  removeLocked(victim);
+  stats_.record(CacheCounter::Eviction);
 }
 
-template <typename Key, typename Value>
-void LfuCache<Key, Value>::removeFromFreqList(NodePtr node) {
-  // 检查结点是否为空
-  if (!node)
-    return;
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::removeLocked(Index i) {
+  Node &node = nodes_[i];
+  List *list = listOf(node);
+  removeNode(list, i);
+  if (list->isEmpty())
+    eraseList(list);
+  timers_.cancel(node.timer);
+  totalWeight_ -= node.weight;
+  const Freq freq = effectiveFreq(node);
+  index_.erase(index_.hashOf(node.key), i);
+  nodes_.destroy(i);
+  decreaseFreqNum(freq);
+}
 
-  auto freq = node->freq;
-  auto it = freqToFreqList_.find(freq);
-  if (it == freqToFreqList_.end() || !it->second)
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::addNode(List *list, Index i) {
+  Node &node = nodes_[i];
+  node.pre = list->tail_;
+  node.next = kNil;
+  if (list->tail_ != kNil)
+    nodes_[list->tail_].next = i;
+  else
+    list->head_ = i;
+  list->tail_ = i;
+}
+
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::addNodeFront(List *list, Index i) {
+  Node &node = nodes_[i];
+  node.pre = kNil;
+  node.next = list->head_;
+  if (list->head_ != kNil)
+    nodes_[list->head_].pre = i;
+  else
+    list->tail_ = i;
+  list->head_ = i;
+}
+
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+bool LfuCache<Key, Value, Stats, Weigher>::appendLeastLocked(
+    Key &&key, Value &&value, Freq freq, std::uint64_t ttlNs) {
+  const std::uint64_t hash = index_.hashOf(key);
+  if (findLocked(key, hash) != kNil)
+    return true; // 重复的 key 只保留先出现的一份
+  const Index i = nodes_.create(std::move(key), std::move(value));
+  Node &node = nodes_[i];
+  node.weight = weigher_(node.key, node.value);
+  if (totalWeight_ + node.weight > capacity_) {
+    nodes_.destroy(i);
+    return false;
+  }
+  totalWeight_ += node.weight;
+
+  // 写出顺序的频次不增，正常情况下只会落在最小频次链表或在它之前新建；
+  // 顺序被打乱时并入最小频次链表
+  node.freq = std::max<Freq>(1, freq);
+  if (minList_ && node.freq > minList_->freq_)
+    node.freq = minList_->freq_;
+  List *list = minList_ && minList_->freq_ == node.freq
+                   ? minList_
+                   : insertListAfter(nullptr, node.freq);
+  addNodeFront(list, i);
+  index_.insert(hash, i,
+                [this](Index j) { return index_.hashOf(nodes_[j].key); });
+  curTotalNum_ += node.freq;
+  if (ttlNs != 0)
+    timers_.schedule(node.timer, i, std::chrono::nanoseconds(ttlNs));
+  return true;
+}
+
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::removeNode(List *list, Index i) {
+  Node &node = nodes_[i];
+  if (node.pre != kNil)
+    nodes_[node.pre].next = node.next;
+  else
+    list->head_ = node.next;
+  if (node.next != kNil)
+    nodes_[node.next].pre = node.pre;
+  else
+    list->tail_ = node.pre;
+  node.pre = node.next = kNil;
+}
+
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::scheduleLocked(
+    const Key &key, TtlClock::duration ttl) {
+  const Index i = findLocked(key);
+  if (i == kNil)
     return;
-  it->second->removeNode(node);
+  // 定时器只为带 ttl 写入的条目分配，不用 ttl 时没有任何额外开销
+  timers_.schedule(nodes_[i].timer, i, ttl);
 }
 
-template <typename Key, typename Value>
-void LfuCache<Key, Value>::addToFreqList(NodePtr node) {
-  // 检查结点是否为空
-  if (!node)
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::expireLocked() {
+  applyReadsLocked();
+  timers_.advance([this](Index expired) {
+    removeLocked(expired);
+    stats_.record(CacheCounter::Expiration);
+  });
+}
+
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::applyReadsLocked() {
+  if (!readBuffer_)
     return;
+  // 被删除的下标跳过；下标已被别的 key 复用时只是多记一次访问
+  readBuffer_->drain([this](Index i) {
+    if (nodes_.contains(i))
+      getInternal(i);
+  });
+}
+
+// 共享锁内只查找和拷贝，过期但还没回收的条目按未命中处理
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+template <typename K>
+bool LfuCache<Key, Value, Stats, Weigher>::getBuffered(const K &key,
+                                                       Value &value) {
+  bool full = false;
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const Index i = findLocked(key);
+    const bool hit = i != kNil && !expiredLocked(i);
+    stats_.record(hit ? CacheCounter::Hit : CacheCounter::Miss);
+    if (!hit)
+      return false;
+    value = nodes_[i].value;
+    full = readBuffer_->record(i);
+  }
+  // 条带满了：能立刻拿到写锁就顺手补上，拿不到就留给下一个写者
+  if (full) {
+    std::unique_lock<std::shared_mutex> lock(mutex_, std::try_to_lock);
+    if (lock.owns_lock())
+      applyReadsLocked();
+  }
+  return true;
+}
+
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+typename LfuCache<Key, Value, Stats, Weigher>::List *
+LfuCache<Key, Value, Stats, Weigher>::insertListAfter(List *pos, Freq freq) {
+  std::unique_ptr<List> list;
+  if (!spareLists_.empty()) {
+    // 复用已清空的链表，避免频繁分配假头尾结点
+    list = std::move(spareLists_.back());
+    spareLists_.pop_back();
+    list->freq_ = freq;
+  } else {
+    list = std::make_unique<List>(freq);
+  }
+
+  List *raw = list.get();
+  raw->prev_ = pos;
+  raw->next_ = pos ? pos->next_ : minList_;
+  if (raw->next_)
+    raw->next_->prev_ = raw;
+  if (pos)
+    pos->next_ = raw;
+  else
+    minList_ = raw;
+
+  if (freq <= agingOffset_ + 1 && (!agedTail_ || agedTail_->freq_ < freq))
+    agedTail_ = raw;
+
+  freqToFreqList_.emplace(freq, std::move(list));
+  return raw;
+}
 
-  // 添加进入相应的频次链表前需要判断该频次链表是否存在
-  auto freq = node->freq;
-  auto it = freqToFreqList_.find(freq);
-  if (it == freqToFreqList_.end()) {
-    it = freqToFreqList_
-             .emplace(freq, std::make_unique<FreqList<Key, Value>>(freq))
-             .first;
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::eraseList(List *list) {
+  if (list->prev_)
+    list->prev_->next_ = list->next_;
+  else
+    minList_ = list->next_;
+  if (list->next_)
+    list->next_->prev_ = list->prev_;
+  if (agedTail_ == list)
+    agedTail_ = list->prev_;
+  list->prev_ = list->next_ = nullptr;
+
+  auto it = freqToFreqList_.find(list->freq_);
+  if (spareLists_.size() < kMaxSpareLists) {
+    spareLists_.push_back(std::move(it->second));
   }
-  it->second->addNode(node);
+  freqToFreqList_.erase(it);
 }
 
-template <typename Key, typename Value>
-void LfuCache<Key, Value>::addFreqNum() {
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::addFreqNum() {
   curTotalNum_++;
-  if (nodeMap_.empty())
+  if (index_.empty())
     curAverageNum_ = 0;
   else
-    curAverageNum_ = curTotalNum_ / nodeMap_.size();
+    curAverageNum_ = curTotalNum_ / static_cast<Freq>(index_.size());
 
   if (curAverageNum_ > maxAverageNum_) {
     handleOverMaxAverageNum();
   }
 }
 
-template <typename Key, typename Value>
-void LfuCache<Key, Value>::decreaseFreqNum(int num) {
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::decreaseFreqNum(Freq num) {
   // 减少平均访问频次和总访问频次
   curTotalNum_ -= num;
-  if (nodeMap_.empty())
+  if (index_.empty())
     curAverageNum_ = 0;
   else
-    curAverageNum_ = curTotalNum_ / nodeMap_.size();
+    curAverageNum_ = curTotalNum_ / static_cast<Freq>(index_.size());
 }
 
-template <typename Key, typename Value>
-void LfuCache<Key, Value>::handleOverMaxAverageNum() {
-  if (nodeMap_.empty())
+template <typename Key, typename Value, typename Stats,
+          WeigherFor<Key, Value> Weigher>
+void LfuCache<Key, Value, Stats, Weigher>::handleOverMaxAverageNum() {
+  if (index_.empty())
     return;
 
-  // 当前平均访问频次已经超过了最大平均访问频次，所有结点的访问频次-
-  // (maxAverageNum_ / 2)
-  for (auto it = nodeMap_.begin(); it != nodeMap_.end(); ++it) {
-    // 检查结点是否为空
-    if (!it->second)
-      continue;
+  // 当前平均访问频次已经超过了最大平均访问频次，所有结点的有效频次
+  // 减 (maxAverageNum_ / 2)：只累加全局衰减量，不遍历结点
+  const Freq decay = maxAverageNum_ / 2;
+  if (decay <= 0)
+    return;
+  agingOffset_ += decay;
 
-    NodePtr node = it->second;
+  // 每个结点最多减 decay、且不低于 1，总数按这个上界估计
+  const Freq n = static_cast<Freq>(index_.size());
+  curTotalNum_ = std::max(n, curTotalNum_ - decay * n);
+  curAverageNum_ = curTotalNum_ / n;
 
-    // 先从当前频率列表中移除
-    removeFromFreqList(node);
+  // 新落入有效频次 1 的链表排在 agedTail_ 之后，逐个推进。
+  // 每个链表最多被越过一次，均摊 O(1)
+  List *next = agedTail_ ? agedTail_->next_ : minList_;
+  while (next && next->freq_ <= agingOffset_ + 1) {
+    agedTail_ = next;
+    next = next->next_;
+  }
+}
 
-    // 减少频率
-    int oldFreq = node->freq;
+// 并没有牺牲空间换时间，他是把原有缓存大小进行了分片。
+// 分片数会向上取整到 2 的幂，分片选择见 ShardSet
+// capacity 以 Weigher 的单位计，每个分片各得 capacity / 分片数 的预算
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Stats = NullStats,
+          WeigherFor<Key, Value> Weigher = UnitWeigher>
+class KHashLfuCache {
+public:
+  using Shard = LfuCache<Key, Value, Stats, Weigher>;
 
-    int decay = maxAverageNum_ / 2;
-    node->freq -= decay;
+  KHashLfuCache(size_t capacity, int sliceNum, int maxAverageNum = 10,
+                Weigher weigher = Weigher())
+      : capacity_(capacity),
+        lfuSliceCaches_(capacity, sliceNum,
+                        [maxAverageNum, &weigher](size_t sliceSize) {
+                          return Shard(static_cast<std::int64_t>(sliceSize),
+                                       maxAverageNum, weigher);
+                        }) {}
 
-    if (node->freq < 1)
-      node->freq = 1;
+  void put(const Key &key, const Value &value) {
+    // 根据key找出对应的lfu分片
+    lfuSliceCaches_.shardFor(key).put(key, value);
+  }
 
-    int delta = node->freq - oldFreq;
-    curTotalNum_ += delta;
+  void put(const Key &key, const Value &value, TtlClock::duration ttl) {
+    lfuSliceCaches_.shardFor(key).put(key, value, ttl);
+  }
 
-    // 添加到新的频率列表
-    addToFreqList(node);
+  bool get(const Key &key, Value &value) {
+    // 根据key找出对应的lfu分片
+    return lfuSliceCaches_.shardFor(key).get(key, value);
   }
 
-  // 更新最小频率
-  updateMinFreq();
-}
+  Value get(const Key &key) {
+    Value value{};
+    get(key, value);
+    return value;
+  }
 
-template <typename Key, typename Value>
-void LfuCache<Key, Value>::updateMinFreq() {
-  minFreq_ = INT8_MAX;
-  for (const auto &pair : freqToFreqList_) {
-    if (pair.second && !pair.second->isEmpty()) {
-      minFreq_ = std::min(minFreq_, pair.first);
-    }
+  template <typename Fn> bool withValue(const Key &key, Fn &&fn) {
+    return lfuSliceCaches_.shardFor(key).withValue(key, std::forward<Fn>(fn));
   }
-  if (minFreq_ == INT8_MAX)
-    minFreq_ = 1;
-}
 
-// 并没有牺牲空间换时间，他是把原有缓存大小进行了分片。
-template <typename Key, typename Value> class KHashLfuCache {
-public:
-  KHashLfuCache(size_t capacity, int sliceNum, int maxAverageNum = 10)
-      : capacity_(capacity),
-        sliceNum_(sliceNum > 0
-                      ? sliceNum
-                      : static_cast<int>(std::thread::hardware_concurrency())) {
-    size_t sliceSize = static_cast<size_t>(
-        std::ceil(capacity_ / static_cast<double>(sliceNum_)));
-
-    for (int i = 0; i < sliceNum_; ++i) {
-      lfuSliceCaches_.emplace_back(
-          std::make_unique<LfuCache<Key, Value>>(sliceSize, maxAverageNum));
-    }
+  void remove(const Key &key) { lfuSliceCaches_.shardFor(key).remove(key); }
+
+  // 每个分片开启读缓冲模式(见 LfuCache::setBufferedRecency)
+  void setBufferedRecency(bool enabled, int stripes = 0) {
+    lfuSliceCaches_.forEach(
+        [&](Shard &shard) { shard.setBufferedRecency(enabled, stripes); });
   }
 
-  void put(Key key, Value value) {
-    // 根据key找出对应的lfu分片
-    size_t sliceIndex = Hash(key) % sliceNum_;
-    lfuSliceCaches_[sliceIndex]->put(key, value);
+  // 所有分片共用同一个淘汰回调(会被并发调用)
+  void setEvictionListener(const EvictionListener<Key, Value> &listener) {
+    lfuSliceCaches_.forEach(
+        [&](Shard &shard) { shard.setEvictionListener(listener); });
   }
 
-  bool get(Key key, Value &value) {
-    // 根据key找出对应的lfu分片
-    size_t sliceIndex = Hash(key) % sliceNum_;
-    return lfuSliceCaches_[sliceIndex]->get(key, value);
+  // 读穿加载：由 key 所在的分片合并同一个 key 的并发加载(见 SingleFlight.h)
+  template <typename Loader>
+  bool getOrLoad(const Key &key, Value &value, Loader &&loader,
+                 const LoadOptions &options = {}) {
+    return lfuSliceCaches_.shardFor(key).getOrLoad(
+        key, value, std::forward<Loader>(loader), options);
   }
 
-  Value get(Key key) {
+  template <typename Loader>
+  Value getOrLoad(const Key &key, Loader &&loader,
+                  const LoadOptions &options = {}) {
     Value value{};
-    get(key, value);
+    getOrLoad(key, value, std::forward<Loader>(loader), options);
     return value;
   }
 
-  // 清除缓存
-  void purge() {
-    for (auto &lfuSliceCache : lfuSliceCaches_) {
-      lfuSliceCache->purge();
+  template <typename Loader>
+  typename SingleFlight<Key, Value>::Future
+  getOrLoadAsync(const Key &key, Loader loader,
+                 const LoadOptions &options = {}) {
+    return lfuSliceCaches_.shardFor(key).getOrLoadAsync(
+        key, std::move(loader), options);
+  }
+
+  void drainLoads() {
+    lfuSliceCaches_.forEach([](auto &slice) { slice.drainLoads(); });
+  }
+
+  // 清空所有分片(见 clear)
+  void purge() { clear(); }
+
+  // 批量导入：按分片分组后在最多 threads 个线程上并行导入(threads <= 0 取硬件线程数)，
+  // 每个分片只加一次锁
+  template <BulkLoadRange<Key, Value> R>
+  void bulkLoad(const R &items, int threads = 0) {
+    const auto first = std::ranges::begin(items);
+    lfuSliceCaches_.forEachGroupParallel(
+        static_cast<std::size_t>(std::ranges::size(items)),
+        [first](std::size_t i) -> const Key & {
+          return first[static_cast<std::ptrdiff_t>(i)].first;
+        },
+        [&](Shard &slice, std::span<const std::uint32_t> positions) {
+          slice.bulkLoadAt(items, positions);
+        },
+        threads);
+  }
+
+  // 以下批量失效各分片并行执行，每个分片只在处理它时加锁，其余分片照常读写
+  void clear(int threads = 0) {
+    lfuSliceCaches_.forEachParallel([](Shard &slice) { slice.clear(); },
+                                    threads);
+  }
+
+  // pred 会在多个线程上并发调用 | 返回删除的条目数
+  template <typename Pred>
+  std::size_t removeIf(const Pred &pred, int threads = 0) {
+    std::atomic<std::size_t> removed{0};
+    lfuSliceCaches_.forEachParallel(
+        [&](Shard &slice) { removed += slice.removeIf(pred); }, threads);
+    return removed.load();
+  }
+
+  std::size_t removePrefix(std::string_view prefix, int threads = 0)
+    requires PrefixKey<Key>
+  {
+    return removeIf(
+        [prefix](const Key &key, const Value &) {
+          return std::string_view(key).starts_with(prefix);
+        },
+        threads);
+  }
+
+  // 批量查询：按分片分组，每个涉及到的分片只加一次锁
+  std::size_t getMany(std::span<const Key> keys, std::span<Value> values,
+                      std::span<bool> found) {
+    std::size_t hits = 0;
+    lfuSliceCaches_.forEachGroup(
+        keys, [&](auto &slice, std::span<const std::uint32_t> positions) {
+          hits += slice.getManyAt(keys, positions, values, found);
+        });
+    return hits;
+  }
+
+  void putMany(std::span<const Key> keys, std::span<const Value> values) {
+    lfuSliceCaches_.forEachGroup(
+        keys, [&](auto &slice, std::span<const std::uint32_t> positions) {
+          slice.putManyAt(keys, values, positions);
+        });
+  }
+
+  std::size_t sliceNum() const { return lfuSliceCaches_.shardCount(); }
+  std::size_t sliceIndex(const Key &key) const {
+    return lfuSliceCaches_.shardIndex(key);
+  }
+
+  // 各分片当前条目数
+  std::vector<std::size_t> occupancy() const {
+    return lfuSliceCaches_.occupancy();
+  }
+
+  // 所有分片的权重之和
+  std::size_t weight() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < lfuSliceCaches_.shardCount(); ++i) {
+      total += lfuSliceCaches_.shard(i).weight();
     }
+    return total;
   }
 
-private:
-  // 将key计算成对应哈希值
-  size_t Hash(Key key) {
-    std::hash<Key> hashFunc;
-    return hashFunc(key);
+  // 各分片统计之和
+  CacheStats stats() const {
+    CacheStats total;
+    for (std::size_t i = 0; i < lfuSliceCaches_.shardCount(); ++i) {
+      total += lfuSliceCaches_.shard(i).stats();
+    }
+    return total;
+  }
+
+  // 快照：每个分片一段(见 SnapshotFile.h)，恢复时分片数必须相同
+  static constexpr SnapshotPolicy kSnapshotPolicy = Shard::kSnapshotPolicy;
+  std::size_t snapshotSections() const { return lfuSliceCaches_.shardCount(); }
+  void writeSnapshotSection(std::size_t i, SnapshotWriter &out) const {
+    lfuSliceCaches_.shard(i).writeSnapshotSection(0, out);
+  }
+  bool restoreSnapshotSection(std::size_t i, SnapshotReader &in) {
+    return lfuSliceCaches_.shard(i).restoreSnapshotSection(0, in);
+  }
+
+  void purgeExpired() {
+    lfuSliceCaches_.forEach([](auto &slice) { slice.purgeExpired(); });
+  }
+
+  // 启动后台清理线程，每隔 interval 回收一遍所有分片的过期条目(重复调用会替换)
+  void startReaper(TtlClock::duration interval) {
+    reaper_.reset();
+    reaper_ = std::make_unique<PeriodicReaper>([this] { purgeExpired(); },
+                                               interval);
   }
+  void stopReaper() { reaper_.reset(); }
 
 private:
   std::size_t capacity_; // 缓存总容量
-  int sliceNum_;         // 缓存分片数量
-  std::vector<std::unique_ptr<LfuCache<Key, Value>>>
-      lfuSliceCaches_; // 缓存lfu分片容器
+  ShardSet<Key, Shard, Hash> lfuSliceCaches_; // 缓存lfu分片容器
+  std::unique_ptr<PeriodicReaper> reaper_; // 最后声明，最先停止
 };
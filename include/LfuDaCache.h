@@ -0,0 +1,290 @@
+#pragma once
+
+#include "CacheStats.h"
+#include "FlatIndex.h"
+#include "ICachePolicy.h"
+#include "NodeSlab.h"
+#include "Weigher.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 动态老化的 LFU(LFU-DA)，带权重时即 GreedyDual-Size-Frequency(GDSF)：
+// - 每个条目的优先级 K = L + F(GDSF 为 L + F / weight)，F 为访问次数(含写入)
+// - 总是淘汰 K 最小的条目(相同时淘汰最久没访问的)，并把全局膨胀值 L 提升到它的 K
+// 新条目以当前的 L 起步，过去很热但不再访问的 key 会被后来者逐渐超过，
+// 不需要定期扫描全部条目做衰减，F 也不会溢出(饱和在 2^32 - 1)。
+// 条目按 (K, 最近访问序号) 组织成带位置索引的二叉小顶堆：
+// 取 victim O(1)，命中、写入、淘汰 O(log n)。
+// Weigher 为 UnitWeigher 时 K 用整数精确计算；否则用 double，
+// 容量按 Weigher 的单位计，小而常用的条目优先留下
+template <typename Key, typename Value, typename Stats = NullStats,
+          WeigherFor<Key, Value> Weigher = UnitWeigher>
+class LfuDaCache : public ICachePolicy<Key, Value> {
+public:
+  // LFU-DA 为整数优先级，GDSF 为 double
+  using Priority = std::conditional_t<std::is_same_v<Weigher, UnitWeigher>,
+                                      std::uint64_t, double>;
+
+  explicit LfuDaCache(std::int64_t capacity, Weigher weigher = Weigher())
+      : capacity_(capacity > 0 ? static_cast<std::size_t>(capacity) : 0),
+        weigher_(std::move(weigher)) {}
+
+  ~LfuDaCache() override = default;
+
+  void put(const Key &key, const Value &value) override {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    putLocked(key, value);
+  }
+
+  // 右值版本：key/value 直接移动进结点
+  void put(Key &&key, Value &&value) {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    putLocked(std::move(key), std::move(value));
+  }
+
+  bool get(const Key &key, Value &value) override {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    const Index i = find(key, index_.hashOf(key));
+    stats_.record(i != kNil ? CacheCounter::Hit : CacheCounter::Miss);
+    if (i == kNil)
+      return false;
+
+    touch(i);
+    value = nodes_[i].value_;
+    return true;
+  }
+
+  Value get(const Key &key) override {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  // 删除指定元素(不影响 L)
+  void remove(const Key &key) {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    const std::uint64_t hash = index_.hashOf(key);
+    const Index i = find(key, hash);
+    if (i != kNil)
+      erase(i, hash);
+  }
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nodes_.size();
+  }
+
+  std::size_t capacity() const { return capacity_; }
+
+  // 当前条目的权重之和
+  std::size_t totalWeight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totalWeight_;
+  }
+
+  // 全局膨胀值 L(最近一次淘汰的条目的优先级)
+  Priority inflation() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inflation_;
+  }
+
+  // key 的访问次数与优先级，不在缓存中时返回 false
+  bool inspect(const Key &key, std::uint32_t &freq, Priority &priority) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Index i = find(key, index_.hashOf(key));
+    if (i == kNil)
+      return false;
+    freq = nodes_[i].freq_;
+    priority = nodes_[i].priority_;
+    return true;
+  }
+
+  // 结点存储、索引与堆占用的字节数(不含 key/value 自己在堆上的部分)
+  std::size_t memoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nodes_.memoryBytes() + index_.memoryBytes() +
+           heap_.capacity() * sizeof(Index);
+  }
+
+  // 统计快照(Stats 为 NullStats 时全为 0)
+  CacheStats stats() const { return stats_.snapshot(); }
+
+private:
+  using Index = std::uint32_t;
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
+
+  struct Node {
+    Key key_;
+    Value value_;
+    Priority priority_{};
+    std::uint64_t tick_ = 0;  // 最近访问序号，K 相同时先淘汰更旧的
+    std::size_t weight_ = 1;
+    std::uint32_t freq_ = 1;  // 访问次数，饱和不回绕
+    Index heapPos_ = kNil;    // 在 heap_ 中的位置
+
+    template <typename K, typename V>
+    Node(K &&key, V &&value)
+        : key_(std::forward<K>(key)), value_(std::forward<V>(value)) {}
+  };
+
+  // 以下方法要求调用方已持有 mutex_
+  template <typename K, typename V> void putLocked(K &&key, V &&value) {
+    const std::uint64_t hash = index_.hashOf(key);
+    Index i = find(key, hash);
+    if (i != kNil) {
+      Node &node = nodes_[i];
+      node.value_ = std::forward<V>(value);
+      const std::size_t weight = weigher_(node.key_, node.value_);
+      if (weight > capacity_) {
+        erase(i, hash); // 新值本身就超过整个容量
+        return;
+      }
+      totalWeight_ = totalWeight_ - node.weight_ + weight;
+      node.weight_ = weight;
+      touch(i); // 权重变了优先级可能变小，touch 里上下都会调整
+      evictUntilFits(0, i);
+      return;
+    }
+
+    i = nodes_.create(std::forward<K>(key), std::forward<V>(value));
+    Node &node = nodes_[i];
+    node.weight_ = weigher_(node.key_, node.value_);
+    if (node.weight_ > capacity_) {
+      nodes_.destroy(i); // 单个条目超过整个容量，淘汰谁都放不下
+      return;
+    }
+    evictUntilFits(node.weight_, kNil);
+
+    Node &fresh = nodes_[i];
+    fresh.priority_ = priorityOf(fresh);
+    fresh.tick_ = ++tick_;
+    totalWeight_ += fresh.weight_;
+    index_.insert(hash, i, [this](Index j) {
+      return index_.hashOf(nodes_[j].key_);
+    });
+    fresh.heapPos_ = static_cast<Index>(heap_.size());
+    heap_.push_back(i);
+    siftUp(fresh.heapPos_);
+    stats_.record(CacheCounter::Insert);
+  }
+
+  // 命中：F + 1，按当前的 L 重新计算优先级
+  void touch(Index i) {
+    Node &node = nodes_[i];
+    if (node.freq_ < std::numeric_limits<std::uint32_t>::max())
+      ++node.freq_;
+    node.priority_ = priorityOf(node);
+    node.tick_ = ++tick_;
+    siftDown(siftUp(node.heapPos_));
+  }
+
+  // 淘汰堆顶直到再放 extra 的权重也不超过容量；keep 是本次写入的结点，不淘汰
+  void evictUntilFits(std::size_t extra, Index keep) {
+    while (!heap_.empty() && totalWeight_ + extra > capacity_) {
+      Index victim = heap_.front();
+      if (victim == keep) {
+        if (heap_.size() == 1)
+          return;
+        victim = heap_.size() == 2 || less(heap_[1], heap_[2]) ? heap_[1]
+                                                               : heap_[2];
+      }
+      inflation_ = nodes_[victim].priority_;
+      erase(victim, index_.hashOf(nodes_[victim].key_));
+      stats_.record(CacheCounter::Eviction);
+    }
+  }
+
+  Priority priorityOf(const Node &node) const {
+    if constexpr (std::is_same_v<Priority, std::uint64_t>) {
+      return inflation_ + node.freq_;
+    } else {
+      return inflation_ + static_cast<double>(node.freq_) /
+                              static_cast<double>(node.weight_ > 0 ? node.weight_
+                                                                   : 1);
+    }
+  }
+
+  void erase(Index i, std::uint64_t hash) {
+    const Index pos = nodes_[i].heapPos_;
+    const Index last = heap_.back();
+    heap_.pop_back();
+    if (last != i) {
+      heap_[pos] = last;
+      nodes_[last].heapPos_ = pos;
+      siftDown(siftUp(pos));
+    }
+    totalWeight_ -= nodes_[i].weight_;
+    index_.erase(hash, i);
+    nodes_.destroy(i);
+  }
+
+  template <typename K> Index find(const K &key, std::uint64_t hash) const {
+    return index_.find(key, hash,
+                       [this](Index i) -> const Key & { return nodes_[i].key_; });
+  }
+
+  bool less(Index a, Index b) const {
+    const Node &x = nodes_[a];
+    const Node &y = nodes_[b];
+    return x.priority_ < y.priority_ ||
+           (x.priority_ == y.priority_ && x.tick_ < y.tick_);
+  }
+
+  void place(Index pos, Index i) {
+    heap_[pos] = i;
+    nodes_[i].heapPos_ = pos;
+  }
+
+  // 返回结点最终所在的位置
+  Index siftUp(Index pos) {
+    const Index i = heap_[pos];
+    while (pos > 0) {
+      const Index parent = (pos - 1) / 2;
+      if (!less(i, heap_[parent]))
+        break;
+      place(pos, heap_[parent]);
+      pos = parent;
+    }
+    place(pos, i);
+    return pos;
+  }
+
+  void siftDown(Index pos) {
+    const Index i = heap_[pos];
+    const std::size_t n = heap_.size();
+    for (;;) {
+      std::size_t child = 2 * static_cast<std::size_t>(pos) + 1;
+      if (child >= n)
+        break;
+      if (child + 1 < n && less(heap_[child + 1], heap_[child]))
+        ++child;
+      if (!less(heap_[child], i))
+        break;
+      place(pos, heap_[child]);
+      pos = static_cast<Index>(child);
+    }
+    place(pos, i);
+  }
+
+  std::size_t capacity_;        // 缓存容量(Weigher 的单位)
+  std::size_t totalWeight_ = 0; // 当前条目的权重之和
+  [[no_unique_address]] Weigher weigher_;
+  Priority inflation_{};        // 全局膨胀值 L
+  std::uint64_t tick_ = 0;      // 访问序号
+  NodeSlab<Node> nodes_;
+  FlatIndex<Key> index_;        // key -> 结点下标
+  std::vector<Index> heap_;     // 按 (priority_, tick_) 排序的小顶堆
+  mutable std::mutex mutex_;
+  mutable Stats stats_;
+};
@@ -1,20 +1,47 @@
+#pragma once
+
+#include "CacheStats.h"
+#include "FlatIndex.h"
+#include "HashUtil.h"
 #include "ICachePolicy.h"
+#include "LruKHistory.h"
+#include "NodeSlab.h"
+#include "ReadBuffer.h"
+#include "ShardSet.h"
+#include "SingleFlight.h"
+#include "Snapshot.h"
+#include "TimingWheel.h"
+#include "Weigher.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <ranges>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
 #include <thread>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
-template <typename Key, typename Value>
+// Stats 为统计策略(见 CacheStats.h)，默认的 NullStats 不产生任何开销。
+// Weigher 决定每个条目占多少容量(见 Weigher.h)，默认每个条目 1 个单位。
+// 结点按块存放在 NodeSlab 中，用 32 位下标串成双向链表，索引为 FlatIndex：
+// 每个条目没有单独的堆分配，也没有 shared_ptr 的控制块和原子引用计数
+template <typename Key, typename Value, typename Stats = NullStats,
+          WeigherFor<Key, Value> Weigher = UnitWeigher>
 class LruCache : public ICachePolicy<Key, Value> {
 public:
-  LruCache(int capacity)
-      : capacity_(capacity > 0 ? static_cast<std::size_t>(capacity) : 0) {
-    initializeList();
-  }
+  // capacity 以 Weigher 的单位计：默认为条目数，SizeofWeigher 时为字节数
+  LruCache(std::int64_t capacity, Weigher weigher = Weigher())
+      : capacity_(capacity > 0 ? static_cast<std::size_t>(capacity) : 0),
+        weigher_(std::move(weigher)) {}
 
   ~LruCache() override = default;
 
@@ -23,26 +50,54 @@ public:
     if (capacity_ == 0)
       return;
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = nodeMap_.find(key);
-    if (it != nodeMap_.end()) {
-      // 如果在当前容器中,则更新value,并调用get方法，代表该数据刚被访问
-      updateExistingNode(it->second, value);
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    putLocked(key, value);
+  }
+
+  // 右值版本：key/value 直接移动进结点
+  void put(Key &&key, Value &&value) {
+    if (capacity_ == 0)
       return;
-    }
 
-    addNewNode(key, value);
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    putLocked(std::move(key), std::move(value));
+  }
+
+  // 带过期时间的写入：ttl 之后该条目视为不存在，并优先于未过期的条目让出容量。
+  // 不带 ttl 的 put 会清除已有的过期时间
+  void put(const Key &key, const Value &value, TtlClock::duration ttl) {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    putLocked(key, value);
+    scheduleLocked(key, ttl);
+  }
+
+  // 用 args 原地构造 value；key 已存在时同样覆盖并刷新为最近访问
+  template <typename K, typename... Args>
+    requires std::constructible_from<Key, K>
+  void emplace(K &&key, Args &&...args) {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    putLocked(std::forward<K>(key), std::forward<Args>(args)...);
   }
 
   bool get(const Key &key, Value &value) override {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = nodeMap_.find(key);
-    if (it != nodeMap_.end()) {
-      moveToMostRecent(it->second);
-      value = it->second->getValue();
-      return true;
-    }
-    return false;
+    if (readBuffer_)
+      return getBuffered(key, value);
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    return getLocked(key, value);
+  }
+
+  // 异构查找：例如 Key 为 std::string 时用 std::string_view 查找，不构造临时 key
+  template <HeterogeneousKey<Key> K> bool get(const K &key, Value &value) {
+    if (readBuffer_)
+      return getBuffered(key, value);
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    return getLocked(key, value);
   }
 
   Value get(const Key &key) override {
@@ -54,236 +109,1063 @@ public:
     return value;
   }
 
+  // 命中时同时取出剩余 ttl(没有 ttl 时为 0)，getOrLoad 据此决定是否提前刷新
+  bool get(const Key &key, Value &value, TtlClock::duration &ttl) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    return getLocked(key, value, ttl);
+  }
+
+  // 读穿加载(见 SingleFlight.h)：未命中时调用 loader(key, value) 取值并写回缓存，
+  // 同一个 key 同时只有一次 loader 在执行，其余调用者等待它的结果
+  template <typename Loader>
+  bool getOrLoad(const Key &key, Value &value, Loader &&loader,
+                 const LoadOptions &options = {}) {
+    return loadThrough(*this, loads_, key, value, loader, options);
+  }
+
+  template <typename Loader>
+  Value getOrLoad(const Key &key, Loader &&loader,
+                  const LoadOptions &options = {}) {
+    Value value{};
+    getOrLoad(key, value, loader, options);
+    return value;
+  }
+
+  // 异步版本：命中时返回已就绪的 future，未命中时在后台线程里加载
+  template <typename Loader>
+  typename SingleFlight<Key, Value>::Future
+  getOrLoadAsync(const Key &key, Loader loader,
+                 const LoadOptions &options = {}) {
+    return loadThroughAsync(*this, loads_, key, std::move(loader), options);
+  }
+
+  // 等待已发起的后台加载(异步 getOrLoad、refresh-ahead)全部完成
+  void drainLoads() { loads_.drain(); }
+
+  // 零拷贝读取：命中时在锁内以 const Value& 调用 fn，返回是否命中。
+  // fn 执行期间持有缓存锁，不要在 fn 里再访问同一个缓存
+  template <typename K, typename Fn> bool withValue(const K &key, Fn &&fn) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    const Value *value = touchLocked(key);
+    stats_.record(value ? CacheCounter::Hit : CacheCounter::Miss);
+    if (value == nullptr)
+      return false;
+
+    std::forward<Fn>(fn)(*value);
+    return true;
+  }
+
   // 删除指定元素
   void remove(const Key &key) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = nodeMap_.find(key);
-    if (it != nodeMap_.end()) {
-      removeNode(it->second);
-      nodeMap_.erase(it);
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    const Index i = findLocked(key);
+    if (i != kNil)
+      eraseLocked(i);
+  }
+
+  // 清空缓存：不计为淘汰，也不回调淘汰监听
+  void clear() {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    clearLocked();
+  }
+
+  // 删除所有 pred(key, value) 为真的条目，返回删除的个数(一次加锁内遍历全部条目)
+  template <typename Pred> std::size_t removeIf(Pred &&pred) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    expireLocked();
+    std::size_t removed = 0;
+    for (Index i = oldest_; i != kNil;) {
+      const Index next = nodes_[i].next_;
+      if (pred(std::as_const(nodes_[i].key_),
+               std::as_const(nodes_[i].value_))) {
+        eraseLocked(i);
+        ++removed;
+      }
+      i = next;
+    }
+    return removed;
+  }
+
+  // 删除 key 以 prefix 开头的条目：按前缀组织的一组 key(例如 "user:42:" 下的
+  // 所有条目，或以标签开头的 key)一次失效
+  std::size_t removePrefix(std::string_view prefix)
+    requires PrefixKey<Key>
+  {
+    return removeIf([prefix](const Key &key, const Value &) {
+      return std::string_view(key).starts_with(prefix);
+    });
+  }
+
+  // 批量导入：一次加锁，按条数预留好索引后依次写入(靠后的条目更新)，
+  // 超出容量时照常从最旧的一端淘汰
+  template <BulkLoadRange<Key, Value> R> void bulkLoad(const R &items) {
+    bulkLoadImpl(items, [](std::size_t j) { return j; },
+                 static_cast<std::size_t>(std::ranges::size(items)));
+  }
+
+  // 只导入 items 中 positions 指定的条目(分片包装按分片分组后调用)
+  template <BulkLoadRange<Key, Value> R>
+  void bulkLoadAt(const R &items, std::span<const std::uint32_t> positions) {
+    bulkLoadImpl(items, [positions](std::size_t j) { return positions[j]; },
+                 positions.size());
+  }
+
+  // 包含已过期但还没被回收的条目
+  std::size_t size() const {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    return nodes_.size();
+  }
+
+  // 当前所有条目的权重之和(不超过 capacity())
+  std::size_t weight() const {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    return totalWeight_;
+  }
+
+  std::size_t capacity() const { return capacity_; }
+
+  // 结点存储与索引实际占用的字节数(不含 key/value 自己在堆上的部分)
+  std::size_t memoryBytes() const {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    return nodes_.memoryBytes() + index_.memoryBytes() +
+           timers_.memoryBytes();
+  }
+
+  // 回收所有已过期的条目(后台清理线程见 PeriodicReaper)；
+  // 不调用时，过期条目在下一次访问这个缓存时回收
+  void purgeExpired() {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    expireLocked();
+  }
+
+  // 统计快照(Stats 为 NullStats 时全为 0)
+  CacheStats stats() const { return stats_.snapshot(); }
+
+  // 读缓冲模式(见 ReadBuffer.h)：get 只拿共享锁查索引、拷贝 value，命中记进读缓冲，
+  // 由之后拿写锁的操作批量移到最近访问端；多个读者之间不再互斥。
+  // 淘汰顺序只在还没补上的少量访问内不精确。要在并发使用缓存之前设置
+  void setBufferedRecency(bool enabled, int stripes = 0) {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    applyReadsLocked();
+    readBuffer_ = enabled ? std::make_unique<ReadBuffer>(stripes) : nullptr;
+  }
+
+  // 结点存储和索引放到 NUMA 节点 node 上(见 NumaTopology.h、NumaCache.h)，
+  // 以后扩容出来的部分也一样；node < 0 取消
+  void setHomeNode(int node) {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    nodes_.setHomeNode(node);
+    index_.setHomeNode(node);
+  }
+
+  // 容量淘汰时回调 listener(key, value)，例如把条目写到下一级缓存(见 TieredCache.h)。
+  // 传空的 listener 取消
+  void setEvictionListener(EvictionListener<Key, Value> listener) {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    onEvict_ = std::move(listener);
+  }
+
+  // 快照(见 SnapshotFile.h)：从新到旧写出 key、value 和剩余 ttl(ns，0 表示没有)，
+  // 已过期的条目不写
+  static constexpr SnapshotPolicy kSnapshotPolicy = SnapshotPolicy::Lru;
+  std::size_t snapshotSections() const { return 1; }
+
+  void writeSnapshotSection(std::size_t, SnapshotWriter &out) const
+    requires SnapshotEncodable<Key> && SnapshotEncodable<Value>
+  {
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    writeSnapshotTypes<Key, Value>(out);
+    const std::size_t countAt = out.size();
+    out.u64(0);
+    std::uint64_t count = 0;
+    for (Index i = newest_; i != kNil; i = nodes_[i].prev_) {
+      const Node &node = nodes_[i];
+      std::uint64_t ttl = 0;
+      if (node.timer_ != ExpiryTimers::kNone) {
+        ttl = static_cast<std::uint64_t>(
+            std::chrono::nanoseconds(timers_.remaining(node.timer_)).count());
+        if (ttl == 0)
+          continue;
+      }
+      out.value(node.key_);
+      out.value(node.value_);
+      out.u64(ttl);
+      ++count;
+    }
+    out.patch(countAt, count);
+  }
+
+  // 恢复到空缓存：一次加锁内按从新到旧把结点依次接到最旧的一端，
+  // 放不下时丢弃剩下(更旧)的条目，不触发淘汰
+  bool restoreSnapshotSection(std::size_t, SnapshotReader &in)
+    requires SnapshotEncodable<Key> && SnapshotEncodable<Value>
+  {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    std::uint64_t count = 0;
+    if (nodes_.size() != 0 || !checkSnapshotTypes<Key, Value>(in) ||
+        !in.u64(count))
+      return false;
+
+    const int home = index_.homeNode();
+    index_ = FlatIndex<Key>(static_cast<std::size_t>(
+        std::min<std::uint64_t>(count, capacity_)));
+    index_.setHomeNode(home);
+    for (std::uint64_t n = 0; n < count; ++n) {
+      Key key{};
+      Value value{};
+      std::uint64_t ttl = 0;
+      if (!in.value(key) || !in.value(value) || !in.u64(ttl))
+        return false;
+      if (!appendOldestLocked(std::move(key), std::move(value), ttl))
+        break;
     }
+    return true;
+  }
+
+  // 批量查询：整批只加一次锁
+  std::size_t getMany(std::span<const Key> keys, std::span<Value> values,
+                      std::span<bool> found) override {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    return getBatchLocked(
+        keys.size(), [](std::size_t j) { return j; }, keys, values, found);
+  }
+
+  // 只处理 keys 中 positions 指定的那些下标(分片包装按分片分组后调用)
+  std::size_t getManyAt(std::span<const Key> keys,
+                        std::span<const std::uint32_t> positions,
+                        std::span<Value> values, std::span<bool> found) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    return getBatchLocked(
+        positions.size(), [positions](std::size_t j) { return positions[j]; },
+        keys, values, found);
+  }
+
+  void putMany(std::span<const Key> keys,
+               std::span<const Value> values) override {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      putLocked(keys[i], values[i]);
+    }
+  }
+
+  void putManyAt(std::span<const Key> keys, std::span<const Value> values,
+                 std::span<const std::uint32_t> positions) {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    for (std::uint32_t i : positions) {
+      putLocked(keys[i], values[i]);
+    }
+  }
+
+protected:
+  template <typename R, typename IndexOf>
+  void bulkLoadImpl(const R &items, IndexOf indexOf, std::size_t n) {
+    if (capacity_ == 0 || n == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    expireLocked();
+    index_.reserve(std::min(nodes_.size() + n, capacity_), [this](Index j) {
+      return index_.hashOf(nodes_[j].key_);
+    });
+    const auto first = std::ranges::begin(items);
+    for (std::size_t j = 0; j < n; ++j) {
+      const auto &item = first[static_cast<std::ptrdiff_t>(indexOf(j))];
+      putLocked(item.first, item.second);
+    }
+  }
+
+  // 以下 *Locked 方法要求调用方已持有 mutex_
+  template <typename K, typename... Args>
+  void putLocked(K &&key, Args &&...args) {
+    expireLocked();
+    const std::uint64_t hash = index_.hashOf(key);
+    const Index i = findLocked(key, hash);
+    if (i != kNil) {
+      // 如果在当前容器中,则更新value,并调用get方法，代表该数据刚被访问
+      updateExistingNode(i, std::forward<Args>(args)...);
+      return;
+    }
+
+    addNewNode(hash, std::forward<K>(key), std::forward<Args>(args)...);
+  }
+
+  template <typename K> bool getLocked(const K &key, Value &value) {
+    const Value *found = touchLocked(key);
+    stats_.record(found ? CacheCounter::Hit : CacheCounter::Miss);
+    if (found == nullptr)
+      return false;
+
+    value = *found;
+    return true;
+  }
+
+  bool getLocked(const Key &key, Value &value, TtlClock::duration &ttl) {
+    if (!getLocked(key, value))
+      return false;
+    const Index timer = nodes_[findLocked(key)].timer_;
+    ttl = timer != ExpiryTimers::kNone ? timers_.remaining(timer)
+                                       : TtlClock::duration::zero();
+    return true;
+  }
+
+  // 命中时刷新为最近访问并返回 value 的地址，未命中返回 nullptr
+  template <typename K> const Value *touchLocked(const K &key) {
+    expireLocked();
+    const Index i = findLocked(key);
+    if (i == kNil)
+      return nullptr;
+
+    moveToMostRecent(i);
+    return &nodes_[i].value_;
+  }
+
+  // 只刷新访问顺序、不计入命中统计(LruKCache 写入前探测主缓存用)
+  template <typename K> bool refresh(const K &key) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(mutex_, stats_);
+    return touchLocked(key) != nullptr;
+  }
+
+  void recordStat(CacheCounter counter) { stats_.record(counter); }
+
+  // 定时器只为带 ttl 写入的条目分配，不用 ttl 时没有任何额外开销
+  void scheduleLocked(const Key &key, TtlClock::duration ttl) {
+    const Index i = findLocked(key);
+    if (i != kNil)
+      timers_.schedule(nodes_[i].timer_, i, ttl);
   }
 
 private:
+  using Index = std::uint32_t;
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
+
   struct Node {
     Key key_;
     Value value_;
-    // std::size_t accessCount_{1};
-    std::weak_ptr<Node> prev_;
-    std::shared_ptr<Node> next_;
+    std::size_t weight_ = 0; // 写入时由 Weigher 算出
+    Index prev_ = kNil;      // 更旧的一侧
+    Index next_ = kNil;      // 更新的一侧
+    Index timer_ = ExpiryTimers::kNone; // 只有带 ttl 写入时才分配定时器
 
-    Node() = default;
-    Node(const Key &key, const Value &value) : key_(key), value_(value) {}
-
-    const Key &getKey() const { return key_; }
-    const Value &getValue() const { return value_; }
-    void setValue(const Value &value) { value_ = value; }
-
-    // std::size_t getAccessCount() const { return accessCount_; }
-    // void incrementAccessCount() { ++accessCount_; }
+    template <typename K, typename... Args>
+    explicit Node(K &&key, Args &&...args)
+        : key_(std::forward<K>(key)), value_(std::forward<Args>(args)...) {}
   };
 
-  using NodePtr = std::shared_ptr<Node>;
-  using NodeMap = std::unordered_map<Key, NodePtr>;
+  template <typename K> Index findLocked(const K &key) const {
+    return findLocked(key, index_.hashOf(key));
+  }
 
-  void initializeList() {
-    // 创建首尾虚拟节点
-    dummyHead_ = std::make_shared<Node>();
-    dummyTail_ = std::make_shared<Node>();
-    dummyHead_->next_ = dummyTail_;
-    dummyTail_->prev_ = dummyHead_;
+  template <typename K> Index findLocked(const K &key, std::uint64_t hash) const {
+    return index_.find(key, hash,
+                       [this](Index i) -> const Key & { return nodes_[i].key_; });
   }
 
-  void updateExistingNode(NodePtr node, const Value &value) {
-    node->setValue(value);
-    moveToMostRecent(node);
+  // 先查出一小批 key 对应的结点并预取，再逐个调整链表、拷贝 value，
+  // 让多次结点访存的延迟相互重叠
+  template <typename IndexOf>
+  std::size_t getBatchLocked(std::size_t n, IndexOf indexOf,
+                             std::span<const Key> keys,
+                             std::span<Value> values, std::span<bool> found) {
+    constexpr std::size_t kWindow = 8;
+    Index window[kWindow];
+    std::size_t hits = 0;
+    expireLocked();
+
+    for (std::size_t base = 0; base < n; base += kWindow) {
+      const std::size_t end = std::min(n, base + kWindow);
+      for (std::size_t j = base; j < end; ++j) {
+        window[j - base] = findLocked(keys[indexOf(j)]);
+        if (window[j - base] != kNil)
+          prefetchRead(&nodes_[window[j - base]]);
+      }
+      for (std::size_t j = base; j < end; ++j) {
+        const std::size_t i = indexOf(j);
+        const Index node = window[j - base];
+        found[i] = node != kNil;
+        stats_.record(node != kNil ? CacheCounter::Hit : CacheCounter::Miss);
+        if (node != kNil) {
+          moveToMostRecent(node);
+          values[i] = nodes_[node].value_;
+          ++hits;
+        }
+      }
+    }
+    return hits;
   }
 
-  void addNewNode(const Key &key, const Value &value) {
-    if (nodeMap_.size() >= capacity_) {
+  template <typename... Args>
+  void updateExistingNode(Index i, Args &&...args) {
+    Node &node = nodes_[i];
+    assignValue(node.value_, std::forward<Args>(args)...);
+    timers_.cancel(node.timer_);
+    const std::size_t weight = weigher_(node.key_, node.value_);
+    if (weight > capacity_) {
+      // 新值单独就超过容量：不再缓存，也不为它淘汰别的条目。
+      // 和新插入超重一样算作被拒绝的写入，不计淘汰，也不通知监听者
+      eraseLocked(i);
+      return;
+    }
+    totalWeight_ = totalWeight_ - node.weight_ + weight;
+    node.weight_ = weight;
+    moveToMostRecent(i);
+    // 新值变重时从最旧的一端淘汰，刚更新的结点在最新端，不会被淘汰
+    while (totalWeight_ > capacity_) {
       evictLeastRecent();
     }
+  }
 
-    NodePtr newNode = std::make_shared<Node>(key, value);
-    insertNode(newNode);
-    nodeMap_.try_emplace(key, newNode);
+  // 从链表和索引中摘掉结点，同时扣除权重、释放定时器
+  void eraseLocked(Index i) {
+    Node &node = nodes_[i];
+    timers_.cancel(node.timer_);
+    totalWeight_ -= node.weight_;
+    unlinkNode(i);
+    index_.erase(index_.hashOf(node.key_), i);
+    nodes_.destroy(i);
   }
 
-  // 将该节点移动到最新的位置
-  void moveToMostRecent(NodePtr node) {
-    removeNode(node);
-    insertNode(node);
+  // 拿到写锁后的例行维护：补上读缓冲里的访问，再回收时间轮上到期的条目
+  void expireLocked() {
+    applyReadsLocked();
+    timers_.advance([this](Index expired) {
+      eraseLocked(expired);
+      stats_.record(CacheCounter::Expiration);
+    });
+  }
+
+  // 读缓冲模式下的 get：共享锁内不改链表，过期但还没回收的条目按未命中处理
+  template <typename K> bool getBuffered(const K &key, Value &value) {
+    bool full = false;
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex_);
+      const Index i = findLocked(key);
+      const bool hit = i != kNil && !expiredLocked(i);
+      stats_.record(hit ? CacheCounter::Hit : CacheCounter::Miss);
+      if (!hit)
+        return false;
+      value = nodes_[i].value_;
+      full = readBuffer_->record(i);
+    }
+    // 条带满了：能立刻拿到写锁就顺手补上，拿不到就留给下一个写者
+    if (full) {
+      std::unique_lock<std::shared_mutex> lock(mutex_, std::try_to_lock);
+      if (lock.owns_lock())
+        applyReadsLocked();
+    }
+    return true;
   }
 
-  void removeNode(NodePtr node) {
-    auto prev = node->prev_.lock();
-    auto next = node->next_;
-    if (!prev || !next)
-      return; // 不在链上或 dummy
+  bool expiredLocked(Index i) const {
+    const Index timer = nodes_[i].timer_;
+    return timer != ExpiryTimers::kNone &&
+           timers_.remaining(timer) == TtlClock::duration::zero();
+  }
+
+  // 被删除的下标跳过；下标已被别的 key 复用时也只是多刷新一次，不影响正确性
+  void applyReadsLocked() {
+    if (!readBuffer_)
+      return;
+    readBuffer_->drain([this](Index i) {
+      if (nodes_.contains(i))
+        moveToMostRecent(i);
+    });
+  }
+
+  template <typename K, typename... Args>
+  void addNewNode(std::uint64_t hash, K &&key, Args &&...args) {
+    // key 只移动进结点一次，索引里只保存结点下标
+    const Index i =
+        nodes_.create(std::forward<K>(key), std::forward<Args>(args)...);
+    Node &node = nodes_[i];
+    node.weight_ = weigher_(node.key_, node.value_);
+    if (node.weight_ > capacity_) {
+      nodes_.destroy(i); // 单个条目超过整个容量，淘汰谁都放不下
+      return;
+    }
 
-    prev->next_ = next;
-    next->prev_ = prev;
+    // 淘汰到放得下为止(默认权重下就是满了淘汰一个)
+    while (totalWeight_ + node.weight_ > capacity_) {
+      evictLeastRecent();
+    }
+    totalWeight_ += node.weight_;
+    insertNode(i);
+    index_.insert(hash, i, [this](Index j) {
+      return index_.hashOf(nodes_[j].key_);
+    });
+    stats_.record(CacheCounter::Insert);
+  }
 
-    node->next_.reset();
-    node->prev_.reset();
+  void clearLocked() {
+    if (readBuffer_)
+      readBuffer_->drain([](Index) {});
+    timers_.clear();
+    index_.clear();
+    nodes_.clear();
+    oldest_ = newest_ = kNil;
+    totalWeight_ = 0;
   }
 
-  // 从尾部插入结点
-  void insertNode(NodePtr node) {
-    auto prev = dummyTail_->prev_.lock();
-    assert(prev && "LRU list invariant broken: tail must have prev");
+  // 快照恢复用：接到最旧的一端，容量不够时返回 false
+  bool appendOldestLocked(Key &&key, Value &&value, std::uint64_t ttlNs) {
+    const std::uint64_t hash = index_.hashOf(key);
+    if (findLocked(key, hash) != kNil)
+      return true; // 重复的 key 只保留较新的一份
+    const Index i = nodes_.create(std::move(key), std::move(value));
+    Node &node = nodes_[i];
+    node.weight_ = weigher_(node.key_, node.value_);
+    if (totalWeight_ + node.weight_ > capacity_) {
+      nodes_.destroy(i);
+      return false;
+    }
 
-    node->next_ = dummyTail_;
-    node->prev_ = prev;
-    prev->next_ = node;
-    dummyTail_->prev_ = node;
+    totalWeight_ += node.weight_;
+    node.prev_ = kNil;
+    node.next_ = oldest_;
+    if (oldest_ != kNil)
+      nodes_[oldest_].prev_ = i;
+    else
+      newest_ = i;
+    oldest_ = i;
+    index_.insert(hash, i, [this](Index j) {
+      return index_.hashOf(nodes_[j].key_);
+    });
+    if (ttlNs != 0)
+      timers_.schedule(node.timer_, i, std::chrono::nanoseconds(ttlNs));
+    return true;
+  }
+
+  // 将该节点移动到最新的位置
+  void moveToMostRecent(Index i) {
+    if (newest_ == i)
+      return;
+    unlinkNode(i);
+    insertNode(i);
+  }
+
+  void unlinkNode(Index i) {
+    Node &node = nodes_[i];
+    if (node.prev_ != kNil)
+      nodes_[node.prev_].next_ = node.next_;
+    else
+      oldest_ = node.next_;
+    if (node.next_ != kNil)
+      nodes_[node.next_].prev_ = node.prev_;
+    else
+      newest_ = node.prev_;
+    node.prev_ = node.next_ = kNil;
+  }
+
+  // 插到最新的一端
+  void insertNode(Index i) {
+    Node &node = nodes_[i];
+    node.prev_ = newest_;
+    node.next_ = kNil;
+    if (newest_ != kNil)
+      nodes_[newest_].next_ = i;
+    else
+      oldest_ = i;
+    newest_ = i;
   }
 
   // 驱逐最近最少访问
   void evictLeastRecent() {
-    NodePtr leastRecent = dummyHead_->next_;
-    if (!leastRecent || leastRecent == dummyTail_)
+    if (oldest_ == kNil)
       return; // 空链表不驱逐
-    removeNode(leastRecent);
-    nodeMap_.erase(leastRecent->getKey());
+    if (onEvict_)
+      onEvict_(nodes_[oldest_].key_, nodes_[oldest_].value_);
+    eraseLocked(oldest_);
+    stats_.record(CacheCounter::Eviction);
   }
 
 private:
-  std::size_t capacity_; // 缓存容量
-  NodeMap nodeMap_;      // key -> Node
-  std::mutex mutex_;
-  NodePtr dummyHead_; // 虚拟头结点
-  NodePtr dummyTail_;
+  std::size_t capacity_;        // 缓存容量(Weigher 的单位)
+  std::size_t totalWeight_ = 0; // 当前条目的权重之和
+  [[no_unique_address]] Weigher weigher_;
+  NodeSlab<Node> nodes_;  // 结点存储
+  FlatIndex<Key> index_;  // key -> 结点下标
+  Index oldest_ = kNil;   // 最近最少访问(淘汰位置)
+  Index newest_ = kNil;   // 最近访问
+
+protected:
+  // LruKCache 在同一个临界区内维护访问历史
+  mutable std::shared_mutex mutex_;
+  mutable Stats stats_;
+
+private:
+  ExpiryTimers timers_; // 过期时间轮
+  std::unique_ptr<ReadBuffer> readBuffer_; // 读缓冲模式下才有
+  EvictionListener<Key, Value> onEvict_;   // 容量淘汰回调，可为空
+
+protected:
+  // 最后声明、最先析构：析构时等后台加载写完，其余成员仍然有效
+  SingleFlight<Key, Value> loads_; // getOrLoad 正在进行的加载
 };
 
 // LRU优化：Lru-k版本。 通过继承的方式进行再优化
-template <typename Key, typename Value>
-class LruKCache : public LruCache<Key, Value> {
+// 一个 key 累计访问 k 次(未命中的 get 和 put 都算)后，下一次 put 才写入主缓存。
+// 访问历史(LruKHistory)只记 key 和次数，不保存 value，条目数不超过 historyCapacity；
+// 主缓存和历史共用一把锁，每次操作只加一次锁
+template <typename Key, typename Value, typename Stats = NullStats>
+class LruKCache : public LruCache<Key, Value, Stats> {
+  using Base = LruCache<Key, Value, Stats>;
+
 public:
   LruKCache(int capacity, int historyCapacity, int k)
-      : LruCache<Key, Value>(capacity), k_(k),
-        historyList_(std::make_unique<LruCache<Key, size_t>>(historyCapacity)) {
+      : Base(capacity), k_(k > 0 ? static_cast<std::size_t>(k) : 1),
+        history_(historyCapacity > 0 ? static_cast<std::size_t>(historyCapacity)
+                                     : 0) {}
+
+  // 后台加载会写 history_，要在派生类的成员析构之前等它们完成
+  ~LruKCache() override { this->loads_.drain(); }
+
+  // 基类的 get 重载在下面逐个按 LRU-K 语义重写(未命中记一次访问)
+  using Base::get;
+
+  bool get(const Key &key, Value &value) override {
+    return getImpl(key, value);
   }
 
-  Value get(const Key &key) {
-    std::lock_guard<std::mutex> lock(k_mutex_);
-    // 首先尝试从主缓存获取数据
+  // 异构查找同样在未命中时记一次访问
+  template <HeterogeneousKey<Key> K> bool get(const K &key, Value &value) {
+    return getImpl(key, value);
+  }
+
+  Value get(const Key &key) override {
     Value value{};
-    bool inMainCache = LruCache<Key, Value>::get(key, value);
+    get(key, value);
+    return value;
+  }
 
-    // 获取并更新访问历史计数
-    size_t historyCount = historyList_->get(key);
-    historyCount++;
-    historyList_->put(key, historyCount);
+  // 命中时同时取出剩余 ttl；未命中同样记一次访问
+  bool get(const Key &key, Value &value, TtlClock::duration &ttl) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(this->mutex_, this->stats_);
+    if (Base::getLocked(key, value, ttl))
+      return true;
+    history_.touch(key);
+    return false;
+  }
 
-    // 如果数据在主缓存中，直接返回
-    if (inMainCache) {
-      return value;
-    }
+  void put(const Key &key, const Value &value) override { putImpl(key, value); }
 
-    // 如果数据不在主缓存，但访问次数达到了k次
-    if (historyCount >= k_) {
-      // 检查是否有历史值记录
-      auto it = historyValueMap_.find(key);
-      if (it != historyValueMap_.end()) {
-        // 有历史值，将其添加到主缓存
-        Value storedValue = it->second;
+  void put(Key &&key, Value &&value) {
+    putImpl(std::move(key), std::move(value));
+  }
 
-        // 从历史记录移除
-        historyList_->remove(key);
-        historyValueMap_.erase(it);
+  // 带 ttl 的写入同样要先准入；未准入时 value 被丢弃，也就不记过期时间
+  void put(const Key &key, const Value &value, TtlClock::duration ttl) {
+    if (Base::capacity() == 0)
+      return;
 
-        // 添加到主缓存
-        LruCache<Key, Value>::put(key, storedValue);
+    StatsLockGuard<Stats, std::shared_mutex> lock(this->mutex_, this->stats_);
+    if (admitLocked(key, value))
+      Base::scheduleLocked(key, ttl);
+  }
 
-        return storedValue;
-      }
-      // 没有历史值记录，无法添加到缓存，返回默认值
-    }
+  // 只查主缓存，未命中不记访问：getOrLoad 成为加载者后的再查一次用它，
+  // 前面的 get 已经为这次访问记过历史
+  bool probe(const Key &key, Value &value) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(this->mutex_, this->stats_);
+    return Base::getLocked(key, value);
+  }
 
-    // 数据不在主缓存且不满足添加条件，返回默认值
+  // 读穿加载按 LRU-K 语义读写：未命中和写回都记访问，够 k 次才进主缓存
+  template <typename Loader>
+  bool getOrLoad(const Key &key, Value &value, Loader &&loader,
+                 const LoadOptions &options = {}) {
+    return loadThrough(*this, this->loads_, key, value, loader, options);
+  }
+
+  template <typename Loader>
+  Value getOrLoad(const Key &key, Loader &&loader,
+                  const LoadOptions &options = {}) {
+    Value value{};
+    getOrLoad(key, value, loader, options);
     return value;
   }
 
-  void put(const Key &key, const Value &value) {
-    std::lock_guard<std::mutex> lock(k_mutex_);
-    // 检查是否已在主缓存
-    Value existingValue{};
-    bool inMainCache = LruCache<Key, Value>::get(key, existingValue);
-
-    if (inMainCache) {
-      // 已在主缓存，直接更新
-      LruCache<Key, Value>::put(key, value);
+  template <typename Loader>
+  typename SingleFlight<Key, Value>::Future
+  getOrLoadAsync(const Key &key, Loader loader,
+                 const LoadOptions &options = {}) {
+    return loadThroughAsync(*this, this->loads_, key, std::move(loader),
+                            options);
+  }
+
+  // 未命中同样记一次访问
+  template <typename K, typename Fn> bool withValue(const K &key, Fn &&fn) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(this->mutex_, this->stats_);
+    const Value *value = Base::touchLocked(key);
+    Base::recordStat(value ? CacheCounter::Hit : CacheCounter::Miss);
+    if (value == nullptr) {
+      history_.touch(key);
+      return false;
+    }
+    std::forward<Fn>(fn)(*value);
+    return true;
+  }
+
+  // 与 put 相同的准入逻辑：未准入时不构造 value
+  template <typename K, typename... Args>
+    requires std::constructible_from<Key, K>
+  void emplace(K &&key, Args &&...args) {
+    putImpl(std::forward<K>(key), std::forward<Args>(args)...);
+  }
+
+  // 批量接口逐个走 LRU-K 的准入逻辑，而不是直接落到主缓存
+  template <BulkLoadRange<Key, Value> R> void bulkLoad(const R &items) {
+    bulkAdmit(items, [](std::size_t j) { return j; },
+              static_cast<std::size_t>(std::ranges::size(items)));
+  }
+
+  template <BulkLoadRange<Key, Value> R>
+  void bulkLoadAt(const R &items, std::span<const std::uint32_t> positions) {
+    bulkAdmit(items, [positions](std::size_t j) { return positions[j]; },
+              positions.size());
+  }
+
+  std::size_t getMany(std::span<const Key> keys, std::span<Value> values,
+                      std::span<bool> found) override {
+    return ICachePolicy<Key, Value>::getMany(keys, values, found);
+  }
+
+  void putMany(std::span<const Key> keys,
+               std::span<const Value> values) override {
+    ICachePolicy<Key, Value>::putMany(keys, values);
+  }
+
+  // 历史中的 key 数(不超过 historyCapacity)
+  std::size_t historySize() const {
+    std::lock_guard<std::shared_mutex> lock(this->mutex_);
+    return history_.size();
+  }
+
+  std::size_t memoryBytes() const {
+    const std::size_t main = Base::memoryBytes();
+    std::lock_guard<std::shared_mutex> lock(this->mutex_);
+    return main + history_.memoryBytes();
+  }
+
+private:
+  template <typename K> bool getImpl(const K &key, Value &value) {
+    StatsLockGuard<Stats, std::shared_mutex> lock(this->mutex_, this->stats_);
+    if (Base::getLocked(key, value))
+      return true;
+
+    // 未命中只记一次访问；没有 value 可以准入，要等下一次 put
+    history_.touch(key);
+    return false;
+  }
+
+  template <typename K, typename... Args>
+  void putImpl(K &&key, Args &&...args) {
+    if (Base::capacity() == 0)
       return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(this->mutex_, this->stats_);
+    admitLocked(std::forward<K>(key), std::forward<Args>(args)...);
+  }
+
+  template <typename R, typename IndexOf>
+  void bulkAdmit(const R &items, IndexOf indexOf, std::size_t n) {
+    if (Base::capacity() == 0 || n == 0)
+      return;
+
+    StatsLockGuard<Stats, std::shared_mutex> lock(this->mutex_, this->stats_);
+    const auto first = std::ranges::begin(items);
+    for (std::size_t j = 0; j < n; ++j) {
+      const auto &item = first[static_cast<std::ptrdiff_t>(indexOf(j))];
+      admitLocked(item.first, item.second);
     }
+  }
 
-    // 获取并更新访问历史
-    std::size_t historyCount = historyList_->get(key);
-    historyCount++;
-    historyList_->put(key, historyCount);
+  // 返回条目是否写进了主缓存。要求调用方已持有 mutex_
+  template <typename K, typename... Args>
+  bool admitLocked(K &&key, Args &&...args) {
+    // 已在主缓存：直接更新
+    if (Base::touchLocked(key) != nullptr) {
+      Base::putLocked(std::forward<K>(key), std::forward<Args>(args)...);
+      return true;
+    }
+
+    // 达到 k 次才准入主缓存，否则只记访问次数、丢弃 value
+    if (history_.touch(key) < k_)
+      return false;
+    history_.erase(key);
+    Base::putLocked(std::forward<K>(key), std::forward<Args>(args)...);
+    Base::recordStat(CacheCounter::Promotion);
+    return true;
+  }
+
+  std::size_t k_; // 进入缓存队列的评判标准
+  LruKHistory<Key> history_; // 未准入 key 的访问次数
+};
+
+// 对 LRU-K 进行分片：每个分片是独立的 LruKCache(主缓存与历史各按分片数切分)
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Stats = NullStats>
+class KHashLruKCache {
+public:
+  using Shard = LruKCache<Key, Value, Stats>;
 
-    // 保存值到历史记录映射，供后续get操作使用
-    historyValueMap_[key] = value;
+  KHashLruKCache(std::size_t capacity, std::size_t historyCapacity, int k,
+                 int sliceNum)
+      : lruKSliceCaches_(capacity, sliceNum,
+                         [capacity, historyCapacity, k](std::size_t sliceSize) {
+                           // 历史容量按主缓存的切分比例分给每个分片
+                           const std::size_t history =
+                               capacity == 0
+                                   ? historyCapacity
+                                   : (historyCapacity * sliceSize + capacity -
+                                      1) / capacity;
+                           return Shard(static_cast<int>(sliceSize),
+                                        static_cast<int>(history), k);
+                         }) {}
 
-    // 检查是否达到k次访问阈值
-    if (historyCount >= k_) {
-      // 达到阈值，添加到主缓存
-      historyList_->remove(key);
-      historyValueMap_.erase(key);
-      LruCache<Key, Value>::put(key, value);
+  void put(const Key &key, const Value &value) {
+    lruKSliceCaches_.shardFor(key).put(key, value);
+  }
+
+  void put(Key &&key, Value &&value) {
+    Shard &shard = lruKSliceCaches_.shardFor(key);
+    shard.put(std::move(key), std::move(value));
+  }
+
+  bool get(const Key &key, Value &value) {
+    return lruKSliceCaches_.shardFor(key).get(key, value);
+  }
+
+  Value get(const Key &key) {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  std::size_t sliceNum() const { return lruKSliceCaches_.shardCount(); }
+
+  // 各分片主缓存的条目数
+  std::vector<std::size_t> occupancy() const {
+    return lruKSliceCaches_.occupancy();
+  }
+
+  // 所有分片历史中的 key 数
+  std::size_t historySize() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < lruKSliceCaches_.shardCount(); ++i) {
+      total += lruKSliceCaches_.shard(i).historySize();
+    }
+    return total;
+  }
+
+  // 汇总所有分片的统计
+  CacheStats stats() const {
+    CacheStats total;
+    for (std::size_t i = 0; i < lruKSliceCaches_.shardCount(); ++i) {
+      total += lruKSliceCaches_.shard(i).stats();
     }
+    return total;
   }
 
 private:
-  int k_; // 进入缓存队列的评判标准
-  mutable std::mutex k_mutex_;
-  std::unique_ptr<LruCache<Key, size_t>>
-      historyList_; // 访问数据历史记录(value为访问次数)
-  std::unordered_map<Key, Value> historyValueMap_; // 存储未达到k次访问的数据值
+  ShardSet<Key, Shard, Hash> lruKSliceCaches_;
 };
 
 // lru优化：对lru进行分片，提高高并发使用的性能
-template <typename Key, typename Value> class KHashLruCaches {
+// 分片数会向上取整到 2 的幂，分片选择见 ShardSet
+// capacity 以 Weigher 的单位计，每个分片各得 capacity / 分片数 的预算
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Stats = NullStats,
+          WeigherFor<Key, Value> Weigher = UnitWeigher>
+class KHashLruCaches {
 public:
-  KHashLruCaches(size_t capacity, int sliceNum)
+  using Shard = LruCache<Key, Value, Stats, Weigher>;
+
+  KHashLruCaches(size_t capacity, int sliceNum, Weigher weigher = Weigher())
       : capacity_(capacity),
-        sliceNum_(sliceNum > 0 ? sliceNum
-                               : std::thread::hardware_concurrency()) {
-    size_t sliceSize = std::ceil(
-        capacity / static_cast<double>(sliceNum_)); // 获取每个分片的大小
-    for (int i = 0; i < sliceNum_; ++i) {
-      lruSliceCaches_.emplace_back(new LruCache<Key, Value>(sliceSize));
-    }
-  }
+        lruSliceCaches_(capacity, sliceNum, [&weigher](size_t sliceSize) {
+          return Shard(static_cast<std::int64_t>(sliceSize), weigher);
+        }) {}
 
   void put(const Key &key, const Value &value) {
-    // 获取key的hash值，并计算出对应的分片索引
-    size_t sliceIndex = Hash(key) % sliceNum_;
-    lruSliceCaches_[sliceIndex]->put(key, value);
+    lruSliceCaches_.shardFor(key).put(key, value);
   }
 
-  bool get(Key key, Value &value) {
-    // 获取key的hash值，并计算出对应的分片索引
-    size_t sliceIndex = Hash(key) % sliceNum_;
-    return lruSliceCaches_[sliceIndex]->get(key, value);
+  void put(const Key &key, const Value &value, TtlClock::duration ttl) {
+    lruSliceCaches_.shardFor(key).put(key, value, ttl);
   }
 
-  Value get(Key key) {
+  bool get(const Key &key, Value &value) {
+    return lruSliceCaches_.shardFor(key).get(key, value);
+  }
+
+  Value get(const Key &key) {
     Value value{};
     get(key, value);
     return value;
   }
 
-private:
-  // 将key转换为对应hash值
-  size_t Hash(Key key) {
-    std::hash<Key> hashFunc;
-    return hashFunc(key);
+  template <typename Fn> bool withValue(const Key &key, Fn &&fn) {
+    return lruSliceCaches_.shardFor(key).withValue(key, std::forward<Fn>(fn));
+  }
+
+  void remove(const Key &key) { lruSliceCaches_.shardFor(key).remove(key); }
+
+  // 每个分片开启读缓冲模式(见 LruCache::setBufferedRecency)
+  void setBufferedRecency(bool enabled, int stripes = 0) {
+    lruSliceCaches_.forEach(
+        [&](Shard &shard) { shard.setBufferedRecency(enabled, stripes); });
   }
 
+  // 所有分片共用同一个淘汰回调(会被并发调用)
+  void setEvictionListener(const EvictionListener<Key, Value> &listener) {
+    lruSliceCaches_.forEach(
+        [&](Shard &shard) { shard.setEvictionListener(listener); });
+  }
+
+  // 批量导入：按分片分组后在最多 threads 个线程上并行导入(threads <= 0 取硬件线程数)，
+  // 每个分片只加一次锁
+  template <BulkLoadRange<Key, Value> R>
+  void bulkLoad(const R &items, int threads = 0) {
+    const auto first = std::ranges::begin(items);
+    lruSliceCaches_.forEachGroupParallel(
+        static_cast<std::size_t>(std::ranges::size(items)),
+        [first](std::size_t i) -> const Key & {
+          return first[static_cast<std::ptrdiff_t>(i)].first;
+        },
+        [&](Shard &slice, std::span<const std::uint32_t> positions) {
+          slice.bulkLoadAt(items, positions);
+        },
+        threads);
+  }
+
+  // 以下批量失效各分片并行执行，每个分片只在处理它时加锁，其余分片照常读写
+  void clear(int threads = 0) {
+    lruSliceCaches_.forEachParallel([](Shard &slice) { slice.clear(); },
+                                    threads);
+  }
+
+  // pred 会在多个线程上并发调用 | 返回删除的条目数
+  template <typename Pred>
+  std::size_t removeIf(const Pred &pred, int threads = 0) {
+    std::atomic<std::size_t> removed{0};
+    lruSliceCaches_.forEachParallel(
+        [&](Shard &slice) { removed += slice.removeIf(pred); }, threads);
+    return removed.load();
+  }
+
+  std::size_t removePrefix(std::string_view prefix, int threads = 0)
+    requires PrefixKey<Key>
+  {
+    return removeIf(
+        [prefix](const Key &key, const Value &) {
+          return std::string_view(key).starts_with(prefix);
+        },
+        threads);
+  }
+
+  // 读穿加载：由 key 所在的分片合并同一个 key 的并发加载(见 SingleFlight.h)
+  template <typename Loader>
+  bool getOrLoad(const Key &key, Value &value, Loader &&loader,
+                 const LoadOptions &options = {}) {
+    return lruSliceCaches_.shardFor(key).getOrLoad(
+        key, value, std::forward<Loader>(loader), options);
+  }
+
+  template <typename Loader>
+  Value getOrLoad(const Key &key, Loader &&loader,
+                  const LoadOptions &options = {}) {
+    Value value{};
+    getOrLoad(key, value, std::forward<Loader>(loader), options);
+    return value;
+  }
+
+  template <typename Loader>
+  typename SingleFlight<Key, Value>::Future
+  getOrLoadAsync(const Key &key, Loader loader,
+                 const LoadOptions &options = {}) {
+    return lruSliceCaches_.shardFor(key).getOrLoadAsync(
+        key, std::move(loader), options);
+  }
+
+  void drainLoads() {
+    lruSliceCaches_.forEach([](auto &slice) { slice.drainLoads(); });
+  }
+
+  // 批量查询：按分片分组，每个涉及到的分片只加一次锁
+  std::size_t getMany(std::span<const Key> keys, std::span<Value> values,
+                      std::span<bool> found) {
+    std::size_t hits = 0;
+    lruSliceCaches_.forEachGroup(
+        keys, [&](auto &slice, std::span<const std::uint32_t> positions) {
+          hits += slice.getManyAt(keys, positions, values, found);
+        });
+    return hits;
+  }
+
+  void putMany(std::span<const Key> keys, std::span<const Value> values) {
+    lruSliceCaches_.forEachGroup(
+        keys, [&](auto &slice, std::span<const std::uint32_t> positions) {
+          slice.putManyAt(keys, values, positions);
+        });
+  }
+
+  std::size_t sliceNum() const { return lruSliceCaches_.shardCount(); }
+  std::size_t sliceIndex(const Key &key) const {
+    return lruSliceCaches_.shardIndex(key);
+  }
+
+  // 各分片当前条目数
+  std::vector<std::size_t> occupancy() const {
+    return lruSliceCaches_.occupancy();
+  }
+
+  // 所有分片的权重之和
+  std::size_t weight() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < lruSliceCaches_.shardCount(); ++i) {
+      total += lruSliceCaches_.shard(i).weight();
+    }
+    return total;
+  }
+
+  // 汇总所有分片的统计
+  CacheStats stats() const {
+    CacheStats total;
+    for (std::size_t i = 0; i < lruSliceCaches_.shardCount(); ++i) {
+      total += lruSliceCaches_.shard(i).stats();
+    }
+    return total;
+  }
+
+  // 快照：每个分片一段(见 SnapshotFile.h)，恢复时分片数必须相同
+  static constexpr SnapshotPolicy kSnapshotPolicy = Shard::kSnapshotPolicy;
+  std::size_t snapshotSections() const { return lruSliceCaches_.shardCount(); }
+  void writeSnapshotSection(std::size_t i, SnapshotWriter &out) const {
+    lruSliceCaches_.shard(i).writeSnapshotSection(0, out);
+  }
+  bool restoreSnapshotSection(std::size_t i, SnapshotReader &in) {
+    return lruSliceCaches_.shard(i).restoreSnapshotSection(0, in);
+  }
+
+  void purgeExpired() {
+    lruSliceCaches_.forEach([](auto &slice) { slice.purgeExpired(); });
+  }
+
+  // 启动后台清理线程，每隔 interval 回收一遍所有分片的过期条目(重复调用会替换)
+  void startReaper(TtlClock::duration interval) {
+    reaper_.reset();
+    reaper_ = std::make_unique<PeriodicReaper>([this] { purgeExpired(); },
+                                               interval);
+  }
+  void stopReaper() { reaper_.reset(); }
+
 private:
   std::size_t capacity_; // 总容量
-  int sliceNum_;         // 切片数量
-  std::vector<std::unique_ptr<LruCache<Key, Value>>>
-      lruSliceCaches_; // 切片LRU缓存
-};
\ No newline at end of file
+  ShardSet<Key, Shard, Hash> lruSliceCaches_; // 切片LRU缓存
+  std::unique_ptr<PeriodicReaper> reaper_; // 最后声明，最先停止
+};
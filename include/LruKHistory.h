@@ -0,0 +1,117 @@
+#pragma once
+
+#include "FlatIndex.h"
+#include "NodeSlab.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+// LRU-K 的访问历史：还没被准入主缓存的 key 及其访问次数，不保存 value。
+// 条目数不超过 capacity，满了淘汰最久没访问的 key(它的计数随之清零)。
+// 本身不加锁，由 LruKCache 在主缓存的同一个临界区内调用。
+template <typename Key> class LruKHistory {
+public:
+  using Count = std::uint32_t;
+
+  explicit LruKHistory(std::size_t capacity) : capacity_(capacity) {}
+
+  std::size_t size() const { return nodes_.size(); }
+  std::size_t capacity() const { return capacity_; }
+
+  // 记一次访问并返回累计次数；容量为 0 时不记录，始终返回 1
+  template <typename K> Count touch(const K &key) {
+    const std::uint64_t hash = index_.hashOf(key);
+    Index i = find(key, hash);
+    if (i != kNil) {
+      unlink(i);
+      pushNewest(i);
+      Node &node = nodes_[i];
+      if (node.count_ < std::numeric_limits<Count>::max())
+        ++node.count_;
+      return node.count_;
+    }
+    if (capacity_ == 0)
+      return 1;
+
+    if (nodes_.size() >= capacity_)
+      eraseAt(oldest_);
+    i = nodes_.create(key);
+    index_.insert(hash, i, [this](Index j) {
+      return index_.hashOf(nodes_[j].key_);
+    });
+    pushNewest(i);
+    return nodes_[i].count_;
+  }
+
+  // 准入主缓存后清掉历史
+  template <typename K> void erase(const K &key) {
+    const Index i = find(key, index_.hashOf(key));
+    if (i != kNil)
+      eraseAt(i);
+  }
+
+  void clear() {
+    nodes_.clear();
+    index_.clear();
+    oldest_ = newest_ = kNil;
+  }
+
+  std::size_t memoryBytes() const {
+    return nodes_.memoryBytes() + index_.memoryBytes();
+  }
+
+private:
+  using Index = std::uint32_t;
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
+
+  struct Node {
+    Key key_;
+    Count count_ = 1;
+    Index prev_ = kNil; // 更旧的一侧
+    Index next_ = kNil; // 更新的一侧
+
+    template <typename K> explicit Node(const K &key) : key_(key) {}
+  };
+
+  template <typename K> Index find(const K &key, std::uint64_t hash) const {
+    return index_.find(key, hash,
+                       [this](Index i) -> const Key & { return nodes_[i].key_; });
+  }
+
+  void eraseAt(Index i) {
+    index_.erase(index_.hashOf(nodes_[i].key_), i);
+    unlink(i);
+    nodes_.destroy(i);
+  }
+
+  void unlink(Index i) {
+    Node &node = nodes_[i];
+    if (node.prev_ != kNil)
+      nodes_[node.prev_].next_ = node.next_;
+    else
+      oldest_ = node.next_;
+    if (node.next_ != kNil)
+      nodes_[node.next_].prev_ = node.prev_;
+    else
+      newest_ = node.prev_;
+    node.prev_ = node.next_ = kNil;
+  }
+
+  void pushNewest(Index i) {
+    Node &node = nodes_[i];
+    node.prev_ = newest_;
+    node.next_ = kNil;
+    if (newest_ != kNil)
+      nodes_[newest_].next_ = i;
+    else
+      oldest_ = i;
+    newest_ = i;
+  }
+
+  std::size_t capacity_;
+  NodeSlab<Node> nodes_;
+  FlatIndex<Key> index_; // key -> 结点下标
+  Index oldest_ = kNil;
+  Index newest_ = kNil;
+};
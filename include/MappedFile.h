@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 只读内存映射文件(RAII)。不支持 mmap 的平台退化为整体读入内存
+class MappedFile {
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile() { close(); }
+
+  bool open(const std::string &path) {
+    close();
+#if defined(_WIN32)
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+      return false;
+    buffer_.assign(std::istreambuf_iterator<char>(in), {});
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return true;
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0)
+      return false;
+    struct stat st {};
+    if (::fstat(fd_, &st) != 0) {
+      close();
+      return false;
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ == 0)
+      return true;
+    void *p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (p == MAP_FAILED) {
+      close();
+      return false;
+    }
+    // 整个文件顺序扫一遍，提示内核提前预读
+    ::madvise(p, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char *>(p);
+    return true;
+#endif
+  }
+
+  void close() {
+#if defined(_WIN32)
+    buffer_.clear();
+#else
+    if (data_ != nullptr)
+      ::munmap(const_cast<char *>(data_), size_);
+    if (fd_ >= 0)
+      ::close(fd_);
+    fd_ = -1;
+#endif
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+private:
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+#if defined(_WIN32)
+  std::vector<char> buffer_;
+#else
+  int fd_ = -1;
+#endif
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "FlatIndex.h"
+#include "HashUtil.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// 预分配的结点槽位池：
+// - 槽位数量在构造时按容量一次性分配，淘汰/删除后的槽位通过 free list 复用
+// - 结点之间用 32 位下标链接（没有 shared_ptr/weak_ptr，也就没有原子引用计数）
+// - 内置 FlatIndex 索引(按容量一次分配好)，稳态下 put/get 不做堆分配
+// 本身不加锁，由使用它的缓存负责同步。
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class NodePool {
+public:
+  using Index = std::uint32_t;
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
+
+  struct Slot {
+    Key key{};
+    Value value{};
+    Index prev = kNil;
+    Index next = kNil;
+  };
+
+  // 侵入式双向链表（只记录首尾下标，结点链接存放在槽位中）
+  struct List {
+    Index head = kNil; // 最旧
+    Index tail = kNil; // 最新
+    std::size_t size = 0;
+
+    bool empty() const { return head == kNil; }
+  };
+
+  explicit NodePool(std::size_t capacity)
+      : slots_(capacity), index_(capacity) {
+    assert(capacity < kNil && "NodePool capacity must fit in 32-bit index");
+    // 初始时所有槽位都在 free list 上（复用 next 字段串起来）
+    for (std::size_t i = 0; i < capacity; ++i) {
+      slots_[i].next = (i + 1 < capacity) ? static_cast<Index>(i + 1) : kNil;
+    }
+    freeHead_ = capacity > 0 ? 0 : kNil;
+  }
+
+  std::size_t capacity() const { return slots_.size(); }
+  std::size_t size() const { return size_; }
+  bool full() const { return freeHead_ == kNil; }
+
+  Slot &operator[](Index i) { return slots_[i]; }
+  const Slot &operator[](Index i) const { return slots_[i]; }
+
+  // 查找 key 所在槽位，找不到返回 kNil
+  Index find(const Key &key) const {
+    return index_.find(key, index_.hashOf(key),
+                       [this](Index i) -> const Key & { return slots_[i].key; });
+  }
+
+  // 预取 key 在索引中的第一组(批量查询时提前发起访存)
+  void prefetch(const Key &key) const { index_.prefetch(index_.hashOf(key)); }
+
+  // 索引占用的字节数
+  std::size_t indexBytes() const { return index_.memoryBytes(); }
+
+  // 从 free list 取出一个槽位并登记到索引中；池已满时返回 kNil
+  template <typename K, typename V> Index acquire(K &&key, V &&value) {
+    if (freeHead_ == kNil)
+      return kNil;
+
+    Index i = freeHead_;
+    freeHead_ = slots_[i].next;
+    Slot &slot = slots_[i];
+    slot.key = std::forward<K>(key);
+    slot.value = std::forward<V>(value);
+    slot.prev = slot.next = kNil;
+    linkHash(i);
+    ++size_;
+    return i;
+  }
+
+  // 淘汰时直接复用槽位：摘掉旧 key 的索引，写入新 key/value
+  // (赋值而非重新构造，std::string 等类型可以复用已有缓冲区)
+  template <typename K, typename V>
+  void reassign(Index i, K &&key, V &&value) {
+    unlinkHash(i);
+    Slot &slot = slots_[i];
+    slot.key = std::forward<K>(key);
+    slot.value = std::forward<V>(value);
+    linkHash(i);
+  }
+
+  // 归还槽位（调用方需先将其从所在链表中摘下）
+  void release(Index i) {
+    unlinkHash(i);
+    Slot &slot = slots_[i];
+    slot.value = Value{}; // 不再持有被删除的数据
+    slot.prev = kNil;
+    slot.next = freeHead_;
+    freeHead_ = i;
+    --size_;
+  }
+
+  // ===== 链表操作 =====
+  void pushBack(List &list, Index i) {
+    Slot &slot = slots_[i];
+    slot.prev = list.tail;
+    slot.next = kNil;
+    if (list.tail != kNil)
+      slots_[list.tail].next = i;
+    else
+      list.head = i;
+    list.tail = i;
+    ++list.size;
+  }
+
+  void unlink(List &list, Index i) {
+    Slot &slot = slots_[i];
+    if (slot.prev != kNil)
+      slots_[slot.prev].next = slot.next;
+    else
+      list.head = slot.next;
+    if (slot.next != kNil)
+      slots_[slot.next].prev = slot.prev;
+    else
+      list.tail = slot.prev;
+    slot.prev = slot.next = kNil;
+    --list.size;
+  }
+
+  void moveToBack(List &list, Index i) {
+    if (list.tail == i)
+      return;
+    unlink(list, i);
+    pushBack(list, i);
+  }
+
+private:
+  void linkHash(Index i) {
+    index_.insert(index_.hashOf(slots_[i].key), i, [this](Index j) {
+      return index_.hashOf(slots_[j].key);
+    });
+  }
+
+  void unlinkHash(Index i) { index_.erase(index_.hashOf(slots_[i].key), i); }
+
+private:
+  std::vector<Slot> slots_;
+  FlatIndex<Key, Hash, std::equal_to<>> index_; // key -> 槽位
+  Index freeHead_ = kNil;
+  std::size_t size_ = 0;
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "NumaTopology.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// 按块分配的结点存储：
+// - 结点用 32 位下标引用，配合 FlatIndex 可以不为每个条目单独分配内存
+// - 每块 kChunkSize 个结点，只在用完时追加新块，已分配的结点地址不变
+//   (时间轮的侵入式挂钩、withValue 返回的引用都依赖这一点)
+// - 删除的下标进入 free list 优先复用
+// 本身不加锁，由使用它的缓存负责同步。
+template <typename Node> class NodeSlab {
+public:
+  using Index = std::uint32_t;
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
+
+  NodeSlab() = default;
+  NodeSlab(NodeSlab &&other) noexcept
+      : chunks_(std::move(other.chunks_)), live_(std::move(other.live_)),
+        free_(std::move(other.free_)), end_(std::exchange(other.end_, 0)),
+        size_(std::exchange(other.size_, 0)), homeNode_(other.homeNode_) {}
+  NodeSlab &operator=(NodeSlab &&) = delete;
+
+  ~NodeSlab() { clear(); }
+
+  std::size_t size() const { return size_; }
+
+  Node &operator[](Index i) { return *slot(i); }
+  const Node &operator[](Index i) const { return *slot(i); }
+
+  // 原地构造一个结点并返回下标
+  template <typename... Args> Index create(Args &&...args) {
+    Index i;
+    if (!free_.empty()) {
+      i = free_.back();
+      free_.pop_back();
+    } else {
+      assert(end_ < kNil && "NodeSlab size must fit in 32-bit index");
+      if ((end_ & kChunkMask) == 0) {
+        chunks_.push_back(std::make_unique<Storage[]>(kChunkSize));
+        if (homeNode_ >= 0)
+          bindMemoryToNode(chunks_.back().get(), kChunkBytes, homeNode_);
+      }
+      i = end_++;
+      live_.push_back(false);
+    }
+    ::new (static_cast<void *>(slot(i))) Node(std::forward<Args>(args)...);
+    live_[i] = true;
+    ++size_;
+    return i;
+  }
+
+  // i 处是否存放着结点(读缓冲补访问时用来跳过已删除的下标)
+  bool contains(Index i) const { return i < end_ && live_[i]; }
+
+  void destroy(Index i) {
+    assert(live_[i] && "NodeSlab: double destroy");
+    slot(i)->~Node();
+    live_[i] = false;
+    free_.push_back(i);
+    --size_;
+  }
+
+  // 把已有的块和以后新分配的块放到 NUMA 节点 node 上(node < 0 取消)，
+  // 返回已有的块是否都绑定成功
+  bool setHomeNode(int node) {
+    homeNode_ = node;
+    bool bound = node >= 0;
+    for (const auto &chunk : chunks_) {
+      bound = node >= 0 && bindMemoryToNode(chunk.get(), kChunkBytes, node) &&
+              bound;
+    }
+    return bound;
+  }
+  int homeNode() const { return homeNode_; }
+
+  // 析构所有结点并释放所有块
+  void clear() {
+    for (Index i = 0; i < end_; ++i) {
+      if (live_[i])
+        slot(i)->~Node();
+    }
+    chunks_.clear();
+    live_.clear();
+    free_.clear();
+    end_ = 0;
+    size_ = 0;
+  }
+
+  // 已分配的字节数(结点块 + 存活位图 + free list)
+  std::size_t memoryBytes() const {
+    return chunks_.size() * kChunkSize * sizeof(Storage) + live_.capacity() / 8 +
+           free_.capacity() * sizeof(Index);
+  }
+
+private:
+  static constexpr Index kChunkBits = 10;
+  static constexpr Index kChunkSize = Index{1} << kChunkBits;
+  static constexpr Index kChunkMask = kChunkSize - 1;
+
+  struct alignas(Node) Storage {
+    std::byte bytes[sizeof(Node)];
+  };
+  static constexpr std::size_t kChunkBytes = kChunkSize * sizeof(Storage);
+
+  Node *slot(Index i) const {
+    return std::launder(reinterpret_cast<Node *>(
+        chunks_[i >> kChunkBits][i & kChunkMask].bytes));
+  }
+
+  std::vector<std::unique_ptr<Storage[]>> chunks_;
+  std::vector<bool> live_;   // 下标 -> 是否存放着结点
+  std::vector<Index> free_;  // 可复用的下标
+  Index end_ = 0;            // 已经用过的下标上界
+  std::size_t size_ = 0;
+  int homeNode_ = -1; // 块所在的 NUMA 节点，-1 为不指定
+};
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "CacheStats.h"
+#include "HashUtil.h"
+#include "LruCache.h"
+#include "NumaTopology.h"
+#include "Weigher.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// NumaLruCaches 的两种工作方式
+enum class NumaMode {
+  Partitioned, // 每个 key 只属于一个节点上的一个分片，总容量分给所有分片
+  Replicated,  // 每个节点一份完整副本：读只访问本节点，写同步到所有副本
+};
+
+struct NumaOptions {
+  NumaMode mode = NumaMode::Partitioned;
+  int nodes = 0;          // 节点数，0 为检测到的节点数；多出实际节点的只是逻辑分组
+  int shardsPerNode = 0;  // 每个节点的分片数(向上取整到 2 的幂)，0 为每节点的 CPU 数
+  bool bindMemory = true; // 用 mbind 把分片的结点存储和索引放到所属节点上
+};
+
+// 一个分片放在哪里、被谁访问(见 NumaLruCaches::placement)
+struct ShardPlacement {
+  std::size_t shard = 0;
+  int node = 0;             // 所属节点
+  bool memoryBound = false; // 结点存储与索引是否绑定到了该节点
+  std::size_t capacity = 0;
+  std::size_t size = 0;
+  // 来自同一节点 / 其他节点线程的访问次数(Stats 为 NullStats 时不计数，全为 0)
+  std::uint64_t localAccesses = 0;
+  std::uint64_t remoteAccesses = 0;
+};
+
+// 感知 NUMA 的分片 LRU：分片按节点分组，每组在绑定到该节点 CPU 的线程里构造，
+// 结点存储和索引(包括以后扩容的部分)用 mbind 放在该节点上。
+// - Partitioned：默认按哈希把 key 分到各节点，内存和跨节点流量在节点间均摊；
+//   key 本身带有归属(例如按租户、按连接分给各 socket 的工作线程)时，
+//   传入 affinity(key) -> 节点，这些线程访问的就都是本节点的分片
+// - Replicated：适合很小、读极热的缓存，每个节点一份容量为 capacity 的副本，
+//   get 只访问当前线程所在节点的副本；put / remove 在一把写锁下依次写所有副本，
+//   各副本收到的写入顺序相同，但各自按本节点的访问淘汰，内容可能略有不同
+template <typename Key, typename Value, typename Stats = NullStats,
+          WeigherFor<Key, Value> Weigher = UnitWeigher,
+          typename Hash = std::hash<Key>>
+class NumaLruCaches {
+public:
+  using Shard = LruCache<Key, Value, Stats, Weigher>;
+  using KeyAffinity = std::function<int(const Key &)>;
+
+  NumaLruCaches(std::size_t capacity, NumaOptions options = {},
+                KeyAffinity affinity = nullptr, Weigher weigher = Weigher(),
+                Hash hash = Hash())
+      : capacity_(capacity), mode_(options.mode),
+        affinity_(std::move(affinity)), hash_(std::move(hash)) {
+    const NumaTopology &topology = NumaTopology::system();
+    nodes_ = options.nodes > 0 ? static_cast<std::size_t>(options.nodes)
+                               : topology.nodeCount();
+    const std::size_t perNode =
+        options.shardsPerNode > 0
+            ? static_cast<std::size_t>(options.shardsPerNode)
+            : std::max<std::size_t>(
+                  1, std::max(1u, std::thread::hardware_concurrency()) /
+                         topology.nodeCount());
+    shardsPerNode_ = roundUpPow2(perNode);
+    shardMask_ = shardsPerNode_ - 1;
+
+    const std::size_t groupCapacity =
+        mode_ == NumaMode::Replicated
+            ? capacity
+            : static_cast<std::size_t>(
+                  std::ceil(capacity / static_cast<double>(nodes_)));
+    sliceCapacity_ = static_cast<std::size_t>(
+        std::ceil(groupCapacity / static_cast<double>(shardsPerNode_)));
+
+    slots_.resize(nodes_ * shardsPerNode_);
+    for (std::size_t node = 0; node < nodes_; ++node) {
+      const int physical = node < topology.nodeCount() ? static_cast<int>(node)
+                                                       : -1;
+      const bool bind =
+          options.bindMemory && physical >= 0 && numaBindingSupported();
+      runOnNode(physical, [&] {
+        for (std::size_t j = 0; j < shardsPerNode_; ++j) {
+          auto slot = std::make_unique<Slot>(sliceCapacity_, weigher,
+                                             static_cast<int>(node), bind);
+          if (bind)
+            slot->shard.setHomeNode(physical);
+          slots_[node * shardsPerNode_ + j] = std::move(slot);
+        }
+      });
+    }
+  }
+
+  NumaLruCaches(const NumaLruCaches &) = delete;
+  NumaLruCaches &operator=(const NumaLruCaches &) = delete;
+
+  void put(const Key &key, const Value &value) {
+    write(key, [&](Shard &shard) { shard.put(key, value); });
+  }
+
+  void put(const Key &key, const Value &value, TtlClock::duration ttl) {
+    write(key, [&](Shard &shard) { shard.put(key, value, ttl); });
+  }
+
+  bool get(const Key &key, Value &value) {
+    const std::uint64_t hash = hashOf(key);
+    const int here = localNode();
+    const std::size_t node =
+        mode_ == NumaMode::Replicated ? static_cast<std::size_t>(here)
+                                      : homeNode(key, hash);
+    Slot &slot = slotAt(node, hash);
+    countAccess(slot, here);
+    return slot.shard.get(key, value);
+  }
+
+  Value get(const Key &key) {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  void remove(const Key &key) {
+    write(key, [&](Shard &shard) { shard.remove(key); });
+  }
+
+  // Partitioned 为所有分片的条目数之和；Replicated 为当前节点副本的条目数
+  std::size_t size() const {
+    std::size_t total = 0;
+    const std::size_t here = static_cast<std::size_t>(localNode());
+    for (std::size_t i = 0; i < slots_.size(); ++i) {
+      if (mode_ == NumaMode::Partitioned || i / shardsPerNode_ == here)
+        total += slots_[i]->shard.size();
+    }
+    return total;
+  }
+
+  std::size_t capacity() const { return capacity_; }
+  NumaMode mode() const { return mode_; }
+  std::size_t nodeCount() const { return nodes_; }
+  std::size_t shardsPerNode() const { return shardsPerNode_; }
+
+  // key 所在的分片下标(Replicated 时为当前节点副本中的分片)
+  std::size_t shardIndex(const Key &key) const {
+    const std::uint64_t hash = hashOf(key);
+    const std::size_t node = mode_ == NumaMode::Replicated
+                                 ? static_cast<std::size_t>(localNode())
+                                 : homeNode(key, hash);
+    return node * shardsPerNode_ + (hash & shardMask_);
+  }
+
+  // 每个分片的所属节点、内存是否绑定、条目数与本地 / 远端访问次数
+  std::vector<ShardPlacement> placement() const {
+    std::vector<ShardPlacement> out;
+    out.reserve(slots_.size());
+    for (std::size_t i = 0; i < slots_.size(); ++i) {
+      const Slot &slot = *slots_[i];
+      ShardPlacement p;
+      p.shard = i;
+      p.node = slot.node;
+      p.memoryBound = slot.bound;
+      p.capacity = slot.shard.capacity();
+      p.size = slot.shard.size();
+      p.localAccesses = slot.local.load(std::memory_order_relaxed);
+      p.remoteAccesses = slot.remote.load(std::memory_order_relaxed);
+      out.push_back(p);
+    }
+    return out;
+  }
+
+  // 汇总所有分片(所有副本)的统计
+  CacheStats stats() const {
+    CacheStats total;
+    for (const auto &slot : slots_) {
+      total += slot->shard.stats();
+    }
+    return total;
+  }
+
+private:
+  // 分片与它的访问计数各占独立的缓存行
+  struct alignas(kCacheLineSize) Slot {
+    Slot(std::size_t capacity, const Weigher &weigher, int node, bool bound)
+        : shard(static_cast<std::int64_t>(capacity), weigher), node(node),
+          bound(bound) {}
+    Shard shard;
+    const int node;
+    const bool bound;
+    alignas(kCacheLineSize) std::atomic<std::uint64_t> local{0};
+    std::atomic<std::uint64_t> remote{0};
+  };
+
+  std::uint64_t hashOf(const Key &key) const {
+    return mixHash(static_cast<std::uint64_t>(hash_(key)));
+  }
+
+  // 当前线程所在节点(逻辑节点多于实际节点时取模)
+  int localNode() const {
+    return static_cast<int>(static_cast<std::size_t>(currentNumaNode()) %
+                            nodes_);
+  }
+
+  // Partitioned 时 key 归属的节点：有 affinity 用它，否则取哈希的高位
+  std::size_t homeNode(const Key &key, std::uint64_t hash) const {
+    if (affinity_) {
+      const int node = affinity_(key);
+      return node >= 0 ? static_cast<std::size_t>(node) % nodes_ : 0;
+    }
+    return static_cast<std::size_t>(hash >> 32) % nodes_;
+  }
+
+  Slot &slotAt(std::size_t node, std::uint64_t hash) {
+    return *slots_[node * shardsPerNode_ + (hash & shardMask_)];
+  }
+
+  void countAccess(Slot &slot, int here) {
+    if constexpr (!std::is_same_v<Stats, NullStats>) {
+      (slot.node == here ? slot.local : slot.remote)
+          .fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // Partitioned 只写归属的分片；Replicated 在写锁下按节点顺序写所有副本
+  template <typename Fn> void write(const Key &key, Fn &&fn) {
+    const std::uint64_t hash = hashOf(key);
+    const int here = localNode();
+    if (mode_ == NumaMode::Partitioned) {
+      Slot &slot = slotAt(homeNode(key, hash), hash);
+      countAccess(slot, here);
+      fn(slot.shard);
+      return;
+    }
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    for (std::size_t node = 0; node < nodes_; ++node) {
+      Slot &slot = slotAt(node, hash);
+      countAccess(slot, here);
+      fn(slot.shard);
+    }
+  }
+
+  std::size_t capacity_;      // 总容量(Replicated 时为每个副本的容量)
+  const NumaMode mode_;
+  std::size_t nodes_ = 1;
+  std::size_t shardsPerNode_ = 1;
+  std::size_t shardMask_ = 0;
+  std::size_t sliceCapacity_ = 0; // 每个分片的容量
+  KeyAffinity affinity_;          // key -> 节点，可为空
+  Hash hash_;
+  std::vector<std::unique_ptr<Slot>> slots_; // 节点 i 的分片为 [i * shardsPerNode_, ...)
+  std::mutex writeMutex_;                    // Replicated 时串行化写入
+};
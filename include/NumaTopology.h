@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define CPP_CACHE_NUMA_LINUX 1
+#endif
+
+// NUMA 拓扑与内存放置的最小封装，直接走系统调用，不依赖 libnuma：
+// - 节点与 CPU 的对应关系读自 /sys/devices/system/node，读不到时视为单节点
+// - bindMemoryToNode 用 mbind(MPOL_PREFERRED) 把一段内存放到指定节点
+//   (已经落在别处的页一并迁移)，只作用于区间内完整的页
+// - runOnNode 在绑定到该节点 CPU 的临时线程里执行，构造出来的对象首次触碰在本地
+// 非 Linux 平台上全部退化：单节点、绑定返回 false、runOnNode 直接调用
+class NumaTopology {
+public:
+  // 本进程看到的拓扑(第一次调用时读取)
+  static const NumaTopology &system() {
+    static const NumaTopology topology = detect();
+    return topology;
+  }
+
+  std::size_t nodeCount() const { return cpus_.size(); }
+
+  // 节点上的 CPU 编号
+  const std::vector<int> &cpusOf(std::size_t node) const { return cpus_[node]; }
+
+  // 内核里的节点编号(节点连续编号后可能与之不同)
+  int systemId(std::size_t node) const { return systemIds_[node]; }
+
+  // CPU 所在的节点，未知的 CPU 归到 0 号节点
+  int nodeOfCpu(int cpu) const {
+    return cpu >= 0 && static_cast<std::size_t>(cpu) < nodeOfCpu_.size()
+               ? nodeOfCpu_[static_cast<std::size_t>(cpu)]
+               : 0;
+  }
+
+private:
+  static NumaTopology detect() {
+    NumaTopology topology;
+#if defined(CPP_CACHE_NUMA_LINUX)
+    std::vector<int> nodes = readList("/sys/devices/system/node/online");
+    for (int node : nodes) {
+      std::vector<int> cpus = readList("/sys/devices/system/node/node" +
+                                       std::to_string(node) + "/cpulist");
+      if (cpus.empty())
+        continue; // 只有内存没有 CPU 的节点不参与分片
+      for (int cpu : cpus) {
+        if (static_cast<std::size_t>(cpu) >= topology.nodeOfCpu_.size())
+          topology.nodeOfCpu_.resize(static_cast<std::size_t>(cpu) + 1, 0);
+        topology.nodeOfCpu_[static_cast<std::size_t>(cpu)] =
+            static_cast<int>(topology.cpus_.size());
+      }
+      topology.cpus_.push_back(std::move(cpus));
+      topology.systemIds_.push_back(node);
+    }
+#endif
+    if (topology.cpus_.empty()) {
+      std::vector<int> cpus;
+      const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+      for (unsigned cpu = 0; cpu < n; ++cpu) {
+        cpus.push_back(static_cast<int>(cpu));
+      }
+      topology.cpus_.push_back(std::move(cpus));
+      topology.systemIds_.push_back(0);
+      topology.nodeOfCpu_.clear();
+    }
+    return topology;
+  }
+
+  // 解析 "0-3,8,10-11" 形式的列表
+  static std::vector<int> readList(const std::string &path) {
+    std::vector<int> out;
+    std::ifstream in(path);
+    std::string text;
+    if (!std::getline(in, text))
+      return out;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+      std::size_t end = text.find(',', pos);
+      if (end == std::string::npos)
+        end = text.size();
+      const char *begin = text.data() + pos;
+      const char *stop = text.data() + end;
+      int first = 0;
+      auto [next, ec] = std::from_chars(begin, stop, first);
+      if (ec != std::errc())
+        return {};
+      int last = first;
+      if (next != stop &&
+          (*next != '-' ||
+           std::from_chars(next + 1, stop, last).ec != std::errc()))
+        return {};
+      for (int v = first; v <= last; ++v) {
+        out.push_back(v);
+      }
+      pos = end + 1;
+    }
+    return out;
+  }
+
+  std::vector<std::vector<int>> cpus_; // 节点(连续编号) -> CPU
+  std::vector<int> systemIds_;         // 节点 -> 内核里的节点编号
+  std::vector<int> nodeOfCpu_;         // CPU -> 节点
+};
+
+namespace numa_detail {
+
+struct ThreadNode {
+  int forced = -1;       // ScopedNumaNode 指定的节点
+  int cached = -1;       // 上一次查到的节点
+  std::uint32_t calls = 0;
+};
+
+inline ThreadNode &threadNode() {
+  thread_local ThreadNode state;
+  return state;
+}
+
+} // namespace numa_detail
+
+// 当前线程所在的节点。线程可能被调度到别的 CPU，每 1024 次调用重新查一次
+inline int currentNumaNode() {
+  numa_detail::ThreadNode &state = numa_detail::threadNode();
+  if (state.forced >= 0)
+    return state.forced;
+  const NumaTopology &topology = NumaTopology::system();
+  if (topology.nodeCount() == 1)
+    return 0;
+#if defined(CPP_CACHE_NUMA_LINUX)
+  if (state.cached < 0 || (++state.calls & 1023) == 0)
+    state.cached = topology.nodeOfCpu(::sched_getcpu());
+  return state.cached;
+#else
+  return 0;
+#endif
+}
+
+// 在作用域内把当前线程视为位于 node 上：已经按节点绑好 CPU 的线程池
+// 可以直接声明自己的节点，测试里也可以借此模拟多节点
+class ScopedNumaNode {
+public:
+  explicit ScopedNumaNode(int node)
+      : previous_(std::exchange(numa_detail::threadNode().forced, node)) {}
+  ~ScopedNumaNode() { numa_detail::threadNode().forced = previous_; }
+  ScopedNumaNode(const ScopedNumaNode &) = delete;
+  ScopedNumaNode &operator=(const ScopedNumaNode &) = delete;
+
+private:
+  int previous_;
+};
+
+// 把 [p, p + bytes) 中完整的页优先放到 node 上，成功返回 true。
+// 不足一页、节点不存在或内核不支持(容器里常见)时返回 false，内存照常可用
+inline bool bindMemoryToNode(void *p, std::size_t bytes, int node) {
+#if defined(CPP_CACHE_NUMA_LINUX) && defined(SYS_mbind)
+  const NumaTopology &topology = NumaTopology::system();
+  if (p == nullptr || node < 0 ||
+      static_cast<std::size_t>(node) >= topology.nodeCount())
+    return false;
+  const int systemId = topology.systemId(static_cast<std::size_t>(node));
+  if (systemId >= 64)
+    return false;
+
+  const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+  const auto begin = reinterpret_cast<std::uintptr_t>(p);
+  const std::uintptr_t first = (begin + page - 1) & ~(page - 1);
+  const std::uintptr_t last = (begin + bytes) & ~(page - 1);
+  if (last <= first)
+    return false;
+
+  constexpr int kPreferred = 1; // MPOL_PREFERRED
+  constexpr unsigned kMove = 2; // MPOL_MF_MOVE：迁移已经分配的页
+  unsigned long mask = 1UL << systemId;
+  return ::syscall(SYS_mbind, first, last - first, kPreferred, &mask,
+                   sizeof(mask) * 8, kMove) == 0;
+#else
+  (void)p;
+  (void)bytes;
+  (void)node;
+  return false;
+#endif
+}
+
+// 当前环境能否用 mbind 放置内存(第一次调用时用两页内存试一次)
+inline bool numaBindingSupported() {
+  static const bool supported = [] {
+#if defined(CPP_CACHE_NUMA_LINUX)
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::vector<std::byte> probe(page * 2);
+    return bindMemoryToNode(probe.data(), probe.size(), 0);
+#else
+    return false;
+#endif
+  }();
+  return supported;
+}
+
+// 在绑定到 node 所有 CPU 的临时线程里执行 fn 并等待结束；
+// fn 里分配并初始化的内存按首次触碰落在该节点上。节点不存在时直接调用
+template <typename Fn> void runOnNode(int node, Fn &&fn) {
+#if defined(CPP_CACHE_NUMA_LINUX)
+  const NumaTopology &topology = NumaTopology::system();
+  if (node >= 0 && static_cast<std::size_t>(node) < topology.nodeCount() &&
+      topology.nodeCount() > 1) {
+    std::thread worker([&] {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (int cpu : topology.cpusOf(static_cast<std::size_t>(node))) {
+        if (cpu < CPU_SETSIZE)
+          CPU_SET(cpu, &set);
+      }
+      ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+      ScopedNumaNode scoped(node);
+      fn();
+    });
+    worker.join();
+    return;
+  }
+#endif
+  ScopedNumaNode scoped(node);
+  fn();
+}
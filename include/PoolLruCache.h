@@ -0,0 +1,123 @@
+#pragma once
+
+#include "ICachePolicy.h"
+#include "NodePool.h"
+#include <cstddef>
+#include <mutex>
+#include <span>
+
+// LRU 的池化版本：结点存放在按容量预分配的 NodePool 中，
+// 用 32 位下标组成侵入式链表，淘汰的槽位直接复用。
+// 稳态下的命中和写入都不做堆分配，也没有 shared_ptr 的原子引用计数。
+template <typename Key, typename Value>
+class PoolLruCache : public ICachePolicy<Key, Value> {
+public:
+  using Pool = NodePool<Key, Value>;
+  using Index = typename Pool::Index;
+
+  explicit PoolLruCache(int capacity)
+      : capacity_(capacity > 0 ? static_cast<std::size_t>(capacity) : 0),
+        pool_(capacity_) {}
+
+  ~PoolLruCache() override = default;
+
+  void put(const Key &key, const Value &value) override {
+    if (capacity_ == 0)
+      return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    putLocked(key, value);
+  }
+
+  bool get(const Key &key, Value &value) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Index i = pool_.find(key);
+    if (i == Pool::kNil)
+      return false;
+
+    pool_.moveToBack(list_, i);
+    value = pool_[i].value;
+    return true;
+  }
+
+  Value get(const Key &key) override {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  // 批量查询：整批只加一次锁，并提前预取后面几个 key 的哈希桶
+  std::size_t getMany(std::span<const Key> keys, std::span<Value> values,
+                      std::span<bool> found) override {
+    constexpr std::size_t kPrefetchDistance = 4;
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t hits = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      if (i + kPrefetchDistance < keys.size())
+        pool_.prefetch(keys[i + kPrefetchDistance]);
+
+      Index slot = pool_.find(keys[i]);
+      found[i] = slot != Pool::kNil;
+      if (found[i]) {
+        pool_.moveToBack(list_, slot);
+        values[i] = pool_[slot].value;
+        ++hits;
+      }
+    }
+    return hits;
+  }
+
+  void putMany(std::span<const Key> keys,
+               std::span<const Value> values) override {
+    if (capacity_ == 0)
+      return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      putLocked(keys[i], values[i]);
+    }
+  }
+
+  // 删除指定元素
+  void remove(const Key &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Index i = pool_.find(key);
+    if (i != Pool::kNil) {
+      pool_.unlink(list_, i);
+      pool_.release(i);
+    }
+  }
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pool_.size();
+  }
+
+private:
+  void putLocked(const Key &key, const Value &value) {
+    Index i = pool_.find(key);
+    if (i != Pool::kNil) {
+      // 已存在：更新 value 并刷新为最近访问
+      pool_[i].value = value;
+      pool_.moveToBack(list_, i);
+      return;
+    }
+
+    if (pool_.full()) {
+      // 复用最近最少访问结点的槽位
+      Index victim = list_.head;
+      pool_.unlink(list_, victim);
+      pool_.reassign(victim, key, value);
+      pool_.pushBack(list_, victim);
+      return;
+    }
+
+    i = pool_.acquire(key, value);
+    pool_.pushBack(list_, i);
+  }
+
+  std::size_t capacity_;     // 缓存容量
+  Pool pool_;                // 预分配结点池 + 索引
+  typename Pool::List list_; // head 为最近最少访问，tail 为最近访问
+  mutable std::mutex mutex_;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "HashUtil.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+
+// 有损的条带化读缓冲(参考 Caffeine 的 read buffer)：
+// - 命中时只把结点下标写进当前线程所在条带的小环形缓冲，不改链表/频次结构
+// - 之后持有写锁的线程(下一次写入、清理，或者发现条带已满的读者)批量补上这些访问
+// - 条带满了或与其他线程抢同一个位置失败时，直接丢弃这次记录
+// 淘汰顺序因此只在还没补上的那一小段访问内不精确，每个条带最多 kRingSize 次。
+class ReadBuffer {
+public:
+  using Index = std::uint32_t;
+  static constexpr std::size_t kRingSize = 16; // 2 的幂
+
+  // stripes <= 0 时取硬件线程数(向上取整到 2 的幂)
+  explicit ReadBuffer(int stripes = 0) {
+    const std::size_t want =
+        stripes > 0 ? static_cast<std::size_t>(stripes)
+                    : static_cast<std::size_t>(
+                          std::max(1u, std::thread::hardware_concurrency()));
+    stripeCount_ = roundUpPow2(want);
+    stripes_ = std::make_unique<Stripe[]>(stripeCount_);
+  }
+
+  // 记录一次访问(只要求 i 在持有共享锁时有效)。
+  // 返回 true 表示这个条带已满，调用方应尽快拿写锁 drain
+  bool record(Index i) {
+    Stripe &stripe = stripes_[stripeIndex() & (stripeCount_ - 1)];
+    std::uint64_t head = stripe.head.load(std::memory_order_relaxed);
+    const std::uint64_t tail = stripe.tail.load(std::memory_order_acquire);
+    if (head - tail >= kRingSize)
+      return true;
+    if (!stripe.head.compare_exchange_weak(head, head + 1,
+                                           std::memory_order_relaxed))
+      return false; // 有损：让给抢到位置的线程
+    stripe.slots[head & (kRingSize - 1)].store(i, std::memory_order_release);
+    return head + 1 - tail >= kRingSize;
+  }
+
+  // 按记录顺序对每个缓冲的下标调用 fn(i)。调用方必须持有写锁，
+  // 并自行跳过已经被删除(或被复用)的下标
+  template <typename Fn> void drain(Fn &&fn) {
+    for (std::size_t s = 0; s < stripeCount_; ++s) {
+      Stripe &stripe = stripes_[s];
+      const std::uint64_t head = stripe.head.load(std::memory_order_acquire);
+      std::uint64_t tail = stripe.tail.load(std::memory_order_relaxed);
+      for (; tail < head; ++tail) {
+        auto &slot = stripe.slots[tail & (kRingSize - 1)];
+        const Index i = slot.exchange(kEmpty, std::memory_order_acquire);
+        if (i == kEmpty)
+          break; // 位置已经抢到但下标还没写入，留到下一次
+        fn(i);
+      }
+      stripe.tail.store(tail, std::memory_order_release);
+    }
+  }
+
+  std::size_t stripeCount() const { return stripeCount_; }
+
+private:
+  static constexpr Index kEmpty = std::numeric_limits<Index>::max();
+
+  struct alignas(kCacheLineSize) Stripe {
+    std::atomic<std::uint64_t> head{0}; // 下一个写入位置
+    std::atomic<std::uint64_t> tail{0}; // 下一个待补的位置
+    std::array<std::atomic<Index>, kRingSize> slots;
+
+    Stripe() {
+      for (auto &slot : slots) {
+        slot.store(kEmpty, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  // 线程首次记录时按轮转分配条带
+  static std::size_t stripeIndex() noexcept {
+    static std::atomic<std::size_t> nextThread{0};
+    thread_local const std::size_t index =
+        nextThread.fetch_add(1, std::memory_order_relaxed);
+    return index;
+  }
+
+  std::size_t stripeCount_ = 1;
+  std::unique_ptr<Stripe[]> stripes_;
+};
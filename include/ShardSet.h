@@ -0,0 +1,182 @@
+#pragma once
+
+#include "HashUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+// 分片缓存共用的分片层：
+// - 分片数向上取整到 2 的幂，用掩码代替取模
+// - 分片下标取自混合后的强哈希，顺序整数 key 也能均匀分布
+// - 每个分片单独分配并按缓存行对齐，相邻分片的互斥锁不会伪共享
+template <typename Key, typename Shard, typename Hash = std::hash<Key>>
+class ShardSet {
+public:
+  // sliceNum <= 0 时取硬件线程数；makeShard(sliceCapacity) 按值返回单个分片
+  // (返回的纯右值直接在对齐的存储上构造，分片类型不需要可移动)
+  template <typename Factory>
+  ShardSet(std::size_t capacity, int sliceNum, Factory makeShard,
+           Hash hash = Hash())
+      : hash_(std::move(hash)) {
+    std::size_t want =
+        sliceNum > 0 ? static_cast<std::size_t>(sliceNum)
+                     : static_cast<std::size_t>(
+                           std::max(1u, std::thread::hardware_concurrency()));
+    const std::size_t count = roundUpPow2(want);
+    mask_ = count - 1;
+    sliceCapacity_ = static_cast<std::size_t>(
+        std::ceil(capacity / static_cast<double>(count)));
+
+    shards_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      shards_.emplace_back(
+          std::make_unique<PaddedShard>(makeShard, sliceCapacity_));
+    }
+  }
+
+  std::size_t shardCount() const { return shards_.size(); }
+  std::size_t sliceCapacity() const { return sliceCapacity_; }
+
+  std::size_t shardIndex(const Key &key) const {
+    return static_cast<std::size_t>(
+               mixHash(static_cast<std::uint64_t>(hash_(key)))) &
+           mask_;
+  }
+
+  Shard &shardFor(const Key &key) { return shards_[shardIndex(key)]->shard; }
+  Shard &shard(std::size_t i) { return shards_[i]->shard; }
+  const Shard &shard(std::size_t i) const { return shards_[i]->shard; }
+
+  template <typename Fn> void forEach(Fn &&fn) {
+    for (auto &padded : shards_) {
+      fn(padded->shard);
+    }
+  }
+
+  // 在最多 threads 个线程上并行地对每个分片调用 fn(shard)(threads <= 0 时取硬件线程数)。
+  // 每个分片只在处理它的那一刻加锁，其余分片照常读写
+  template <typename Fn> void forEachParallel(Fn &&fn, int threads = 0) {
+    runParallel(shards_.size(), threads,
+                [&](std::size_t s) { fn(shards_[s]->shard); });
+  }
+
+  // 把一批 key 按分片分组(计数排序)，每个涉及到的分片只回调一次：
+  // fn(shard, positions)，positions 是落在该分片上的 key 在 keys 中的下标
+  template <typename Fn> void forEachGroup(std::span<const Key> keys, Fn &&fn) {
+    const Groups groups =
+        group(keys.size(), [keys](std::size_t i) -> const Key & {
+          return keys[i];
+        });
+    const std::size_t count = shards_.size();
+    for (std::size_t s = 0; s < count; ++s) {
+      const std::span<const std::uint32_t> positions = groups.of(s);
+      if (positions.empty())
+        continue;
+      // 处理当前分片时先把下一个分片(锁所在的缓存行)取进来
+      if (s + 1 < count)
+        prefetchRead(shards_[s + 1].get());
+      fn(shards_[s]->shard, positions);
+    }
+  }
+
+  // forEachGroup 的并行版本(批量导入用)：n 个条目，keyAt(i) 返回第 i 个的 key，
+  // 各分片的 fn(shard, positions) 在最多 threads 个线程上并行执行
+  template <typename KeyAt, typename Fn>
+  void forEachGroupParallel(std::size_t n, KeyAt &&keyAt, Fn &&fn,
+                            int threads = 0) {
+    const Groups groups = group(n, keyAt);
+    runParallel(shards_.size(), threads, [&](std::size_t s) {
+      const std::span<const std::uint32_t> positions = groups.of(s);
+      if (!positions.empty())
+        fn(shards_[s]->shard, positions);
+    });
+  }
+
+  // 各分片当前条目数，用来检查分片是否倾斜
+  std::vector<std::size_t> occupancy() const {
+    std::vector<std::size_t> sizes;
+    sizes.reserve(shards_.size());
+    for (const auto &padded : shards_) {
+      sizes.push_back(padded->shard.size());
+    }
+    return sizes;
+  }
+
+private:
+  // 按分片排好序的条目下标：分片 s 的条目为 order[offsets[s], offsets[s + 1])
+  struct Groups {
+    std::vector<std::uint32_t> order;
+    std::vector<std::uint32_t> offsets;
+
+    std::span<const std::uint32_t> of(std::size_t s) const {
+      return {order.data() + offsets[s], offsets[s + 1] - offsets[s]};
+    }
+  };
+
+  template <typename KeyAt> Groups group(std::size_t n, KeyAt keyAt) const {
+    const std::size_t count = shards_.size();
+    Groups groups;
+    std::vector<std::uint32_t> shardOf(n);
+    groups.offsets.assign(count + 1, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+      shardOf[i] = static_cast<std::uint32_t>(shardIndex(keyAt(i)));
+      ++groups.offsets[shardOf[i] + 1];
+    }
+    for (std::size_t s = 0; s < count; ++s) {
+      groups.offsets[s + 1] += groups.offsets[s];
+    }
+
+    groups.order.resize(n);
+    std::vector<std::uint32_t> cursor(groups.offsets.begin(),
+                                      groups.offsets.end() - 1);
+    for (std::size_t i = 0; i < n; ++i) {
+      groups.order[cursor[shardOf[i]]++] = static_cast<std::uint32_t>(i);
+    }
+    return groups;
+  }
+
+  // task(0 .. tasks - 1)，由调用线程和至多 threads - 1 个临时线程领取执行
+  template <typename Task>
+  static void runParallel(std::size_t tasks, int threads, Task &&task) {
+    std::size_t workers =
+        threads > 0 ? static_cast<std::size_t>(threads)
+                    : static_cast<std::size_t>(
+                          std::max(1u, std::thread::hardware_concurrency()));
+    workers = std::min(workers, tasks);
+    std::atomic<std::size_t> next{0};
+    auto loop = [&] {
+      for (std::size_t s = next.fetch_add(1); s < tasks;
+           s = next.fetch_add(1)) {
+        task(s);
+      }
+    };
+    std::vector<std::thread> pool;
+    for (std::size_t w = 1; w < workers; ++w) {
+      pool.emplace_back(loop);
+    }
+    loop();
+    for (auto &t : pool) {
+      t.join();
+    }
+  }
+
+  // 分片对象本身按缓存行对齐，大小也补齐到缓存行的整数倍
+  struct alignas(kCacheLineSize) PaddedShard {
+    template <typename Factory>
+    PaddedShard(Factory &makeShard, std::size_t sliceCapacity)
+        : shard(makeShard(sliceCapacity)) {}
+    Shard shard;
+  };
+
+  std::vector<std::unique_ptr<PaddedShard>> shards_;
+  std::size_t mask_ = 0;
+  std::size_t sliceCapacity_ = 0;
+  Hash hash_;
+};
@@ -0,0 +1,277 @@
+#pragma once
+
+#include "HashUtil.h"
+#include "TimingWheel.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 同一个 key 的并发加载合并成一次(single-flight)：第一个调用者执行加载，
+// 其余调用者等待同一个 shared_future。缓存的 getOrLoad 用它避免热点 key
+// 过期或被淘汰的瞬间大量请求同时打到后端。
+// 异步加载在自带的后台线程里执行(按需启动，最多 kMaxWorkers 个)，
+// 析构时等待已提交的加载全部完成，所以缓存把它声明为最后一个成员
+template <typename Key, typename Value> class SingleFlight {
+public:
+  using Result = std::optional<Value>; // 加载失败时为空
+  using Future = std::shared_future<Result>;
+
+  static constexpr std::size_t kMaxWorkers = 4;
+
+  SingleFlight() = default;
+  SingleFlight(const SingleFlight &) = delete;
+  SingleFlight &operator=(const SingleFlight &) = delete;
+
+  ~SingleFlight() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    taskCv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join(); // 线程做完队列里剩下的加载才退出
+    }
+  }
+
+  // 在当前线程执行 load()，或等待已在进行的同一个 key 的加载。
+  // load 抛出的异常会原样传给所有等待者
+  template <typename Load> Result run(const Key &key, Load &&load) {
+    std::promise<Result> promise;
+    Future future;
+    if (join(key, promise, future))
+      complete(key, promise, load);
+    return future.get();
+  }
+
+  // 同上，但 load 交给后台线程执行，立即返回 future。
+  // 已有同一个 key 的加载时不提交，直接返回它的 future；
+  // 后台线程都在忙时排队等待
+  template <typename Load> Future runAsync(const Key &key, Load load) {
+    std::promise<Result> promise;
+    Future future;
+    if (join(key, promise, future))
+      submit(key, std::move(promise), std::move(load));
+    return future;
+  }
+
+  // 等待已提交的后台加载全部完成
+  void drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCv_.wait(lock, [this] { return tasks_.empty() && running_ == 0; });
+  }
+
+  // 正在进行的加载数
+  std::size_t inflight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return calls_.size();
+  }
+
+  // 已完成的加载数。调用者查缓存前记下它，成为加载者时如果变了，
+  // 说明其间有加载写回过缓存，值得再查一次
+  std::uint64_t epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+private:
+  // 已有同一个 key 的加载时取到它的 future 并返回 false；否则登记新的加载
+  bool join(const Key &key, std::promise<Result> &promise, Future &future) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = calls_.find(key);
+    if (it != calls_.end()) {
+      future = it->second;
+      return false;
+    }
+    future = promise.get_future().share();
+    calls_.emplace(key, future);
+    return true;
+  }
+
+  // 先交付结果再注销：注销前到达的调用者直接拿到已就绪的 future，
+  // 不会在结果已写回缓存之后又发起一次加载
+  template <typename Load>
+  void complete(const Key &key, std::promise<Result> &promise, Load &load) {
+    Result result;
+    std::exception_ptr error;
+    try {
+      result = load();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    if (error)
+      promise.set_exception(error);
+    else
+      promise.set_value(std::move(result));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    calls_.erase(key);
+    epoch_.fetch_add(1, std::memory_order_release);
+  }
+
+  // std::function 要求可拷贝，promise 和 load 放在 shared_ptr 里
+  template <typename Load>
+  void submit(const Key &key, std::promise<Result> promise, Load load) {
+    auto call = std::make_shared<std::pair<std::promise<Result>, Load>>(
+        std::move(promise), std::move(load));
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.emplace_back(
+        [this, key, call] { complete(key, call->first, call->second); });
+    if (tasks_.size() > idle_ && workers_.size() < kMaxWorkers)
+      workers_.emplace_back([this] { work(); });
+    else
+      taskCv_.notify_one();
+  }
+
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      ++idle_;
+      taskCv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      --idle_;
+      if (tasks_.empty())
+        return; // 要退出且队列已空
+      std::function<void()> task = std::move(tasks_.front());
+      tasks_.pop_front();
+      ++running_;
+      lock.unlock();
+      task();
+      task = nullptr; // 在锁外释放 loader 持有的资源
+      lock.lock();
+      --running_;
+      if (running_ == 0 && tasks_.empty())
+        idleCv_.notify_all();
+    }
+  }
+
+  mutable std::mutex mutex_;
+  std::unordered_map<Key, Future, TransparentHash<Key>, TransparentEqual>
+      calls_; // key -> 正在进行的加载
+  std::atomic<std::uint64_t> epoch_{0};
+
+  std::deque<std::function<void()>> tasks_; // 等待后台线程执行的加载
+  std::vector<std::thread> workers_;
+  std::condition_variable taskCv_; // 有新加载或要退出
+  std::condition_variable idleCv_; // 队列清空且没有加载在执行
+  std::size_t idle_ = 0;    // 空闲的后台线程数
+  std::size_t running_ = 0; // 正在执行的后台加载数
+  bool stop_ = false;
+};
+
+// getOrLoad 的选项
+struct LoadOptions {
+  // 加载结果写回缓存时的 ttl，0 表示不过期(不支持 ttl 的缓存忽略)
+  TtlClock::duration ttl{};
+  // 命中的条目剩余 ttl 不超过它时先返回当前值，同时在后台重新加载(refresh-ahead)，
+  // 热点 key 不会等到过期才让读者阻塞在后端上。0 表示不提前刷新
+  TtlClock::duration refreshAhead{};
+};
+
+// 以下是各缓存 getOrLoad 的共同实现。loader 的形式为
+//   bool loader(const Key &key, Value &value);
+// 返回 false 表示后端也没有该 key，此时不写缓存，getOrLoad 返回 false。
+// 后台加载(异步版本和 refresh-ahead)在缓存自己的 SingleFlight 里执行，
+// 缓存析构时等它们完成。
+
+// 调用 loader 并把结果写回缓存
+template <typename Value, typename Cache, typename Key, typename Loader>
+std::optional<Value> loadAndStore(Cache &cache, const Key &key, Loader &loader,
+                                  const LoadOptions &options) {
+  Value value{};
+  if (!loader(key, value))
+    return std::nullopt;
+  if constexpr (requires { cache.put(key, value, options.ttl); }) {
+    if (options.ttl > TtlClock::duration::zero()) {
+      cache.put(key, value, options.ttl);
+      return value;
+    }
+  }
+  cache.put(key, value);
+  return value;
+}
+
+// 成为加载者后调用：查缓存之后若有加载完成过(epoch 变了)，它可能正好
+// 写回了这个 key，先再查一次缓存，命中就不必再打后端。
+// 缓存提供 probe(key, value) 时用它再查：这次查找属于同一次访问，
+// 不该再算一次(例如 LruKCache 的访问历史)
+template <typename Value, typename Cache, typename Key, typename Loader>
+std::optional<Value> probeOrLoad(Cache &cache,
+                                 const SingleFlight<Key, Value> &flight,
+                                 std::uint64_t seen, const Key &key,
+                                 Loader &loader, const LoadOptions &options) {
+  if (flight.epoch() != seen) {
+    Value value{};
+    bool hit = false;
+    if constexpr (requires { cache.probe(key, value); })
+      hit = cache.probe(key, value);
+    else
+      hit = cache.get(key, value);
+    if (hit)
+      return value;
+  }
+  return loadAndStore<Value>(cache, key, loader, options);
+}
+
+// 查缓存；命中且快要过期时顺带发起一次后台刷新
+template <typename Cache, typename Key, typename Value, typename Loader>
+bool lookupOrRefresh(Cache &cache, SingleFlight<Key, Value> &flight,
+                     const Key &key, Value &value, const Loader &loader,
+                     const LoadOptions &options) {
+  if constexpr (requires(TtlClock::duration &ttl) {
+                  cache.get(key, value, ttl);
+                }) {
+    if (options.refreshAhead > TtlClock::duration::zero()) {
+      TtlClock::duration ttl{};
+      if (!cache.get(key, value, ttl))
+        return false;
+      if (ttl > TtlClock::duration::zero() && ttl <= options.refreshAhead) {
+        flight.runAsync(key, [&cache, key, loader, options]() mutable {
+          return loadAndStore<Value>(cache, key, loader, options);
+        });
+      }
+      return true;
+    }
+  }
+  return cache.get(key, value);
+}
+
+template <typename Cache, typename Key, typename Value, typename Loader>
+bool loadThrough(Cache &cache, SingleFlight<Key, Value> &flight,
+                 const Key &key, Value &value, Loader &loader,
+                 const LoadOptions &options) {
+  const std::uint64_t seen = flight.epoch();
+  if (lookupOrRefresh(cache, flight, key, value, loader, options))
+    return true;
+
+  auto result = flight.run(key, [&] {
+    return probeOrLoad<Value>(cache, flight, seen, key, loader, options);
+  });
+  if (!result)
+    return false;
+  value = std::move(*result);
+  return true;
+}
+
+template <typename Cache, typename Key, typename Value, typename Loader>
+typename SingleFlight<Key, Value>::Future
+loadThroughAsync(Cache &cache, SingleFlight<Key, Value> &flight,
+                 const Key &key, Loader loader, const LoadOptions &options) {
+  const std::uint64_t seen = flight.epoch();
+  Value value{};
+  if (lookupOrRefresh(cache, flight, key, value, loader, options)) {
+    std::promise<std::optional<Value>> hit;
+    hit.set_value(std::move(value));
+    return hit.get_future().share();
+  }
+  return flight.runAsync(key, [&cache, &flight, seen, key,
+                               loader = std::move(loader), options]() mutable {
+    return probeOrLoad<Value>(cache, flight, seen, key, loader, options);
+  });
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "CacheStats.h"
+#include "FlatIndex.h"
+#include "ICachePolicy.h"
+#include "NodeSlab.h"
+#include "arc/ArcGhost.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+// 分段 LRU(SLRU)，外加 2Q 的 A1out 幽灵队列：
+// - 新 key 进入试用段(probation)，在试用段里再被访问一次才晋升到保护段(protected)
+// - 保护段超过 protectedRatio * capacity 时，最久未访问的结点降回试用段的最新端
+// - 淘汰总是先从试用段最旧的一端开始，被淘汰 key 的指纹记入 A1out
+// - 写入时命中 A1out(最近刚被淘汰过又回来了)直接进保护段
+// 一次性扫描只会冲刷试用段，保护段里的热点不受影响。
+// 两个分段共用一个 NodeSlab 和一个 FlatIndex，结点结构与 LruCache 相同，
+// 每次操作只加一次锁、查一次索引，开销接近普通 LRU
+template <typename Key, typename Value, typename Stats = NullStats>
+class SlruCache : public ICachePolicy<Key, Value> {
+public:
+  // protectedRatio：保护段最多占的容量比例；
+  // ghostRatio：A1out 最多记住的 key 数相对于 capacity 的比例(0 表示不用 A1out)
+  explicit SlruCache(std::int64_t capacity, double protectedRatio = 0.8,
+                     double ghostRatio = 0.5)
+      : capacity_(capacity > 0 ? static_cast<std::size_t>(capacity) : 0),
+        protectedCapacity_(static_cast<std::size_t>(
+            static_cast<double>(capacity_) *
+            std::clamp(protectedRatio, 0.0, 1.0))),
+        ghostCapacity_(static_cast<std::size_t>(
+            static_cast<double>(capacity_) * std::max(ghostRatio, 0.0))) {}
+
+  ~SlruCache() override = default;
+
+  void put(const Key &key, const Value &value) override {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    putLocked(key, value);
+  }
+
+  // 右值版本：key/value 直接移动进结点
+  void put(Key &&key, Value &&value) {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    putLocked(std::move(key), std::move(value));
+  }
+
+  bool get(const Key &key, Value &value) override {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    const Index i = find(key, index_.hashOf(key));
+    stats_.record(i != kNil ? CacheCounter::Hit : CacheCounter::Miss);
+    if (i == kNil)
+      return false;
+
+    touch(i);
+    value = nodes_[i].value_;
+    return true;
+  }
+
+  Value get(const Key &key) override {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  // 删除指定元素(不记入 A1out)
+  void remove(const Key &key) {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    const std::uint64_t hash = index_.hashOf(key);
+    const Index i = find(key, hash);
+    if (i != kNil)
+      erase(i, hash);
+  }
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nodes_.size();
+  }
+
+  std::size_t capacity() const { return capacity_; }
+
+  // 两个分段当前的条目数，以及 A1out 记住的 key 数
+  std::size_t probationSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return probation_.size;
+  }
+
+  std::size_t protectedSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return protected_.size;
+  }
+
+  std::size_t ghostSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ghost_.size();
+  }
+
+  // 结点存储、索引与 A1out 占用的字节数(不含 key/value 自己在堆上的部分)
+  std::size_t memoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nodes_.memoryBytes() + index_.memoryBytes() + ghost_.memoryBytes();
+  }
+
+  // 统计快照(Stats 为 NullStats 时全为 0)
+  CacheStats stats() const { return stats_.snapshot(); }
+
+private:
+  using Index = std::uint32_t;
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
+
+  struct Node {
+    Key key_;
+    Value value_;
+    Index prev_ = kNil;       // 更旧的一侧
+    Index next_ = kNil;       // 更新的一侧
+    bool protected_ = false;  // 所在分段
+
+    template <typename K, typename V>
+    Node(K &&key, V &&value)
+        : key_(std::forward<K>(key)), value_(std::forward<V>(value)) {}
+  };
+
+  // 一个分段：侵入式双向链表，oldest 一端淘汰
+  struct Segment {
+    Index oldest = kNil;
+    Index newest = kNil;
+    std::size_t size = 0;
+  };
+
+  // 以下方法要求调用方已持有 mutex_
+  template <typename K, typename V> void putLocked(K &&key, V &&value) {
+    const std::uint64_t hash = index_.hashOf(key);
+    Index i = find(key, hash);
+    if (i != kNil) {
+      nodes_[i].value_ = std::forward<V>(value);
+      touch(i);
+      return;
+    }
+
+    if (nodes_.size() >= capacity_)
+      evict();
+
+    std::size_t weight = 0;
+    const bool returning = ghost_.take(hash, weight);
+    if (returning)
+      stats_.record(CacheCounter::GhostHit);
+
+    i = nodes_.create(std::forward<K>(key), std::forward<V>(value));
+    index_.insert(hash, i, [this](Index j) {
+      return index_.hashOf(nodes_[j].key_);
+    });
+    stats_.record(CacheCounter::Insert);
+    if (returning && protectedCapacity_ > 0) {
+      pushNewest(protected_, i, true);
+      demoteOverflow();
+    } else {
+      pushNewest(probation_, i, false);
+    }
+  }
+
+  // 命中：试用段的结点晋升到保护段，保护段的结点移到最新端
+  void touch(Index i) {
+    Node &node = nodes_[i];
+    if (node.protected_) {
+      unlink(protected_, i);
+      pushNewest(protected_, i, true);
+      return;
+    }
+
+    unlink(probation_, i);
+    if (protectedCapacity_ == 0) { // 没有保护段时退化为普通 LRU
+      pushNewest(probation_, i, false);
+      return;
+    }
+    pushNewest(protected_, i, true);
+    stats_.record(CacheCounter::Promotion);
+    demoteOverflow();
+  }
+
+  // 保护段超出容量时，把最久未访问的结点降回试用段的最新端
+  void demoteOverflow() {
+    while (protected_.size > protectedCapacity_) {
+      const Index j = protected_.oldest;
+      unlink(protected_, j);
+      pushNewest(probation_, j, false);
+    }
+  }
+
+  // 先淘汰试用段最旧的结点(试用段为空时才动保护段)，并把它的指纹记入 A1out
+  void evict() {
+    const Index victim =
+        probation_.oldest != kNil ? probation_.oldest : protected_.oldest;
+    if (victim == kNil)
+      return;
+
+    const std::uint64_t hash = index_.hashOf(nodes_[victim].key_);
+    erase(victim, hash);
+    stats_.record(CacheCounter::Eviction);
+    if (ghostCapacity_ == 0)
+      return;
+    while (ghost_.size() >= ghostCapacity_) {
+      ghost_.popOldest();
+    }
+    ghost_.push(hash, 1);
+  }
+
+  void erase(Index i, std::uint64_t hash) {
+    index_.erase(hash, i);
+    unlink(nodes_[i].protected_ ? protected_ : probation_, i);
+    nodes_.destroy(i);
+  }
+
+  template <typename K> Index find(const K &key, std::uint64_t hash) const {
+    return index_.find(key, hash,
+                       [this](Index i) -> const Key & { return nodes_[i].key_; });
+  }
+
+  void unlink(Segment &segment, Index i) {
+    Node &node = nodes_[i];
+    if (node.prev_ != kNil)
+      nodes_[node.prev_].next_ = node.next_;
+    else
+      segment.oldest = node.next_;
+    if (node.next_ != kNil)
+      nodes_[node.next_].prev_ = node.prev_;
+    else
+      segment.newest = node.prev_;
+    node.prev_ = node.next_ = kNil;
+    --segment.size;
+  }
+
+  void pushNewest(Segment &segment, Index i, bool isProtected) {
+    Node &node = nodes_[i];
+    node.protected_ = isProtected;
+    node.prev_ = segment.newest;
+    node.next_ = kNil;
+    if (segment.newest != kNil)
+      nodes_[segment.newest].next_ = i;
+    else
+      segment.oldest = i;
+    segment.newest = i;
+    ++segment.size;
+  }
+
+  std::size_t capacity_;
+  std::size_t protectedCapacity_; // 保护段最多的条目数
+  std::size_t ghostCapacity_;     // A1out 最多记住的 key 数
+  NodeSlab<Node> nodes_;
+  FlatIndex<Key> index_; // key -> 结点下标
+  Segment probation_;    // 试用段(2Q 的 A1in)
+  Segment protected_;    // 保护段(2Q 的 Am)
+  ArcGhostList<> ghost_; // A1out：最近被淘汰的 key 指纹
+  mutable std::mutex mutex_;
+  mutable Stats stats_;
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "HashUtil.h"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// 缓存快照的编解码(文件读写见 SnapshotFile.h)。
+// 快照按本机字节序和对齐方式写出，只保证同一平台、同一份代码构建的进程之间可以互相加载。
+
+// 快照里记录的淘汰策略，加载时必须与目标缓存一致
+enum class SnapshotPolicy : std::uint32_t { Lru = 1, Lfu = 2, Arc = 3 };
+
+class SnapshotWriter;
+class SnapshotReader;
+
+// key / value 的编解码方式：可平凡复制的类型按字节拷贝，std::string 写长度 + 内容。
+// 其他类型可以特化 SnapshotCodec<T>，提供
+//   static void encode(SnapshotWriter &, const T &);
+//   static bool decode(SnapshotReader &, T &);
+template <typename T, typename = void> struct SnapshotCodec;
+
+template <typename T>
+concept SnapshotEncodable = requires(SnapshotWriter &w, SnapshotReader &r,
+                                     const T &in, T &out) {
+  SnapshotCodec<T>::encode(w, in);
+  { SnapshotCodec<T>::decode(r, out) } -> std::convertible_to<bool>;
+};
+
+// 追加写入的字节缓冲。一个分片的内容先在锁内编码到这里，解锁后再写文件
+class SnapshotWriter {
+public:
+  void clear() { buffer_.clear(); }
+  std::size_t size() const { return buffer_.size(); }
+  const char *data() const { return buffer_.data(); }
+
+  void bytes(const void *p, std::size_t n) {
+    buffer_.append(static_cast<const char *>(p), n);
+  }
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void raw(const T &v) {
+    bytes(&v, sizeof(T));
+  }
+
+  void u64(std::uint64_t v) { raw(v); }
+
+  // 回填之前在 offset 处占位写下的 u64(例如写完才知道的条目数)
+  void patch(std::size_t offset, std::uint64_t v) {
+    std::memcpy(buffer_.data() + offset, &v, sizeof(v));
+  }
+
+  template <SnapshotEncodable T> void value(const T &v) {
+    SnapshotCodec<T>::encode(*this, v);
+  }
+
+private:
+  std::string buffer_;
+};
+
+// 在一段只读内存(通常是 mmap 的快照文件)上顺序解码，越界时返回 false 并保持失败状态
+class SnapshotReader {
+public:
+  SnapshotReader(const char *data, std::size_t size)
+      : pos_(data), end_(data + size) {}
+
+  bool ok() const { return ok_; }
+  std::size_t remaining() const { return static_cast<std::size_t>(end_ - pos_); }
+
+  // 取出接下来的 n 个字节(不拷贝)
+  bool view(std::size_t n, std::string_view &out) {
+    if (!ok_ || remaining() < n)
+      return ok_ = false;
+    out = std::string_view(pos_, n);
+    pos_ += n;
+    return true;
+  }
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  bool raw(T &v) {
+    std::string_view bytes;
+    if (!view(sizeof(T), bytes))
+      return false;
+    std::memcpy(&v, bytes.data(), sizeof(T));
+    return true;
+  }
+
+  bool u64(std::uint64_t &v) { return raw(v); }
+
+  template <SnapshotEncodable T> bool value(T &v) {
+    return ok_ && SnapshotCodec<T>::decode(*this, v) ? true : (ok_ = false);
+  }
+
+private:
+  const char *pos_;
+  const char *end_;
+  bool ok_ = true;
+};
+
+template <typename T>
+struct SnapshotCodec<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+  static void encode(SnapshotWriter &w, const T &v) { w.raw(v); }
+  static bool decode(SnapshotReader &r, T &v) { return r.raw(v); }
+};
+
+template <> struct SnapshotCodec<std::string> {
+  static void encode(SnapshotWriter &w, const std::string &v) {
+    w.u64(v.size());
+    w.bytes(v.data(), v.size());
+  }
+  static bool decode(SnapshotReader &r, std::string &v) {
+    std::uint64_t n = 0;
+    std::string_view bytes;
+    if (!r.u64(n) || !r.view(static_cast<std::size_t>(n), bytes))
+      return false;
+    v.assign(bytes);
+    return true;
+  }
+};
+
+// 快照里一段内容的校验和：按 8 字节一组混合，加载时先校验再恢复
+inline std::uint64_t snapshotChecksum(const char *data, std::size_t n) {
+  std::uint64_t h = n;
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, data + i, 8);
+    h = mixHash(h ^ word);
+  }
+  std::uint64_t tail = 0;
+  if (i < n)
+    std::memcpy(&tail, data + i, n - i);
+  return mixHash(h ^ tail);
+}
+
+// 每段开头记录 key / value 的大小，加载到类型不同的缓存时尽早失败
+template <typename Key, typename Value>
+void writeSnapshotTypes(SnapshotWriter &out) {
+  out.u64(std::uint64_t{sizeof(Key)} << 32 | sizeof(Value));
+}
+
+template <typename Key, typename Value>
+bool checkSnapshotTypes(SnapshotReader &in) {
+  std::uint64_t sizes = 0;
+  return in.u64(sizes) &&
+         sizes == (std::uint64_t{sizeof(Key)} << 32 | sizeof(Value));
+}
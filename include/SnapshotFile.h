@@ -0,0 +1,123 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "Snapshot.h"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// 快照文件(版本 1)：
+//   文件头  8 字节 magic | u32 版本 | u32 淘汰策略 | u64 段数
+//   每一段  u64 字节数 | u64 校验和 | 内容(由缓存的 writeSnapshotSection 写出)
+// 单个缓存只有一段；分片缓存每个分片一段，加载时分片数必须相同。
+//
+// 写入时逐段在该分片的锁内编码到内存，解锁后再写文件，同一时刻最多阻塞一个分片；
+// 先写到 path + ".tmp" 再改名，写到一半的文件不会覆盖上一份快照。
+// 加载时整个文件 mmap 进来，先校验所有段，再由缓存在一次加锁内直接建好结点，
+// 不经过 put，也不会触发淘汰。
+
+inline constexpr std::uint32_t kSnapshotVersion = 1;
+inline constexpr char kSnapshotMagic[8] = {'C', 'P', 'P', 'C',
+                                           'S', 'N', 'A', 'P'};
+
+template <typename Cache>
+concept SnapshotCapable =
+    requires(const Cache &c, Cache &m, std::size_t i, SnapshotWriter &w,
+             SnapshotReader &r) {
+      { Cache::kSnapshotPolicy } -> std::convertible_to<SnapshotPolicy>;
+      { c.snapshotSections() } -> std::convertible_to<std::size_t>;
+      c.writeSnapshotSection(i, w);
+      { m.restoreSnapshotSection(i, r) } -> std::convertible_to<bool>;
+    };
+
+// 把 cache 的内容写到 path，成功返回 true
+template <SnapshotCapable Cache>
+bool saveSnapshot(const Cache &cache, const std::string &path) {
+  const std::string tmp = path + ".tmp";
+  std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+  if (!out)
+    return false;
+
+  const std::uint32_t version = kSnapshotVersion;
+  const auto policy = static_cast<std::uint32_t>(Cache::kSnapshotPolicy);
+  const std::uint64_t sections = cache.snapshotSections();
+  out.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+  out.write(reinterpret_cast<const char *>(&version), sizeof(version));
+  out.write(reinterpret_cast<const char *>(&policy), sizeof(policy));
+  out.write(reinterpret_cast<const char *>(&sections), sizeof(sections));
+
+  SnapshotWriter section; // 各段复用同一块缓冲
+  for (std::size_t i = 0; i < sections; ++i) {
+    section.clear();
+    cache.writeSnapshotSection(i, section);
+    const std::uint64_t size = section.size();
+    const std::uint64_t checksum =
+        snapshotChecksum(section.data(), section.size());
+    out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+    out.write(section.data(), static_cast<std::streamsize>(section.size()));
+  }
+
+  out.close();
+  if (!out || std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+// 在后台线程里写快照，不阻塞调用方。完成前 cache 必须一直有效
+template <SnapshotCapable Cache>
+std::future<bool> saveSnapshotAsync(const Cache &cache, std::string path) {
+  return std::async(std::launch::async, [&cache, path = std::move(path)] {
+    return saveSnapshot(cache, path);
+  });
+}
+
+// 从 path 恢复到一个空缓存。文件不存在、格式/版本/策略/分片数不符或校验失败时
+// 返回 false 且不修改 cache；某个分片不为空时跳过该段并返回 false。
+// 快照内容超出 cache 的容量时只恢复最值得保留的那部分(由各策略决定)
+template <SnapshotCapable Cache>
+bool loadSnapshot(Cache &cache, const std::string &path) {
+  MappedFile file;
+  if (!file.open(path))
+    return false;
+
+  SnapshotReader in(file.data(), file.size());
+  std::string_view magic;
+  std::uint32_t version = 0, policy = 0;
+  std::uint64_t sections = 0;
+  if (!in.view(sizeof(kSnapshotMagic), magic) || !in.raw(version) ||
+      !in.raw(policy) || !in.u64(sections))
+    return false;
+  if (std::memcmp(magic.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+      version != kSnapshotVersion ||
+      policy != static_cast<std::uint32_t>(Cache::kSnapshotPolicy) ||
+      sections != cache.snapshotSections())
+    return false;
+
+  // 先校验所有段，损坏的文件不会恢复出半份内容
+  std::vector<std::string_view> bodies(static_cast<std::size_t>(sections));
+  for (auto &body : bodies) {
+    std::uint64_t size = 0, checksum = 0;
+    if (!in.u64(size) || !in.u64(checksum) ||
+        !in.view(static_cast<std::size_t>(size), body) ||
+        snapshotChecksum(body.data(), body.size()) != checksum)
+      return false;
+  }
+
+  bool restored = true;
+  for (std::size_t i = 0; i < bodies.size(); ++i) {
+    SnapshotReader section(bodies[i].data(), bodies[i].size());
+    restored = cache.restoreSnapshotSection(i, section) && restored;
+  }
+  return restored;
+}
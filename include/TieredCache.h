@@ -0,0 +1,69 @@
+#pragma once
+
+#include "FlashTier.h"
+#include "ICachePolicy.h"
+#include <concepts>
+#include <utility>
+
+// 可以作为 TieredCache 内存层的缓存：提供 put/get 和容量淘汰回调
+// (LruCache、LfuCache、ArcCache 及对应的 KHash* 分片版本)
+template <typename Memory, typename Key, typename Value>
+concept EvictionSource =
+    requires(Memory &m, const Key &key, const Value &in, Value &out,
+             EvictionListener<Key, Value> listener) {
+      m.put(key, in);
+      { m.get(key, out) } -> std::convertible_to<bool>;
+      m.setEvictionListener(listener);
+    };
+
+// 内存 + 闪存两级缓存：
+// - 内存层按自己的策略淘汰，被淘汰的条目经回调写进 FlashTier(只排队，不等磁盘)
+// - 内存未命中时查闪存层，命中则从闪存摘下并回填到内存层
+// - 闪存层的读在内存层的锁外进行，读盘期间其他 key 的内存访问不受影响
+// 同一个 key 的 put 与未命中回填并发时，回填可能用旧值覆盖新值(与 getOrLoad 相同)
+template <typename Key, typename Value, typename Memory>
+  requires EvictionSource<Memory, Key, Value>
+class TieredCache : public ICachePolicy<Key, Value> {
+public:
+  // memoryArgs 原样转给内存层的构造函数
+  template <typename... Args>
+  explicit TieredCache(FlashOptions flashOptions, Args &&...memoryArgs)
+      : flash_(std::move(flashOptions)),
+        memory_(std::forward<Args>(memoryArgs)...) {
+    memory_.setEvictionListener(
+        [this](const Key &key, const Value &value) { flash_.put(key, value); });
+  }
+
+  ~TieredCache() override { memory_.setEvictionListener(nullptr); }
+
+  // 写入内存层；闪存里的旧值先作废。顺序不能反过来：写入内存之后、作废之前，
+  // 这个 key 可能已经被其他线程的写入挤到闪存，那份才是新值
+  void put(const Key &key, const Value &value) override {
+    flash_.erase(key);
+    memory_.put(key, value);
+  }
+
+  bool get(const Key &key, Value &value) override {
+    if (memory_.get(key, value))
+      return true;
+    if (!flash_.take(key, value))
+      return false;
+    memory_.put(key, value); // 回填，可能把别的条目挤到闪存
+    return true;
+  }
+
+  Value get(const Key &key) override {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  Memory &memory() { return memory_; }
+  const Memory &memory() const { return memory_; }
+  FlashTier<Key, Value> &flash() { return flash_; }
+  const FlashTier<Key, Value> &flash() const { return flash_; }
+
+private:
+  FlashTier<Key, Value> flash_; // 先于内存层构造、后于内存层析构
+  Memory memory_;
+};
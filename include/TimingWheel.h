@@ -0,0 +1,346 @@
+#pragma once
+
+#include "NodeSlab.h"
+#include <array>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// 过期时间用单调时钟，不受系统时间调整影响
+using TtlClock = std::chrono::steady_clock;
+
+// 侵入式定时器挂钩：调度/取消只改链接，不分配内存
+template <typename Owner> struct TimerNode {
+  Owner *owner = nullptr;
+  TimerNode *prev = nullptr;
+  TimerNode *next = nullptr;
+  std::uint64_t expireTick = 0;
+  std::uint8_t level = 0;
+  std::uint8_t slot = 0;
+  bool linked = false;
+};
+
+// 分层时间轮：4 层 x 64 个槽位，每层一格是下一层一整圈，
+// 以 1 个 tick 为粒度覆盖 64^4 个 tick，更远的定时器先放在最高层最远的槽位，
+// 转到时再重新计算位置。
+// - schedule / cancel 都是 O(1)
+// - advance 只在槽位边界把上层槽位里的定时器下放，每个定时器最多下放 4 次，
+//   到期回调均摊 O(1)；每层用一个 64 位图记录非空槽位，空闲时段直接跳过
+// 本身不加锁，由使用它的缓存负责同步。
+template <typename Owner> class TimingWheel {
+public:
+  using Node = TimerNode<Owner>;
+
+  explicit TimingWheel(TtlClock::duration tick = std::chrono::milliseconds(1))
+      : tick_(tick > TtlClock::duration::zero() ? tick : TtlClock::duration(1)),
+        epoch_(TtlClock::now()) {}
+
+  TimingWheel(const TimingWheel &) = delete;
+  TimingWheel &operator=(const TimingWheel &) = delete;
+
+  bool empty() const { return size_ == 0; }
+  std::size_t size() const { return size_; }
+
+  // 当前时刻对应的 tick
+  std::uint64_t nowTick() const {
+    return static_cast<std::uint64_t>((TtlClock::now() - epoch_) / tick_);
+  }
+
+  // ttl 之后到期的 tick(向上取整，保证不会早于 ttl 过期)
+  std::uint64_t expireTickAfter(TtlClock::duration ttl) const {
+    const auto at = TtlClock::now() - epoch_ + ttl;
+    const auto ticks = (at + tick_ - TtlClock::duration(1)) / tick_;
+    return static_cast<std::uint64_t>(ticks > 0 ? ticks : 0);
+  }
+
+  // 安排(或重新安排)node 在 expireTick 到期；已经到期的放到下一个 tick
+  void schedule(Node &node, std::uint64_t expireTick) {
+    if (node.linked)
+      unlink(node);
+    else
+      ++size_;
+    node.expireTick = expireTick;
+    insert(node);
+  }
+
+  void cancel(Node &node) {
+    if (!node.linked)
+      return;
+    unlink(node);
+    --size_;
+  }
+
+  // 距离到期还剩多久(已到期为 0)
+  TtlClock::duration remaining(const Node &node) const {
+    const std::uint64_t now = nowTick();
+    return node.expireTick > now
+               ? tick_ * static_cast<TtlClock::rep>(node.expireTick - now)
+               : TtlClock::duration::zero();
+  }
+
+  // 推进到 now，对每个到期的定时器调用 fn(Owner*)。
+  // 调用 fn 前定时器已经摘下，fn 里可以直接销毁 owner
+  template <typename Fn> void advance(std::uint64_t now, Fn &&fn) {
+    while (current_ < now) {
+      if (size_ == 0) {
+        current_ = now;
+        return;
+      }
+      const std::uint64_t next = nextEventTick();
+      if (next > now) {
+        current_ = now;
+        return;
+      }
+      current_ = next;
+
+      // 从高层往低层下放：经过某层的槽位边界时，该槽位里的定时器重新安排
+      for (unsigned level = kLevels - 1; level > 0; --level) {
+        const unsigned shift = kBits * level;
+        if ((current_ & ((std::uint64_t{1} << shift) - 1)) != 0)
+          continue;
+        cascade(level, static_cast<unsigned>(current_ >> shift) & kMask, fn);
+      }
+      expireSlot(static_cast<unsigned>(current_) & kMask, fn);
+    }
+  }
+
+private:
+  static constexpr unsigned kBits = 6;
+  static constexpr unsigned kSlots = 1u << kBits;
+  static constexpr unsigned kMask = kSlots - 1;
+  static constexpr unsigned kLevels = 4;
+
+  struct Slot {
+    Node *head = nullptr;
+  };
+
+  void insert(Node &node) {
+    // 已到期的放到下一个 tick，由下一次 advance 处理
+    const std::uint64_t expire =
+        node.expireTick > current_ ? node.expireTick : current_ + 1;
+    const std::uint64_t delta = expire - current_;
+
+    unsigned level = 0;
+    while (level + 1 < kLevels &&
+           delta >= (std::uint64_t{1} << (kBits * (level + 1)))) {
+      ++level;
+    }
+    const unsigned shift = kBits * level;
+    unsigned slot;
+    if (delta >= (std::uint64_t{1} << (kBits * kLevels))) {
+      // 超出整个时间轮的范围：放在最高层最远的槽位
+      slot = static_cast<unsigned>((current_ >> shift) + kMask) & kMask;
+    } else {
+      slot = static_cast<unsigned>(expire >> shift) & kMask;
+    }
+
+    node.level = static_cast<std::uint8_t>(level);
+    node.slot = static_cast<std::uint8_t>(slot);
+    node.prev = nullptr;
+    node.next = wheel_[level][slot].head;
+    if (node.next)
+      node.next->prev = &node;
+    wheel_[level][slot].head = &node;
+    node.linked = true;
+    occupied_[level] |= std::uint64_t{1} << slot;
+  }
+
+  void unlink(Node &node) {
+    Slot &slot = wheel_[node.level][node.slot];
+    if (node.prev)
+      node.prev->next = node.next;
+    else
+      slot.head = node.next;
+    if (node.next)
+      node.next->prev = node.prev;
+    if (!slot.head)
+      occupied_[node.level] &= ~(std::uint64_t{1} << node.slot);
+    node.prev = node.next = nullptr;
+    node.linked = false;
+  }
+
+  // 下一个需要处理的 tick：各层下一个非空槽位的起点取最小
+  std::uint64_t nextEventTick() const {
+    std::uint64_t best = UINT64_MAX;
+    for (unsigned level = 0; level < kLevels; ++level) {
+      const std::uint64_t bits = occupied_[level];
+      if (bits == 0)
+        continue;
+      const unsigned shift = kBits * level;
+      const std::uint64_t cursor = current_ >> shift;
+      const unsigned pos = static_cast<unsigned>(cursor) & kMask;
+      const std::uint64_t base = cursor & ~std::uint64_t{kMask};
+
+      // 当前槽位之后的非空槽位在本圈，否则在下一圈
+      const std::uint64_t ahead =
+          pos == kMask ? 0 : bits & (~std::uint64_t{0} << (pos + 1));
+      const std::uint64_t index =
+          ahead != 0 ? base + static_cast<unsigned>(std::countr_zero(ahead))
+                     : base + kSlots +
+                           static_cast<unsigned>(std::countr_zero(bits));
+      const std::uint64_t tick = index << shift;
+      if (tick < best)
+        best = tick;
+    }
+    return best;
+  }
+
+  template <typename Fn> void cascade(unsigned level, unsigned slot, Fn &fn) {
+    Node *node = takeSlot(level, slot);
+    while (node) {
+      Node *next = node->next;
+      node->prev = node->next = nullptr;
+      if (node->expireTick <= current_) {
+        --size_;
+        fn(node->owner);
+      } else {
+        insert(*node);
+      }
+      node = next;
+    }
+  }
+
+  template <typename Fn> void expireSlot(unsigned slot, Fn &fn) {
+    Node *node = takeSlot(0, slot);
+    while (node) {
+      Node *next = node->next;
+      node->prev = node->next = nullptr;
+      if (node->expireTick <= current_) {
+        --size_;
+        fn(node->owner);
+      } else {
+        insert(*node); // 超出范围后被放回的定时器
+      }
+      node = next;
+    }
+  }
+
+  // 整个槽位摘下来，链上结点标记为未挂载
+  Node *takeSlot(unsigned level, unsigned slot) {
+    Node *head = wheel_[level][slot].head;
+    wheel_[level][slot].head = nullptr;
+    occupied_[level] &= ~(std::uint64_t{1} << slot);
+    for (Node *node = head; node; node = node->next) {
+      node->linked = false;
+    }
+    return head;
+  }
+
+  TtlClock::duration tick_;
+  TtlClock::time_point epoch_;
+  std::uint64_t current_ = 0; // 已处理到的 tick
+  std::size_t size_ = 0;
+  std::array<std::array<Slot, kSlots>, kLevels> wheel_{};
+  std::array<std::uint64_t, kLevels> occupied_{}; // 每层非空槽位的位图
+};
+
+// 挂在时间轮上的定时器：owner 指向自己，node 为所属条目在缓存 NodeSlab 中的下标
+struct SlabTimer {
+  explicit SlabTimer(std::uint32_t owner) : node(owner) {}
+
+  TimerNode<SlabTimer> hook;
+  std::uint32_t node;
+};
+
+// 按需分配定时器的时间轮：缓存结点里只保存一个 32 位定时器下标(kNone 表示没有)，
+// 不带 ttl 的条目不为定时器占用任何空间。本身不加锁，由使用它的缓存负责同步。
+class ExpiryTimers {
+public:
+  using Index = std::uint32_t;
+  static constexpr Index kNone = NodeSlab<SlabTimer>::kNil;
+
+  bool empty() const { return !wheel_ || wheel_->empty(); }
+
+  // 给下标为 node 的条目安排(或重新安排)过期时间，timer 为它保存的定时器下标
+  void schedule(Index &timer, Index node, TtlClock::duration ttl) {
+    if (!wheel_)
+      wheel_ = std::make_unique<TimingWheel<SlabTimer>>();
+    if (timer == kNone) {
+      timer = timers_.create(node);
+      timers_[timer].hook.owner = &timers_[timer];
+    }
+    wheel_->schedule(timers_[timer].hook, wheel_->expireTickAfter(ttl));
+  }
+
+  // 取消并释放定时器；timer 为 kNone 时什么也不做
+  void cancel(Index &timer) {
+    if (timer == kNone)
+      return;
+    wheel_->cancel(timers_[timer].hook);
+    timers_.destroy(timer);
+    timer = kNone;
+  }
+
+  // 距离到期还剩多久(已到期为 0)；timer 不能是 kNone
+  TtlClock::duration remaining(Index timer) const {
+    return wheel_->remaining(timers_[timer].hook);
+  }
+
+  // 推进到当前时刻，对每个到期条目调用 fn(node)。
+  // fn 删除条目时要对它的定时器调用 cancel，定时器在那时才释放
+  template <typename Fn> void advance(Fn &&fn) {
+    if (empty())
+      return;
+    wheel_->advance(wheel_->nowTick(),
+                    [&fn](SlabTimer *expired) { fn(expired->node); });
+  }
+
+  void clear() {
+    wheel_.reset();
+    timers_.clear();
+  }
+
+  std::size_t memoryBytes() const {
+    return timers_.memoryBytes() +
+           (wheel_ ? sizeof(TimingWheel<SlabTimer>) : 0);
+  }
+
+private:
+  NodeSlab<SlabTimer> timers_;
+  std::unique_ptr<TimingWheel<SlabTimer>> wheel_; // 第一次带 ttl 写入时创建
+};
+
+// 后台清理线程：每隔 interval 调用一次 reap(例如 cache.purgeExpired())，
+// 析构时停止并等待线程退出
+class PeriodicReaper {
+public:
+  PeriodicReaper(std::function<void()> reap, TtlClock::duration interval)
+      : reap_(std::move(reap)), interval_(interval),
+        thread_([this] { run(); }) {}
+
+  PeriodicReaper(const PeriodicReaper &) = delete;
+  PeriodicReaper &operator=(const PeriodicReaper &) = delete;
+
+  ~PeriodicReaper() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+private:
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+      lock.unlock();
+      reap_();
+      lock.lock();
+    }
+  }
+
+  std::function<void()> reap_;
+  TtlClock::duration interval_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::thread thread_; // 最后初始化：线程启动时其余成员都已就绪
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "CacheStats.h"
+#include "FrequencySketch.h"
+#include "ICachePolicy.h"
+#include "NodePool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// W-TinyLFU：
+// - 窗口 LRU(约 1% 容量)：新 key 先进窗口，吸收突发的新数据
+// - 主缓存为分段 LRU：试用段(probation) + 保护段(protected，主缓存的 80%)，
+//   试用段里再次命中的结点升入保护段，保护段满时把最旧的降回试用段
+// - 窗口溢出的结点成为候选者，与试用段最旧的结点(牺牲者)比较 Count-Min Sketch
+//   估计的频率，候选者更高才准入，否则直接丢弃候选者
+// 频率只记在 FrequencySketch 里(每个条目约 8 字节)，不为没有准入的 key 保存 value。
+// 结点放在按容量预分配的 NodePool 中，三个段共用同一个池和索引。
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Stats = NullStats>
+class TinyLfuCache : public ICachePolicy<Key, Value> {
+public:
+  using Pool = NodePool<Key, Value, Hash>;
+  using Index = typename Pool::Index;
+
+  explicit TinyLfuCache(int capacity)
+      : capacity_(capacity > 0 ? static_cast<std::size_t>(capacity) : 0),
+        windowCapacity_(capacity_ > 0 ? std::max<std::size_t>(1, capacity_ / 100)
+                                      : 0),
+        mainCapacity_(capacity_ - windowCapacity_),
+        protectedCapacity_(mainCapacity_ * 8 / 10), pool_(capacity_),
+        segment_(capacity_, Segment::Window), sketch_(capacity_) {}
+
+  ~TinyLfuCache() override = default;
+
+  void put(const Key &key, const Value &value) override {
+    if (capacity_ == 0)
+      return;
+
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    sketch_.increment(key);
+
+    Index i = pool_.find(key);
+    if (i != Pool::kNil) {
+      pool_[i].value = value;
+      onHitLocked(i);
+      return;
+    }
+
+    if (window_.size >= windowCapacity_)
+      evictFromWindowLocked();
+
+    i = pool_.acquire(key, value);
+    segment_[i] = Segment::Window;
+    pool_.pushBack(window_, i);
+    stats_.record(CacheCounter::Insert);
+  }
+
+  bool get(const Key &key, Value &value) override {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    sketch_.increment(key);
+
+    Index i = pool_.find(key);
+    stats_.record(i != Pool::kNil ? CacheCounter::Hit : CacheCounter::Miss);
+    if (i == Pool::kNil)
+      return false;
+
+    onHitLocked(i);
+    value = pool_[i].value;
+    return true;
+  }
+
+  Value get(const Key &key) override {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  // 删除指定元素(频率记录保留在 sketch 里，随衰减自然消失)
+  void remove(const Key &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Index i = pool_.find(key);
+    if (i != Pool::kNil) {
+      pool_.unlink(listOf(i), i);
+      pool_.release(i);
+    }
+  }
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pool_.size();
+  }
+
+  // 当前估计频率(观察准入行为)
+  std::uint32_t frequency(const Key &key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sketch_.frequency(key);
+  }
+
+  // 统计快照(Stats 为 NullStats 时全为 0)
+  CacheStats stats() const { return stats_.snapshot(); }
+
+private:
+  enum class Segment : std::uint8_t { Window, Probation, Protected };
+
+  typename Pool::List &listOf(Index i) {
+    switch (segment_[i]) {
+    case Segment::Window:
+      return window_;
+    case Segment::Probation:
+      return probation_;
+    case Segment::Protected:
+      break;
+    }
+    return protected_;
+  }
+
+  void onHitLocked(Index i) {
+    switch (segment_[i]) {
+    case Segment::Window:
+      pool_.moveToBack(window_, i);
+      break;
+    case Segment::Probation:
+      // 试用段再次命中：升入保护段，保护段超额时把最旧的降回试用段
+      pool_.unlink(probation_, i);
+      segment_[i] = Segment::Protected;
+      pool_.pushBack(protected_, i);
+      if (protected_.size > protectedCapacity_) {
+        Index demoted = protected_.head;
+        pool_.unlink(protected_, demoted);
+        segment_[demoted] = Segment::Probation;
+        pool_.pushBack(probation_, demoted);
+      }
+      break;
+    case Segment::Protected:
+      pool_.moveToBack(protected_, i);
+      break;
+    }
+  }
+
+  // 窗口已满：把最旧的窗口结点移入主缓存；主缓存也满时由 sketch 决定
+  // 留下候选者还是牺牲者，调用后池中至少有一个空槽位
+  void evictFromWindowLocked() {
+    Index candidate = window_.head;
+    pool_.unlink(window_, candidate);
+
+    if (probation_.size + protected_.size < mainCapacity_) {
+      segment_[candidate] = Segment::Probation;
+      pool_.pushBack(probation_, candidate);
+      return;
+    }
+
+    Index victim = probation_.head;
+    typename Pool::List *victimList = &probation_;
+    if (victim == Pool::kNil) {
+      victim = protected_.head;
+      victimList = &protected_;
+    }
+
+    // 频率相同时保留牺牲者：已在主缓存里的结点更可能是真正的热点
+    if (victim != Pool::kNil && sketch_.frequency(pool_[candidate].key) >
+                                    sketch_.frequency(pool_[victim].key)) {
+      pool_.unlink(*victimList, victim);
+      pool_.release(victim);
+      segment_[candidate] = Segment::Probation;
+      pool_.pushBack(probation_, candidate);
+    } else {
+      pool_.release(candidate);
+    }
+    stats_.record(CacheCounter::Eviction);
+  }
+
+  std::size_t capacity_;          // 总容量
+  std::size_t windowCapacity_;    // 窗口 LRU 容量
+  std::size_t mainCapacity_;      // 主缓存(试用段 + 保护段)容量
+  std::size_t protectedCapacity_; // 保护段容量
+  Pool pool_;                     // 三个段共用的结点池 + 索引
+  std::vector<Segment> segment_;  // 槽位 -> 所在段
+  typename Pool::List window_;    // head 为最旧
+  typename Pool::List probation_;
+  typename Pool::List protected_;
+  FrequencySketch<Key, Hash> sketch_;
+  mutable std::mutex mutex_;
+  mutable Stats stats_;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+
+// 条目权重：缓存的容量按权重之和计算，淘汰一直进行到总权重不超过容量为止。
+// weigher(key, value) 返回该条目占用的单位数，只在写入时调用一次并记在结点上
+template <typename W, typename Key, typename Value>
+concept WeigherFor = requires(const W &weigher, const Key &key,
+                              const Value &value) {
+  { weigher(key, value) } -> std::convertible_to<std::size_t>;
+};
+
+// 默认权重：每个条目 1 个单位，容量即条目数(与不带权重时的行为一致)
+struct UnitWeigher {
+  template <typename Key, typename Value>
+  constexpr std::size_t operator()(const Key &, const Value &) const noexcept {
+    return 1;
+  }
+};
+
+// 按字节估计：sizeof(Key) + sizeof(Value)，再加上 std::string / std::vector
+// 这类连续容器在堆上的缓冲区(capacity() * sizeof(value_type))。
+// 容量即字节预算，适合 value 大小相差很大的场景
+struct SizeofWeigher {
+  template <typename Key, typename Value>
+  std::size_t operator()(const Key &key, const Value &value) const noexcept {
+    return bytesOf(key) + bytesOf(value);
+  }
+
+private:
+  template <typename T> static std::size_t bytesOf(const T &object) noexcept {
+    if constexpr (requires {
+                    typename T::value_type;
+                    { object.capacity() } -> std::convertible_to<std::size_t>;
+                  }) {
+      return sizeof(T) +
+             static_cast<std::size_t>(object.capacity()) *
+                 sizeof(typename T::value_type);
+    } else {
+      return sizeof(T);
+    }
+  }
+};
@@ -1,47 +1,78 @@
 #pragma once
 
+#include "../CacheStats.h"
 #include "../ICachePolicy.h"
+#include "../ShardSet.h"
+#include "../SingleFlight.h"
+#include "../Snapshot.h"
 #include "ArcLfuPart.h"
 #include "ArcLruPart.h"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
 
-template <typename Key, typename Value>
+// Stats 为统计策略(见 CacheStats.h)，默认的 NullStats 不产生任何开销。
+// Weigher 决定每个条目占多少容量(见 Weigher.h)，默认每个条目 1 个单位；
+// 两部分的容量、幽灵容量以及自适应调整(p)都以 Weigher 的单位计
+template <typename Key, typename Value, typename Stats = NullStats,
+          WeigherFor<Key, Value> Weigher = UnitWeigher>
 class ArcCache : public ICachePolicy<Key, Value> {
+  using Node = ArcNode<Key, Value>;
+  using Index = typename Node::Index;
+  static constexpr Index kNil = Node::kNil;
+  using LruPart = ArcLruPart<Key, Value, Weigher>;
+  using LfuPart = ArcLfuPart<Key, Value, Weigher>;
+
 public:
-  explicit ArcCache(size_t capacity = 10, size_t transformThreshold = 2)
+  explicit ArcCache(size_t capacity = 10, size_t transformThreshold = 2,
+                    Weigher weigher = Weigher())
       : capacity_(capacity), transformThreshold_(transformThreshold),
-        lruPart_(std::make_unique<ArcLruPart<Key, Value>>(capacity,
-                                                          transformThreshold)),
-        lfuPart_(std::make_unique<ArcLfuPart<Key, Value>>(capacity,
-                                                          transformThreshold)) {
+        lruPart_(std::make_unique<LruPart>(nodes_, capacity,
+                                           transformThreshold, weigher)),
+        lfuPart_(std::make_unique<LfuPart>(nodes_, capacity,
+                                           transformThreshold, weigher)) {
+    lruPart_->setEvictionListener(&onEvict_);
+    lfuPart_->setEvictionListener(&onEvict_);
   }
 
   ~ArcCache() override = default;
 
   void put(const Key &key, const Value &value) override {
-    checkGhostCaches(key);
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    putLocked(key, value);
+  }
 
-    // 检查 LFU 部分是否存在该键
-    bool inLfu = lfuPart_->contain(key);
-    // 更新 LRU 部分缓存
-    lruPart_->put(key, value);
-    // 如果 LFU 部分存在该键，则更新 LFU 部分
-    if (inLfu) {
-      lfuPart_->put(key, value);
-    }
+  // 右值版本：key/value 直接移动进结点
+  void put(Key &&key, Value &&value) {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    putLocked(std::move(key), std::move(value));
+  }
+
+  // 用 args 原地构造 value；key 已存在时同样覆盖
+  template <typename K, typename... Args>
+    requires std::constructible_from<Key, K>
+  void emplace(K &&key, Args &&...args) {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    putLocked(std::forward<K>(key), std::forward<Args>(args)...);
   }
 
   bool get(const Key &key, Value &value) override {
-    checkGhostCaches(key);
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    return getLocked(key, value);
+  }
 
-    bool shouldTransform = false;
-    if (lruPart_->get(key, value, shouldTransform)) {
-      if (shouldTransform) {
-        lfuPart_->put(key, value);
-      }
-      return true;
-    }
-    return lfuPart_->get(key, value);
+  // 异构查找：例如 Key 为 std::string 时用 std::string_view 查找，不构造临时 key
+  template <HeterogeneousKey<Key> K> bool get(const K &key, Value &value) {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    return getLocked(key, value);
   }
 
   Value get(const Key &key) override {
@@ -50,26 +81,601 @@ public:
     return value;
   }
 
+  // 读穿加载(见 SingleFlight.h)：未命中时调用 loader(key, value) 取值并写回缓存，
+  // 同一个 key 同时只有一次 loader 在执行，其余调用者等待它的结果。
+  // ARC 不支持 ttl，options 里的 ttl 与 refreshAhead 不起作用
+  template <typename Loader>
+  bool getOrLoad(const Key &key, Value &value, Loader &&loader,
+                 const LoadOptions &options = {}) {
+    return loadThrough(*this, loads_, key, value, loader, options);
+  }
+
+  template <typename Loader>
+  Value getOrLoad(const Key &key, Loader &&loader,
+                  const LoadOptions &options = {}) {
+    Value value{};
+    getOrLoad(key, value, loader, options);
+    return value;
+  }
+
+  // 异步版本：命中时返回已就绪的 future，未命中时在后台线程里加载
+  template <typename Loader>
+  typename SingleFlight<Key, Value>::Future
+  getOrLoadAsync(const Key &key, Loader loader,
+                 const LoadOptions &options = {}) {
+    return loadThroughAsync(*this, loads_, key, std::move(loader), options);
+  }
+
+  // 等待已发起的后台加载(异步 getOrLoad、refresh-ahead)全部完成
+  void drainLoads() { loads_.drain(); }
+
+  // 零拷贝读取：命中时在锁内以 const Value& 调用 fn，返回是否命中。
+  // fn 执行期间持有缓存锁，不要在 fn 里再访问同一个缓存
+  template <typename K, typename Fn> bool withValue(const K &key, Fn &&fn) {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    const Index i = touchLocked(key);
+    stats_.record(i != kNil ? CacheCounter::Hit : CacheCounter::Miss);
+    if (i == kNil)
+      return false;
+
+    std::forward<Fn>(fn)(nodes_[i].getValue());
+    return true;
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lruPart_->size() + lfuPart_->size();
+  }
+
+  // 清空 T1/T2 和两个幽灵链表(自适应的 p 保持不变)：不计为淘汰，也不回调淘汰监听
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lruPart_->clear();
+    lfuPart_->clear();
+    nodes_.clear();
+    lruGhostHits_ = lfuGhostHits_ = 0;
+  }
+
+  // 删除所有 pred(key, value) 为真的条目，返回删除的个数(一次加锁内遍历全部条目)。
+  // 删除的条目不进入幽灵链表
+  template <typename Pred> size_t removeIf(Pred &&pred) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lruPart_->removeIf(pred) + lfuPart_->removeIf(pred);
+  }
+
+  // 删除 key 以 prefix 开头的条目(见 LruCache::removePrefix)
+  size_t removePrefix(std::string_view prefix)
+    requires PrefixKey<Key>
+  {
+    return removeIf([prefix](const Key &key, const Value &) {
+      return std::string_view(key).starts_with(prefix);
+    });
+  }
+
+  // 批量导入：一次加锁，预留好 T1 的索引后依次写入，新条目都进入 T1
+  template <BulkLoadRange<Key, Value> R> void bulkLoad(const R &items) {
+    bulkLoadImpl(items, [](size_t j) { return j; },
+                 static_cast<size_t>(std::ranges::size(items)));
+  }
+
+  // 只导入 items 中 positions 指定的条目(分片包装按分片分组后调用)
+  template <BulkLoadRange<Key, Value> R>
+  void bulkLoadAt(const R &items, std::span<const std::uint32_t> positions) {
+    bulkLoadImpl(items, [positions](size_t j) { return positions[j]; },
+                 positions.size());
+  }
+
+  // 容量淘汰(T1/T2 的条目被换成幽灵)时回调 listener(key, value)，
+  // 例如把条目写到下一级缓存(见 TieredCache.h)。传空的 listener 取消
+  void setEvictionListener(EvictionListener<Key, Value> listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    onEvict_ = std::move(listener);
+  }
+
+  // 结点存储与各索引实际占用的字节数(不含 key/value 自己在堆上的部分)
+  size_t memoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nodes_.memoryBytes() + lruPart_->indexBytes() +
+           lfuPart_->indexBytes();
+  }
+
+  // 两部分条目的权重之和
+  size_t weight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lruPart_->weight() + lfuPart_->weight();
+  }
+
+  // 批量查询：整批只加一次锁
+  size_t getMany(std::span<const Key> keys, std::span<Value> values,
+                 std::span<bool> found) override {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    size_t hits = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      found[i] = getLocked(keys[i], values[i]);
+      hits += found[i] ? 1 : 0;
+    }
+    return hits;
+  }
+
+  // 只处理 keys 中 positions 指定的那些下标(分片包装按分片分组后调用)
+  size_t getManyAt(std::span<const Key> keys,
+                   std::span<const std::uint32_t> positions,
+                   std::span<Value> values, std::span<bool> found) {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    size_t hits = 0;
+    for (std::uint32_t i : positions) {
+      found[i] = getLocked(keys[i], values[i]);
+      hits += found[i] ? 1 : 0;
+    }
+    return hits;
+  }
+
+  void putMany(std::span<const Key> keys,
+               std::span<const Value> values) override {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      putLocked(keys[i], values[i]);
+    }
+  }
+
+  void putManyAt(std::span<const Key> keys, std::span<const Value> values,
+                 std::span<const std::uint32_t> positions) {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    for (std::uint32_t i : positions) {
+      putLocked(keys[i], values[i]);
+    }
+  }
+
+  // 当前总容量(LRU 部分 + LFU 部分)
+  size_t capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lruPart_->capacity() + lfuPart_->capacity();
+  }
+
+  // 其中 LFU 部分的容量
+  size_t lfuCapacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lfuPart_->capacity();
+  }
+
+  // 两侧各自的幽灵命中次数
+  struct GhostHits {
+    size_t lru = 0;
+    size_t lfu = 0;
+    size_t total() const { return lru + lfu; }
+  };
+
+  // 取出并清零自上次调用以来的幽灵命中次数(用于分片间的容量再平衡)
+  GhostHits takeGhostHits() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const GhostHits hits{lruGhostHits_, lfuGhostHits_};
+    lruGhostHits_ = lfuGhostHits_ = 0;
+    return hits;
+  }
+
+  // 扩容 n 个单位，toLfu 选择交给哪一侧。调用方按 takeGhostHits 取出的
+  // 计数交给近期幽灵命中更多的一侧(说明那一侧容量不够)
+  void growCapacity(size_t n, bool toLfu) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (toLfu)
+      lfuPart_->increaseCapacity(n);
+    else
+      lruPart_->increaseCapacity(n);
+  }
+
+  // 缩容最多 n 个单位(必要时淘汰)，优先从容量更大的一侧收回，
+  // 两侧相等后各收一半，每侧至少保留 1 个单位 | 返回实际收回的数量。
+  // 按段计算而不是逐个单位循环，容量按字节计时 n 可能很大
+  size_t shrinkCapacity(size_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t shrunk = 0;
+    while (shrunk < n) {
+      const size_t lruCap = lruPart_->capacity();
+      const size_t lfuCap = lfuPart_->capacity();
+      const bool fromLru = lruCap >= lfuCap;
+      const size_t larger = fromLru ? lruCap : lfuCap;
+      const size_t smaller = fromLru ? lfuCap : lruCap;
+      if (larger <= 1)
+        break;
+
+      const size_t left = n - shrunk;
+      size_t step = larger > smaller ? std::min(left, larger - smaller)
+                                     : (left + 1) / 2;
+      step = std::min(step, larger - 1);
+      shrunk += fromLru ? lruPart_->decreaseCapacity(step)
+                        : lfuPart_->decreaseCapacity(step);
+    }
+    return shrunk;
+  }
+
+  // 统计快照(Stats 为 NullStats 时全为 0)
+  CacheStats stats() const { return stats_.snapshot(); }
+
+  // 快照(见 SnapshotFile.h)：两部分的容量(即自适应的 p)、T1/T2 的条目
+  // 及访问次数、两个幽灵链表的指纹。指纹依赖 key 的哈希函数，
+  // 只在哈希结果不变的进程之间有效
+  static constexpr SnapshotPolicy kSnapshotPolicy = SnapshotPolicy::Arc;
+  size_t snapshotSections() const { return 1; }
+
+  void writeSnapshotSection(size_t, SnapshotWriter &out) const
+    requires SnapshotEncodable<Key> && SnapshotEncodable<Value>
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writeSnapshotTypes<Key, Value>(out);
+    out.u64(capacity_);
+    out.u64(lruPart_->capacity());
+    out.u64(lfuPart_->capacity());
+    lruPart_->writeSnapshot(out);
+    lfuPart_->writeSnapshot(out);
+  }
+
+  // 恢复到空缓存。构造容量与快照相同时连同 p 一起恢复，否则沿用当前的划分
+  bool restoreSnapshotSection(size_t, SnapshotReader &in)
+    requires SnapshotEncodable<Key> && SnapshotEncodable<Value>
+  {
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    std::uint64_t total = 0, lruCap = 0, lfuCap = 0;
+    if (sizeLocked() != 0 || !checkSnapshotTypes<Key, Value>(in) ||
+        !in.u64(total) || !in.u64(lruCap) || !in.u64(lfuCap))
+      return false;
+    if (total == capacity_) {
+      lruPart_->setCapacity(static_cast<size_t>(lruCap));
+      lfuPart_->setCapacity(static_cast<size_t>(lfuCap));
+    }
+    return lruPart_->restoreSnapshot(in) && lfuPart_->restoreSnapshot(in);
+  }
+
 private:
-  bool checkGhostCaches(Key key) {
-    bool inGhost = false;
-    if (lruPart_->checkGhost(key)) {
-      if (lfuPart_->decreaseCapacity()) {
-        lruPart_->increaseCapacity();
+  template <typename R, typename IndexOf>
+  void bulkLoadImpl(const R &items, IndexOf indexOf, size_t n) {
+    if (n == 0)
+      return;
+
+    StatsLockGuard<Stats, std::mutex> lock(mutex_, stats_);
+    lruPart_->reserve(std::min(lruPart_->size() + n, lruPart_->capacity()));
+    const auto first = std::ranges::begin(items);
+    for (size_t j = 0; j < n; ++j) {
+      const auto &item = first[static_cast<std::ptrdiff_t>(indexOf(j))];
+      putLocked(item.first, item.second);
+    }
+  }
+
+  // 以下 *Locked 方法要求调用方已持有 mutex_
+  template <typename K, typename... Args>
+  void putLocked(K &&key, Args &&...args) {
+    checkGhostCaches(key);
+
+    // 每个 key 只存一个结点：已在 LFU 部分就原地更新，否则写入 LRU 部分
+    if (lfuPart_->contain(key)) {
+      lfuPart_->put(std::forward<K>(key), std::forward<Args>(args)...);
+      return;
+    }
+    if constexpr (Stats::kEnabled) {
+      // 两部分自己不计数：由前后的条目数推出插入与淘汰次数
+      const bool existed = lruPart_->contain(key);
+      const size_t before = lruPart_->size();
+      const bool stored =
+          lruPart_->put(std::forward<K>(key), std::forward<Args>(args)...);
+      const size_t inserted = !existed && stored ? 1 : 0;
+      // 超重的更新被拒绝时移除的是它自己，不算淘汰
+      const size_t rejected = existed && !stored ? 1 : 0;
+      stats_.record(CacheCounter::Insert, inserted);
+      stats_.record(CacheCounter::Eviction,
+                    before + inserted - rejected - lruPart_->size());
+    } else {
+      lruPart_->put(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+  }
+
+  template <typename K> bool getLocked(const K &key, Value &value) {
+    const Index i = touchLocked(key);
+    stats_.record(i != kNil ? CacheCounter::Hit : CacheCounter::Miss);
+    if (i == kNil)
+      return false;
+
+    value = nodes_[i].getValue();
+    return true;
+  }
+
+  // 记一次访问并返回命中的结点下标，未命中返回 kNil
+  template <typename K> Index touchLocked(const K &key) {
+    checkGhostCaches(key);
+
+    bool shouldTransform = false;
+    const Index i = lruPart_->get(key, shouldTransform);
+    if (i != kNil) {
+      // 访问次数达到门槛：把结点整体迁移到 LFU 部分，而不是复制一份
+      if (shouldTransform && lfuPart_->hasCapacity(nodes_[i].getWeight())) {
+        lruPart_->extract(i);
+        lfuPart_->adopt(i);
+        stats_.record(CacheCounter::Migration);
       }
+      return i;
+    }
+    return lfuPart_->get(key);
+  }
+
+  template <typename K> bool checkGhostCaches(const K &key) {
+    bool inGhost = false;
+    const size_t before = sizeLocked();
+    // 幽灵命中时按该条目的权重在两侧之间挪容量(默认权重下每次挪 1 个单位)
+    size_t weight = 0;
+    if (lruPart_->checkGhost(key, weight)) {
+      ++lruGhostHits_;
+      lruPart_->increaseCapacity(lfuPart_->decreaseCapacity(weight));
       inGhost = true;
-    } else if (lfuPart_->checkGhost(key)) {
-      if (lruPart_->decreaseCapacity()) {
-        lfuPart_->increaseCapacity();
-      }
+    } else if (lfuPart_->checkGhost(key, weight)) {
+      ++lfuGhostHits_;
+      lfuPart_->increaseCapacity(lruPart_->decreaseCapacity(weight));
       inGhost = true;
     }
+    if (inGhost) {
+      // 幽灵命中会把容量从一侧挪到另一侧，被缩容的一侧满时会淘汰一个结点
+      stats_.record(CacheCounter::GhostHit);
+      stats_.record(CacheCounter::PAdjustment);
+      stats_.record(CacheCounter::Eviction, before - sizeLocked());
+    }
     return inGhost;
   }
 
+  size_t sizeLocked() const { return lruPart_->size() + lfuPart_->size(); }
+
 private:
   size_t capacity_;
   size_t transformThreshold_;
-  std::unique_ptr<ArcLruPart<Key, Value>> lruPart_;
-  std::unique_ptr<ArcLfuPart<Key, Value>> lfuPart_;
+  // 一次操作只进一个临界区，覆盖 LRU/LFU 两部分及各自的幽灵链表
+  mutable std::mutex mutex_;
+  mutable Stats stats_;
+  NodeSlab<Node> nodes_; // 两部分共用的结点存储，先于两部分构造
+  std::unique_ptr<LruPart> lruPart_;
+  std::unique_ptr<LfuPart> lfuPart_;
+  EvictionListener<Key, Value> onEvict_; // 两部分共用的淘汰回调，可为空
+  size_t lruGhostHits_ = 0; // 近期 LRU 幽灵命中次数
+  size_t lfuGhostHits_ = 0; // 近期 LFU 幽灵命中次数
+  // 最后声明、最先析构：析构时等后台加载写完，其余成员仍然有效
+  SingleFlight<Key, Value> loads_; // getOrLoad 正在进行的加载
+};
+
+// 对 ARC 进行分片：每个分片是独立的 ArcCache，各自调整自己的 T1/T2 划分。
+// rebalanceInterval > 0 时每隔这么多次操作按各分片的幽灵命中压力，
+// 把容量从压力最小的分片挪给压力最大的分片(总容量不变)。
+// 分片数会向上取整到 2 的幂，分片选择见 ShardSet
+// capacity 以 Weigher 的单位计，再平衡挪动的也是这个单位
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Stats = NullStats,
+          WeigherFor<Key, Value> Weigher = UnitWeigher>
+class KHashArcCache {
+public:
+  using Shard = ArcCache<Key, Value, Stats, Weigher>;
+
+  KHashArcCache(size_t capacity, int sliceNum, size_t transformThreshold = 2,
+                size_t rebalanceInterval = 0, Weigher weigher = Weigher())
+      : capacity_(capacity), rebalanceInterval_(rebalanceInterval),
+        arcSliceCaches_(capacity, sliceNum,
+                        [transformThreshold, &weigher](size_t sliceSize) {
+                          return Shard(sliceSize, transformThreshold, weigher);
+                        }) {}
+
+  void put(const Key &key, const Value &value) {
+    arcSliceCaches_.shardFor(key).put(key, value);
+    maybeRebalance();
+  }
+
+  bool get(const Key &key, Value &value) {
+    bool hit = arcSliceCaches_.shardFor(key).get(key, value);
+    maybeRebalance();
+    return hit;
+  }
+
+  Value get(const Key &key) {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  template <typename Fn> bool withValue(const Key &key, Fn &&fn) {
+    bool hit =
+        arcSliceCaches_.shardFor(key).withValue(key, std::forward<Fn>(fn));
+    maybeRebalance();
+    return hit;
+  }
+
+  // 所有分片共用同一个淘汰回调(会被并发调用)
+  void setEvictionListener(const EvictionListener<Key, Value> &listener) {
+    arcSliceCaches_.forEach(
+        [&](Shard &shard) { shard.setEvictionListener(listener); });
+  }
+
+  // 批量导入：按分片分组后在最多 threads 个线程上并行导入(threads <= 0 取硬件线程数)，
+  // 每个分片只加一次锁
+  template <BulkLoadRange<Key, Value> R>
+  void bulkLoad(const R &items, int threads = 0) {
+    const auto first = std::ranges::begin(items);
+    arcSliceCaches_.forEachGroupParallel(
+        static_cast<std::size_t>(std::ranges::size(items)),
+        [first](std::size_t i) -> const Key & {
+          return first[static_cast<std::ptrdiff_t>(i)].first;
+        },
+        [&](Shard &slice, std::span<const std::uint32_t> positions) {
+          slice.bulkLoadAt(items, positions);
+        },
+        threads);
+  }
+
+  // 以下批量失效各分片并行执行，每个分片只在处理它时加锁，其余分片照常读写
+  void clear(int threads = 0) {
+    arcSliceCaches_.forEachParallel([](Shard &slice) { slice.clear(); },
+                                    threads);
+  }
+
+  // pred 会在多个线程上并发调用 | 返回删除的条目数
+  template <typename Pred>
+  std::size_t removeIf(const Pred &pred, int threads = 0) {
+    std::atomic<std::size_t> removed{0};
+    arcSliceCaches_.forEachParallel(
+        [&](Shard &slice) { removed += slice.removeIf(pred); }, threads);
+    return removed.load();
+  }
+
+  std::size_t removePrefix(std::string_view prefix, int threads = 0)
+    requires PrefixKey<Key>
+  {
+    return removeIf(
+        [prefix](const Key &key, const Value &) {
+          return std::string_view(key).starts_with(prefix);
+        },
+        threads);
+  }
+
+  // 读穿加载：由 key 所在的分片合并同一个 key 的并发加载(见 SingleFlight.h)
+  template <typename Loader>
+  bool getOrLoad(const Key &key, Value &value, Loader &&loader,
+                 const LoadOptions &options = {}) {
+    maybeRebalance();
+    return arcSliceCaches_.shardFor(key).getOrLoad(
+        key, value, std::forward<Loader>(loader), options);
+  }
+
+  template <typename Loader>
+  Value getOrLoad(const Key &key, Loader &&loader,
+                  const LoadOptions &options = {}) {
+    Value value{};
+    getOrLoad(key, value, std::forward<Loader>(loader), options);
+    return value;
+  }
+
+  template <typename Loader>
+  typename SingleFlight<Key, Value>::Future
+  getOrLoadAsync(const Key &key, Loader loader,
+                 const LoadOptions &options = {}) {
+    maybeRebalance();
+    return arcSliceCaches_.shardFor(key).getOrLoadAsync(
+        key, std::move(loader), options);
+  }
+
+  void drainLoads() {
+    arcSliceCaches_.forEach([](auto &slice) { slice.drainLoads(); });
+  }
+
+  // 批量查询：按分片分组，每个涉及到的分片只加一次锁
+  std::size_t getMany(std::span<const Key> keys, std::span<Value> values,
+                      std::span<bool> found) {
+    std::size_t hits = 0;
+    arcSliceCaches_.forEachGroup(
+        keys, [&](auto &slice, std::span<const std::uint32_t> positions) {
+          hits += slice.getManyAt(keys, positions, values, found);
+        });
+    maybeRebalance(keys.size());
+    return hits;
+  }
+
+  void putMany(std::span<const Key> keys, std::span<const Value> values) {
+    arcSliceCaches_.forEachGroup(
+        keys, [&](auto &slice, std::span<const std::uint32_t> positions) {
+          slice.putManyAt(keys, values, positions);
+        });
+    maybeRebalance(keys.size());
+  }
+
+  // 按幽灵命中压力做一轮再平衡：每轮从压力最小的分片向压力最大的分片
+  // 转移一部分容量，单个分片不会缩到初始容量的 1/4 以下
+  void rebalance() {
+    std::lock_guard<std::mutex> lock(rebalanceMutex_);
+    const size_t count = arcSliceCaches_.shardCount();
+    if (count < 2)
+      return;
+
+    // 取出时即清零，两侧的计数要留到下面决定扩容给哪一侧
+    std::vector<typename Shard::GhostHits> hits(count);
+    std::vector<size_t> pressure(count);
+    for (size_t i = 0; i < count; ++i) {
+      hits[i] = arcSliceCaches_.shard(i).takeGhostHits();
+      pressure[i] = hits[i].total();
+    }
+
+    const auto [minIt, maxIt] =
+        std::minmax_element(pressure.begin(), pressure.end());
+    if (*maxIt == *minIt)
+      return;
+
+    auto &donor = arcSliceCaches_.shard(minIt - pressure.begin());
+    auto &receiver = arcSliceCaches_.shard(maxIt - pressure.begin());
+
+    // ArcCache 两部分各自持有 sliceSize 的初始容量
+    const size_t sliceSize = arcSliceCaches_.sliceCapacity();
+    const size_t floor = std::max<size_t>(2, sliceSize / 2);
+    const size_t donorCap = donor.capacity();
+    if (donorCap <= floor)
+      return;
+    const size_t step =
+        std::min(donorCap - floor, std::max<size_t>(1, sliceSize / 16));
+    const auto &receiverHits = hits[maxIt - pressure.begin()];
+    receiver.growCapacity(donor.shrinkCapacity(step),
+                          receiverHits.lfu > receiverHits.lru);
+  }
+
+  // 各分片当前容量(观察再平衡效果)
+  std::vector<size_t> sliceCapacities() const {
+    std::vector<size_t> caps;
+    for (size_t i = 0; i < arcSliceCaches_.shardCount(); ++i) {
+      caps.push_back(arcSliceCaches_.shard(i).capacity());
+    }
+    return caps;
+  }
+
+  // 各分片 LFU 部分的容量
+  std::vector<size_t> sliceLfuCapacities() const {
+    std::vector<size_t> caps;
+    for (size_t i = 0; i < arcSliceCaches_.shardCount(); ++i) {
+      caps.push_back(arcSliceCaches_.shard(i).lfuCapacity());
+    }
+    return caps;
+  }
+
+  std::size_t sliceNum() const { return arcSliceCaches_.shardCount(); }
+  std::size_t sliceIndex(const Key &key) const {
+    return arcSliceCaches_.shardIndex(key);
+  }
+
+  // 各分片当前条目数
+  std::vector<std::size_t> occupancy() const {
+    return arcSliceCaches_.occupancy();
+  }
+
+  // 各分片统计之和
+  CacheStats stats() const {
+    CacheStats total;
+    for (size_t i = 0; i < arcSliceCaches_.shardCount(); ++i) {
+      total += arcSliceCaches_.shard(i).stats();
+    }
+    return total;
+  }
+
+  // 快照：每个分片一段(见 SnapshotFile.h)，恢复时分片数必须相同
+  static constexpr SnapshotPolicy kSnapshotPolicy = Shard::kSnapshotPolicy;
+  std::size_t snapshotSections() const { return arcSliceCaches_.shardCount(); }
+  void writeSnapshotSection(std::size_t i, SnapshotWriter &out) const {
+    arcSliceCaches_.shard(i).writeSnapshotSection(0, out);
+  }
+  bool restoreSnapshotSection(std::size_t i, SnapshotReader &in) {
+    return arcSliceCaches_.shard(i).restoreSnapshotSection(0, in);
+  }
+
+private:
+  // 每累计 rebalanceInterval_ 次操作做一轮再平衡(批量接口按 key 数计)
+  void maybeRebalance(size_t ops = 1) {
+    if (rebalanceInterval_ == 0)
+      return;
+    const size_t before = opCount_.fetch_add(ops, std::memory_order_relaxed);
+    if (before / rebalanceInterval_ != (before + ops) / rebalanceInterval_) {
+      rebalance();
+    }
+  }
+
+private:
+  std::size_t capacity_; // 缓存总容量
+  size_t rebalanceInterval_;
+  std::atomic<size_t> opCount_{0};
+  std::mutex rebalanceMutex_;
+  ShardSet<Key, Shard, Hash> arcSliceCaches_; // 缓存 arc 分片容器
 };
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "../FlatIndex.h"
+#include "../Snapshot.h"
+#include "../Weigher.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// ARC 的幽灵链表：只记录被淘汰条目的 64 位 key 指纹(以及非默认 Weigher 下的权重)，
+// 不保留 key/value。按淘汰先后存放在环形缓冲里，再用 FlatIndex 按指纹查找。
+// - 默认权重下每个幽灵约 8 字节指纹 + 5~11 字节索引
+// - 命中的幽灵只在环里留一个空洞，空洞过多时整体压实
+// 两个不同 key 的指纹相同的概率可以忽略，最坏也只是多调整一次 p。
+// 本身不加锁，由 ArcCache 在同一个临界区内统一调用。
+template <typename Weigher = UnitWeigher> class ArcGhostList {
+public:
+  using Fingerprint = std::uint64_t;
+
+  bool empty() const { return live_ == 0; }
+  std::size_t size() const { return live_; }
+  std::size_t weight() const { return kWeighted ? weight_ : live_; }
+
+  // 记录一个刚被淘汰的条目(最新)
+  void push(Fingerprint fp, std::size_t weight) {
+    fp = normalize(fp);
+    std::size_t old = 0;
+    take(fp, old); // 同一指纹只保留最新一次
+    if (count_ == ring_.size())
+      grow();
+
+    const std::size_t pos = (head_ + count_) & mask();
+    ring_[pos] = fp;
+    if constexpr (kWeighted) {
+      weights_[pos] = weight;
+      weight_ += weight;
+    }
+    ++count_;
+    ++live_;
+    index_.insert(index_.hashOf(fp), static_cast<Index>(pos),
+                  [this](Index i) { return index_.hashOf(ring_[i]); });
+  }
+
+  // 命中时摘掉该幽灵并返回 true，weight 返回它被淘汰时的权重
+  bool take(Fingerprint fp, std::size_t &weight) {
+    fp = normalize(fp);
+    const std::uint64_t hash = index_.hashOf(fp);
+    const Index pos = find(fp, hash);
+    if (pos == kNil)
+      return false;
+
+    weight = weightAt(pos);
+    index_.erase(hash, pos);
+    release(pos);
+    return true;
+  }
+
+  // 摘掉最旧的幽灵，返回它的权重(没有幽灵时返回 0)
+  std::size_t popOldest() {
+    while (count_ > 0 && ring_[head_] == kHole) {
+      head_ = (head_ + 1) & mask();
+      --count_;
+    }
+    if (count_ == 0)
+      return 0;
+
+    const Index pos = static_cast<Index>(head_);
+    const std::size_t weight = weightAt(pos);
+    index_.erase(index_.hashOf(ring_[pos]), pos);
+    release(pos);
+    return weight;
+  }
+
+  // 快照：从旧到新写出指纹和权重
+  void writeSnapshot(SnapshotWriter &out) const {
+    out.u64(live_);
+    for (std::size_t k = 0; k < count_; ++k) {
+      const std::size_t pos = (head_ + k) & mask();
+      if (ring_[pos] == kHole)
+        continue;
+      out.u64(ring_[pos]);
+      out.u64(weightAt(static_cast<Index>(pos)));
+    }
+  }
+
+  // 按写出的顺序依次记回，总权重超过 capacity 时淘汰最旧的
+  bool restoreSnapshot(SnapshotReader &in, std::size_t capacity) {
+    std::uint64_t count = 0;
+    if (!in.u64(count))
+      return false;
+    for (std::uint64_t n = 0; n < count; ++n) {
+      std::uint64_t fp = 0, weight = 0;
+      if (!in.u64(fp) || !in.u64(weight))
+        return false;
+      while (!empty() && this->weight() + weight > capacity) {
+        popOldest();
+      }
+      push(fp, static_cast<std::size_t>(weight));
+    }
+    return true;
+  }
+
+  // 环形缓冲、权重与索引占用的字节数
+  std::size_t memoryBytes() const {
+    return ring_.capacity() * sizeof(Fingerprint) +
+           weights_.capacity() * sizeof(std::size_t) + index_.memoryBytes();
+  }
+
+private:
+  using Index = typename FlatIndex<Fingerprint>::Index;
+  static constexpr Index kNil = FlatIndex<Fingerprint>::kNil;
+  static constexpr bool kWeighted = !std::is_same_v<Weigher, UnitWeigher>;
+  static constexpr Fingerprint kHole = 0; // 环里已被摘掉的位置
+
+  // 0 留给空洞
+  static Fingerprint normalize(Fingerprint fp) { return fp == kHole ? 1 : fp; }
+
+  std::size_t mask() const { return ring_.size() - 1; }
+
+  std::size_t weightAt(Index pos) const {
+    if constexpr (kWeighted)
+      return weights_[pos];
+    else
+      return 1;
+  }
+
+  Index find(Fingerprint fp, std::uint64_t hash) const {
+    return index_.find(fp, hash,
+                       [this](Index i) -> const Fingerprint & { return ring_[i]; });
+  }
+
+  // 把 pos 变成空洞并扣掉计数；落在最旧一端的空洞直接收回
+  void release(Index pos) {
+    if constexpr (kWeighted)
+      weight_ -= weights_[pos];
+    ring_[pos] = kHole;
+    --live_;
+    while (count_ > 0 && ring_[head_] == kHole) {
+      head_ = (head_ + 1) & mask();
+      --count_;
+    }
+  }
+
+  // 环满时：空洞占了一半以上就原地压实，否则容量翻倍；两种情况都重建索引
+  void grow() {
+    const std::size_t size =
+        ring_.empty() ? kInitialSize
+        : live_ * 2 <= ring_.size() ? ring_.size()
+                                    : ring_.size() * 2;
+    std::vector<Fingerprint> ring(size, kHole);
+    std::vector<std::size_t> weights(kWeighted ? size : 0);
+    std::size_t n = 0;
+    for (std::size_t k = 0; k < count_; ++k) {
+      const std::size_t pos = (head_ + k) & mask();
+      if (ring_[pos] == kHole)
+        continue;
+      ring[n] = ring_[pos];
+      if constexpr (kWeighted)
+        weights[n] = weights_[pos];
+      ++n;
+    }
+    ring_.swap(ring);
+    weights_.swap(weights);
+    head_ = 0;
+    count_ = n;
+
+    index_ = FlatIndex<Fingerprint>(n);
+    for (std::size_t pos = 0; pos < n; ++pos) {
+      index_.insert(index_.hashOf(ring_[pos]), static_cast<Index>(pos),
+                    [this](Index i) { return index_.hashOf(ring_[i]); });
+    }
+  }
+
+  static constexpr std::size_t kInitialSize = 16; // 环的大小始终是 2 的幂
+
+  std::vector<Fingerprint> ring_;   // 按淘汰先后排列，head_ 处最旧
+  std::vector<std::size_t> weights_; // 与 ring_ 一一对应(默认权重下为空)
+  FlatIndex<Fingerprint> index_;    // 指纹 -> 环里的位置
+  std::size_t head_ = 0;            // 最旧的位置
+  std::size_t count_ = 0;           // head_ 之后占用的位置数(含空洞)
+  std::size_t live_ = 0;            // 幽灵个数
+  std::size_t weight_ = 0;          // 幽灵的权重之和(默认权重下不用)
+};
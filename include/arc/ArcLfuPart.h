@@ -1,195 +1,405 @@
 #pragma once
 
+#include "../FlatIndex.h"
+#include "../HashUtil.h"
+#include "../ICachePolicy.h"
+#include "ArcGhost.h"
 #include "ArcNode.h"
-#include <list>
-#include <map>
-#include <mutex>
+#include <algorithm>
+#include <memory>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
-template <typename Key, typename Value> class ArcLfuPart {
+// ARC 的频次部分(T2)。本身不加锁，由 ArcCache 在同一个临界区内统一调用。
+// 容量、幽灵容量及增减容量都以 Weigher 的单位计。
+// 结点存放在 ArcCache 持有的 NodeSlab 中，主缓存用 FlatIndex 索引，
+// 幽灵链表只记录 key 的指纹(见 ArcGhost.h)
+template <typename Key, typename Value,
+          WeigherFor<Key, Value> Weigher = UnitWeigher>
+class ArcLfuPart {
 public:
   using NodeType = ArcNode<Key, Value>;
-  using NodePtr = std::shared_ptr<NodeType>;
-  using NodeMap = std::unordered_map<Key, NodePtr>;
-  using FreqMap = std::map<size_t, std::list<NodePtr>>;
+  using Slab = NodeSlab<NodeType>;
+  using List = ArcList<Key, Value>;
+  using Index = typename NodeType::Index;
+  static constexpr Index kNil = NodeType::kNil;
 
-  explicit ArcLfuPart(size_t capacity, size_t transformThreshold)
-      : capacity_(capacity), ghostCapacity_(capacity),
-        transformThreshold_(transformThreshold), minFreq_(0) {
-    initializeLists();
-  }
+private:
+  // 同一访问频次的结点链表(侵入式，复用 ArcNode 的 prev_/next_)。
+  // 所有非空桶按频次升序串成双向链表，首桶即最小频次，
+  // 因此升频、淘汰、更新最小频次全部是 O(1)，不需要遍历桶内结点。
+  struct FreqBucket {
+    size_t freq = 0;
+    List nodes; // 头部为该频次中最早进入的结点
+    FreqBucket *prev = nullptr;
+    FreqBucket *next = nullptr;
+
+    bool empty() const { return nodes.empty(); }
+  };
+
+  using FreqMap = std::unordered_map<size_t, std::unique_ptr<FreqBucket>>;
 
-  bool put(Key key, Value value) {
+public:
+  explicit ArcLfuPart(Slab &nodes, size_t capacity, size_t transformThreshold,
+                      Weigher weigher = Weigher())
+      : nodes_(nodes), capacity_(capacity), ghostCapacity_(capacity),
+        transformThreshold_(transformThreshold), weigher_(std::move(weigher)) {}
+
+  // 写入或覆盖：key/value 按调用方传入的值类别转发，右值直接移动进结点
+  template <typename K, typename... Args> bool put(K &&key, Args &&...args) {
     if (capacity_ == 0)
       return false;
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = mainCache_.find(key);
-    if (it != mainCache_.end()) {
-      return updateExistingNode(it->second, value);
+    const std::uint64_t hash = mainIndex_.hashOf(key);
+    const Index i = find(key, hash);
+    if (i != kNil) {
+      return updateExistingNode(i, std::forward<Args>(args)...);
     }
-    return addNewNode(key, value);
+    return addNewNode(hash, std::forward<K>(key), std::forward<Args>(args)...);
   }
 
-  bool get(Key key, Value &value) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = mainCache_.find(key);
-    if (it != mainCache_.end()) {
-      updateNodeFrequency(it->second);
-      value = it->second->getValue();
-      return true;
+  // 命中时更新频次并返回结点下标，未命中返回 kNil
+  template <typename K> Index get(const K &key) {
+    const Index i = find(key);
+    if (i == kNil)
+      return kNil;
+
+    updateNodeFrequency(i);
+    return i;
+  }
+
+  template <typename K> bool contain(const K &key) const {
+    return find(key) != kNil;
+  }
+
+  // 权重为 weight 的结点能否放进这一侧
+  bool hasCapacity(size_t weight = 1) const {
+    return capacity_ > 0 && weight <= capacity_;
+  }
+
+  // 接管从 LRU 部分迁移过来的结点(同一个 key 只保留一个结点)，
+  // 调用前需确认 hasCapacity(weight)
+  void adopt(Index i) {
+    NodeType &node = nodes_[i];
+    while (weight_ + node.weight_ > capacity_) {
+      evictLeastFrequent();
     }
-    return false;
+    weight_ += node.weight_;
+    node.accessCount_ = 1;
+    indexInsert(i);
+    frequencyOneBucket()->nodes.pushBack(nodes_, i);
+  }
+
+  // 命中幽灵时摘掉它，weight 返回该条目的权重(ARC 按它调整两侧容量)
+  template <typename K> bool checkGhost(const K &key, size_t &weight) {
+    return ghost_.take(mainIndex_.hashOf(key), weight);
+  }
+
+  size_t capacity() const { return capacity_; }
+  size_t size() const { return mainIndex_.size(); }
+  size_t weight() const { return weight_; }
+  // 主索引与幽灵链表占用的字节数(结点存储由 ArcCache 统计)
+  size_t indexBytes() const {
+    return mainIndex_.memoryBytes() + ghost_.memoryBytes();
   }
 
-  bool contain(Key key) { return mainCache_.find(key) != mainCache_.end(); }
+  void increaseCapacity(size_t n = 1) { capacity_ += n; }
+  void setCapacity(size_t n) { capacity_ = n; } // 只用于空的部分(快照恢复)
 
-  bool checkGhost(Key key) {
-    auto it = ghostCache_.find(key);
-    if (it != ghostCache_.end()) {
-      removeFromGhost(it->second);
-      ghostCache_.erase(it);
-      return true;
+  // 淘汰进幽灵链表前回调；指向 ArcCache 持有的 listener
+  void setEvictionListener(const EvictionListener<Key, Value> *listener) {
+    onEvict_ = listener;
+  }
+
+  // 删除 pred(key, value) 为真的条目(不进入幽灵链表) | 返回删除的个数
+  template <typename Pred> size_t removeIf(Pred &pred) {
+    // 先收集再删除：删除会回收空的频次桶，不能边遍历边删
+    std::vector<Index> matched;
+    mainIndex_.forEach([&](Index i) {
+      if (pred(std::as_const(nodes_[i].getKey()),
+               std::as_const(nodes_[i].getValue())))
+        matched.push_back(i);
+    });
+    for (Index i : matched) {
+      removeNode(i);
     }
-    return false;
+    return matched.size();
+  }
+
+  // 清空主缓存和幽灵链表；结点由 ArcCache 随 NodeSlab 一起释放
+  void clear() {
+    mainIndex_.clear();
+    freqMap_.clear();
+    minBucket_ = nullptr;
+    ghost_ = ArcGhostList<Weigher>();
+    weight_ = 0;
   }
 
-  void increaseCapacity() { ++capacity_; }
+  // 快照：按淘汰顺序的逆序(频次从高到低，同频次从新到旧)写出
+  // key、value、访问次数，再写幽灵链表
+  void writeSnapshot(SnapshotWriter &out) const {
+    out.u64(mainIndex_.size());
+    const FreqBucket *bucket = minBucket_;
+    while (bucket && bucket->next)
+      bucket = bucket->next;
+    for (; bucket; bucket = bucket->prev) {
+      for (Index i = bucket->nodes.back(); i != kNil; i = nodes_[i].prev_) {
+        out.value(nodes_[i].getKey());
+        out.value(nodes_[i].getValue());
+        out.u64(nodes_[i].accessCount_);
+      }
+    }
+    ghost_.writeSnapshot(out);
+  }
 
-  bool decreaseCapacity() {
-    if (capacity_ <= 0)
+  // 按写出的顺序依次放到淘汰端，放不下的条目跳过(后面还有幽灵要读)
+  bool restoreSnapshot(SnapshotReader &in) {
+    std::uint64_t count = 0;
+    if (!in.u64(count))
       return false;
-    if (mainCache_.size() == capacity_) {
+    bool full = false;
+    for (std::uint64_t n = 0; n < count; ++n) {
+      Key key{};
+      Value value{};
+      std::uint64_t accessCount = 0;
+      if (!in.value(key) || !in.value(value) || !in.u64(accessCount))
+        return false;
+      if (!full)
+        full = !appendLeast(std::move(key), std::move(value), accessCount);
+    }
+    return ghost_.restoreSnapshot(in, ghostCapacity_);
+  }
+
+  // 缩容最多 n 个单位，超出新容量的部分按频次淘汰 | 返回实际缩掉的单位数
+  size_t decreaseCapacity(size_t n = 1) {
+    n = std::min(n, capacity_);
+    capacity_ -= n;
+    while (weight_ > capacity_) {
       evictLeastFrequent();
     }
-    --capacity_;
-    return true;
+    return n;
   }
 
 private:
-  void initializeLists() {
-    ghostHead_ = std::make_shared<NodeType>();
-    ghostTail_ = std::make_shared<NodeType>();
-    ghostHead_->next_ = ghostTail_;
-    ghostTail_->prev_ = ghostHead_;
+  template <typename K> Index find(const K &key) const {
+    return find(key, mainIndex_.hashOf(key));
   }
 
-  bool updateExistingNode(NodePtr node, const Value &value) {
-    node->setValue(value);
-    updateNodeFrequency(node);
-    return true;
+  template <typename K> Index find(const K &key, std::uint64_t hash) const {
+    return mainIndex_.find(key, hash, [this](Index i) -> const Key & {
+      return nodes_[i].getKey();
+    });
   }
 
-  bool addNewNode(const Key &key, const Value &value) {
-    if (mainCache_.size() >= capacity_) {
+  void indexInsert(Index i) {
+    mainIndex_.insert(mainIndex_.hashOf(nodes_[i].getKey()), i,
+                      [this](Index j) {
+                        return mainIndex_.hashOf(nodes_[j].getKey());
+                      });
+  }
+
+  template <typename... Args>
+  bool updateExistingNode(Index i, Args &&...args) {
+    NodeType &node = nodes_[i];
+    node.setValue(std::forward<Args>(args)...);
+    const size_t weight = weigher_(node.getKey(), node.getValue());
+    if (weight > capacity_) {
+      // 新值单独就超过这一侧的容量：和超重的新条目一样拒绝写入，
+      // 只摘掉它自己，不进幽灵链表，也不通知监听者
+      removeNode(i);
+      return false;
+    }
+    weight_ = weight_ - node.weight_ + weight;
+    node.weight_ = weight;
+    updateNodeFrequency(i);
+    // 新值变重时按频次淘汰，直到总权重重新放得下
+    while (weight_ > capacity_) {
       evictLeastFrequent();
     }
+    return true;
+  }
 
-    NodePtr newNode = std::make_shared<NodeType>(key, value);
-    mainCache_[key] = newNode;
+  template <typename K, typename... Args>
+  bool addNewNode(std::uint64_t hash, K &&key, Args &&...args) {
+    const Index i =
+        nodes_.create(std::forward<K>(key), std::forward<Args>(args)...);
+    NodeType &node = nodes_[i];
+    node.weight_ = weigher_(node.getKey(), node.getValue());
+    if (node.weight_ > capacity_) {
+      nodes_.destroy(i);
+      return false; // 单个条目超过这一侧的容量
+    }
 
-    // 将新节点添加到频率为1的列表中
-    if (freqMap_.find(1) == freqMap_.end()) {
-      freqMap_[1] = std::list<NodePtr>();
+    while (weight_ + node.weight_ > capacity_) {
+      evictLeastFrequent();
     }
-    freqMap_[1].push_back(newNode);
-    minFreq_ = 1;
+    weight_ += node.weight_;
+    mainIndex_.insert(hash, i, [this](Index j) {
+      return mainIndex_.hashOf(nodes_[j].getKey());
+    });
+
+    frequencyOneBucket()->nodes.pushBack(nodes_, i);
 
     return true;
   }
 
-  void updateNodeFrequency(NodePtr node) {
-    size_t oldFreq = node->getAccessCount();
-    node->incrementAccessCount();
-    size_t newFreq = node->getAccessCount();
-
-    // 从旧频率列表中移除
-    auto &oldList = freqMap_[oldFreq];
-    oldList.remove(node);
-    if (oldList.empty()) {
-      freqMap_.erase(oldFreq);
-      if (oldFreq == minFreq_) {
-        minFreq_ = newFreq;
-      }
+  // 快照恢复用：容量不够时返回 false。写出顺序的频次不增，
+  // 只会落在最小频次桶或在它之前新建；顺序被打乱时并入最小频次桶
+  bool appendLeast(Key &&key, Value &&value, std::uint64_t accessCount) {
+    const std::uint64_t hash = mainIndex_.hashOf(key);
+    if (find(key, hash) != kNil)
+      return true;
+    const Index i = nodes_.create(std::move(key), std::move(value));
+    NodeType &node = nodes_[i];
+    node.weight_ = weigher_(node.getKey(), node.getValue());
+    if (weight_ + node.weight_ > capacity_) {
+      nodes_.destroy(i);
+      return false;
     }
+    weight_ += node.weight_;
 
-    // 添加到新频率列表
-    if (freqMap_.find(newFreq) == freqMap_.end()) {
-      freqMap_[newFreq] = std::list<NodePtr>();
-    }
-    freqMap_[newFreq].push_back(node);
+    size_t freq = static_cast<size_t>(std::max<std::uint64_t>(1, accessCount));
+    if (minBucket_ && freq > minBucket_->freq)
+      freq = minBucket_->freq;
+    node.accessCount_ = freq;
+    FreqBucket *bucket = minBucket_ && minBucket_->freq == freq
+                             ? minBucket_
+                             : insertBucketAfter(nullptr, freq);
+    bucket->nodes.pushFront(nodes_, i);
+    mainIndex_.insert(hash, i, [this](Index j) {
+      return mainIndex_.hashOf(nodes_[j].getKey());
+    });
+    return true;
   }
 
-  void evictLeastFrequent() {
-    if (freqMap_.empty())
-      return;
+  // 新结点进入频率为 1 的桶，该桶若存在必然是首桶
+  FreqBucket *frequencyOneBucket() {
+    if (minBucket_ && minBucket_->freq == 1)
+      return minBucket_;
+    return insertBucketAfter(nullptr, 1);
+  }
 
-    // 获取最小频率的列表
-    auto &minFreqList = freqMap_[minFreq_];
-    if (minFreqList.empty())
+  void updateNodeFrequency(Index i) {
+    NodeType &node = nodes_[i];
+    auto it = freqMap_.find(node.getAccessCount());
+    if (it == freqMap_.end())
       return;
+    FreqBucket *oldBucket = it->second.get();
 
-    // 移除最少使用的节点
-    NodePtr leastNode = minFreqList.front();
-    minFreqList.pop_front();
+    node.incrementAccessCount();
+    size_t newFreq = node.getAccessCount();
 
-    // 如果该频率的列表为空，则删除该频率项
-    if (minFreqList.empty()) {
-      freqMap_.erase(minFreq_);
-      // 更新最小频率
-      if (!freqMap_.empty()) {
-        minFreq_ = freqMap_.begin()->first;
-      }
+    // 目标桶只可能是紧邻的下一个桶，不存在则在其后新建
+    FreqBucket *newBucket = oldBucket->next;
+    if (!newBucket || newBucket->freq != newFreq) {
+      newBucket = insertBucketAfter(oldBucket, newFreq);
     }
 
-    // 将节点移到幽灵缓存
-    if (ghostCache_.size() >= ghostCapacity_) {
-      removeOldestGhost();
+    oldBucket->nodes.unlink(nodes_, i);
+    newBucket->nodes.pushBack(nodes_, i);
+    if (oldBucket->empty()) {
+      eraseBucket(oldBucket);
     }
-    addToGhost(leastNode);
+  }
 
-    // 从主缓存中移除
-    mainCache_.erase(leastNode->getKey());
+  // 直接删除结点(不进入幽灵链表)
+  void removeNode(Index i) {
+    FreqBucket *bucket = freqMap_.find(nodes_[i].getAccessCount())->second.get();
+    bucket->nodes.unlink(nodes_, i);
+    if (bucket->empty())
+      eraseBucket(bucket);
+    weight_ -= nodes_[i].weight_;
+    mainIndex_.erase(mainIndex_.hashOf(nodes_[i].getKey()), i);
+    nodes_.destroy(i);
   }
 
-  void removeFromGhost(NodePtr node) {
-    if (!node->prev_.expired() && node->next_) {
-      auto prev = node->prev_.lock();
-      prev->next_ = node->next_;
-      node->next_->prev_ = node->prev_;
-      node->next_ = nullptr; // 清空指针，防止悬垂引用
+  void evictLeastFrequent() {
+    if (!minBucket_)
+      return;
+
+    // 最小频次桶的头部是该频次中最早进入的结点
+    FreqBucket *bucket = minBucket_;
+    const Index leastNode = bucket->nodes.front();
+    bucket->nodes.unlink(nodes_, leastNode);
+    if (bucket->empty()) {
+      eraseBucket(bucket);
     }
+    weight_ -= nodes_[leastNode].weight_;
+    moveToGhost(leastNode);
   }
 
-  void addToGhost(NodePtr node) {
-    node->next_ = ghostTail_;
-    node->prev_ = ghostTail_->prev_;
-    if (!ghostTail_->prev_.expired()) {
-      ghostTail_->prev_.lock()->next_ = node;
+  // 在 pos 之后插入一个新的频次桶(pos 为空表示插到最前面)
+  FreqBucket *insertBucketAfter(FreqBucket *pos, size_t freq) {
+    std::unique_ptr<FreqBucket> bucket;
+    if (!spareBuckets_.empty()) {
+      // 复用已清空的桶
+      bucket = std::move(spareBuckets_.back());
+      spareBuckets_.pop_back();
+    } else {
+      bucket = std::make_unique<FreqBucket>();
     }
-    ghostTail_->prev_ = node;
-    ghostCache_[node->getKey()] = node;
+    bucket->freq = freq;
+
+    FreqBucket *raw = bucket.get();
+    raw->prev = pos;
+    raw->next = pos ? pos->next : minBucket_;
+    if (raw->next)
+      raw->next->prev = raw;
+    if (pos)
+      pos->next = raw;
+    else
+      minBucket_ = raw;
+
+    freqMap_.emplace(freq, std::move(bucket));
+    return raw;
   }
 
-  void removeOldestGhost() {
-    NodePtr oldestGhost = ghostHead_->next_;
-    if (oldestGhost != ghostTail_) {
-      removeFromGhost(oldestGhost);
-      ghostCache_.erase(oldestGhost->getKey());
+  void eraseBucket(FreqBucket *bucket) {
+    if (bucket->prev)
+      bucket->prev->next = bucket->next;
+    else
+      minBucket_ = bucket->next;
+    if (bucket->next)
+      bucket->next->prev = bucket->prev;
+    bucket->prev = bucket->next = nullptr;
+
+    auto it = freqMap_.find(bucket->freq);
+    if (spareBuckets_.size() < kMaxSpareBuckets) {
+      spareBuckets_.push_back(std::move(it->second));
     }
+    freqMap_.erase(it);
+  }
+
+  // 结点换成幽灵：只留下指纹和权重，结点本身(连同 value)立即释放。
+  // 幽灵同样按权重计，放不下时淘汰最旧的幽灵
+  void moveToGhost(Index i) {
+    const size_t weight = nodes_[i].weight_;
+    const std::uint64_t fp = mainIndex_.hashOf(nodes_[i].getKey());
+    if (onEvict_ && *onEvict_)
+      (*onEvict_)(nodes_[i].getKey(), nodes_[i].getValue());
+    mainIndex_.erase(fp, i);
+    nodes_.destroy(i);
+    while (!ghost_.empty() && ghost_.weight() + weight > ghostCapacity_) {
+      ghost_.popOldest();
+    }
+    ghost_.push(fp, weight);
   }
 
 private:
+  static constexpr size_t kMaxSpareBuckets = 8;
+
+  Slab &nodes_; // ArcCache 持有，两部分共用
   size_t capacity_;
   size_t ghostCapacity_;
   size_t transformThreshold_;
-  size_t minFreq_;
-  std::mutex mutex_;
-
-  NodeMap mainCache_;
-  NodeMap ghostCache_;
-  FreqMap freqMap_;
+  size_t weight_ = 0; // 主缓存条目的权重之和
+  [[no_unique_address]] Weigher weigher_;
 
-  NodePtr ghostHead_;
-  NodePtr ghostTail_;
+  FlatIndex<Key> mainIndex_;        // key -> 主缓存结点
+  FreqMap freqMap_;                 // 频次 -> 桶
+  FreqBucket *minBucket_ = nullptr; // 最小频次桶(桶链表头)
+  std::vector<std::unique_ptr<FreqBucket>> spareBuckets_;
+  ArcGhostList<Weigher> ghost_; // 最近淘汰的 key 指纹
+  const EvictionListener<Key, Value> *onEvict_ = nullptr;
 };
@@ -1,195 +1,289 @@
 #pragma once
 
+#include "../FlatIndex.h"
+#include "../HashUtil.h"
+#include "../ICachePolicy.h"
+#include "ArcGhost.h"
 #include "ArcNode.h"
-#include <mutex>
-#include <unordered_map>
-
-template <typename Key, typename Value> class ArcLruPart {
+#include <algorithm>
+#include <utility>
+
+// ARC 的最近访问部分(T1)。本身不加锁，由 ArcCache 在同一个临界区内统一调用。
+// 容量、幽灵容量及增减容量都以 Weigher 的单位计。
+// 结点存放在 ArcCache 持有的 NodeSlab 中，主链表用 FlatIndex 索引，
+// 幽灵链表只记录 key 的指纹(见 ArcGhost.h)
+template <typename Key, typename Value,
+          WeigherFor<Key, Value> Weigher = UnitWeigher>
+class ArcLruPart {
 public:
   using NodeType = ArcNode<Key, Value>;
-  using NodePtr = std::shared_ptr<NodeType>;
-  using NodeMap = std::unordered_map<Key, NodePtr>;
-
-  explicit ArcLruPart(size_t capacity, size_t transformThreshold)
-      : capacity_(capacity), ghostCapacity_(capacity),
-        transformThreshold_(transformThreshold) {
-    initializeLists();
-  }
-
-  bool put(Key key, Value value) {
+  using Slab = NodeSlab<NodeType>;
+  using List = ArcList<Key, Value>;
+  using Index = typename NodeType::Index;
+  static constexpr Index kNil = NodeType::kNil;
+
+  explicit ArcLruPart(Slab &nodes, size_t capacity, size_t transformThreshold,
+                      Weigher weigher = Weigher())
+      : nodes_(nodes), capacity_(capacity), ghostCapacity_(capacity),
+        transformThreshold_(transformThreshold), weigher_(std::move(weigher)) {}
+
+  // 写入或覆盖：key/value 按调用方传入的值类别转发，右值直接移动进结点
+  template <typename K, typename... Args> bool put(K &&key, Args &&...args) {
     if (capacity_ == 0)
       return false;
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = mainCache_.find(key);
-    if (it != mainCache_.end()) {
-      return updateExistingNode(it->second, value);
+    const std::uint64_t hash = mainIndex_.hashOf(key);
+    const Index i = find(key, hash);
+    if (i != kNil) {
+      return updateExistingNode(i, std::forward<Args>(args)...);
     }
-    return addNewNode(key, value);
+    return addNewNode(hash, std::forward<K>(key), std::forward<Args>(args)...);
   }
 
-  bool get(Key key, Value &value, bool &shouldTransform) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = mainCache_.find(key);
-    if (it != mainCache_.end()) {
-      shouldTransform = updateNodeAccess(it->second);
-      value = it->second->getValue();
-      return true;
-    }
-    return false;
-  }
+  // 命中时返回结点下标(未命中为 kNil)，shouldTransform 表示访问次数已达到
+  // 转入 LFU 部分的门槛
+  template <typename K> Index get(const K &key, bool &shouldTransform) {
+    const Index i = find(key);
+    if (i == kNil)
+      return kNil;
 
-  bool checkGhost(Key key) {
-    auto it = ghostCache_.find(key);
-    if (it != ghostCache_.end()) {
-      removeFromGhost(it->second);
-      ghostCache_.erase(it);
-      return true;
-    }
-    return false;
+    shouldTransform = updateNodeAccess(i);
+    return i;
   }
 
-  void increaseCapacity() { ++capacity_; }
+  // 把结点从主链表中摘出交给 LFU 部分(不进入幽灵链表)
+  void extract(Index i) {
+    main_.unlink(nodes_, i);
+    weight_ -= nodes_[i].weight_;
+    mainIndex_.erase(mainIndex_.hashOf(nodes_[i].getKey()), i);
+  }
 
-  bool decreaseCapacity() {
-    if (capacity_ == 0)
-      return false;
-    if (mainCache_.size() == capacity_) {
-      evictLeastRecent();
-    }
-    --capacity_;
-    return true;
+  // 命中幽灵时摘掉它，weight 返回该条目的权重(ARC 按它调整两侧容量)
+  template <typename K> bool checkGhost(const K &key, size_t &weight) {
+    return ghost_.take(mainIndex_.hashOf(key), weight);
   }
 
-private:
-  void initializeLists() {
-    mainHead_ = std::make_shared<NodeType>();
-    mainTail_ = std::make_shared<NodeType>();
-    mainHead_->next_ = mainTail_;
-    mainTail_->prev_ = mainHead_;
+  template <typename K> bool contain(const K &key) const {
+    return find(key) != kNil;
+  }
 
-    ghostHead_ = std::make_shared<NodeType>();
-    ghostTail_ = std::make_shared<NodeType>();
-    ghostHead_->next_ = ghostTail_;
-    ghostTail_->prev_ = ghostHead_;
+  size_t capacity() const { return capacity_; }
+  size_t size() const { return main_.size(); }
+  size_t weight() const { return weight_; }
+  // 主索引与幽灵链表占用的字节数(结点存储由 ArcCache 统计)
+  size_t indexBytes() const {
+    return mainIndex_.memoryBytes() + ghost_.memoryBytes();
   }
 
-  bool updateExistingNode(NodePtr node, const Value &value) {
-    node->setValue(value);
-    moveToFront(node);
-    return true;
+  void increaseCapacity(size_t n = 1) { capacity_ += n; }
+  void setCapacity(size_t n) { capacity_ = n; } // 只用于空的部分(快照恢复)
+
+  // 淘汰进幽灵链表前回调；指向 ArcCache 持有的 listener
+  void setEvictionListener(const EvictionListener<Key, Value> *listener) {
+    onEvict_ = listener;
   }
 
-  bool addNewNode(const Key &key, const Value &value) {
-    if (mainCache_.size() >= capacity_) {
-      evictLeastRecent(); // 驱逐最近最少访问
+  // 删除 pred(key, value) 为真的条目(不进入幽灵链表) | 返回删除的个数
+  template <typename Pred> size_t removeIf(Pred &pred) {
+    size_t removed = 0;
+    for (Index i = main_.front(); i != kNil;) {
+      const Index next = nodes_[i].next_;
+      if (pred(std::as_const(nodes_[i].getKey()),
+               std::as_const(nodes_[i].getValue()))) {
+        extract(i);
+        nodes_.destroy(i);
+        ++removed;
+      }
+      i = next;
     }
+    return removed;
+  }
 
-    NodePtr newNode = std::make_shared<NodeType>(key, value);
-    mainCache_.try_emplace(key, newNode);
-    addToFront(newNode);
-    return true;
+  // 清空主链表和幽灵链表；结点由 ArcCache 随 NodeSlab 一起释放
+  void clear() {
+    mainIndex_.clear();
+    main_ = List();
+    ghost_ = ArcGhostList<Weigher>();
+    weight_ = 0;
   }
 
-  bool updateNodeAccess(NodePtr node) {
-    moveToFront(node);
-    node->incrementAccessCount();
-    return node->getAccessCount() >= transformThreshold_;
+  // 批量导入前预留主索引
+  void reserve(size_t expected) {
+    mainIndex_.reserve(expected, [this](Index j) {
+      return mainIndex_.hashOf(nodes_[j].getKey());
+    });
   }
 
-  void moveToFront(NodePtr node) {
-    // 先从当前位置移除
-    if (!node->prev_.expired() && node->next_) {
-      auto prev = node->prev_.lock();
-      prev->next_ = node->next_;
-      node->next_->prev_ = node->prev_;
-      node->next_ = nullptr; // 清空指针，防止悬垂引用
+  // 快照：主链表从新到旧写出 key、value、访问次数，再写幽灵链表
+  void writeSnapshot(SnapshotWriter &out) const {
+    out.u64(main_.size());
+    for (Index i = main_.front(); i != kNil; i = nodes_[i].next_) {
+      out.value(nodes_[i].getKey());
+      out.value(nodes_[i].getValue());
+      out.u64(nodes_[i].accessCount_);
     }
-
-    // 添加到头部
-    addToFront(node);
+    ghost_.writeSnapshot(out);
   }
 
-  void addToFront(NodePtr node) {
-    node->next_ = mainHead_->next_;
-    node->prev_ = mainHead_;
-    mainHead_->next_->prev_ = node;
-    mainHead_->next_ = node;
+  // 按写出的顺序依次接到最旧的一端，放不下的条目跳过(后面还有幽灵要读)
+  bool restoreSnapshot(SnapshotReader &in) {
+    std::uint64_t count = 0;
+    if (!in.u64(count))
+      return false;
+    bool full = false;
+    for (std::uint64_t n = 0; n < count; ++n) {
+      Key key{};
+      Value value{};
+      std::uint64_t accessCount = 0;
+      if (!in.value(key) || !in.value(value) || !in.u64(accessCount))
+        return false;
+      if (!full)
+        full = !appendOldest(std::move(key), std::move(value), accessCount);
+    }
+    return ghost_.restoreSnapshot(in, ghostCapacity_);
   }
 
-  void evictLeastRecent() {
-    NodePtr leastRecent = mainTail_->prev_.lock();
-    if (!leastRecent || leastRecent == mainHead_)
-      return;
+  // 缩容最多 n 个单位，超出新容量的部分从最旧的一端淘汰 | 返回实际缩掉的单位数
+  size_t decreaseCapacity(size_t n = 1) {
+    n = std::min(n, capacity_);
+    capacity_ -= n;
+    while (weight_ > capacity_) {
+      evictLeastRecent();
+    }
+    return n;
+  }
 
-    // 从主链表中移除
-    removeFromMain(leastRecent);
+private:
+  template <typename K> Index find(const K &key) const {
+    return find(key, mainIndex_.hashOf(key));
+  }
 
-    // 添加到幽灵缓存
-    if (ghostCache_.size() >= ghostCapacity_) {
-      removeOldestGhost();
-    }
-    addToGhost(leastRecent);
+  template <typename K> Index find(const K &key, std::uint64_t hash) const {
+    return mainIndex_.find(key, hash, [this](Index i) -> const Key & {
+      return nodes_[i].getKey();
+    });
+  }
 
-    // 从主缓存映射中移除
-    mainCache_.erase(leastRecent->getKey());
+  void indexInsert(Index i) {
+    mainIndex_.insert(mainIndex_.hashOf(nodes_[i].getKey()), i,
+                      [this](Index j) {
+                        return mainIndex_.hashOf(nodes_[j].getKey());
+                      });
   }
 
-  void removeFromMain(NodePtr node) {
-    if (!node->prev_.expired() && node->next_) {
-      auto prev = node->prev_.lock();
-      prev->next_ = node->next_;
-      node->next_->prev_ = node->prev_;
-      node->next_ = nullptr; // 清空指针，防止悬垂引用
+  template <typename... Args>
+  bool updateExistingNode(Index i, Args &&...args) {
+    NodeType &node = nodes_[i];
+    node.setValue(std::forward<Args>(args)...);
+    const size_t weight = weigher_(node.getKey(), node.getValue());
+    if (weight > capacity_) {
+      // 新值单独就超过这一侧的容量：和超重的新条目一样拒绝写入，
+      // 只摘掉它自己，不进幽灵链表，也不通知监听者
+      extract(i);
+      nodes_.destroy(i);
+      return false;
+    }
+    weight_ = weight_ - node.weight_ + weight;
+    node.weight_ = weight;
+    moveToFront(i);
+    // 新值变重时从最旧的一端淘汰，刚更新的结点在最前端，不会被淘汰
+    while (weight_ > capacity_) {
+      evictLeastRecent();
     }
+    return true;
   }
 
-  void removeFromGhost(NodePtr node) {
-    if (!node->prev_.expired() && node->next_) {
-      auto prev = node->prev_.lock();
-      prev->next_ = node->next_;
-      node->next_->prev_ = node->prev_;
-      node->next_ = nullptr; // 清空指针，防止悬垂引用
+  template <typename K, typename... Args>
+  bool addNewNode(std::uint64_t hash, K &&key, Args &&...args) {
+    const Index i =
+        nodes_.create(std::forward<K>(key), std::forward<Args>(args)...);
+    NodeType &node = nodes_[i];
+    node.weight_ = weigher_(node.getKey(), node.getValue());
+    if (node.weight_ > capacity_) {
+      nodes_.destroy(i);
+      return false; // 单个条目超过这一侧的容量
+    }
+
+    while (weight_ + node.weight_ > capacity_) {
+      evictLeastRecent(); // 驱逐最近最少访问
     }
+    weight_ += node.weight_;
+    mainIndex_.insert(hash, i, [this](Index j) {
+      return mainIndex_.hashOf(nodes_[j].getKey());
+    });
+    main_.pushFront(nodes_, i);
+    return true;
   }
 
-  void addToGhost(NodePtr node) {
-    // 重置节点的访问计数
-    node->accessCount_ = 1;
+  // 快照恢复用：容量不够时返回 false
+  bool appendOldest(Key &&key, Value &&value, std::uint64_t accessCount) {
+    const std::uint64_t hash = mainIndex_.hashOf(key);
+    if (find(key, hash) != kNil)
+      return true;
+    const Index i = nodes_.create(std::move(key), std::move(value));
+    NodeType &node = nodes_[i];
+    node.weight_ = weigher_(node.getKey(), node.getValue());
+    if (weight_ + node.weight_ > capacity_) {
+      nodes_.destroy(i);
+      return false;
+    }
+    weight_ += node.weight_;
+    node.accessCount_ = std::max<std::uint64_t>(1, accessCount);
+    mainIndex_.insert(hash, i, [this](Index j) {
+      return mainIndex_.hashOf(nodes_[j].getKey());
+    });
+    main_.pushBack(nodes_, i);
+    return true;
+  }
 
-    // 添加到幽灵缓存的头部
-    node->next_ = ghostHead_->next_;
-    node->prev_ = ghostHead_;
-    ghostHead_->next_->prev_ = node;
-    ghostHead_->next_ = node;
+  bool updateNodeAccess(Index i) {
+    moveToFront(i);
+    nodes_[i].incrementAccessCount();
+    return nodes_[i].getAccessCount() >= transformThreshold_;
+  }
 
-    // 添加到幽灵缓存映射
-    ghostCache_[node->getKey()] = node;
+  void moveToFront(Index i) {
+    if (main_.front() == i)
+      return;
+    main_.unlink(nodes_, i);
+    main_.pushFront(nodes_, i);
   }
 
-  void removeOldestGhost() {
-    // 使用lock()方法，并添加null检查
-    NodePtr oldestGhost = ghostTail_->prev_.lock();
-    if (!oldestGhost || oldestGhost == ghostHead_)
+  void evictLeastRecent() {
+    const Index leastRecent = main_.back();
+    if (leastRecent == kNil)
       return;
 
-    removeFromGhost(oldestGhost);
-    ghostCache_.erase(oldestGhost->getKey());
+    main_.unlink(nodes_, leastRecent);
+    weight_ -= nodes_[leastRecent].weight_;
+    moveToGhost(leastRecent);
+  }
+
+  // 结点换成幽灵：只留下指纹和权重，结点本身(连同 value)立即释放。
+  // 幽灵同样按权重计，放不下时淘汰最旧的幽灵
+  void moveToGhost(Index i) {
+    const size_t weight = nodes_[i].weight_;
+    const std::uint64_t fp = mainIndex_.hashOf(nodes_[i].getKey());
+    if (onEvict_ && *onEvict_)
+      (*onEvict_)(nodes_[i].getKey(), nodes_[i].getValue());
+    mainIndex_.erase(fp, i);
+    nodes_.destroy(i);
+    while (!ghost_.empty() && ghost_.weight() + weight > ghostCapacity_) {
+      ghost_.popOldest();
+    }
+    ghost_.push(fp, weight);
   }
 
 private:
+  Slab &nodes_; // ArcCache 持有，两部分共用
   size_t capacity_;
   size_t ghostCapacity_;
   size_t transformThreshold_; // 转换门槛值
-  std::mutex mutex_;
-
-  NodeMap mainCache_; // key -> ArcNode
-  NodeMap ghostCache_;
+  size_t weight_ = 0;         // 主链表条目的权重之和
+  [[no_unique_address]] Weigher weigher_;
 
-  // 主链表
-  NodePtr mainHead_;
-  NodePtr mainTail_;
-  // 淘汰链表
-  NodePtr ghostHead_;
-  NodePtr ghostTail_;
+  FlatIndex<Key> mainIndex_;     // key -> 主链表结点
+  List main_;                    // 头部为最近访问
+  ArcGhostList<Weigher> ghost_;  // 最近淘汰的 key 指纹
+  const EvictionListener<Key, Value> *onEvict_ = nullptr;
 };
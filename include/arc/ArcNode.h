@@ -1,30 +1,103 @@
 #pragma once
 
-#include <memory>
+#include "../HashUtil.h"
+#include "../NodeSlab.h"
+#include "../Weigher.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
 
+// ARC 的结点：LRU / LFU 两部分共用 ArcCache 里的同一个 NodeSlab，
+// 结点从 LRU 部分迁移到 LFU 部分时只改链接，不复制；被淘汰时结点立即释放，
+// 幽灵链表里只留 key 的指纹
 template <typename Key, typename Value> class ArcNode {
-private:
-  Key key_;
-  Value value_;
-  size_t accessCount_;
-  std::weak_ptr<ArcNode> prev_;
-  std::shared_ptr<ArcNode> next_;
-
 public:
-  ArcNode() : accessCount_(1), next_(nullptr) {}
+  using Index = std::uint32_t;
+  static constexpr Index kNil = std::numeric_limits<Index>::max();
 
-  ArcNode(Key key, Value value)
-      : key_(key), value_(value), accessCount_(1), next_(nullptr) {}
+  template <typename K, typename... Args>
+  explicit ArcNode(K &&key, Args &&...args)
+      : key_(std::forward<K>(key)), value_(std::forward<Args>(args)...) {}
 
   // Getters
-  Key getKey() const { return key_; }
-  Value getValue() const { return value_; }
+  const Key &getKey() const { return key_; }
+  const Value &getValue() const { return value_; }
   size_t getAccessCount() const { return accessCount_; }
+  size_t getWeight() const { return weight_; }
 
   // Setters
-  void setValue(const Value &value) { value_ = value; }
+  template <typename... Args> void setValue(Args &&...args) {
+    assignValue(value_, std::forward<Args>(args)...);
+  }
   void incrementAccessCount() { ++accessCount_; }
 
-  template <typename K, typename V> friend class ArcLruPart;
-  template <typename K, typename V> friend class ArcLfuPart;
+private:
+  Key key_;
+  Value value_;
+  size_t accessCount_ = 1;
+  size_t weight_ = 0; // 写入时由 Weigher 算出
+  Index prev_ = kNil;
+  Index next_ = kNil;
+
+  template <typename K, typename V> friend class ArcList;
+  template <typename K, typename V, WeigherFor<K, V> W> friend class ArcLruPart;
+  template <typename K, typename V, WeigherFor<K, V> W> friend class ArcLfuPart;
+};
+
+// 串在 NodeSlab 里的侵入式双向链表，只记录首尾下标和长度
+template <typename Key, typename Value> class ArcList {
+public:
+  using Node = ArcNode<Key, Value>;
+  using Slab = NodeSlab<Node>;
+  using Index = typename Node::Index;
+  static constexpr Index kNil = Node::kNil;
+
+  bool empty() const { return head_ == kNil; }
+  size_t size() const { return size_; }
+  Index front() const { return head_; }
+  Index back() const { return tail_; }
+
+  void pushFront(Slab &nodes, Index i) {
+    Node &node = nodes[i];
+    node.prev_ = kNil;
+    node.next_ = head_;
+    if (head_ != kNil)
+      nodes[head_].prev_ = i;
+    else
+      tail_ = i;
+    head_ = i;
+    ++size_;
+  }
+
+  void pushBack(Slab &nodes, Index i) {
+    Node &node = nodes[i];
+    node.prev_ = tail_;
+    node.next_ = kNil;
+    if (tail_ != kNil)
+      nodes[tail_].next_ = i;
+    else
+      head_ = i;
+    tail_ = i;
+    ++size_;
+  }
+
+  void unlink(Slab &nodes, Index i) {
+    Node &node = nodes[i];
+    if (node.prev_ != kNil)
+      nodes[node.prev_].next_ = node.next_;
+    else
+      head_ = node.next_;
+    if (node.next_ != kNil)
+      nodes[node.next_].prev_ = node.prev_;
+    else
+      tail_ = node.prev_;
+    node.prev_ = node.next_ = kNil;
+    --size_;
+  }
+
+private:
+  Index head_ = kNil;
+  Index tail_ = kNil;
+  size_t size_ = 0;
 };
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "../Snapshot.h"
+#include "../TimingWheel.h"
+#include "Socket.h"
+#include "WireProtocol.h"
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 可以作为集群节点本地存储的缓存：put/get/remove
+// (KHashLruCaches、KHashLfuCache，以及 LruCache 等单个缓存)
+template <typename Local, typename Key, typename Value>
+concept ClusterBackend =
+    requires(Local &l, const Key &key, const Value &in, Value &out) {
+      l.put(key, in);
+      { l.get(key, out) } -> std::convertible_to<bool>;
+      l.remove(key);
+    };
+
+// 集群节点的服务端：每个对端连接一个线程，逐帧读请求、在本地缓存上执行并应答。
+// 连接由对端的 ConnectionPool 长期复用，线程数约为 对端数 × 每个对端的连接数。
+// Hooks 在连接线程里调用：
+// - written(key)：对端写入或删除了 key(写完之后调用，用于广播失效)
+// - invalidated(hash)：收到失效通知
+template <typename Key, typename Value, typename Backend>
+  requires ClusterBackend<Backend, Key, Value> && SnapshotEncodable<Key> &&
+           SnapshotEncodable<Value>
+class CacheServer {
+public:
+  struct Hooks {
+    std::function<void(const Key &)> written;
+    std::function<void(std::uint64_t)> invalidated;
+  };
+
+  // port 为 0 时由系统分配(见 port())；监听失败时 ok() 为 false
+  CacheServer(Backend &backend, std::uint16_t port, Hooks hooks = {})
+      : backend_(backend), hooks_(std::move(hooks)),
+        listener_(Socket::listen(port)) {
+    if (listener_.valid()) {
+      port_ = listener_.localPort();
+      acceptor_ = std::thread([this] { acceptLoop(); });
+    }
+  }
+
+  CacheServer(const CacheServer &) = delete;
+  CacheServer &operator=(const CacheServer &) = delete;
+
+  ~CacheServer() { stop(); }
+
+  bool ok() const { return listener_.valid(); }
+  std::uint16_t port() const { return port_; }
+
+  // 已处理的请求帧数
+  std::uint64_t frames() const {
+    return frames_.load(std::memory_order_relaxed);
+  }
+
+  // 停止接受新连接并断开所有连接，等连接线程全部退出后返回(可重复调用)
+  void stop() {
+    if (stopping_.exchange(true))
+      return;
+    listener_.shutdown();
+    if (acceptor_.joinable())
+      acceptor_.join();
+    std::vector<std::unique_ptr<Connection>> connections;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      connections.swap(connections_);
+    }
+    for (auto &conn : connections) {
+      conn->socket.shutdown();
+    }
+    for (auto &conn : connections) {
+      conn->thread.join();
+    }
+  }
+
+private:
+  struct Connection {
+    explicit Connection(Socket s) : socket(std::move(s)) {}
+    Socket socket;
+    std::thread thread;
+    std::atomic<bool> done{false};
+  };
+
+  void acceptLoop() {
+    for (;;) {
+      Socket socket = listener_.accept();
+      if (stopping_.load())
+        return;
+      if (!socket.valid()) {
+        // 文件描述符耗尽等临时错误：稍后再试
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      reapLocked();
+      auto conn = std::make_unique<Connection>(std::move(socket));
+      conn->thread = std::thread([this, c = conn.get()] { serve(*c); });
+      connections_.push_back(std::move(conn));
+    }
+  }
+
+  // 回收已经断开的连接线程
+  void reapLocked() {
+    std::erase_if(connections_, [](std::unique_ptr<Connection> &conn) {
+      if (!conn->done.load())
+        return false;
+      conn->thread.join();
+      return true;
+    });
+  }
+
+  void serve(Connection &conn) {
+    WireHeader header;
+    std::string body;
+    SnapshotWriter out;
+    while (readWireFrame(conn.socket, header, body)) {
+      frames_.fetch_add(1, std::memory_order_relaxed);
+      out.clear();
+      SnapshotReader in(body.data(), body.size());
+      if (!handle(header, in, out)) {
+        // 内容解码失败：前面的条目可能已经执行，整帧按失败应答
+        out.clear();
+        endWireFrame(out, beginWireFrame(out, header.op, header.id, 0,
+                                         WireStatus::BadRequest));
+      }
+      if (!sendWire(conn.socket, out))
+        break;
+    }
+    conn.done.store(true);
+  }
+
+  bool handle(const WireHeader &header, SnapshotReader &in,
+              SnapshotWriter &out) {
+    const std::size_t at =
+        beginWireFrame(out, header.op, header.id, header.count);
+    Key key{};
+    Value value{};
+    for (std::uint32_t n = 0; n < header.count; ++n) {
+      switch (header.op) {
+      case WireOp::Get: {
+        if (!in.value(key))
+          return false;
+        const bool hit = backend_.get(key, value);
+        out.raw(static_cast<std::uint8_t>(hit ? 1 : 0));
+        if (hit)
+          out.value(value);
+        break;
+      }
+      case WireOp::Put: {
+        std::uint64_t ttlMs = 0;
+        if (!in.value(key) || !in.value(value) || !in.u64(ttlMs))
+          return false;
+        if constexpr (requires(const Key &k, const Value &v) {
+                        backend_.put(k, v, TtlClock::duration());
+                      }) {
+          if (ttlMs > 0) {
+            backend_.put(key, value, std::chrono::milliseconds(ttlMs));
+          } else {
+            backend_.put(key, value);
+          }
+        } else {
+          backend_.put(key, value);
+        }
+        if (hooks_.written)
+          hooks_.written(key);
+        break;
+      }
+      case WireOp::Remove:
+        if (!in.value(key))
+          return false;
+        backend_.remove(key);
+        if (hooks_.written)
+          hooks_.written(key);
+        break;
+      case WireOp::Invalidate: {
+        std::uint64_t hash = 0;
+        if (!in.u64(hash))
+          return false;
+        if (hooks_.invalidated)
+          hooks_.invalidated(hash);
+        break;
+      }
+      default:
+        return false;
+      }
+    }
+    endWireFrame(out, at);
+    return true;
+  }
+
+  Backend &backend_;
+  Hooks hooks_;
+  Socket listener_;
+  std::uint16_t port_ = 0;
+  std::atomic<bool> stopping_{false};
+  std::atomic<std::uint64_t> frames_{0};
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Connection>> connections_;
+  std::thread acceptor_; // 最后初始化：线程启动时其余成员都已就绪
+};
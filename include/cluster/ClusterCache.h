@@ -0,0 +1,669 @@
+#pragma once
+
+#include "../HashUtil.h"
+#include "../Snapshot.h"
+#include "../TimingWheel.h"
+#include "CacheServer.h"
+#include "ConnectionPool.h"
+#include "HashRing.h"
+#include "NearCache.h"
+#include "WireProtocol.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct ClusterPeer {
+  ClusterNodeId id = 0;
+  std::string host;
+  std::uint16_t port = 0;
+  std::size_t weight = 1; // 在环上的权重(虚拟节点数的倍数)
+};
+
+struct ClusterOptions {
+  ClusterNodeId self = 0;
+  std::uint16_t port = 0;   // 本节点的监听端口，0 时由系统分配(见 port())
+  std::size_t weight = 1;   // 本节点在环上的权重
+  std::size_t virtualNodes = 160;
+  std::size_t connectionsPerPeer = 4; // 每个对端保留的空闲连接数
+  std::size_t maxBatch = 256;         // 一帧最多带的条目数
+  std::size_t pipelineDepth = 16;     // 每个连接上同时在途的帧数
+  std::chrono::milliseconds timeout{1000}; // 连接与每次读写的超时
+  bool broadcastInvalidations = true; // 本节点的 key 被写入或删除后通知所有对端
+  std::chrono::microseconds invalidationDelay{200}; // 失效通知攒批的时间
+};
+
+// 累计统计
+struct ClusterStats {
+  std::uint64_t localOps = 0;     // 归属本节点、直接在本地缓存上执行的 key 数
+  std::uint64_t remoteOps = 0;    // 发给对端的 key 数
+  std::uint64_t roundTrips = 0;   // 请求与对端的往返次数(同时发往多个对端的算一次)
+  std::uint64_t remoteErrors = 0; // 失败的对端请求组数(get 按未命中处理，写入丢弃)
+  std::uint64_t nearHits = 0;
+  std::uint64_t invalidationsSent = 0; // 发出的失效条目数(每个对端各算一次)
+  std::uint64_t invalidationsReceived = 0;
+  std::uint64_t connectionsOpened = 0; // 到所有对端累计新建的连接数
+};
+
+// 把 KHashLruCaches / KHashLfuCache 的分片从一台机器扩展到整个集群：
+// - 每个 key 按一致性哈希环归属一个节点，只存在那个节点的本地缓存里，集群里不重复占内存
+// - 归属对端的 key 经连接池里的长连接发给归属节点，一次网络往返；
+//   getMany / putMany 按归属节点分组，每组拆成不超过 maxBatch 条的帧，
+//   先向所有对端发出最多 pipelineDepth 帧再依次收响应，
+//   maxBatch × pipelineDepth 条以内的整批 key 也只需一次往返
+// - 可选的近端缓存(enableNearCache)缓存取回的远端条目；归属节点上的 key 被写入或删除后，
+//   它把 key 哈希攒批广播给所有对端，对端的近端缓存随即失效(见 NearCache.h)。
+//   本节点写对端的 key 时，写完立刻作废自己近端缓存里的这一项
+// 对端故障时 get 按未命中处理、写入丢弃(计入 remoteErrors)，不抛异常，也不转给其他节点。
+// 成员变化(addPeer / removePeer)只影响之后的请求：迁走的 key 不搬数据，
+// 在新的归属节点上从未命中开始
+template <typename Key, typename Value, typename Local,
+          typename Hash = std::hash<Key>>
+  requires ClusterBackend<Local, Key, Value> && SnapshotEncodable<Key> &&
+           SnapshotEncodable<Value>
+class ClusterCache {
+public:
+  using Near = NearCache<Key, Value>;
+  using Server = CacheServer<Key, Value, Local>;
+
+  // localArgs 原样转给本地缓存的构造函数
+  template <typename... Args>
+  explicit ClusterCache(ClusterOptions options, Args &&...localArgs)
+      : options_(std::move(options)),
+        local_(std::forward<Args>(localArgs)...),
+        ring_(options_.virtualNodes) {
+    options_.maxBatch = std::max<std::size_t>(options_.maxBatch, 1);
+    options_.pipelineDepth = std::max<std::size_t>(options_.pipelineDepth, 1);
+    ring_.add(options_.self, options_.weight);
+    server_ = std::make_unique<Server>(
+        local_, options_.port,
+        typename Server::Hooks{
+            [this](const Key &key) { written(hashOf(key)); },
+            [this](std::uint64_t hash) { invalidated(hash); }});
+    if (options_.broadcastInvalidations)
+      flusher_ = std::thread([this] { flushLoop(); });
+  }
+
+  ClusterCache(const ClusterCache &) = delete;
+  ClusterCache &operator=(const ClusterCache &) = delete;
+
+  // 先停服务端，之后不会再有对端的请求访问本地缓存
+  ~ClusterCache() {
+    server_->stop();
+    {
+      std::lock_guard<std::mutex> lock(invalidationMutex_);
+      stop_ = true;
+    }
+    invalidationCv_.notify_all();
+    if (flusher_.joinable())
+      flusher_.join();
+  }
+
+  // 监听失败时为 false(此时仍可以访问对端，但对端访问不到本节点)
+  bool ok() const { return server_->ok(); }
+  std::uint16_t port() const { return server_->port(); }
+  ClusterNodeId self() const { return options_.self; }
+
+  // 加入或更新一个对端(所有节点的成员列表应当一致，否则同一个 key 会有不同的归属)
+  bool addPeer(const ClusterPeer &peer) {
+    if (peer.id == options_.self)
+      return false;
+    auto entry = std::make_shared<Peer>(peer, options_);
+    std::unique_lock<std::shared_mutex> lock(membershipMutex_);
+    std::shared_ptr<Peer> &slot = peers_[peer.id];
+    if (slot)
+      retiredConnections_ += slot->pool.opened();
+    slot = std::move(entry);
+    ring_.add(peer.id, peer.weight);
+    return true;
+  }
+
+  bool removePeer(ClusterNodeId id) {
+    std::unique_lock<std::shared_mutex> lock(membershipMutex_);
+    auto it = peers_.find(id);
+    if (it == peers_.end())
+      return false;
+    retiredConnections_ += it->second->pool.opened();
+    peers_.erase(it);
+    ring_.remove(id);
+    return true;
+  }
+
+  std::size_t nodeCount() const {
+    std::shared_lock<std::shared_mutex> lock(membershipMutex_);
+    return ring_.nodeCount();
+  }
+
+  ClusterNodeId ownerOf(const Key &key) const {
+    std::shared_lock<std::shared_mutex> lock(membershipMutex_);
+    return ring_.ownerOf(hashOf(key));
+  }
+
+  bool isLocal(const Key &key) const { return ownerOf(key) == options_.self; }
+
+  // 开启近端缓存(只能开启一次，重复调用返回 false)。
+  // 例如 std::make_unique<LruCache<Key, NearEntry<Value>>>(10000)
+  bool enableNearCache(std::unique_ptr<typename Near::Policy> policy,
+                       TtlClock::duration ttl = TtlClock::duration::zero(),
+                       std::size_t slots = 4096) {
+    std::lock_guard<std::mutex> lock(invalidationMutex_);
+    if (nearOwner_)
+      return false;
+    nearOwner_ = std::make_unique<Near>(std::move(policy), ttl, slots);
+    near_.store(nearOwner_.get(), std::memory_order_release);
+    return true;
+  }
+
+  Near *nearCache() { return near_.load(std::memory_order_acquire); }
+
+  void put(const Key &key, const Value &value) {
+    putOne(key, value, TtlClock::duration::zero());
+  }
+
+  // 带过期时间的写入(本地缓存支持 ttl 时生效，按毫秒传给归属节点)
+  void put(const Key &key, const Value &value, TtlClock::duration ttl) {
+    putOne(key, value, ttl);
+  }
+
+  bool get(const Key &key, Value &value) {
+    const std::uint64_t hash = hashOf(key);
+    std::shared_ptr<Peer> peer = peerFor(hash);
+    if (!peer) {
+      counters_.localOps.fetch_add(1, std::memory_order_relaxed);
+      return local_.get(key, value);
+    }
+    Near *near = near_.load(std::memory_order_acquire);
+    if (near && near->get(key, hash, value)) {
+      counters_.nearHits.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    bool found = false;
+    std::vector<Batch> batches(1);
+    batches[0].peer = std::move(peer);
+    batches[0].positions.push_back(0);
+    fetchRemote(std::span<const Key>(&key, 1),
+                std::span<const std::uint64_t>(&hash, 1),
+                std::span<Value>(&value, 1), std::span<bool>(&found, 1),
+                batches, near);
+    return found;
+  }
+
+  Value get(const Key &key) {
+    Value value{};
+    get(key, value);
+    return value;
+  }
+
+  void remove(const Key &key) {
+    const std::uint64_t hash = hashOf(key);
+    std::shared_ptr<Peer> peer = peerFor(hash);
+    if (!peer) {
+      counters_.localOps.fetch_add(1, std::memory_order_relaxed);
+      local_.remove(key);
+      written(hash);
+      return;
+    }
+    std::vector<Batch> batches(1);
+    batches[0].peer = std::move(peer);
+    batches[0].positions.push_back(0);
+    counters_.remoteOps.fetch_add(1, std::memory_order_relaxed);
+    exchange(
+        WireOp::Remove, batches,
+        [&](SnapshotWriter &out, std::span<const std::uint32_t>) {
+          out.value(key);
+        },
+        [](SnapshotReader &, std::span<const std::uint32_t>) { return true; });
+    invalidateNear(hash);
+  }
+
+  // 批量查询：本地的 key 直接查，其余按归属节点分组后一次往返取回 | 返回命中个数
+  std::size_t getMany(std::span<const Key> keys, std::span<Value> values,
+                      std::span<bool> found) {
+    Near *near = near_.load(std::memory_order_acquire);
+    std::vector<std::uint64_t> hashes(keys.size());
+    std::vector<std::uint32_t> locals;
+    std::vector<Batch> batches;
+    std::size_t hits = 0;
+    group(keys, hashes, locals, batches, [&](std::size_t i) {
+      // 近端缓存命中的 key 不发出去
+      if (near && near->get(keys[i], hashes[i], values[i])) {
+        counters_.nearHits.fetch_add(1, std::memory_order_relaxed);
+        found[i] = true;
+        ++hits;
+        return true;
+      }
+      return false;
+    });
+    counters_.localOps.fetch_add(locals.size(), std::memory_order_relaxed);
+    for (std::uint32_t i : locals) {
+      found[i] = local_.get(keys[i], values[i]);
+      hits += found[i] ? 1 : 0;
+    }
+    hits += fetchRemote(keys, hashes, values, found, batches, near);
+    return hits;
+  }
+
+  // 批量写入：keys[i] 对应 values[i]，写往对端的部分一次往返
+  void putMany(std::span<const Key> keys, std::span<const Value> values) {
+    std::vector<std::uint64_t> hashes(keys.size());
+    std::vector<std::uint32_t> locals;
+    std::vector<Batch> batches;
+    group(keys, hashes, locals, batches, [](std::size_t) { return false; });
+    counters_.localOps.fetch_add(locals.size(), std::memory_order_relaxed);
+    for (std::uint32_t i : locals) {
+      local_.put(keys[i], values[i]);
+      written(hashes[i]);
+    }
+    sendPuts(keys, values, hashes, batches, TtlClock::duration::zero());
+  }
+
+  Local &local() { return local_; }
+  const Local &local() const { return local_; }
+  Server &server() { return *server_; }
+
+  ClusterStats stats() const {
+    ClusterStats s;
+    s.localOps = counters_.localOps.load(std::memory_order_relaxed);
+    s.remoteOps = counters_.remoteOps.load(std::memory_order_relaxed);
+    s.roundTrips = counters_.roundTrips.load(std::memory_order_relaxed);
+    s.remoteErrors = counters_.remoteErrors.load(std::memory_order_relaxed);
+    s.nearHits = counters_.nearHits.load(std::memory_order_relaxed);
+    s.invalidationsSent =
+        counters_.invalidationsSent.load(std::memory_order_relaxed);
+    s.invalidationsReceived =
+        counters_.invalidationsReceived.load(std::memory_order_relaxed);
+    std::shared_lock<std::shared_mutex> lock(membershipMutex_);
+    s.connectionsOpened = retiredConnections_;
+    for (const auto &[id, peer] : peers_) {
+      s.connectionsOpened += peer->pool.opened();
+    }
+    return s;
+  }
+
+private:
+  struct Peer {
+    Peer(const ClusterPeer &info, const ClusterOptions &options)
+        : info(info), pool(info.host, info.port, options.connectionsPerPeer,
+                           options.timeout) {}
+    ClusterPeer info;
+    ConnectionPool pool;
+  };
+
+  // 发往同一个对端的一组 key(positions 为它们在请求里的下标)
+  struct Batch {
+    std::shared_ptr<Peer> peer;
+    std::vector<std::uint32_t> positions;
+    ConnectionPool::Lease lease;
+    std::size_t sent = 0;       // 已发出的条目数(positions 的前缀)
+    std::size_t done = 0;       // 已收到响应的条目数
+    std::uint32_t firstId = 0;  // 本轮第一帧的请求号
+    bool retried = false;
+    bool failed = false;
+  };
+
+  struct Counters {
+    std::atomic<std::uint64_t> localOps{0};
+    std::atomic<std::uint64_t> remoteOps{0};
+    std::atomic<std::uint64_t> roundTrips{0};
+    std::atomic<std::uint64_t> remoteErrors{0};
+    std::atomic<std::uint64_t> nearHits{0};
+    std::atomic<std::uint64_t> invalidationsSent{0};
+    std::atomic<std::uint64_t> invalidationsReceived{0};
+  };
+
+  std::uint64_t hashOf(const Key &key) const {
+    return mixHash(static_cast<std::uint64_t>(hash_(key)));
+  }
+
+  // 归属对端时返回该对端，归属本节点时返回空
+  std::shared_ptr<Peer> peerFor(std::uint64_t hash) const {
+    std::shared_lock<std::shared_mutex> lock(membershipMutex_);
+    const ClusterNodeId owner = ring_.ownerOf(hash);
+    if (owner == options_.self)
+      return nullptr;
+    auto it = peers_.find(owner);
+    return it != peers_.end() ? it->second : nullptr;
+  }
+
+  // 按归属节点分组：本节点的下标放进 locals，其余按对端放进 batches；
+  // skip(i) 为真的 key 不分组(例如近端缓存已经命中)
+  template <typename Skip>
+  void group(std::span<const Key> keys, std::vector<std::uint64_t> &hashes,
+             std::vector<std::uint32_t> &locals, std::vector<Batch> &batches,
+             Skip &&skip) {
+    std::unordered_map<ClusterNodeId, std::size_t> batchOf;
+    std::shared_lock<std::shared_mutex> lock(membershipMutex_);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      hashes[i] = hashOf(keys[i]);
+      const ClusterNodeId owner = ring_.ownerOf(hashes[i]);
+      const auto position = static_cast<std::uint32_t>(i);
+      if (owner == options_.self) {
+        locals.push_back(position);
+        continue;
+      }
+      if (skip(i))
+        continue;
+      auto [it, inserted] = batchOf.try_emplace(owner, batches.size());
+      if (inserted) {
+        batches.emplace_back();
+        batches.back().peer = peers_.at(owner);
+      }
+      batches[it->second].positions.push_back(position);
+    }
+  }
+
+  // 从对端取回 batches 里的 key，命中的写进近端缓存 | 返回命中个数
+  std::size_t fetchRemote(std::span<const Key> keys,
+                          std::span<const std::uint64_t> hashes,
+                          std::span<Value> values, std::span<bool> found,
+                          std::vector<Batch> &batches, Near *near) {
+    if (batches.empty())
+      return 0;
+    // 发请求之前读戳，在途期间到达的失效会作废之后写入近端缓存的条目
+    std::vector<std::uint32_t> stamps;
+    if (near) {
+      stamps.resize(keys.size());
+      for (const Batch &b : batches) {
+        for (std::uint32_t i : b.positions) {
+          stamps[i] = near->stampOf(hashes[i]);
+        }
+      }
+    }
+    std::size_t remote = 0;
+    for (const Batch &b : batches) {
+      remote += b.positions.size();
+      for (std::uint32_t i : b.positions) {
+        found[i] = false;
+      }
+    }
+    counters_.remoteOps.fetch_add(remote, std::memory_order_relaxed);
+
+    exchange(
+        WireOp::Get, batches,
+        [&](SnapshotWriter &out, std::span<const std::uint32_t> chunk) {
+          for (std::uint32_t i : chunk) {
+            out.value(keys[i]);
+          }
+        },
+        [&](SnapshotReader &in, std::span<const std::uint32_t> chunk) {
+          for (std::uint32_t i : chunk) {
+            std::uint8_t hit = 0;
+            if (!in.raw(hit) || (hit != 0 && !in.value(values[i])))
+              return false;
+            found[i] = hit != 0;
+          }
+          return true;
+        });
+
+    std::size_t hits = 0;
+    for (const Batch &b : batches) {
+      for (std::uint32_t i : b.positions) {
+        if (!found[i])
+          continue;
+        ++hits;
+        if (near)
+          near->put(keys[i], hashes[i], values[i], stamps[i]);
+      }
+    }
+    return hits;
+  }
+
+  void putOne(const Key &key, const Value &value, TtlClock::duration ttl) {
+    const std::uint64_t hash = hashOf(key);
+    std::shared_ptr<Peer> peer = peerFor(hash);
+    if (!peer) {
+      counters_.localOps.fetch_add(1, std::memory_order_relaxed);
+      if (ttl > TtlClock::duration::zero()) {
+        if constexpr (requires { local_.put(key, value, ttl); })
+          local_.put(key, value, ttl);
+        else
+          local_.put(key, value);
+      } else {
+        local_.put(key, value);
+      }
+      written(hash);
+      return;
+    }
+    std::vector<Batch> batches(1);
+    batches[0].peer = std::move(peer);
+    batches[0].positions.push_back(0);
+    sendPuts(std::span<const Key>(&key, 1), std::span<const Value>(&value, 1),
+             std::span<const std::uint64_t>(&hash, 1), batches, ttl);
+  }
+
+  void sendPuts(std::span<const Key> keys, std::span<const Value> values,
+                std::span<const std::uint64_t> hashes,
+                std::vector<Batch> &batches, TtlClock::duration ttl) {
+    if (batches.empty())
+      return;
+    const auto ttlMs = static_cast<std::uint64_t>(std::max<std::int64_t>(
+        0, std::chrono::ceil<std::chrono::milliseconds>(ttl).count()));
+    std::size_t remote = 0;
+    for (const Batch &b : batches) {
+      remote += b.positions.size();
+    }
+    counters_.remoteOps.fetch_add(remote, std::memory_order_relaxed);
+    exchange(
+        WireOp::Put, batches,
+        [&](SnapshotWriter &out, std::span<const std::uint32_t> chunk) {
+          for (std::uint32_t i : chunk) {
+            out.value(keys[i]);
+            out.value(values[i]);
+            out.u64(ttlMs);
+          }
+        },
+        [](SnapshotReader &, std::span<const std::uint32_t>) { return true; });
+    // 读自己的写：写完后本节点不再从近端缓存读到旧值
+    for (const Batch &b : batches) {
+      for (std::uint32_t i : b.positions) {
+        invalidateNear(hashes[i]);
+      }
+    }
+  }
+
+  // 按轮往返：每轮先向每个对端发出最多 pipelineDepth 帧，再依次读各个对端的响应，
+  // 直到所有条目都有了结果。encode(out, chunk) 写一帧的内容，
+  // decode(in, chunk) 解析对应的响应，失败返回 false。
+  // 取自空闲列表的连接失败时(对端可能已经关掉了它)换新连接重发一次。
+  // 请求的轮数计入 roundTrips，失效广播(countTrips 为 false)不计
+  template <typename Encode, typename Decode>
+  void exchange(WireOp op, std::vector<Batch> &batches, Encode &&encode,
+                Decode &&decode, bool countTrips = true) {
+    SnapshotWriter out;
+    for (;;) {
+      bool pending = false;
+      for (Batch &b : batches) {
+        pending = sendWindow(op, b, out, encode) || pending;
+      }
+      if (!pending)
+        return;
+      if (countTrips)
+        counters_.roundTrips.fetch_add(1, std::memory_order_relaxed);
+      for (Batch &b : batches) {
+        receiveWindow(op, b, decode);
+      }
+    }
+  }
+
+  // 返回 true 表示这个对端还有没完成的条目
+  template <typename Encode>
+  bool sendWindow(WireOp op, Batch &b, SnapshotWriter &out, Encode &encode) {
+    if (b.failed || b.done == b.positions.size())
+      return false;
+    if (b.sent > b.done)
+      return true; // 上一轮的响应还没读完
+    if (!b.lease) {
+      b.lease = b.peer->pool.acquire();
+      if (!b.lease) {
+        fail(b);
+        return !b.failed;
+      }
+    }
+    const std::size_t limit =
+        std::min(b.positions.size(),
+                 b.sent + options_.maxBatch * options_.pipelineDepth);
+    const std::size_t frames =
+        (limit - b.sent + options_.maxBatch - 1) / options_.maxBatch;
+    b.firstId = nextId_.fetch_add(static_cast<std::uint32_t>(frames),
+                                  std::memory_order_relaxed);
+    out.clear();
+    std::uint32_t id = b.firstId;
+    while (b.sent < limit) {
+      const std::size_t n = std::min(options_.maxBatch, limit - b.sent);
+      const std::size_t at =
+          beginWireFrame(out, op, id++, static_cast<std::uint32_t>(n));
+      encode(out, std::span<const std::uint32_t>(b.positions).subspan(b.sent, n));
+      endWireFrame(out, at);
+      b.sent += n;
+    }
+    if (!sendWire(b.lease.socket(), out))
+      fail(b);
+    return !b.failed;
+  }
+
+  template <typename Decode>
+  void receiveWindow(WireOp op, Batch &b, Decode &decode) {
+    WireHeader header;
+    std::string body;
+    std::uint32_t id = b.firstId;
+    while (!b.failed && b.lease && b.done < b.sent) {
+      const std::size_t n = std::min(options_.maxBatch, b.sent - b.done);
+      if (!readWireFrame(b.lease.socket(), header, body) || header.id != id ||
+          header.op != op || header.status != WireStatus::Ok ||
+          header.count != n) {
+        fail(b);
+        return;
+      }
+      SnapshotReader in(body.data(), body.size());
+      if (!decode(in, std::span<const std::uint32_t>(b.positions)
+                          .subspan(b.done, n))) {
+        fail(b);
+        return;
+      }
+      b.done += n;
+      ++id;
+    }
+  }
+
+  // 丢掉出错的连接；复用的连接第一次出错时从没收到响应的条目开始重发
+  void fail(Batch &b) {
+    const bool retry = b.lease.reused() && !b.retried;
+    b.lease.fail();
+    b.lease = ConnectionPool::Lease();
+    if (retry) {
+      b.retried = true;
+      b.sent = b.done;
+      return;
+    }
+    b.failed = true;
+    counters_.remoteErrors.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void invalidateNear(std::uint64_t hash) {
+    if (Near *near = near_.load(std::memory_order_acquire))
+      near->invalidate(hash);
+  }
+
+  // 本节点的 key 被写入或删除(包括对端发来的写)：排队等待广播失效
+  void written(std::uint64_t hash) {
+    if (!options_.broadcastInvalidations)
+      return;
+    {
+      std::lock_guard<std::mutex> lock(invalidationMutex_);
+      pendingInvalidations_.push_back(hash);
+    }
+    invalidationCv_.notify_one();
+  }
+
+  void invalidated(std::uint64_t hash) {
+    counters_.invalidationsReceived.fetch_add(1, std::memory_order_relaxed);
+    invalidateNear(hash);
+  }
+
+  void flushLoop() {
+    std::unique_lock<std::mutex> lock(invalidationMutex_);
+    for (;;) {
+      invalidationCv_.wait(lock, [this] {
+        return stop_ || !pendingInvalidations_.empty();
+      });
+      // 再等一小会儿，把紧接着的写入攒进同一批
+      if (stop_ || invalidationCv_.wait_for(lock, options_.invalidationDelay,
+                                            [this] { return stop_; }))
+        return;
+      std::vector<std::uint64_t> hashes;
+      hashes.swap(pendingInvalidations_);
+      lock.unlock();
+      broadcast(hashes);
+      lock.lock();
+    }
+  }
+
+  // 把一批失效的 key 哈希发给所有对端(一轮往返)
+  void broadcast(std::vector<std::uint64_t> &hashes) {
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+    std::vector<std::uint32_t> positions(hashes.size());
+    std::iota(positions.begin(), positions.end(), 0u);
+    std::vector<Batch> batches;
+    {
+      std::shared_lock<std::shared_mutex> lock(membershipMutex_);
+      batches.resize(peers_.size());
+      std::size_t j = 0;
+      for (const auto &[id, peer] : peers_) {
+        batches[j].peer = peer;
+        batches[j].positions = positions;
+        ++j;
+      }
+    }
+    exchange(
+        WireOp::Invalidate, batches,
+        [&](SnapshotWriter &out, std::span<const std::uint32_t> chunk) {
+          for (std::uint32_t i : chunk) {
+            out.u64(hashes[i]);
+          }
+        },
+        [](SnapshotReader &, std::span<const std::uint32_t>) { return true; },
+        false);
+    std::uint64_t sent = 0;
+    for (const Batch &b : batches) {
+      sent += b.done;
+    }
+    counters_.invalidationsSent.fetch_add(sent, std::memory_order_relaxed);
+  }
+
+  ClusterOptions options_;
+  Local local_;
+  [[no_unique_address]] Hash hash_;
+
+  mutable std::shared_mutex membershipMutex_; // 保护 ring_ 与 peers_
+  HashRing ring_;
+  std::unordered_map<ClusterNodeId, std::shared_ptr<Peer>> peers_;
+  std::uint64_t retiredConnections_ = 0; // 已移除的对端累计新建的连接数
+
+  std::atomic<Near *> near_{nullptr};
+  std::unique_ptr<Near> nearOwner_;
+
+  std::atomic<std::uint32_t> nextId_{1};
+  Counters counters_;
+
+  std::mutex invalidationMutex_; // 保护待广播的失效、stop_ 与 nearOwner_
+  std::condition_variable invalidationCv_;
+  std::vector<std::uint64_t> pendingInvalidations_;
+  bool stop_ = false;
+  std::thread flusher_;
+
+  std::unique_ptr<Server> server_; // 最后构造、最先停止
+};
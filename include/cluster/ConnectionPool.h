@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Socket.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 到一个对端的连接池：
+// - acquire 优先取空闲连接，没有时新建；Lease 析构时把连接还回池里
+//   (空闲连接已有 maxIdle 个时直接关掉)
+// - 出错的连接调用 Lease::fail() 关掉，不会回到池里
+// 一个连接同一时刻只被一个 Lease 持有，请求和响应在上面按顺序流水线进行。
+// Lease 不能比池活得久
+class ConnectionPool {
+public:
+  class Lease {
+  public:
+    Lease() = default;
+    Lease(Lease &&other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)),
+          socket_(std::move(other.socket_)), reused_(other.reused_) {}
+    Lease &operator=(Lease &&other) noexcept {
+      if (this != &other) {
+        release();
+        pool_ = std::exchange(other.pool_, nullptr);
+        socket_ = std::move(other.socket_);
+        reused_ = other.reused_;
+      }
+      return *this;
+    }
+    ~Lease() { release(); }
+
+    explicit operator bool() const { return socket_.valid(); }
+    Socket &socket() { return socket_; }
+
+    // 连接取自空闲列表(可能已被对端关闭，失败时值得换一个新连接重试一次)
+    bool reused() const { return reused_; }
+
+    void fail() { socket_.close(); }
+
+  private:
+    friend class ConnectionPool;
+    Lease(ConnectionPool *pool, Socket socket, bool reused)
+        : pool_(pool), socket_(std::move(socket)), reused_(reused) {}
+
+    void release() {
+      if (pool_ != nullptr && socket_.valid())
+        pool_->giveBack(std::move(socket_));
+      pool_ = nullptr;
+    }
+
+    ConnectionPool *pool_ = nullptr;
+    Socket socket_;
+    bool reused_ = false;
+  };
+
+  ConnectionPool(std::string host, std::uint16_t port, std::size_t maxIdle = 4,
+                 std::chrono::milliseconds timeout = std::chrono::seconds(1))
+      : host_(std::move(host)), port_(port), maxIdle_(maxIdle),
+        timeout_(timeout) {}
+
+  ConnectionPool(const ConnectionPool &) = delete;
+  ConnectionPool &operator=(const ConnectionPool &) = delete;
+
+  // 连接失败时返回空的 Lease
+  Lease acquire() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!idle_.empty()) {
+        Socket socket = std::move(idle_.back());
+        idle_.pop_back();
+        return Lease(this, std::move(socket), true);
+      }
+    }
+    Socket socket = Socket::connect(host_, port_, timeout_);
+    if (!socket.valid())
+      return Lease();
+    opened_.fetch_add(1, std::memory_order_relaxed);
+    return Lease(this, std::move(socket), false);
+  }
+
+  const std::string &host() const { return host_; }
+  std::uint16_t port() const { return port_; }
+
+  std::size_t idleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+  }
+
+  // 累计新建的连接数
+  std::uint64_t opened() const {
+    return opened_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void giveBack(Socket socket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < maxIdle_)
+      idle_.push_back(std::move(socket));
+  }
+
+  const std::string host_;
+  const std::uint16_t port_;
+  const std::size_t maxIdle_;
+  const std::chrono::milliseconds timeout_;
+  mutable std::mutex mutex_;
+  std::vector<Socket> idle_;
+  std::atomic<std::uint64_t> opened_{0};
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../HashUtil.h"
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using ClusterNodeId = std::uint32_t;
+
+// 一致性哈希环：每个节点在环上放 virtualNodes × weight 个点，
+// key 的哈希顺时针遇到的第一个点所属的节点就是它的归属节点。
+// 增删一个节点只会移动与它相邻的区间上的 key(约 1/N)，其余 key 的归属不变。
+// 点按位置排好序，查找是一次二分
+class HashRing {
+public:
+  explicit HashRing(std::size_t virtualNodes = 160)
+      : virtualNodes_(std::max<std::size_t>(virtualNodes, 1)) {}
+
+  // 加入节点(已存在时按新的 weight 重新放点)
+  void add(ClusterNodeId node, std::size_t weight = 1) {
+    remove(node);
+    const std::size_t points = virtualNodes_ * std::max<std::size_t>(weight, 1);
+    for (std::size_t i = 0; i < points; ++i) {
+      points_.push_back(Point{pointOf(node, i), node});
+    }
+    std::sort(points_.begin(), points_.end());
+    nodes_.insert(std::lower_bound(nodes_.begin(), nodes_.end(), node), node);
+  }
+
+  void remove(ClusterNodeId node) {
+    std::erase_if(points_, [node](const Point &p) { return p.node == node; });
+    std::erase(nodes_, node);
+  }
+
+  bool contains(ClusterNodeId node) const {
+    return std::binary_search(nodes_.begin(), nodes_.end(), node);
+  }
+
+  bool empty() const { return nodes_.empty(); }
+  std::size_t nodeCount() const { return nodes_.size(); }
+  const std::vector<ClusterNodeId> &nodes() const { return nodes_; }
+
+  // hash(已混合的 64 位 key 哈希)的归属节点，环不能为空
+  ClusterNodeId ownerOf(std::uint64_t hash) const {
+    auto it = std::lower_bound(
+        points_.begin(), points_.end(), hash,
+        [](const Point &p, std::uint64_t h) { return p.position < h; });
+    return (it != points_.end() ? *it : points_.front()).node;
+  }
+
+private:
+  struct Point {
+    std::uint64_t position;
+    ClusterNodeId node;
+    auto operator<=>(const Point &) const = default;
+  };
+
+  // 点的位置只由节点编号和序号决定，所有节点算出的环相同
+  static std::uint64_t pointOf(ClusterNodeId node, std::size_t i) {
+    return mixHash(mixHash(std::uint64_t{node} + 0x9e3779b97f4a7c15ULL) ^
+                   static_cast<std::uint64_t>(i));
+  }
+
+  std::size_t virtualNodes_;
+  std::vector<Point> points_;         // 按位置排序
+  std::vector<ClusterNodeId> nodes_;  // 环上的节点(有序)
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../HashUtil.h"
+#include "../ICachePolicy.h"
+#include "../TimingWheel.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// 近端缓存里的条目：值、写入时所在戳槽的戳、过期时刻(默认值表示不过期)
+template <typename Value> struct NearEntry {
+  Value value{};
+  std::uint32_t stamp = 0;
+  TtlClock::time_point expires{};
+};
+
+// 集群节点的近端缓存(本地 L1)：缓存从对端取回的条目，命中时不走网络。
+// 容量和淘汰交给任意 ICachePolicy<Key, NearEntry<Value>>(LRU、LFU、ARC 等)，
+// 失效不需要策略支持删除：
+// - key 哈希分到 slots 个戳槽，每个条目记下写入时所在槽的戳
+// - 收到失效通知时把对应槽的戳加一，槽里所有更早写入的条目在读到时都按未命中处理
+//   (同槽的其他 key 多一次未命中，但不会读到旧值)
+// - 取远端值之前先读戳(stampOf)，取回后带着这个戳写入：请求在途期间到达的失效
+//   会让这次写入的条目直接作废
+// ttl 非零时条目最多存活 ttl，失效通知丢失(例如对端重启)时限制读到旧值的时间。
+// 底下的策略须是线程安全的(本库的各策略都是)
+template <typename Key, typename Value> class NearCache {
+public:
+  using Entry = NearEntry<Value>;
+  using Policy = ICachePolicy<Key, Entry>;
+
+  explicit NearCache(std::unique_ptr<Policy> policy,
+                     TtlClock::duration ttl = TtlClock::duration::zero(),
+                     std::size_t slots = 4096)
+      : policy_(std::move(policy)), ttl_(ttl), mask_(roundUpPow2(slots) - 1),
+        stamps_(mask_ + 1) {}
+
+  NearCache(const NearCache &) = delete;
+  NearCache &operator=(const NearCache &) = delete;
+
+  // hash 所在戳槽当前的戳
+  std::uint32_t stampOf(std::uint64_t hash) const {
+    return stamps_[hash & mask_].load(std::memory_order_acquire);
+  }
+
+  bool get(const Key &key, std::uint64_t hash, Value &value) {
+    Entry entry;
+    if (!policy_->get(key, entry) || entry.stamp != stampOf(hash) ||
+        (entry.expires != TtlClock::time_point{} &&
+         TtlClock::now() >= entry.expires)) {
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    value = std::move(entry.value);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // stamp 为取值之前 stampOf(hash) 的结果；之后失效过时不写入
+  void put(const Key &key, std::uint64_t hash, const Value &value,
+           std::uint32_t stamp) {
+    if (stamp != stampOf(hash))
+      return;
+    Entry entry;
+    entry.value = value;
+    entry.stamp = stamp;
+    if (ttl_ > TtlClock::duration::zero())
+      entry.expires = TtlClock::now() + ttl_;
+    policy_->put(key, entry);
+  }
+
+  void invalidate(std::uint64_t hash) {
+    stamps_[hash & mask_].fetch_add(1, std::memory_order_acq_rel);
+    invalidations_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // 作废所有条目(例如集群成员变化之后)
+  void invalidateAll() {
+    for (auto &stamp : stamps_) {
+      stamp.fetch_add(1, std::memory_order_acq_rel);
+    }
+  }
+
+  Policy &policy() { return *policy_; }
+
+  std::uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+  std::uint64_t misses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+  std::uint64_t invalidations() const {
+    return invalidations_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::unique_ptr<Policy> policy_;
+  const TtlClock::duration ttl_;
+  const std::size_t mask_;
+  std::vector<std::atomic<std::uint32_t>> stamps_;
+  std::atomic<std::uint64_t> hits_{0};
+  std::atomic<std::uint64_t> misses_{0};
+  std::atomic<std::uint64_t> invalidations_{0};
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+// 集群层用的最小 TCP 封装(POSIX)，只有阻塞读写：
+// - 失败统一返回 false / 无效的 Socket，调用方丢掉连接重连即可
+// - 连接都开 TCP_NODELAY：请求已经在应用层攒成批，不需要 Nagle 再等
+// - 读写超时用 SO_RCVTIMEO / SO_SNDTIMEO，对端挂死时不会一直阻塞
+class Socket {
+public:
+  Socket() = default;
+  explicit Socket(int fd) : fd_(fd) {}
+  Socket(Socket &&other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+  Socket &operator=(Socket &&other) noexcept {
+    if (this != &other) {
+      close();
+      fd_ = std::exchange(other.fd_, -1);
+    }
+    return *this;
+  }
+  Socket(const Socket &) = delete;
+  Socket &operator=(const Socket &) = delete;
+  ~Socket() { close(); }
+
+  bool valid() const { return fd_ >= 0; }
+  int fd() const { return fd_; }
+
+  void close() {
+    if (fd_ >= 0)
+      ::close(std::exchange(fd_, -1));
+  }
+
+  // 唤醒阻塞在这个连接上的 accept / recv(可以在其他线程里调用)
+  void shutdown() {
+    if (fd_ >= 0)
+      ::shutdown(fd_, SHUT_RDWR);
+  }
+
+  // 连接 host:port，timeout 同时作为之后每次读写的超时
+  static Socket connect(const std::string &host, std::uint16_t port,
+                        std::chrono::milliseconds timeout) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *list = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints,
+                      &list) != 0)
+      return Socket();
+    Socket out;
+    for (addrinfo *ai = list; ai != nullptr && !out.valid(); ai = ai->ai_next) {
+      Socket s(::socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC,
+                        ai->ai_protocol));
+      if (!s.valid())
+        continue;
+      s.setTimeout(timeout);
+      if (::connect(s.fd_, ai->ai_addr, ai->ai_addrlen) == 0) {
+        s.setNoDelay();
+        out = std::move(s);
+      }
+    }
+    ::freeaddrinfo(list);
+    return out;
+  }
+
+  // 在所有地址的 port 上监听(port 为 0 时由系统分配，见 localPort)
+  static Socket listen(std::uint16_t port, int backlog = 128) {
+    Socket s(::socket(AF_INET6, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    bool v6 = s.valid();
+    if (!v6)
+      s = Socket(::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    if (!s.valid())
+      return Socket();
+    const int on = 1, off = 0;
+    ::setsockopt(s.fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    int rc = -1;
+    if (v6) {
+      ::setsockopt(s.fd_, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+      sockaddr_in6 addr{};
+      addr.sin6_family = AF_INET6;
+      addr.sin6_addr = in6addr_any;
+      addr.sin6_port = htons(port);
+      rc = ::bind(s.fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    } else {
+      sockaddr_in addr{};
+      addr.sin_family = AF_INET;
+      addr.sin_addr.s_addr = htonl(INADDR_ANY);
+      addr.sin_port = htons(port);
+      rc = ::bind(s.fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    }
+    if (rc != 0 || ::listen(s.fd_, backlog) != 0)
+      return Socket();
+    return s;
+  }
+
+  // 等待一个新连接；监听 socket 被 shutdown 或出错时返回无效的 Socket
+  Socket accept() const {
+    for (;;) {
+      const int fd = ::accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd >= 0) {
+        Socket s(fd);
+        s.setNoDelay();
+        return s;
+      }
+      if (errno != EINTR)
+        return Socket();
+    }
+  }
+
+  std::uint16_t localPort() const {
+    sockaddr_storage addr{};
+    socklen_t len = sizeof(addr);
+    if (::getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &len) != 0)
+      return 0;
+    if (addr.ss_family == AF_INET6)
+      return ntohs(reinterpret_cast<sockaddr_in6 *>(&addr)->sin6_port);
+    return ntohs(reinterpret_cast<sockaddr_in *>(&addr)->sin_port);
+  }
+
+  bool sendAll(const void *data, std::size_t n) {
+    const char *p = static_cast<const char *>(data);
+    while (n > 0) {
+      const ssize_t sent = ::send(fd_, p, n, MSG_NOSIGNAL);
+      if (sent < 0 && errno == EINTR)
+        continue;
+      if (sent <= 0)
+        return false;
+      p += sent;
+      n -= static_cast<std::size_t>(sent);
+    }
+    return true;
+  }
+
+  // 读满 n 个字节；对端关闭、超时或出错时返回 false
+  bool recvAll(void *data, std::size_t n) {
+    char *p = static_cast<char *>(data);
+    while (n > 0) {
+      const ssize_t got = ::recv(fd_, p, n, 0);
+      if (got < 0 && errno == EINTR)
+        continue;
+      if (got <= 0)
+        return false;
+      p += got;
+      n -= static_cast<std::size_t>(got);
+    }
+    return true;
+  }
+
+  void setTimeout(std::chrono::milliseconds timeout) {
+    if (timeout.count() <= 0)
+      return;
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    tv.tv_usec = static_cast<suseconds_t>(timeout.count() % 1000 * 1000);
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  }
+
+private:
+  void setNoDelay() {
+    const int on = 1;
+    ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  }
+
+  int fd_ = -1;
+};
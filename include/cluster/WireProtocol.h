@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../Snapshot.h"
+#include "Socket.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 集群节点之间的二进制协议(版本 1)：
+//   帧头 24 字节  u32 magic | u32 请求号 | u64 内容字节数 | u32 条目数 | u8 操作 | u8 状态 | u16 保留
+//   内容          count 个条目，key / value 的编码与快照相同(SnapshotCodec)
+// - 批量：一帧带多个条目，一次系统调用发出
+// - 流水线：客户端可以在一个连接上连续写出多帧再依次读响应；服务端按收到的顺序逐帧应答，
+//   响应带回请求号、操作和条目数，客户端据此核对
+// 与快照一样按本机字节序编码，集群里的节点须为同一平台、同一份代码构建
+// (std::hash 的结果也要一致，失效通知里传的是 key 的哈希)
+
+enum class WireOp : std::uint8_t {
+  Get = 1,        // 请求 key...                      响应 (u8 命中, [value])...
+  Put = 2,        // 请求 (key, value, u64 ttl 毫秒)... 响应为空；ttl 为 0 表示不过期
+  Remove = 3,     // 请求 key...                      响应为空
+  Invalidate = 4, // 请求 u64 key 哈希...              响应为空(见 NearCache.h)
+};
+
+enum class WireStatus : std::uint8_t { Ok = 0, BadRequest = 1 };
+
+inline constexpr std::uint32_t kWireMagic = 0x31574343; // "CCW1"
+inline constexpr std::uint64_t kMaxWireFrameBytes = 64ull << 20;
+
+struct WireHeader {
+  std::uint32_t magic = kWireMagic;
+  std::uint32_t id = 0;
+  std::uint64_t bytes = 0; // 帧头之后的内容字节数
+  std::uint32_t count = 0;
+  WireOp op = WireOp::Get;
+  WireStatus status = WireStatus::Ok;
+  std::uint16_t reserved = 0;
+};
+static_assert(sizeof(WireHeader) == 24);
+
+// 在 out 末尾开始一帧，返回帧头所在的位置；写完内容后调用 endWireFrame
+inline std::size_t beginWireFrame(SnapshotWriter &out, WireOp op,
+                                  std::uint32_t id, std::uint32_t count,
+                                  WireStatus status = WireStatus::Ok) {
+  const std::size_t at = out.size();
+  WireHeader header;
+  header.id = id;
+  header.count = count;
+  header.op = op;
+  header.status = status;
+  out.raw(header);
+  return at;
+}
+
+// 回填 at 处帧头里的内容字节数
+inline void endWireFrame(SnapshotWriter &out, std::size_t at) {
+  out.patch(at + offsetof(WireHeader, bytes),
+            out.size() - at - sizeof(WireHeader));
+}
+
+// 读一帧。连接断开、超时、magic 不对或超过大小上限时返回 false，调用方应丢弃连接
+inline bool readWireFrame(Socket &socket, WireHeader &header,
+                          std::string &body) {
+  if (!socket.recvAll(&header, sizeof(header)) || header.magic != kWireMagic ||
+      header.bytes > kMaxWireFrameBytes)
+    return false;
+  body.resize(static_cast<std::size_t>(header.bytes));
+  return body.empty() || socket.recvAll(body.data(), body.size());
+}
+
+inline bool sendWire(Socket &socket, const SnapshotWriter &out) {
+  return socket.sendAll(out.data(), out.size());
+}
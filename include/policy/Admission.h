@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../FrequencySketch.h"
+#include "../LruKHistory.h"
+#include <concepts>
+#include <cstddef>
+
+// Cache<...> 的准入策略，决定一个新 key 能不能进缓存：
+//   Admission(capacity)
+//   onAccess(key, hit)         每次 get 查找之后，以及 put 覆盖已有的 key 时
+//   admit(candidate, victim)   put 一个新 key 时；缓存已满时 victim 指向
+//                              淘汰策略选出的结点的 key，否则为 nullptr
+// admit 返回 false 时这次写入被丢弃，也不会淘汰任何条目
+template <typename A, typename Key>
+concept AdmissionPolicy =
+    std::constructible_from<A, std::size_t> &&
+    requires(A &a, const Key &key, const Key *victim, bool hit) {
+      a.onAccess(key, hit);
+      { a.admit(key, victim) } -> std::convertible_to<bool>;
+    };
+
+// 全部准入(默认)
+template <typename Key> struct AlwaysAdmit {
+  explicit AlwaysAdmit(std::size_t) {}
+  void onAccess(const Key &, bool) {}
+  bool admit(const Key &, const Key *) { return true; }
+};
+
+// TinyLFU：用频率草图估计访问频率，缓存满时只有比 victim 更热的 key 才能挤掉它
+// (与 TinyLfuCache 的准入规则相同，但没有 window 区)
+template <typename Key> class TinyLfuAdmission {
+public:
+  explicit TinyLfuAdmission(std::size_t capacity) : sketch_(capacity) {}
+
+  void onAccess(const Key &key, bool) { sketch_.increment(key); }
+
+  bool admit(const Key &candidate, const Key *victim) {
+    sketch_.increment(candidate);
+    return victim == nullptr ||
+           sketch_.frequency(candidate) > sketch_.frequency(*victim);
+  }
+
+private:
+  FrequencySketch<Key> sketch_;
+};
+
+// LRU-K：一个 key 累计访问 K 次(未命中的 get 和 put 都算)才准入，
+// 访问历史用 LruKHistory，最多记住 capacity 个 key(与 LruKCache 相同)
+template <typename Key, unsigned K = 2> class LruKAdmission {
+public:
+  static_assert(K >= 1, "LruKAdmission: K must be at least 1");
+
+  explicit LruKAdmission(std::size_t capacity) : history_(capacity) {}
+
+  void onAccess(const Key &key, bool hit) {
+    if (!hit)
+      history_.touch(key);
+  }
+
+  bool admit(const Key &candidate, const Key *) {
+    if (history_.touch(candidate) < K)
+      return false;
+    history_.erase(candidate);
+    return true;
+  }
+
+private:
+  LruKHistory<Key> history_;
+};
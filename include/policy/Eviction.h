@@ -0,0 +1,240 @@
+#pragma once
+
+#include "../arc/ArcGhost.h"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Cache<...> 的淘汰策略。策略只看到存储层分配的结点下标和 key 的哈希，
+// 自己在按下标索引的数组里维护链表/频次等元数据，不接触 key/value：
+//   Eviction(capacity)
+//   onInsert(i, hash)            新结点 i 写入
+//   onAccess(i)                  命中(get，或 put 覆盖已有的 key)
+//   onErase(i, hash, evicted)    结点 i 删除；evicted 表示是容量淘汰
+//   victim()                     下一个该淘汰的结点(缓存非空时调用)
+// 可选的 beforeInsert(hash) 在新 key 写入(以及为它挑选 victim)之前调用，
+// ARC 用它检查幽灵链表并调整 p。下标删除后会被复用，onErase 之后
+// 策略里不能再留有它的状态
+template <typename E>
+concept EvictionPolicy =
+    std::constructible_from<E, std::size_t> &&
+    requires(E &e, std::uint32_t i, std::uint64_t hash, bool evicted) {
+      e.onInsert(i, hash);
+      e.onAccess(i);
+      e.onErase(i, hash, evicted);
+      { e.victim() } -> std::same_as<std::uint32_t>;
+    };
+
+namespace policy_detail {
+
+using Index = std::uint32_t;
+inline constexpr Index kNil = std::numeric_limits<Index>::max();
+
+struct Link {
+  Index prev = kNil; // 更旧的一侧
+  Index next = kNil; // 更新的一侧
+};
+
+// 挂在共用 Link 数组上的侵入式双向链表，oldest 一端淘汰
+struct IndexList {
+  Index oldest = kNil;
+  Index newest = kNil;
+  std::size_t size = 0;
+
+  bool empty() const { return size == 0; }
+
+  void pushNewest(std::vector<Link> &links, Index i) {
+    links[i].prev = newest;
+    links[i].next = kNil;
+    if (newest != kNil)
+      links[newest].next = i;
+    else
+      oldest = i;
+    newest = i;
+    ++size;
+  }
+
+  void unlink(std::vector<Link> &links, Index i) {
+    Link &link = links[i];
+    if (link.prev != kNil)
+      links[link.prev].next = link.next;
+    else
+      oldest = link.next;
+    if (link.next != kNil)
+      links[link.next].prev = link.prev;
+    else
+      newest = link.prev;
+    link = Link{};
+    --size;
+  }
+};
+
+// 元数据数组按下标懒扩容(存储层的下标从 0 开始紧凑分配)
+template <typename T> void ensureSlot(std::vector<T> &slots, Index i) {
+  if (i >= slots.size())
+    slots.resize(std::max<std::size_t>(i + 1, slots.size() * 2));
+}
+
+} // namespace policy_detail
+
+// LRU：一条链表，命中移到最新端
+class LruEviction {
+public:
+  using Index = policy_detail::Index;
+
+  explicit LruEviction(std::size_t capacity) { links_.reserve(capacity); }
+
+  void onInsert(Index i, std::uint64_t) {
+    policy_detail::ensureSlot(links_, i);
+    list_.pushNewest(links_, i);
+  }
+
+  void onAccess(Index i) {
+    if (list_.newest == i)
+      return;
+    list_.unlink(links_, i);
+    list_.pushNewest(links_, i);
+  }
+
+  void onErase(Index i, std::uint64_t, bool) { list_.unlink(links_, i); }
+
+  Index victim() const { return list_.oldest; }
+
+private:
+  std::vector<policy_detail::Link> links_;
+  policy_detail::IndexList list_;
+};
+
+// LFU：按频次分桶，同频次内按进入先后淘汰。频次在 kMaxFreq 饱和，
+// 桶是定长数组，命中和淘汰都不分配内存(没有 LfuCache 的老化机制)
+class LfuEviction {
+public:
+  using Index = policy_detail::Index;
+  static constexpr std::uint32_t kMaxFreq = 255;
+
+  explicit LfuEviction(std::size_t capacity) {
+    links_.reserve(capacity);
+    freq_.reserve(capacity);
+  }
+
+  void onInsert(Index i, std::uint64_t) {
+    policy_detail::ensureSlot(links_, i);
+    policy_detail::ensureSlot(freq_, i);
+    freq_[i] = 1;
+    buckets_[1].pushNewest(links_, i);
+    minFreq_ = 1;
+  }
+
+  void onAccess(Index i) {
+    const std::uint32_t freq = freq_[i];
+    if (freq == kMaxFreq) {
+      buckets_[freq].unlink(links_, i);
+      buckets_[freq].pushNewest(links_, i);
+      return;
+    }
+    buckets_[freq].unlink(links_, i);
+    buckets_[freq + 1].pushNewest(links_, i);
+    freq_[i] = static_cast<std::uint8_t>(freq + 1);
+    if (minFreq_ == freq && buckets_[freq].empty())
+      minFreq_ = freq + 1;
+  }
+
+  void onErase(Index i, std::uint64_t, bool) {
+    buckets_[freq_[i]].unlink(links_, i);
+  }
+
+  // 最小频次的桶删空后(remove 或淘汰)向上找下一个非空桶
+  Index victim() {
+    while (minFreq_ < kMaxFreq && buckets_[minFreq_].empty()) {
+      ++minFreq_;
+    }
+    return buckets_[minFreq_].oldest;
+  }
+
+private:
+  std::vector<policy_detail::Link> links_;
+  std::vector<std::uint8_t> freq_;
+  std::array<policy_detail::IndexList, kMaxFreq + 1> buckets_{};
+  std::uint32_t minFreq_ = 1;
+};
+
+// ARC：T1(只访问过一次)与 T2(访问过多次)两条 LRU 链表，
+// B1/B2 记住从两侧淘汰的 key 指纹(复用 ArcGhostList)，
+// 新 key 命中 B1 说明 T1 太小(p 增大)，命中 B2 说明 T2 太小(p 减小)。
+// 与 ArcCache 不同，这里是论文里的单一容量 + 目标值 p 的形式
+class ArcEviction {
+public:
+  using Index = policy_detail::Index;
+
+  explicit ArcEviction(std::size_t capacity) : capacity_(capacity) {
+    links_.reserve(capacity);
+    inT2_.reserve(capacity);
+  }
+
+  void beforeInsert(std::uint64_t hash) {
+    std::size_t weight = 0;
+    const std::size_t b1 = b1_.size();
+    const std::size_t b2 = b2_.size();
+    if (b1 > 0 && b1_.take(hash, weight)) {
+      p_ = std::min(capacity_, p_ + std::max<std::size_t>(b2 / b1, 1));
+      insertToT2_ = true;
+    } else if (b2 > 0 && b2_.take(hash, weight)) {
+      const std::size_t delta = std::max<std::size_t>(b1 / b2, 1);
+      p_ = p_ > delta ? p_ - delta : 0;
+      insertToT2_ = true;
+    } else {
+      insertToT2_ = false;
+    }
+  }
+
+  void onInsert(Index i, std::uint64_t) {
+    policy_detail::ensureSlot(links_, i);
+    policy_detail::ensureSlot(inT2_, i);
+    inT2_[i] = insertToT2_;
+    (insertToT2_ ? t2_ : t1_).pushNewest(links_, i);
+    insertToT2_ = false;
+  }
+
+  // 命中一律移到 T2 的最新端
+  void onAccess(Index i) {
+    (inT2_[i] ? t2_ : t1_).unlink(links_, i);
+    inT2_[i] = true;
+    t2_.pushNewest(links_, i);
+  }
+
+  void onErase(Index i, std::uint64_t hash, bool evicted) {
+    const bool fromT2 = inT2_[i];
+    (fromT2 ? t2_ : t1_).unlink(links_, i);
+    if (!evicted || capacity_ == 0)
+      return;
+    ArcGhostList<> &ghost = fromT2 ? b2_ : b1_;
+    while (ghost.size() >= capacity_) {
+      ghost.popOldest();
+    }
+    ghost.push(hash, 1);
+  }
+
+  // T1 超过目标 p 时淘汰 T1 最旧的，否则淘汰 T2 最旧的
+  Index victim() const {
+    if (!t1_.empty() && (t1_.size > p_ || t2_.empty()))
+      return t1_.oldest;
+    return t2_.oldest;
+  }
+
+  std::size_t target() const { return p_; } // T1 的目标大小 p
+
+private:
+  std::size_t capacity_;
+  std::size_t p_ = 0;
+  bool insertToT2_ = false; // 由 beforeInsert 决定下一个新结点进哪一侧
+  std::vector<policy_detail::Link> links_;
+  std::vector<std::uint8_t> inT2_; // 结点在 T2(1) 还是 T1(0)
+  policy_detail::IndexList t1_;
+  policy_detail::IndexList t2_;
+  ArcGhostList<> b1_;
+  ArcGhostList<> b2_;
+};
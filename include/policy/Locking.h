@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Cache<...> 的加锁策略：任意提供 lock / try_lock / unlock 的类型，
+// 例如 std::mutex、SpinLock，或者单线程使用时的 NoLock。
+// try_lock 是 AtomicStats 统计锁竞争时要用的
+template <typename L>
+concept CacheLock = requires(L &lock) {
+  lock.lock();
+  lock.unlock();
+  { lock.try_lock() } -> std::convertible_to<bool>;
+};
+
+// 不加锁：单线程使用，或由调用方在外面同步。内联后加解锁完全消失
+struct NoLock {
+  void lock() noexcept {}
+  bool try_lock() noexcept { return true; }
+  void unlock() noexcept {}
+};
+
+// 测试-测试-置位自旋锁：临界区只有几十纳秒、线程数不超过核数时，
+// 比 std::mutex 少一次原子 RMW 失败后的 futex 系统调用。
+// 长时间拿不到锁时让出时间片，避免线程数超过核数时空转
+class SpinLock {
+public:
+  void lock() noexcept {
+    for (unsigned spins = 0; locked_.exchange(true, std::memory_order_acquire);) {
+      while (locked_.load(std::memory_order_relaxed)) {
+        if (++spins < kSpinsBeforeYield)
+          pause();
+        else
+          std::this_thread::yield();
+      }
+    }
+  }
+
+  bool try_lock() noexcept {
+    return !locked_.load(std::memory_order_relaxed) &&
+           !locked_.exchange(true, std::memory_order_acquire);
+  }
+
+  void unlock() noexcept { locked_.store(false, std::memory_order_release); }
+
+private:
+  static constexpr unsigned kSpinsBeforeYield = 64;
+
+  static void pause() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    _mm_pause();
+#endif
+  }
+
+  std::atomic<bool> locked_{false};
+};
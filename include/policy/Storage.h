@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../FlatIndex.h"
+#include "../NodeSlab.h"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Cache<...> 的存储层：保存 key/value 并按 key 查找，结点用 32 位下标引用。
+// 下标删除后可以复用；淘汰/准入策略只通过下标和哈希与它打交道
+template <typename S, typename Key, typename Value>
+concept CacheStorage = requires(S &s, const S &cs, const Key &key,
+                                const Value &value, std::uint32_t i,
+                                std::uint64_t hash) {
+  { cs.hashOf(key) } -> std::same_as<std::uint64_t>;
+  { cs.find(key, hash) } -> std::same_as<std::uint32_t>;
+  { s.insert(hash, key, value) } -> std::same_as<std::uint32_t>;
+  s.erase(i, hash);
+  { cs.key(i) } -> std::same_as<const Key &>;
+  { s.value(i) } -> std::same_as<Value &>;
+  { cs.size() } -> std::convertible_to<std::size_t>;
+};
+
+// 默认存储：结点放在 NodeSlab 里，FlatIndex 索引(与 LruCache 等相同的布局)
+template <typename Key, typename Value> class SlabStorage {
+public:
+  using Index = std::uint32_t;
+
+  explicit SlabStorage(std::size_t capacity = 0) : index_(capacity) {}
+
+  template <typename K> std::uint64_t hashOf(const K &key) const {
+    return index_.hashOf(key);
+  }
+
+  template <typename K> Index find(const K &key, std::uint64_t hash) const {
+    return index_.find(key, hash,
+                       [this](Index i) -> const Key & { return nodes_[i].key; });
+  }
+
+  template <typename K, typename V>
+  Index insert(std::uint64_t hash, K &&key, V &&value) {
+    const Index i = nodes_.create(std::forward<K>(key), std::forward<V>(value));
+    index_.insert(hash, i,
+                  [this](Index j) { return index_.hashOf(nodes_[j].key); });
+    return i;
+  }
+
+  void erase(Index i, std::uint64_t hash) {
+    index_.erase(hash, i);
+    nodes_.destroy(i);
+  }
+
+  const Key &key(Index i) const { return nodes_[i].key; }
+  Value &value(Index i) { return nodes_[i].value; }
+  const Value &value(Index i) const { return nodes_[i].value; }
+  std::size_t size() const { return nodes_.size(); }
+
+  std::size_t memoryBytes() const {
+    return nodes_.memoryBytes() + index_.memoryBytes();
+  }
+
+private:
+  struct Node {
+    Key key;
+    Value value;
+
+    template <typename K, typename V>
+    Node(K &&k, V &&v) : key(std::forward<K>(k)), value(std::forward<V>(v)) {}
+  };
+
+  NodeSlab<Node> nodes_;
+  FlatIndex<Key> index_; // key -> 结点下标
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "../MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 访问 trace 的读取：文件整体 mmap 进来，不逐行拷贝。
+// 支持的格式：
+// - Binary：小端 u64 key 数组，直接在映射内存上遍历(零拷贝)
+// - Arc：ARC 论文 trace，每行 "起始块 块数 忽略 请求号"，展开成连续的块号
+// - Twitter：Twitter cache-trace CSV
+//   "时间戳,key,key大小,value大小,客户端,操作,TTL"，key 哈希成 u64
+// - Text：每行一个 key，纯数字按数值解析，否则哈希
+enum class TraceFormat { Binary, Arc, Twitter, Text };
+
+struct TraceRequest {
+  std::uint64_t key;
+  bool isWrite; // set/add/replace 等写操作；其余按读处理
+};
+
+// 一份加载好的 trace：二进制格式直接引用映射内存，文本格式解析一次后复用。
+// 加载完成后只读，可以被多个回放线程同时遍历
+class Trace {
+public:
+  // 失败时返回 false 并写入 error；limit 为 0 表示不限制请求数
+  bool load(const std::string &path, TraceFormat format, std::string &error,
+            std::size_t limit = 0) {
+    if (!file_.open(path)) {
+      error = "cannot open " + path;
+      return false;
+    }
+    format_ = format;
+    requests_.clear();
+
+    const std::string_view text(file_.data(), file_.size());
+    switch (format) {
+    case TraceFormat::Binary:
+      return loadBinary(error, limit);
+    case TraceFormat::Arc:
+      parseLines(text, limit, [this](std::string_view line) {
+        return parseArcLine(line);
+      });
+      return true;
+    case TraceFormat::Twitter:
+      parseLines(text, limit, [this](std::string_view line) {
+        return parseTwitterLine(line);
+      });
+      return true;
+    case TraceFormat::Text:
+      parseLines(text, limit, [this](std::string_view line) {
+        requests_.push_back({parseKey(line), false});
+        return true;
+      });
+      return true;
+    }
+    return true;
+  }
+
+  std::size_t size() const {
+    return format_ == TraceFormat::Binary ? binaryKeys_.size()
+                                          : requests_.size();
+  }
+
+  // 依次回调 fn(const TraceRequest&)
+  template <typename Fn> void forEach(Fn &&fn) const {
+    if (format_ == TraceFormat::Binary) {
+      for (std::uint64_t key : binaryKeys_) {
+        fn(TraceRequest{key, false});
+      }
+      return;
+    }
+    for (const TraceRequest &req : requests_) {
+      fn(req);
+    }
+  }
+
+  // 字符串 key 用 FNV-1a 映射到 u64
+  static std::uint64_t hashKey(std::string_view s) {
+    std::uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) {
+      h ^= c;
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+
+  // 纯数字按数值解析，否则哈希
+  static std::uint64_t parseKey(std::string_view s) {
+    std::uint64_t v = 0;
+    if (s.empty())
+      return hashKey(s);
+    for (char c : s) {
+      if (c < '0' || c > '9')
+        return hashKey(s);
+      v = v * 10 + static_cast<std::uint64_t>(c - '0');
+    }
+    return v;
+  }
+
+private:
+  bool loadBinary(std::string &error, std::size_t limit) {
+    if (file_.size() % sizeof(std::uint64_t) != 0) {
+      error = "binary trace size is not a multiple of 8 bytes";
+      return false;
+    }
+    std::size_t n = file_.size() / sizeof(std::uint64_t);
+    if (limit != 0 && n > limit)
+      n = limit;
+    // mmap 的起始地址按页对齐，可以直接当 u64 数组读(假定小端机器)
+    binaryKeys_ = std::span<const std::uint64_t>(
+        reinterpret_cast<const std::uint64_t *>(file_.data()), n);
+    return true;
+  }
+
+  template <typename ParseLine>
+  void parseLines(std::string_view text, std::size_t limit,
+                  ParseLine parseLine) {
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+      if (limit != 0 && requests_.size() >= limit)
+        break;
+      std::size_t end = text.find('\n', pos);
+      if (end == std::string_view::npos)
+        end = text.size();
+      std::string_view line = text.substr(pos, end - pos);
+      if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+      if (!line.empty() && line.front() != '#')
+        parseLine(line);
+      pos = end + 1;
+    }
+    if (limit != 0 && requests_.size() > limit)
+      requests_.resize(limit);
+  }
+
+  // 按空白/逗号切出第 index 个字段
+  static std::string_view field(std::string_view line, std::size_t index,
+                                char sep) {
+    std::size_t pos = 0;
+    for (std::size_t i = 0;; ++i) {
+      while (sep == ' ' && pos < line.size() && line[pos] == ' ')
+        ++pos;
+      std::size_t end = line.find(sep, pos);
+      if (end == std::string_view::npos)
+        end = line.size();
+      if (i == index)
+        return line.substr(pos, end - pos);
+      if (end >= line.size())
+        return {};
+      pos = end + 1;
+    }
+  }
+
+  bool parseArcLine(std::string_view line) {
+    const std::string_view start = field(line, 0, ' ');
+    const std::string_view count = field(line, 1, ' ');
+    if (start.empty() || count.empty())
+      return false;
+    const std::uint64_t first = parseKey(start);
+    const std::uint64_t blocks = parseKey(count);
+    for (std::uint64_t b = 0; b < blocks; ++b) {
+      requests_.push_back({first + b, false});
+    }
+    return true;
+  }
+
+  bool parseTwitterLine(std::string_view line) {
+    const std::string_view key = field(line, 1, ',');
+    const std::string_view op = field(line, 5, ',');
+    if (key.empty() || op == "delete")
+      return false; // 删除请求不参与命中率统计
+    const bool isWrite = op == "set" || op == "add" || op == "replace" ||
+                         op == "cas" || op == "append" || op == "prepend";
+    requests_.push_back({hashKey(key), isWrite});
+    return true;
+  }
+
+private:
+  MappedFile file_;
+  TraceFormat format_ = TraceFormat::Binary;
+  std::span<const std::uint64_t> binaryKeys_;
+  std::vector<TraceRequest> requests_;
+};
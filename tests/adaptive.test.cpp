@@ -0,0 +1,177 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AdaptiveCache.h"
+
+namespace {
+
+// 偏斜访问：小编号的 key 远比大编号的热，LFU 明显好于 LRU
+int skewedKey(std::mt19937 &rng) {
+  std::uniform_real_distribution<double> u;
+  return static_cast<int>(100000 * u(rng) * u(rng) * u(rng));
+}
+
+// 按需回填：未命中就 put
+template <typename NextKey>
+void drive(AdaptiveCache<int, int> &cache, int ops, NextKey &&next) {
+  int out = 0;
+  for (int i = 0; i < ops; ++i) {
+    const int key = next(i);
+    if (!cache.get(key, out))
+      cache.put(key, key);
+  }
+}
+
+} // namespace
+
+TEST_CASE("AdaptiveCache: serves like a plain cache", "[adaptive]") {
+  AdaptiveCache<int, std::string> cache(3);
+  REQUIRE(cache.policy() == AdaptivePolicy::Lru);
+  cache.put(1, "a");
+  cache.put(2, "b");
+  cache.put(3, "c");
+  REQUIRE(cache.get(1) == "a");
+  cache.put(4, "d"); // LRU：淘汰 2
+
+  std::string out;
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.get(4) == "d");
+  REQUIRE(cache.size() == 3);
+
+  REQUIRE(cache.remove(4));
+  REQUIRE_FALSE(cache.remove(4));
+  REQUIRE(cache.size() == 2);
+}
+
+TEST_CASE("AdaptiveCache: shadows see about sampleRate of the keys",
+          "[adaptive]") {
+  AdaptiveCache<int, int> cache(100000);
+  drive(cache, 200000, [](int i) { return i; });
+  // 1% 抽样，允许 ±20% 的偏差
+  REQUIRE(cache.sampledGets() > 1600);
+  REQUIRE(cache.sampledGets() < 2400);
+
+  // 容量太小时提高抽样率，保证影子至少 minShadowCapacity 个条目
+  AdaptiveCache<int, int> small(100);
+  drive(small, 1000, [](int i) { return i; });
+  REQUIRE(small.sampledGets() > 500);
+}
+
+TEST_CASE("AdaptiveCache: switches to LFU on a skewed workload",
+          "[adaptive]") {
+  AdaptiveCache<int, int> cache(10000);
+  std::mt19937 rng(1);
+  drive(cache, 2000000, [&](int) { return skewedKey(rng); });
+
+  REQUIRE(cache.policy() == AdaptivePolicy::Lfu);
+  REQUIRE(cache.switches() == 1);
+  REQUIRE(cache.windowMissRatio(AdaptivePolicy::Lfu) + 0.02 <
+          cache.windowMissRatio(AdaptivePolicy::Lru));
+}
+
+TEST_CASE("AdaptiveCache: switches back when the workload shifts",
+          "[adaptive]") {
+  AdaptiveOptions options;
+  options.initial = AdaptivePolicy::Lfu;
+  AdaptiveCache<int, int> cache(10000, options);
+  std::mt19937 rng(2);
+  drive(cache, 500000, [&](int) { return skewedKey(rng); });
+  REQUIRE(cache.policy() == AdaptivePolicy::Lfu);
+  REQUIRE(cache.switches() == 0);
+
+  // 工作集随时间漂移：旧的热 key 不再访问，LFU 留着它们不放
+  drive(cache, 2000000,
+        [&](int i) { return 1000000 + i / 4 + static_cast<int>(rng() % 8000); });
+  REQUIRE(cache.policy() != AdaptivePolicy::Lfu);
+  REQUIRE(cache.windowMissRatio(cache.policy()) + 0.02 <
+          cache.windowMissRatio(AdaptivePolicy::Lfu));
+}
+
+TEST_CASE("AdaptiveCache: ties and small differences do not switch",
+          "[adaptive]") {
+  AdaptiveCache<int, int> cache(10000);
+  // 均匀随机：四种策略的未命中率都在 90% 附近
+  std::mt19937 rng(3);
+  drive(cache, 1000000, [&](int) { return static_cast<int>(rng() % 100000); });
+  REQUIRE(cache.policy() == AdaptivePolicy::Lru);
+  REQUIRE(cache.switches() == 0);
+}
+
+TEST_CASE("AdaptiveCache: autoSwitch=false only simulates", "[adaptive]") {
+  AdaptiveOptions options;
+  options.autoSwitch = false;
+  AdaptiveCache<int, int> cache(10000, options);
+  std::mt19937 rng(1);
+  drive(cache, 1000000, [&](int) { return skewedKey(rng); });
+  REQUIRE(cache.policy() == AdaptivePolicy::Lru);
+  REQUIRE(cache.switches() == 0);
+  REQUIRE(cache.windowMissRatio(AdaptivePolicy::Lfu) <
+          cache.windowMissRatio(AdaptivePolicy::Lru));
+}
+
+TEST_CASE("AdaptiveCache: a switch keeps entries and never serves stale values",
+          "[adaptive]") {
+  AdaptiveCache<int, std::string> cache(100);
+  for (int k = 0; k < 100; ++k) {
+    cache.put(k, "old" + std::to_string(k));
+  }
+  cache.select(AdaptivePolicy::Arc);
+  REQUIRE(cache.policy() == AdaptivePolicy::Arc);
+  REQUIRE(cache.switches() == 1);
+  REQUIRE(cache.handingOff());
+
+  // 旧策略里的条目仍然能读到
+  REQUIRE(cache.get(0) == "old0");
+  // 切换后的写入覆盖旧副本
+  cache.put(1, "new1");
+  REQUIRE(cache.get(1) == "new1");
+  // 删除同时作用于两边
+  REQUIRE(cache.remove(2));
+  std::string out;
+  REQUIRE_FALSE(cache.get(2, out));
+
+  // 2 × capacity 次操作之后丢掉旧策略，没被访问过的条目随之消失
+  for (int k = 0; k < 200; ++k) {
+    cache.get(1000 + k, out);
+  }
+  REQUIRE_FALSE(cache.handingOff());
+  REQUIRE(cache.get(0) == "old0"); // 交接期内被读过，已经搬进新策略
+  REQUIRE(cache.get(1) == "new1");
+  REQUIRE_FALSE(cache.get(3, out));
+
+  cache.select(AdaptivePolicy::Arc); // 已经是当前策略：什么都不做
+  REQUIRE(cache.switches() == 1);
+  REQUIRE_FALSE(cache.handingOff());
+}
+
+TEST_CASE("AdaptiveCache: concurrent access is safe", "[adaptive]") {
+  AdaptiveCache<int, int> cache(1000);
+  std::atomic<bool> wrongValue{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, &wrongValue, t] {
+      std::mt19937 rng(static_cast<unsigned>(t));
+      int out = 0;
+      for (int i = 0; i < 50000; ++i) {
+        const int key = skewedKey(rng) % 5000;
+        if (!cache.get(key, out)) {
+          cache.put(key, key);
+        } else if (out != key) {
+          wrongValue = true;
+        }
+        if (i % 10000 == 0)
+          cache.select(static_cast<AdaptivePolicy>((i / 10000 + t) % 4));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  REQUIRE_FALSE(wrongValue);
+  REQUIRE(cache.size() <= 2 * cache.capacity());
+}
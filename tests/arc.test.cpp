@@ -0,0 +1,399 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "arc/ArcCache.h"
+
+TEST_CASE("ARC: put/get basic hit-miss", "[arc]") {
+  ArcCache<int, std::string> cache(2);
+
+  std::string out;
+  REQUIRE_FALSE(cache.get(1, out));
+
+  cache.put(1, "a");
+  cache.put(2, "b");
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == "a");
+  REQUIRE(cache.get(2, out));
+  REQUIRE(out == "b");
+}
+
+TEST_CASE("ARC: put updates value of frequently used key", "[arc]") {
+  ArcCache<int, std::string> cache(2);
+
+  cache.put(1, "a");
+  // 两次访问后 key=1 进入 LFU 部分
+  REQUIRE(cache.get(1) == "a");
+  REQUIRE(cache.get(1) == "a");
+
+  cache.put(1, "a2");
+  REQUIRE(cache.get(1) == "a2");
+}
+
+TEST_CASE("ARC: frequently used keys survive a scan", "[arc]") {
+  ArcCache<int, std::string> cache(4);
+
+  cache.put(1, "hot");
+  for (int i = 0; i < 5; ++i) {
+    REQUIRE(cache.get(1) == "hot");
+  }
+
+  // 一次性扫描大量冷数据，只会冲掉 LRU 部分
+  for (int k = 100; k < 200; ++k) {
+    cache.put(k, "cold");
+  }
+
+  REQUIRE(cache.get(1) == "hot");
+}
+
+TEST_CASE("ARC: LFU ghost hit keeps working after eviction", "[arc]") {
+  ArcCache<int, std::string> cache(2);
+
+  // 让 1、2 都进入 LFU 部分
+  for (int k : {1, 2}) {
+    cache.put(k, "v" + std::to_string(k));
+    cache.get(k);
+    cache.get(k);
+  }
+  // 3 进入 LFU 后挤掉频次最低且最早的结点，进入幽灵链表
+  cache.put(3, "v3");
+  cache.get(3);
+  cache.get(3);
+
+  // 再次写入被淘汰的 key 会命中幽灵链表并调整容量，不应出错
+  for (int k : {1, 2, 3}) {
+    cache.put(k, "again" + std::to_string(k));
+  }
+  std::string out;
+  REQUIRE(cache.get(3, out));
+  REQUIRE(out == "again3");
+}
+
+namespace {
+
+// 让 n 个 key 全部停在 LFU 部分的同一个频次桶里，然后每个 key 命中一次
+// (每次命中都把结点从这个大桶中摘出来)，返回平均每次命中的纳秒数
+double lfuBucketHitNs(int n) {
+  ArcCache<int, int> cache(static_cast<size_t>(n));
+  for (int k = 0; k < n; ++k) {
+    cache.put(k, k);
+    cache.get(k); // 访问次数达到阈值，复制进 LFU 部分(频次 1)
+  }
+
+  int out = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int k = 0; k < n; ++k) {
+    cache.get(k, out);
+  }
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  return static_cast<double>(ns) / n;
+}
+
+} // namespace
+
+TEST_CASE("ARC: LFU hit latency stays flat as one frequency bucket grows",
+          "[arc][perf]") {
+  // 取多次中的最好值，降低调度噪声的影响
+  auto best = [](int n) {
+    double ns = lfuBucketHitNs(n);
+    for (int i = 0; i < 2; ++i) {
+      ns = std::min(ns, lfuBucketHitNs(n));
+    }
+    return ns;
+  };
+
+  const double small = best(1000);
+  const double large = best(64000);
+
+  // 桶大了 64 倍；线性扫描的实现会慢上几十倍，O(1) 摘除只受缓存失效影响
+  INFO("per-hit ns: bucket=1000 -> " << small << ", bucket=64000 -> "
+                                     << large);
+  REQUIRE(large < small * 8);
+}
+
+TEST_CASE("ARC: concurrent put/get keeps one consistent view",
+          "[arc][thread]") {
+  ArcCache<int, int> cache(64);
+
+  std::atomic<bool> start{false};
+  std::atomic<int> corrupted{0};
+  auto worker = [&](int seed) {
+    while (!start.load(std::memory_order_acquire)) {
+    }
+    unsigned x = static_cast<unsigned>(seed) * 2654435761u + 1;
+    for (int i = 0; i < 20000; ++i) {
+      x = x * 1103515245u + 12345u;
+      // 热点 + 冷数据混合，频繁触发 T1->T2 迁移、淘汰和幽灵命中
+      const int key = (x >> 8) % 4 == 0 ? static_cast<int>((x >> 12) % 16)
+                                        : static_cast<int>((x >> 12) % 512);
+      if ((x >> 4) % 4 == 0) {
+        cache.put(key, key * 10);
+      } else {
+        int out = -1;
+        // value 总是 key*10，读到别的值说明结点被并发破坏
+        if (cache.get(key, out) && out != key * 10) {
+          corrupted.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back(worker, t + 1);
+  }
+  start.store(true, std::memory_order_release);
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  REQUIRE(corrupted.load() == 0);
+  cache.put(1, 10);
+  REQUIRE(cache.get(1) == 10);
+}
+
+TEST_CASE("KHashARC: basic put/get works across slices", "[khasharc]") {
+  KHashArcCache<int, std::string> cache(/*capacity*/ 16, /*sliceNum*/ 4);
+
+  for (int i = 0; i < 8; ++i) {
+    cache.put(i, "v" + std::to_string(i));
+  }
+  for (int i = 0; i < 8; ++i) {
+    std::string v;
+    REQUIRE(cache.get(i, v));
+    REQUIRE(v == "v" + std::to_string(i));
+  }
+  REQUIRE(cache.get(100).empty());
+}
+
+TEST_CASE("KHashARC: rebalance moves capacity toward ghost-hit pressure",
+          "[khasharc]") {
+  KHashArcCache<int, int> cache(/*capacity*/ 20, /*sliceNum*/ 2);
+
+  const auto before = cache.sliceCapacities();
+  REQUIRE(before.size() == 2);
+
+  // 挑出落在 0 号分片上的 15 个 key 循环访问，反复命中幽灵链表
+  std::vector<int> keys;
+  for (int k = 0; keys.size() < 15; ++k) {
+    if (cache.sliceIndex(k) == 0)
+      keys.push_back(k);
+  }
+  for (int round = 0; round < 5; ++round) {
+    for (int k : keys) {
+      cache.put(k, k);
+    }
+  }
+
+  cache.rebalance();
+  const auto after = cache.sliceCapacities();
+
+  REQUIRE(after[0] > before[0]);
+  REQUIRE(after[1] < before[1]);
+  REQUIRE(after[0] + after[1] == before[0] + before[1]);
+}
+
+TEST_CASE("KHashARC: rebalance grows the side with the ghost hits",
+          "[khasharc]") {
+  KHashArcCache<int, int> cache(/*capacity*/ 8, /*sliceNum*/ 2);
+
+  // 0 号分片上的 key 写入后读一次就迁到 LFU 部分，LRU 部分从不淘汰；
+  // 第 5 个挤掉 LFU 部分的 key，再写回它只命中 LFU 幽灵
+  std::vector<int> keys;
+  for (int k = 0; keys.size() < 5; ++k) {
+    if (cache.sliceIndex(k) == 0)
+      keys.push_back(k);
+  }
+  for (int k : keys) {
+    cache.put(k, k);
+    (void)cache.get(k);
+  }
+  cache.put(keys[0], keys[0]);
+
+  const auto before = cache.sliceLfuCapacities();
+  cache.rebalance();
+  const auto after = cache.sliceLfuCapacities();
+  REQUIRE(after[0] > before[0]);
+}
+
+TEST_CASE("KHashARC: periodic rebalance keeps working under threads",
+          "[khasharc][thread]") {
+  KHashArcCache<int, int> cache(/*capacity*/ 256, /*sliceNum*/ 4,
+                                /*transformThreshold*/ 2,
+                                /*rebalanceInterval*/ 500);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, t] {
+      for (int i = 0; i < 20000; ++i) {
+        const int key = (i * (t + 3)) % 1024;
+        if (i % 3 == 0)
+          cache.put(key, key);
+        else
+          (void)cache.get(key);
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  size_t total = 0;
+  for (size_t cap : cache.sliceCapacities())
+    total += cap;
+  // 每个分片两部分各 64，总容量守恒
+  REQUIRE(total == 4 * 2 * 64);
+}
+
+TEST_CASE("KHashARC: batch calls agree with single-key calls",
+          "[khasharc][batch]") {
+  KHashArcCache<int, int> batch(/*capacity*/ 64, /*sliceNum*/ 4);
+  KHashArcCache<int, int> single(/*capacity*/ 64, /*sliceNum*/ 4);
+
+  std::vector<int> keys;
+  std::vector<int> values;
+  for (int k = 0; k < 200; ++k) {
+    keys.push_back((k * 37) % 97); // 有重复 key，也会触发淘汰和幽灵命中
+    values.push_back(k);
+  }
+  batch.putMany(keys, values);
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    single.put(keys[i], values[i]);
+  }
+
+  std::vector<int> out(keys.size(), -1);
+  std::unique_ptr<bool[]> found(new bool[keys.size()]);
+  batch.getMany(keys, out, std::span<bool>(found.get(), keys.size()));
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    int v = -1;
+    REQUIRE(found[i] == single.get(keys[i], v));
+    REQUIRE(out[i] == v);
+  }
+}
+
+TEST_CASE("ARC: withValue sees the same node before and after promotion",
+          "[arc][zero-copy]") {
+  ArcCache<int, std::string> cache(4);
+  cache.put(1, "v1");
+
+  const std::string *first = nullptr;
+  const std::string *second = nullptr;
+  // 第一次访问达到门槛，结点从 LRU 部分整体迁到 LFU 部分
+  REQUIRE(cache.withValue(1, [&](const std::string &v) { first = &v; }));
+  REQUIRE(cache.withValue(1, [&](const std::string &v) { second = &v; }));
+  REQUIRE(first == second);
+  REQUIRE(*second == "v1");
+
+  REQUIRE_FALSE(cache.withValue(2, [](const std::string &) {}));
+
+  KHashArcCache<int, std::string> sharded(/*capacity*/ 16, /*sliceNum*/ 4);
+  sharded.put(7, "seven");
+  std::size_t len = 0;
+  REQUIRE(sharded.withValue(7, [&](const std::string &v) { len = v.size(); }));
+  REQUIRE(len == 5);
+}
+
+TEST_CASE("ARC: emplace and string_view lookup in both parts",
+          "[arc][move][heterogeneous]") {
+  ArcCache<std::string, std::string> cache(4);
+  cache.emplace("hot", "h");
+  cache.put(std::string("cold"), std::string("c"));
+
+  std::string out;
+  // 第一次命中把 hot 迁到 LFU 部分，第二次在 LFU 部分查找
+  REQUIRE(cache.get(std::string_view("hot"), out));
+  REQUIRE(cache.get(std::string_view("hot"), out));
+  REQUIRE(out == "h");
+  REQUIRE(cache.get("cold", out));
+  REQUIRE(out == "c");
+
+  cache.emplace("hot", 2, 'H'); // LFU 部分里原地覆盖
+  REQUIRE(cache.get("hot", out));
+  REQUIRE(out == "HH");
+  REQUIRE_FALSE(cache.get(std::string_view("none"), out));
+}
+
+TEST_CASE("ARC ghost list: fingerprints age out in eviction order",
+          "[arc][ghost]") {
+  ArcGhostList<> ghost;
+  for (std::uint64_t fp = 1; fp <= 5; ++fp) {
+    ghost.push(fp, 1);
+  }
+  REQUIRE(ghost.size() == 5);
+
+  std::size_t weight = 0;
+  REQUIRE(ghost.take(3, weight));
+  REQUIRE(weight == 1);
+  REQUIRE_FALSE(ghost.take(3, weight));
+
+  // 最旧的先出，被摘掉的 3 留下的空洞直接跳过
+  REQUIRE(ghost.popOldest() == 1);
+  REQUIRE(ghost.popOldest() == 1);
+  REQUIRE_FALSE(ghost.take(1, weight));
+  REQUIRE_FALSE(ghost.take(2, weight));
+  REQUIRE(ghost.popOldest() == 1);
+  REQUIRE_FALSE(ghost.take(4, weight));
+  REQUIRE(ghost.take(5, weight));
+  REQUIRE(ghost.empty());
+  REQUIRE(ghost.popOldest() == 0);
+}
+
+TEST_CASE("ARC ghost list: holes are compacted and weights tracked",
+          "[arc][ghost]") {
+  ArcGhostList<SizeofWeigher> ghost;
+  constexpr std::uint64_t N = 10000;
+  for (std::uint64_t fp = 1; fp <= N; ++fp) {
+    ghost.push(fp * 0x9E3779B97F4A7C15ULL, fp % 7 + 1);
+    // 每插入一个就摘掉一个较早的，留下大量空洞
+    std::size_t weight = 0;
+    if (fp % 2 == 0)
+      REQUIRE(ghost.take((fp - 1) * 0x9E3779B97F4A7C15ULL, weight));
+  }
+  REQUIRE(ghost.size() == N / 2);
+
+  std::size_t expected = 0;
+  for (std::uint64_t fp = 2; fp <= N; fp += 2) {
+    expected += fp % 7 + 1;
+  }
+  REQUIRE(ghost.weight() == expected);
+  // 每个幽灵只占指纹 + 权重 + 索引
+  REQUIRE(ghost.memoryBytes() / ghost.size() < 64);
+
+  // 剩下的按插入顺序出队
+  std::size_t popped = 0;
+  while (!ghost.empty()) {
+    popped += ghost.popOldest();
+  }
+  REQUIRE(popped == expected);
+}
+
+TEST_CASE("ARC: ghosts drop evicted values but still adapt p",
+          "[arc][ghost]") {
+  ArcCache<int, std::shared_ptr<int>, AtomicStats> cache(4);
+  std::vector<std::weak_ptr<int>> alive;
+  for (int k = 0; k < 64; ++k) {
+    auto value = std::make_shared<int>(k);
+    alive.push_back(value);
+    cache.put(k, std::move(value));
+  }
+  // 只有仍在主缓存里的值还活着，进入幽灵链表的值已经释放
+  const auto live = std::count_if(alive.begin(), alive.end(),
+                                  [](const auto &w) { return !w.expired(); });
+  REQUIRE(live <= 8);
+
+  // 刚被淘汰的 key 再次写入时命中幽灵链表
+  cache.put(59, std::make_shared<int>(59));
+  REQUIRE(cache.stats().ghostHits == 1);
+  REQUIRE(cache.stats().pAdjustments == 1);
+}
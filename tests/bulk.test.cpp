@@ -0,0 +1,204 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "arc/ArcCache.h"
+
+namespace {
+
+std::vector<std::pair<int, int>> makeItems(int n) {
+  std::vector<std::pair<int, int>> items;
+  items.reserve(static_cast<std::size_t>(n));
+  for (int i = 0; i < n; ++i) {
+    items.emplace_back(i, i * 10);
+  }
+  return items;
+}
+
+} // namespace
+
+TEST_CASE("bulkLoad: later items win and excess is evicted", "[bulk]") {
+  const auto items = makeItems(1000);
+
+  LruCache<int, int, AtomicStats> lru(100);
+  lru.bulkLoad(items);
+  REQUIRE(lru.size() == 100);
+  int out = 0;
+  REQUIRE_FALSE(lru.get(899, out));
+  REQUIRE(lru.get(900, out));
+  REQUIRE(out == 9000);
+  REQUIRE(lru.stats().inserts == 1000);
+  REQUIRE(lru.stats().evictions == 900);
+
+  LfuCache<int, int> lfu(100);
+  lfu.bulkLoad(items);
+  REQUIRE(lfu.get(999, out));
+  REQUIRE(out == 9990);
+
+  ArcCache<int, int> arc(100);
+  arc.bulkLoad(items);
+  REQUIRE(arc.get(999, out));
+
+  // 重复的 key：后出现的覆盖前面的
+  std::vector<std::pair<int, int>> dup = {{1, 1}, {2, 2}, {1, 3}};
+  lru.bulkLoad(dup);
+  REQUIRE(lru.get(1) == 3);
+
+  lru.bulkLoad(std::vector<std::pair<int, int>>{});
+}
+
+TEST_CASE("bulkLoad: sharded caches load every shard in parallel",
+          "[bulk][concurrency]") {
+  const auto items = makeItems(20000);
+
+  KHashLruCaches<int, int> lru(40000, 8);
+  lru.bulkLoad(items, 4);
+  KHashLfuCache<int, int> lfu(40000, 8);
+  lfu.bulkLoad(items);
+  KHashArcCache<int, int> arc(80000, 8);
+  arc.bulkLoad(items, 2);
+
+  int out = 0;
+  bool all = true;
+  for (const auto &[key, value] : items) {
+    all = all && lru.get(key, out) && out == value;
+    all = all && lfu.get(key, out) && out == value;
+    all = all && arc.get(key, out) && out == value;
+  }
+  REQUIRE(all);
+  std::size_t total = 0;
+  for (std::size_t n : lru.occupancy()) {
+    total += n;
+  }
+  REQUIRE(total == items.size());
+}
+
+TEST_CASE("clear: empties the cache without counting evictions",
+          "[bulk][stats]") {
+  LruCache<int, int, AtomicStats> lru(8);
+  LfuCache<int, int, AtomicStats> lfu(8);
+  ArcCache<int, int, AtomicStats> arc(8);
+  for (int i = 0; i < 8; ++i) {
+    lru.put(i, i, std::chrono::seconds(60));
+    lfu.put(i, i);
+    arc.put(i, i);
+    arc.get(i); // 一部分进入 T2
+    arc.get(i);
+  }
+  lru.clear();
+  lfu.clear();
+  arc.clear();
+  REQUIRE(lru.size() == 0);
+  REQUIRE(lfu.size() == 0);
+  REQUIRE(arc.size() == 0);
+  REQUIRE(lru.stats().evictions == 0);
+  REQUIRE(lfu.stats().evictions == 0);
+
+  // 清空后照常可用
+  int out = 0;
+  for (int i = 10; i < 20; ++i) {
+    lru.put(i, i);
+    lfu.put(i, i);
+    arc.put(i, i);
+  }
+  REQUIRE(lru.size() == 8);
+  REQUIRE(lfu.size() == 8);
+  REQUIRE(arc.get(19, out));
+  REQUIRE_FALSE(arc.get(3, out));
+}
+
+TEST_CASE("removeIf / removePrefix: invalidate a group of keys", "[bulk]") {
+  LruCache<std::string, int> lru(100);
+  LfuCache<std::string, int> lfu(100);
+  ArcCache<std::string, int> arc(100);
+  for (int i = 0; i < 20; ++i) {
+    const std::string key = (i % 2 ? "user:1:" : "user:2:") + std::to_string(i);
+    lru.put(key, i);
+    lfu.put(key, i);
+    lfu.get(key); // 频次各不相同
+    arc.put(key, i);
+    if (i % 4 == 0) {
+      arc.get(key); // 进入 T2
+      arc.get(key);
+    }
+  }
+
+  REQUIRE(lru.removePrefix("user:1:") == 10);
+  REQUIRE(lfu.removePrefix("user:1:") == 10);
+  REQUIRE(arc.removePrefix("user:1:") == 10);
+  REQUIRE(lru.size() == 10);
+  REQUIRE(lfu.size() == 10);
+  REQUIRE(arc.size() == 10);
+
+  int out = 0;
+  REQUIRE_FALSE(lru.get("user:1:3", out));
+  REQUIRE(lru.get("user:2:4", out));
+  REQUIRE(arc.get("user:2:8", out));
+
+  auto even = [](const std::string &, int value) { return value % 4 == 0; };
+  REQUIRE(lru.removeIf(even) == 5);
+  REQUIRE(lfu.removeIf(even) == 5);
+  REQUIRE(arc.removeIf(even) == 5);
+  REQUIRE_FALSE(lfu.get("user:2:4", out));
+  REQUIRE(lfu.get("user:2:6", out));
+  REQUIRE(arc.get("user:2:6", out));
+}
+
+TEST_CASE("sharded invalidation runs while other keys keep being served",
+          "[bulk][concurrency]") {
+  KHashLfuCache<std::string, int> cache(4000, 8);
+  for (int i = 0; i < 1000; ++i) {
+    cache.put("a:" + std::to_string(i), i);
+    cache.put("b:" + std::to_string(i), i);
+  }
+
+  std::atomic<bool> stop{false};
+  std::atomic<bool> lost{false};
+  std::thread reader([&] {
+    int out = 0;
+    for (int i = 0; !stop.load(); i = (i + 1) % 1000) {
+      if (!cache.get("b:" + std::to_string(i), out) || out != i)
+        lost = true;
+    }
+  });
+  std::thread writer([&] {
+    for (int round = 0; round < 20; ++round) {
+      for (int i = 0; i < 100; ++i) {
+        cache.put("a:" + std::to_string(i), i);
+      }
+    }
+  });
+
+  std::size_t removed = 0;
+  for (int round = 0; round < 20; ++round) {
+    removed += cache.removePrefix("a:", 4);
+  }
+  writer.join();
+  stop = true;
+  reader.join();
+
+  REQUIRE_FALSE(lost);
+  REQUIRE(removed >= 1000);
+  cache.purge(); // purge 与 clear 相同，加锁后清空
+  std::size_t total = 0;
+  for (std::size_t n : cache.occupancy()) {
+    total += n;
+  }
+  REQUIRE(total == 0);
+
+  KHashLruCaches<std::string, int> lru(100, 4);
+  lru.put("x:1", 1);
+  lru.put("y:1", 1);
+  REQUIRE(lru.removeIf([](const std::string &key, int) {
+            return key[0] == 'x';
+          }) == 1);
+  lru.clear();
+  int out = 0;
+  REQUIRE_FALSE(lru.get("y:1", out));
+}
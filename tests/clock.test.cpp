@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ClockCache.h"
+
+TEST_CASE("CLOCK: put/get basic hit-miss", "[clock]") {
+  ClockCache<int, std::string> cache(2);
+
+  std::string out;
+  REQUIRE_FALSE(cache.get(1, out));
+
+  cache.put(1, "a");
+  cache.put(2, "b");
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == "a");
+  REQUIRE(cache.get(2, out));
+  REQUIRE(out == "b");
+
+  cache.put(1, "a2");
+  REQUIRE(cache.get(1) == "a2");
+  REQUIRE(cache.size() == 2);
+}
+
+TEST_CASE("CLOCK: referenced entries get a second chance", "[clock]") {
+  ClockCache<int, std::string> cache(3);
+
+  cache.put(1, "a");
+  cache.put(2, "b");
+  cache.put(3, "c");
+
+  // 1 和 3 被访问过，引用位置 1；2 没有
+  REQUIRE(cache.get(1) == "a");
+  REQUIRE(cache.get(3) == "c");
+
+  cache.put(4, "d"); // 指针扫过 1(清零) -> 2(牺牲)
+
+  std::string out;
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.get(1, out));
+  REQUIRE(cache.get(3, out));
+  REQUIRE(cache.get(4, out));
+}
+
+TEST_CASE("CLOCK: remove frees a slot", "[clock]") {
+  ClockCache<int, int> cache(2);
+
+  cache.put(1, 1);
+  cache.put(2, 2);
+  cache.remove(1);
+  REQUIRE(cache.size() == 1);
+
+  cache.put(3, 3); // 使用空出的槽位，不淘汰 2
+  int out = 0;
+  REQUIRE(cache.get(2, out));
+  REQUIRE(cache.get(3, out));
+  REQUIRE_FALSE(cache.get(1, out));
+}
+
+TEST_CASE("CLOCK: zero capacity stores nothing", "[clock]") {
+  ClockCache<int, std::string> cache(0);
+  cache.put(1, "a");
+  REQUIRE(cache.get(1).empty());
+}
+
+TEST_CASE("CLOCK: concurrent readers and writers see consistent values",
+          "[clock][thread]") {
+  ClockCache<int, int> cache(128, /*stripeNum*/ 8);
+
+  std::atomic<bool> start{false};
+  std::atomic<int> corrupted{0};
+  auto worker = [&](int t) {
+    while (!start.load(std::memory_order_acquire)) {
+    }
+    for (int i = 0; i < 20000; ++i) {
+      const int key = (i * 7 + t * 13) % 512;
+      if (i % 4 == t % 4) {
+        cache.put(key, key * 3);
+      } else {
+        int out = -1;
+        if (cache.get(key, out) && out != key * 3)
+          corrupted.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back(worker, t);
+  }
+  start.store(true, std::memory_order_release);
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  REQUIRE(corrupted.load() == 0);
+  REQUIRE(cache.size() <= 128);
+}
@@ -0,0 +1,323 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "cluster/ClusterCache.h"
+#include "cluster/HashRing.h"
+
+namespace {
+
+using Node = ClusterCache<int, std::string, KHashLruCaches<int, std::string>>;
+
+ClusterOptions nodeOptions(ClusterNodeId id) {
+  ClusterOptions options;
+  options.self = id;
+  options.maxBatch = 64;
+  options.pipelineDepth = 32;
+  options.timeout = std::chrono::milliseconds(500);
+  return options;
+}
+
+// n 个在回环地址上互联的节点，每个节点的本地缓存容量为 capacity
+std::vector<std::unique_ptr<Node>> makeCluster(int n,
+                                               std::size_t capacity = 4096) {
+  std::vector<std::unique_ptr<Node>> nodes;
+  for (int i = 0; i < n; ++i) {
+    nodes.push_back(std::make_unique<Node>(
+        nodeOptions(static_cast<ClusterNodeId>(i)), capacity, 4));
+    REQUIRE(nodes.back()->ok());
+  }
+  for (auto &node : nodes) {
+    for (auto &peer : nodes) {
+      node->addPeer(ClusterPeer{peer->self(), "127.0.0.1", peer->port()});
+    }
+  }
+  return nodes;
+}
+
+std::size_t localSize(Node &node) {
+  const std::vector<std::size_t> occupancy = node.local().occupancy();
+  return std::accumulate(occupancy.begin(), occupancy.end(), std::size_t{0});
+}
+
+// 等到 pred() 为真或超时
+template <typename Pred> bool eventually(Pred pred) {
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (!pred()) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("HashRing: balanced placement and minimal movement", "[cluster]") {
+  HashRing ring;
+  for (ClusterNodeId id = 0; id < 4; ++id) {
+    ring.add(id);
+  }
+  constexpr int kKeys = 100000;
+  std::vector<ClusterNodeId> before(kKeys);
+  std::map<ClusterNodeId, int> counts;
+  for (int k = 0; k < kKeys; ++k) {
+    before[k] = ring.ownerOf(mixHash(static_cast<std::uint64_t>(k)));
+    ++counts[before[k]];
+  }
+  REQUIRE(counts.size() == 4);
+  for (const auto &[id, count] : counts) {
+    REQUIRE(count > kKeys / 4 * 8 / 10);
+    REQUIRE(count < kKeys / 4 * 12 / 10);
+  }
+
+  // 加入第 5 个节点：移动的 key 都归到新节点，约占 1/5
+  ring.add(4);
+  int moved = 0;
+  for (int k = 0; k < kKeys; ++k) {
+    const ClusterNodeId owner =
+        ring.ownerOf(mixHash(static_cast<std::uint64_t>(k)));
+    if (owner != before[k]) {
+      REQUIRE(owner == 4);
+      ++moved;
+    }
+  }
+  REQUIRE(moved > kKeys / 5 * 7 / 10);
+  REQUIRE(moved < kKeys / 5 * 13 / 10);
+
+  ring.remove(4);
+  REQUIRE_FALSE(ring.contains(4));
+  for (int k = 0; k < kKeys; k += 97) {
+    REQUIRE(ring.ownerOf(mixHash(static_cast<std::uint64_t>(k))) == before[k]);
+  }
+}
+
+TEST_CASE("ClusterCache: every key lives on exactly one node", "[cluster]") {
+  auto nodes = makeCluster(3);
+  constexpr int kKeys = 600;
+  for (int k = 0; k < kKeys; ++k) {
+    nodes[static_cast<std::size_t>(k % 3)]->put(k, "v" + std::to_string(k));
+  }
+
+  std::size_t stored = 0;
+  for (auto &node : nodes) {
+    REQUIRE(localSize(*node) > 0);
+    stored += localSize(*node);
+  }
+  REQUIRE(stored == kKeys); // 没有副本
+
+  for (int k = 0; k < kKeys; ++k) {
+    std::string out;
+    Node &reader = *nodes[static_cast<std::size_t>((k + 1) % 3)];
+    REQUIRE(reader.get(k, out));
+    REQUIRE(out == "v" + std::to_string(k));
+    std::string direct;
+    REQUIRE(nodes[reader.ownerOf(k)]->local().get(k, direct));
+  }
+
+  nodes[0]->remove(7);
+  std::string out;
+  REQUIRE_FALSE(nodes[1]->get(7, out));
+  REQUIRE_FALSE(nodes[2]->get(7, out));
+}
+
+TEST_CASE("ClusterCache: getMany fetches a whole batch in one round trip",
+          "[cluster]") {
+  auto nodes = makeCluster(4);
+  std::vector<int> keys(1000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<std::string> values;
+  for (int k : keys) {
+    values.push_back(std::to_string(k * 3));
+  }
+
+  Node &client = *nodes[0];
+  ClusterStats before = client.stats();
+  client.putMany(keys, values);
+  ClusterStats after = client.stats();
+  REQUIRE(after.roundTrips - before.roundTrips == 1);
+  REQUIRE(after.remoteOps - before.remoteOps + after.localOps -
+              before.localOps ==
+          keys.size());
+
+  std::vector<std::string> out(keys.size());
+  std::unique_ptr<bool[]> found(new bool[keys.size()]);
+  before = client.stats();
+  REQUIRE(client.getMany(keys, out,
+                         std::span<bool>(found.get(), keys.size())) ==
+          keys.size());
+  after = client.stats();
+  REQUIRE(after.roundTrips - before.roundTrips == 1);
+  REQUIRE(out == values);
+
+  // 超过 maxBatch × pipelineDepth 的部分分轮发出
+  std::vector<int> many(20000);
+  std::iota(many.begin(), many.end(), 0);
+  std::vector<std::string> manyOut(many.size());
+  std::unique_ptr<bool[]> manyFound(new bool[many.size()]);
+  before = client.stats();
+  REQUIRE(client.getMany(many, manyOut,
+                         std::span<bool>(manyFound.get(), many.size())) ==
+          keys.size());
+  after = client.stats();
+  REQUIRE(after.roundTrips - before.roundTrips > 1);
+  REQUIRE(manyOut[999] == "2997");
+  REQUIRE_FALSE(manyFound[1000]);
+}
+
+TEST_CASE("ClusterCache: connections are pooled and reused", "[cluster]") {
+  auto nodes = makeCluster(2);
+  int remoteKey = 0;
+  while (nodes[0]->isLocal(remoteKey)) {
+    ++remoteKey;
+  }
+  nodes[0]->put(remoteKey, "x");
+  for (int i = 0; i < 200; ++i) {
+    REQUIRE(nodes[0]->get(remoteKey) == "x");
+  }
+  REQUIRE(nodes[0]->stats().connectionsOpened == 1);
+
+  // 并发请求各自占一个连接，空闲下来后回到池里继续复用
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 200; ++i) {
+        std::string out;
+        nodes[0]->get(remoteKey, out);
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  const std::uint64_t opened = nodes[0]->stats().connectionsOpened;
+  REQUIRE(opened <= 4);
+  for (int i = 0; i < 100; ++i) {
+    nodes[0]->get(remoteKey);
+  }
+  REQUIRE(nodes[0]->stats().connectionsOpened == opened);
+  REQUIRE(nodes[0]->stats().remoteErrors == 0);
+}
+
+TEST_CASE("ClusterCache: near cache serves repeats and is invalidated by "
+          "the owner",
+          "[cluster][near]") {
+  auto nodes = makeCluster(3);
+  Node &reader = *nodes[0];
+  REQUIRE(reader.enableNearCache(
+      std::make_unique<LruCache<int, NearEntry<std::string>>>(128)));
+  REQUIRE_FALSE(reader.enableNearCache(
+      std::make_unique<LruCache<int, NearEntry<std::string>>>(128)));
+
+  int key = 0;
+  while (reader.ownerOf(key) != 1) {
+    ++key;
+  }
+  nodes[2]->put(key, "v1");
+  REQUIRE(reader.get(key) == "v1");
+  const ClusterStats before = reader.stats();
+  REQUIRE(reader.get(key) == "v1"); // 近端命中，不走网络
+  REQUIRE(reader.stats().nearHits == before.nearHits + 1);
+  REQUIRE(reader.stats().roundTrips == before.roundTrips);
+
+  // 第三个节点改写：归属节点广播失效，读者随后读到新值
+  nodes[2]->put(key, "v2");
+  REQUIRE(eventually([&] { return reader.get(key) == "v2"; }));
+  REQUIRE(reader.stats().invalidationsReceived > 0);
+
+  // 自己写入之后马上能读到(不等广播)
+  REQUIRE(reader.get(key) == "v2");
+  reader.put(key, "v3");
+  REQUIRE(reader.get(key) == "v3");
+
+  nodes[1]->remove(key);
+  std::string out;
+  REQUIRE(eventually([&] { return !reader.get(key, out); }));
+}
+
+TEST_CASE("ClusterCache: in-flight invalidation discards the fetched value",
+          "[cluster][near]") {
+  NearCache<int, int> near(std::make_unique<LruCache<int, NearEntry<int>>>(16),
+                           TtlClock::duration::zero(), 8);
+  const std::uint64_t hash = mixHash(42);
+  const std::uint32_t stamp = near.stampOf(hash);
+  near.invalidate(hash); // 请求在途期间到达的失效
+  near.put(42, hash, 1, stamp);
+  int out = 0;
+  REQUIRE_FALSE(near.get(42, hash, out));
+
+  near.put(42, hash, 2, near.stampOf(hash));
+  REQUIRE(near.get(42, hash, out));
+  REQUIRE(out == 2);
+  near.invalidateAll();
+  REQUIRE_FALSE(near.get(42, hash, out));
+
+  NearCache<int, int> shortLived(
+      std::make_unique<LruCache<int, NearEntry<int>>>(16),
+      std::chrono::milliseconds(1));
+  shortLived.put(1, mixHash(1), 1, shortLived.stampOf(mixHash(1)));
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  REQUIRE_FALSE(shortLived.get(1, mixHash(1), out));
+}
+
+TEST_CASE("ClusterCache: a dead peer reads as a miss and can be removed",
+          "[cluster]") {
+  auto nodes = makeCluster(3);
+  int key = 0;
+  while (nodes[0]->ownerOf(key) != 2) {
+    ++key;
+  }
+  nodes[0]->put(key, "gone");
+  REQUIRE(nodes[0]->get(key) == "gone");
+
+  nodes[2].reset(); // 节点 2 下线，成员列表还没更新
+  std::string out;
+  REQUIRE_FALSE(nodes[0]->get(key, out));
+  nodes[0]->put(key, "dropped");
+  REQUIRE(nodes[0]->stats().remoteErrors >= 2);
+
+  for (int i = 0; i < 2; ++i) {
+    nodes[static_cast<std::size_t>(i)]->removePeer(2);
+  }
+  REQUIRE(nodes[0]->nodeCount() == 2);
+  REQUIRE(nodes[0]->ownerOf(key) != 2);
+  nodes[0]->put(key, "moved");
+  REQUIRE(nodes[1]->get(key) == "moved");
+}
+
+TEST_CASE("ClusterCache: LFU shards as the local store, with ttl",
+          "[cluster]") {
+  using LfuNode = ClusterCache<int, int, KHashLfuCache<int, int>>;
+  LfuNode a(nodeOptions(0), 1024, 4);
+  LfuNode b(nodeOptions(1), 1024, 4);
+  REQUIRE(a.ok());
+  REQUIRE(b.ok());
+  a.addPeer(ClusterPeer{1, "127.0.0.1", b.port()});
+  b.addPeer(ClusterPeer{0, "127.0.0.1", a.port()});
+
+  int remote = 0;
+  while (a.isLocal(remote)) {
+    ++remote;
+  }
+  a.put(remote, 7);
+  REQUIRE(b.local().get(remote) == 7);
+  REQUIRE(a.get(remote) == 7);
+  a.remove(remote);
+  int out = 0;
+  REQUIRE_FALSE(b.local().get(remote, out));
+
+  a.put(remote, 8, std::chrono::milliseconds(20));
+  REQUIRE(a.get(remote, out));
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  REQUIRE_FALSE(a.get(remote, out));
+}
@@ -0,0 +1,183 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "FlatIndex.h"
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "NodeSlab.h"
+#include "arc/ArcCache.h"
+
+namespace {
+
+// 测试用的结点存储：下标 -> key，模拟缓存里的 NodeSlab
+struct Keys {
+  std::vector<std::string> keys;
+  FlatIndex<std::string> index;
+
+  void insert(std::string key) {
+    const auto i = static_cast<std::uint32_t>(keys.size());
+    keys.push_back(std::move(key));
+    index.insert(index.hashOf(keys[i]), i,
+                 [this](std::uint32_t j) { return index.hashOf(keys[j]); });
+  }
+
+  template <typename K> std::uint32_t find(const K &key) const {
+    return index.find(key, index.hashOf(key),
+                      [this](std::uint32_t j) -> const std::string & {
+                        return keys[j];
+                      });
+  }
+
+  void erase(std::uint32_t i) { index.erase(index.hashOf(keys[i]), i); }
+};
+
+constexpr auto kNil = FlatIndex<std::string>::kNil;
+
+} // namespace
+
+TEST_CASE("FlatIndex: insert/find/erase across growth", "[flat_index]") {
+  Keys t;
+  REQUIRE(t.find(std::string("missing")) == kNil);
+
+  constexpr int N = 5000; // 从 0 组开始，经历多次扩容
+  for (int k = 0; k < N; ++k) {
+    t.insert("key" + std::to_string(k));
+  }
+  REQUIRE(t.index.size() == N);
+  REQUIRE(t.index.slotCount() * 7 / 8 >= t.index.size()); // 负载不超过 7/8
+
+  for (int k = 0; k < N; ++k) {
+    REQUIRE(t.find("key" + std::to_string(k)) == static_cast<std::uint32_t>(k));
+  }
+  REQUIRE(t.find(std::string("key-1")) == kNil);
+
+  // 删掉偶数下标，奇数仍能找到(已删除槽位不打断探测链)
+  for (int k = 0; k < N; k += 2) {
+    t.erase(static_cast<std::uint32_t>(k));
+  }
+  REQUIRE(t.index.size() == N / 2);
+  for (int k = 0; k < N; ++k) {
+    const std::uint32_t expect = (k % 2) ? static_cast<std::uint32_t>(k) : kNil;
+    REQUIRE(t.find("key" + std::to_string(k)) == expect);
+  }
+}
+
+TEST_CASE("FlatIndex: heterogeneous lookup with string_view",
+          "[flat_index]") {
+  Keys t;
+  t.insert("alpha");
+  t.insert("beta");
+
+  REQUIRE(t.find(std::string_view("alpha")) == 0);
+  REQUIRE(t.find(std::string_view("beta")) == 1);
+  REQUIRE(t.find(std::string_view("gamma")) == kNil);
+}
+
+TEST_CASE("FlatIndex: churn with tombstones keeps the table bounded",
+          "[flat_index]") {
+  // 容量固定的缓存式负载：不断插入新 key、删除最旧的 key，
+  // 已删除槽位会被原地重建回收，槽位数不会无限增长
+  Keys t;
+  constexpr int LIVE = 1000;
+  for (int k = 0; k < LIVE; ++k) {
+    t.insert(std::to_string(k));
+  }
+  const std::size_t slots = t.index.slotCount();
+
+  for (int k = LIVE; k < LIVE * 50; ++k) {
+    t.erase(static_cast<std::uint32_t>(k - LIVE));
+    t.insert(std::to_string(k));
+  }
+  REQUIRE(t.index.size() == LIVE);
+  REQUIRE(t.index.slotCount() <= slots * 2);
+  for (int k = LIVE * 49; k < LIVE * 50; ++k) {
+    REQUIRE(t.find(std::to_string(k)) == static_cast<std::uint32_t>(k));
+  }
+  REQUIRE(t.find(std::to_string(0)) == kNil);
+}
+
+TEST_CASE("FlatIndex: replace and forEach", "[flat_index]") {
+  Keys t;
+  t.insert("a");
+  t.insert("b");
+  t.keys.push_back("a"); // 把 "a" 搬到下标 2
+  t.index.replace(t.index.hashOf(std::string("a")), 0, 2);
+  REQUIRE(t.find(std::string("a")) == 2);
+
+  std::vector<std::uint32_t> seen;
+  t.index.forEach([&](std::uint32_t i) { seen.push_back(i); });
+  std::sort(seen.begin(), seen.end());
+  REQUIRE(seen == std::vector<std::uint32_t>{1, 2});
+
+  t.index.clear();
+  REQUIRE(t.index.empty());
+  REQUIRE(t.find(std::string("b")) == kNil);
+}
+
+TEST_CASE("NodeSlab: indices are reused and addresses stay stable",
+          "[flat_index]") {
+  NodeSlab<std::string> slab;
+  std::vector<std::uint32_t> ids;
+  for (int k = 0; k < 3000; ++k) { // 跨越多个块
+    ids.push_back(slab.create(std::to_string(k)));
+  }
+  const std::string *first = &slab[ids[0]];
+
+  slab.destroy(ids[5]);
+  REQUIRE(slab.size() == 2999);
+  REQUIRE(slab.create("reused") == ids[5]);
+  REQUIRE(&slab[ids[0]] == first); // 追加新块不移动已有结点
+  REQUIRE(slab[ids[2999]] == "2999");
+
+  const std::size_t bytes = slab.memoryBytes();
+  slab.clear(); // 析构剩余结点并释放所有块
+  REQUIRE(slab.size() == 0);
+  REQUIRE(slab.memoryBytes() < bytes / 10);
+}
+
+TEST_CASE("Flat index: all policies agree with a reference map",
+          "[flat_index]") {
+  // 容量大于 key 空间，不发生淘汰：每个策略的内容都应与参照 map 一致
+  constexpr int KEYS = 2000;
+  LruCache<int, int> lru(KEYS);
+  LfuCache<int, int> lfu(KEYS);
+  ArcCache<int, int> arc(KEYS);
+  std::unordered_map<int, int> ref;
+
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<int> key(0, KEYS - 1);
+  for (int i = 0; i < 20000; ++i) {
+    const int k = key(gen);
+    if (i % 7 == 0) {
+      lru.remove(k);
+      ref.erase(k);
+      continue;
+    }
+    lru.put(k, i);
+    lfu.put(k, i);
+    arc.put(k, i);
+    ref[k] = i;
+  }
+
+  for (const auto &[k, v] : ref) {
+    REQUIRE(lru.get(k) == v);
+  }
+  REQUIRE(lru.size() == ref.size());
+
+  int out = 0;
+  for (int k = 0; k < KEYS; ++k) {
+    if (lfu.get(k, out)) {
+      REQUIRE(arc.get(k) == out);
+    }
+  }
+  REQUIRE(lru.memoryBytes() > 0);
+  REQUIRE(lfu.memoryBytes() > 0);
+  REQUIRE(arc.memoryBytes() > 0);
+}
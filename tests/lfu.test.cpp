@@ -2,8 +2,12 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <atomic>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 #include "LfuCache.h"
 
@@ -113,8 +117,9 @@ TEST_CASE("LFU: purge clears all entries", "[lfu]") {
 }
 
 TEST_CASE("KHashLFU: basic put/get works across slices", "[khashlfu]") {
-  // sliceNum=2，容量总 10（每片 ceil(10/2)=5）
-  KHashLfuCache<int, std::string> cache(/*capacity*/ 10, /*sliceNum*/ 2,
+  // sliceNum=2，容量总 16（每片 ceil(16/2)=8）
+  // 分片由混合哈希决定，不再是 key%2 的均分，每片需能放下全部 8 个 key
+  KHashLfuCache<int, std::string> cache(/*capacity*/ 16, /*sliceNum*/ 2,
                                         /*maxAverageNum*/ 1000);
 
   for (int i = 1; i <= 8; ++i) {
@@ -163,3 +168,143 @@ TEST_CASE("LFU: concurrent smoke test (no crash, values readable)",
   bool ok = cache.get(0, v) || cache.get(1, v) || cache.get(2, v);
   REQUIRE(ok);
 }
+
+TEST_CASE("LFU: getMany counts as one access per key", "[lfu][batch]") {
+  LfuCache<int, int> cache(2);
+  const std::vector<int> keys = {1, 2};
+  const std::vector<int> values = {10, 20};
+  cache.putMany(keys, values);
+
+  // 批量命中 1 两次，频次变高；随后插入 3 时应淘汰 2
+  const std::vector<int> probe = {1, 1};
+  std::vector<int> out(probe.size(), 0);
+  bool found[2] = {false, false};
+  REQUIRE(cache.getMany(probe, out, found) == 2);
+  REQUIRE(out[0] == 10);
+  REQUIRE(out[1] == 10);
+
+  cache.put(3, 30);
+  int v = 0;
+  REQUIRE(cache.get(1, v));
+  REQUIRE_FALSE(cache.get(2, v));
+}
+
+TEST_CASE("KHashLFU: putMany/getMany across slices", "[khashlfu][batch]") {
+  KHashLfuCache<int, int> cache(/*capacity*/ 64, /*sliceNum*/ 4);
+  std::vector<int> keys;
+  std::vector<int> values;
+  for (int k = 0; k < 32; ++k) {
+    keys.push_back(k);
+    values.push_back(k * 3);
+  }
+  cache.putMany(keys, values);
+
+  std::vector<int> out(keys.size(), -1);
+  std::unique_ptr<bool[]> found(new bool[keys.size()]);
+  REQUIRE(cache.getMany(keys, out,
+                        std::span<bool>(found.get(), keys.size())) ==
+          keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(out[i] == keys[i] * 3);
+  }
+}
+
+TEST_CASE("LFU: withValue visits the stored value and bumps frequency",
+          "[lfu][zero-copy]") {
+  LfuCache<int, std::string> cache(2);
+  cache.put(1, std::string(4096, 'a'));
+  cache.put(2, "b");
+
+  const std::string *addr = nullptr;
+  REQUIRE(cache.withValue(1, [&](const std::string &v) { addr = &v; }));
+  // 两次访问拿到的是同一个对象，没有拷贝
+  const std::string *again = nullptr;
+  REQUIRE(cache.withValue(1, [&](const std::string &v) { again = &v; }));
+  REQUIRE(addr == again);
+  REQUIRE(addr->size() == 4096);
+
+  cache.put(3, "c"); // 1 的频次更高，淘汰 2
+  std::string out;
+  REQUIRE(cache.get(1, out));
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE_FALSE(cache.withValue(2, [](const std::string &) {}));
+}
+
+TEST_CASE("LFU: emplace, rvalue put and string_view lookup",
+          "[lfu][move][heterogeneous]") {
+  LfuCache<std::string, std::string> cache(4);
+  std::string big(1024, 'x');
+  const char *data = big.data();
+
+  cache.put(std::string("k1"), std::move(big));
+  cache.emplace("k2", 3, 'y');
+
+  // 移动进来的 value 仍然是原来的缓冲区
+  const char *stored = nullptr;
+  REQUIRE(cache.withValue(std::string_view("k1"),
+                          [&](const std::string &v) { stored = v.data(); }));
+  REQUIRE(stored == data);
+
+  std::string out;
+  REQUIRE(cache.get(std::string_view("k2"), out));
+  REQUIRE(out == "yyy");
+  REQUIRE_FALSE(cache.get("missing", out));
+}
+
+TEST_CASE("LFU: aging lets a new hot key outlive an old one", "[lfu][aging]") {
+  int out = 0;
+
+  // 不老化：访问 31 次的 key 1 保留，淘汰 key 2
+  LfuCache<int, int> plain(2);
+  plain.put(1, 1);
+  for (int i = 0; i < 30; ++i) {
+    plain.get(1, out);
+  }
+  plain.put(2, 2);
+  for (int i = 0; i < 6; ++i) {
+    plain.get(2, out);
+  }
+  plain.put(3, 3);
+  REQUIRE(plain.get(1, out));
+  REQUIRE_FALSE(plain.get(2, out));
+
+  // 平均频次上限为 4：key 1 的历史频次被衰减掉，反而是它被淘汰
+  LfuCache<int, int> aging(2, 4);
+  aging.put(1, 1);
+  for (int i = 0; i < 30; ++i) {
+    aging.get(1, out);
+  }
+  aging.put(2, 2);
+  for (int i = 0; i < 6; ++i) {
+    aging.get(2, out);
+  }
+  aging.put(3, 3);
+  REQUIRE_FALSE(aging.get(1, out));
+  REQUIRE(aging.get(2, out));
+  REQUIRE(aging.get(3, out));
+}
+
+TEST_CASE("LFU: frequent aging keeps the hot set resident", "[lfu][aging]") {
+  LfuCache<int, int> cache(64, 3);
+  int out = 0;
+
+  // 热点 0..31 每轮访问两次，冷 key 只出现一次；老化频繁触发
+  for (int round = 0; round < 200; ++round) {
+    for (int pass = 0; pass < 2; ++pass) {
+      for (int key = 0; key < 32; ++key) {
+        if (!cache.get(key, out))
+          cache.put(key, key);
+      }
+    }
+    for (int i = 0; i < 64; ++i) {
+      cache.put(10000 + round * 64 + i, i);
+    }
+    REQUIRE(cache.size() <= 64);
+  }
+
+  int resident = 0;
+  for (int key = 0; key < 32; ++key) {
+    resident += cache.get(key, out) ? 1 : 0;
+  }
+  REQUIRE(resident == 32);
+}
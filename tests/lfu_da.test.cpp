@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <string>
+
+#include "LfuDaCache.h"
+
+namespace {
+
+// 按 value 长度计权重
+struct LengthWeigher {
+  std::size_t operator()(const int &, const std::string &value) const {
+    return value.size();
+  }
+};
+
+} // namespace
+
+TEST_CASE("LfuDaCache: evicts the lowest priority and raises L",
+          "[lfu_da]") {
+  LfuDaCache<int, int> cache(3);
+  cache.put(1, 10);
+  cache.put(2, 20);
+  cache.put(3, 30);
+  cache.get(1);
+  cache.get(1);
+  cache.get(3);
+  REQUIRE(cache.inflation() == 0);
+
+  cache.put(4, 40); // 2 的 K = 1 最小
+  int out = 0;
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.inflation() == 1);
+
+  std::uint32_t freq = 0;
+  std::uint64_t priority = 0;
+  REQUIRE(cache.inspect(4, freq, priority));
+  REQUIRE(freq == 1);
+  REQUIRE(priority == 2); // 新条目以当前的 L 起步
+  REQUIRE(cache.inspect(1, freq, priority));
+  REQUIRE(freq == 3);
+  REQUIRE(priority == 3);
+
+  REQUIRE(cache.get(1) == 10);
+  REQUIRE(cache.get(3) == 30);
+  REQUIRE(cache.get(4) == 40);
+}
+
+TEST_CASE("LfuDaCache: a formerly popular key ages out", "[lfu_da]") {
+  LfuDaCache<int, int> cache(2);
+  cache.put(0, 0);
+  for (int i = 0; i < 10; ++i) {
+    cache.get(0); // K = 11
+  }
+
+  // 后来的 key 各访问几次；每次淘汰都把 L 抬高，新 key 的起点随之升高
+  // (用 inspect 检查，不算一次访问)
+  int out = 0;
+  int rounds = 0;
+  std::uint32_t freq = 0;
+  std::uint64_t priority = 0;
+  for (int key = 1; key < 100 && cache.inspect(0, freq, priority); ++key) {
+    cache.put(key, key);
+    for (int j = 0; j < 3; ++j) {
+      cache.get(key, out);
+    }
+    ++rounds;
+  }
+  REQUIRE_FALSE(cache.get(0, out)); // 普通 LFU 里它会一直占着位置
+  REQUIRE(rounds < 20);
+  REQUIRE(cache.size() == 2);
+}
+
+TEST_CASE("LfuDaCache: frequencies well above 127 stay ordered",
+          "[lfu_da]") {
+  LfuDaCache<int, int> cache(2);
+  cache.put(1, 1);
+  cache.put(2, 2);
+  for (int i = 0; i < 1000; ++i) {
+    cache.get(1);
+  }
+  for (int i = 0; i < 500; ++i) {
+    cache.get(2);
+  }
+
+  std::uint32_t freq = 0;
+  std::uint64_t priority = 0;
+  REQUIRE(cache.inspect(1, freq, priority));
+  REQUIRE(freq == 1001);
+
+  cache.put(3, 3); // 淘汰频次较低的 2
+  int out = 0;
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.get(1, out));
+  REQUIRE(cache.inflation() == 501);
+}
+
+TEST_CASE("LfuDaCache: GDSF prefers small entries under a weight budget",
+          "[lfu_da][weigher]") {
+  LfuDaCache<int, std::string, NullStats, LengthWeigher> cache(100);
+  cache.put(1, std::string(60, 'a')); // K = 1/60
+  cache.put(2, std::string(20, 'b')); // K = 1/20
+  cache.put(3, std::string(20, 'c'));
+  REQUIRE(cache.totalWeight() == 100);
+
+  cache.put(4, std::string(10, 'd')); // 先淘汰大而冷的 1
+  std::string out;
+  REQUIRE_FALSE(cache.get(1, out));
+  REQUIRE(cache.totalWeight() == 50);
+  REQUIRE(cache.inflation() > 0.0);
+
+  // 覆盖写入时按新的权重记账，放不下就淘汰别的条目
+  cache.put(2, std::string(80, 'B'));
+  REQUIRE(cache.totalWeight() <= 100);
+  REQUIRE(cache.get(2, out));
+  REQUIRE(out.size() == 80);
+
+  cache.put(5, std::string(200, 'x')); // 超过整个容量，不写入
+  REQUIRE_FALSE(cache.get(5, out));
+}
+
+TEST_CASE("LfuDaCache: remove and stats", "[lfu_da][stats]") {
+  LfuDaCache<int, int, AtomicStats> cache(2);
+  cache.put(1, 1);
+  cache.put(2, 2);
+  cache.remove(1);
+  cache.put(3, 3); // 删除腾出了位置，不淘汰
+  int out = 0;
+  REQUIRE_FALSE(cache.get(1, out));
+  REQUIRE(cache.get(2, out));
+  REQUIRE(cache.get(3, out));
+
+  const CacheStats stats = cache.stats();
+  REQUIRE(stats.inserts == 3);
+  REQUIRE(stats.evictions == 0);
+  REQUIRE(stats.hits == 2);
+  REQUIRE(stats.misses == 1);
+  REQUIRE(cache.inflation() == 0);
+}
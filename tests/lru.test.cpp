@@ -1,7 +1,15 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <random>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "LruCache.h"
 
@@ -125,26 +133,27 @@ TEST_CASE("LRU: random workload smoke test", "[lru][smoke]") {
   REQUIRE(hits > 0);
 }
 
-TEST_CASE("LRU-K: put does not immediately enter main cache, get promotes at k",
+TEST_CASE("LRU-K: put does not immediately enter main cache, k-th access admits",
           "[lruk]") {
   // main cap=2, history cap=10, k=2
   LruKCache<int, std::string> cache(2, 10, 2);
 
-  cache.put(1, "a");
+  cache.put(1, "a"); // 第 1 次访问：只记入历史，value 不保留
+  REQUIRE(cache.get(1).empty());
+  REQUIRE(cache.size() == 0);
 
-  // 第一次 get：historyCount 从 1->2 达到 k，且有 historyValueMap 值 =>
-  // 直接提升并返回
+  // get 未命中也算一次访问，之后的 put 达到 k 次，写入主缓存
+  cache.put(1, "a");
   REQUIRE(cache.get(1) == "a");
-
-  // 已在主缓存，后续 get 仍是 a
   REQUIRE(cache.get(1) == "a");
+  REQUIRE(cache.historySize() == 0); // 准入后历史清掉
 }
 
 TEST_CASE("LRU-K: key never put cannot be promoted (returns default value)",
           "[lruk]") {
   LruKCache<int, std::string> cache(2, 10, 2);
 
-  // 从没 put 过 => historyValueMap 没值
+  // 只有访问次数，没有 value
   REQUIRE(cache.get(42).empty());
   REQUIRE(cache.get(42).empty()); // 即使次数够了也无法提升
 }
@@ -155,16 +164,52 @@ TEST_CASE("LRU-K: promotion triggers main cache eviction by LRU order",
   LruKCache<int, std::string> cache(1, 10, 2);
 
   cache.put(1, "a");
-  REQUIRE(cache.get(1) == "a"); // 提升 1 进入主缓存（k=2）
+  cache.put(1, "a"); // 第 2 次访问，1 进入主缓存（k=2）
+  REQUIRE(cache.get(1) == "a");
 
   cache.put(2, "b");
-  REQUIRE(cache.get(2) == "b"); // 提升 2，会挤掉主缓存里的 1（cap=1）
+  cache.put(2, "b"); // 提升 2，会挤掉主缓存里的 1（cap=1）
 
-  // 1 被挤出主缓存；并且 1 在提升时 historyValueMap 已删除，无法再恢复值
+  // 1 被挤出主缓存，要重新累计访问次数
   REQUIRE(cache.get(1).empty());
   REQUIRE(cache.get(2) == "b");
 }
 
+TEST_CASE("LRU-K: history is bounded and keeps no values", "[lruk]") {
+  LruKCache<int, std::string> cache(4, 8, 3);
+  for (int k = 0; k < 1000; ++k) {
+    cache.put(k, std::string(256, 'x'));
+  }
+  REQUIRE(cache.size() == 0);
+  REQUIRE(cache.historySize() == 8);
+
+  // 被挤出历史的 key 从头计数；仍在历史里的 key 再访问两次就准入
+  cache.put(0, "zero");
+  cache.put(0, "zero");
+  REQUIRE(cache.get(0).empty());
+  cache.put(999, "last");
+  cache.put(999, "last");
+  REQUIRE(cache.get(999) == "last");
+}
+
+TEST_CASE("Sharded LRU-K: admits per shard and aggregates history",
+          "[lruk][sharded-lru]") {
+  KHashLruKCache<int, int, std::hash<int>, AtomicStats> cache(64, 128, 2, 4);
+  REQUIRE(cache.sliceNum() == 4);
+  for (int k = 0; k < 32; ++k) {
+    cache.put(k, k);
+  }
+  REQUIRE(cache.historySize() == 32);
+  for (int k = 0; k < 32; ++k) {
+    cache.put(k, k * 10);
+  }
+  REQUIRE(cache.historySize() == 0);
+  for (int k = 0; k < 32; ++k) {
+    REQUIRE(cache.get(k) == k * 10);
+  }
+  REQUIRE(cache.stats().promotions == 32);
+}
+
 TEST_CASE("Sharded LRU: basic put/get works", "[sharded-lru]") {
   KHashLruCaches<int, std::string> cache(/*capacity*/ 4, /*sliceNum*/ 2);
 
@@ -203,3 +248,325 @@ TEST_CASE("Sharded LRU: eviction happens within shard (sliceNum=1)",
   REQUIRE(cache.get(3, out));
   REQUIRE(out == "c");
 }
+
+TEST_CASE("Sharded LRU: slice count rounds up to a power of two",
+          "[sharded-lru]") {
+  KHashLruCaches<int, int> cache(/*capacity*/ 60, /*sliceNum*/ 3);
+  REQUIRE(cache.sliceNum() == 4);
+  REQUIRE(cache.occupancy().size() == 4);
+}
+
+TEST_CASE("Sharded LRU: sequential integer keys spread evenly over slices",
+          "[sharded-lru]") {
+  constexpr int SLICES = 16;
+  constexpr int KEYS = 16000;
+  // 容量足够大、不触发淘汰，只看分布
+  KHashLruCaches<int, int> cache(/*capacity*/ KEYS * 2, SLICES);
+
+  for (int k = 0; k < KEYS; ++k) {
+    cache.put(k * SLICES, k); // 步长等于分片数，取模分片时会全部挤进同一片
+  }
+
+  const auto sizes = cache.occupancy();
+  const auto [minIt, maxIt] = std::minmax_element(sizes.begin(), sizes.end());
+  const int expected = KEYS / SLICES;
+  REQUIRE(*minIt > expected * 8 / 10);
+  REQUIRE(*maxIt < expected * 12 / 10);
+}
+
+namespace {
+// 把所有 key 都映射到同一个哈希值
+struct ConstantHash {
+  std::size_t operator()(int) const { return 42; }
+};
+} // namespace
+
+TEST_CASE("Sharded LRU: user-supplied hasher decides the slice",
+          "[sharded-lru]") {
+  KHashLruCaches<int, int, ConstantHash> cache(/*capacity*/ 64, 4);
+  for (int k = 0; k < 8; ++k) {
+    cache.put(k, k);
+  }
+
+  const auto sizes = cache.occupancy();
+  REQUIRE(std::count(sizes.begin(), sizes.end(), 8u) == 1);
+  REQUIRE(std::count(sizes.begin(), sizes.end(), 0u) == 3);
+}
+
+TEST_CASE("LRU: getMany/putMany match single-key calls", "[lru][batch]") {
+  LruCache<int, int> batch(4);
+  LruCache<int, int> single(4);
+
+  const std::vector<int> keys = {1, 2, 3, 4, 5, 2};
+  const std::vector<int> values = {10, 20, 30, 40, 50, 21};
+  batch.putMany(keys, values);
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    single.put(keys[i], values[i]);
+  }
+
+  // 查询里有命中、有未命中(1 已被淘汰)，也有重复 key
+  const std::vector<int> probe = {1, 2, 3, 9, 5, 2};
+  std::vector<int> out(probe.size(), -1);
+  std::unique_ptr<bool[]> found(new bool[probe.size()]);
+  const std::size_t hits = batch.getMany(
+      probe, out, std::span<bool>(found.get(), probe.size()));
+
+  std::size_t expectedHits = 0;
+  for (std::size_t i = 0; i < probe.size(); ++i) {
+    int v = -1;
+    const bool hit = single.get(probe[i], v);
+    expectedHits += hit ? 1 : 0;
+    REQUIRE(found[i] == hit);
+    if (hit)
+      REQUIRE(out[i] == v);
+  }
+  REQUIRE(hits == expectedHits);
+
+  // 批量访问同样刷新了 LRU 顺序：两边后续淘汰结果一致
+  batch.put(100, 100);
+  single.put(100, 100);
+  for (int k : {2, 3, 4, 5, 100}) {
+    int a = -1, b = -1;
+    REQUIRE(batch.get(k, a) == single.get(k, b));
+    REQUIRE(a == b);
+  }
+}
+
+TEST_CASE("Sharded LRU: getMany groups keys by slice and keeps positions",
+          "[sharded-lru][batch]") {
+  KHashLruCaches<int, int> cache(/*capacity*/ 256, /*sliceNum*/ 8);
+
+  std::vector<int> keys;
+  std::vector<int> values;
+  for (int k = 0; k < 100; ++k) {
+    keys.push_back(k * 7);
+    values.push_back(k);
+  }
+  cache.putMany(keys, values);
+
+  // 逆序查询，再混入不存在的 key，结果仍按输入下标回填
+  std::vector<int> probe(keys.rbegin(), keys.rend());
+  probe.push_back(-1);
+  std::vector<int> out(probe.size(), -1);
+  std::unique_ptr<bool[]> found(new bool[probe.size()]);
+  const std::size_t hits =
+      cache.getMany(probe, out, std::span<bool>(found.get(), probe.size()));
+
+  REQUIRE(hits == keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(found[i]);
+    REQUIRE(out[i] == probe[i] / 7);
+  }
+  REQUIRE_FALSE(found[probe.size() - 1]);
+}
+
+namespace {
+// 记录被拷贝了多少次的 value 类型
+struct CopyCounter {
+  static inline int copies = 0;
+  int payload = 0;
+
+  CopyCounter() = default;
+  explicit CopyCounter(int p) : payload(p) {}
+  CopyCounter(const CopyCounter &other) : payload(other.payload) { ++copies; }
+  CopyCounter &operator=(const CopyCounter &other) {
+    payload = other.payload;
+    ++copies;
+    return *this;
+  }
+  CopyCounter(CopyCounter &&) noexcept = default;
+  CopyCounter &operator=(CopyCounter &&) noexcept = default;
+};
+} // namespace
+
+TEST_CASE("LRU: withValue reads in place and refreshes recency",
+          "[lru][zero-copy]") {
+  LruCache<int, CopyCounter> cache(2);
+  cache.put(1, CopyCounter(10));
+  cache.put(2, CopyCounter(20));
+
+  CopyCounter::copies = 0;
+  int seen = 0;
+  REQUIRE(cache.withValue(1, [&](const CopyCounter &v) { seen = v.payload; }));
+  REQUIRE(seen == 10);
+  REQUIRE(CopyCounter::copies == 0);
+
+  bool called = false;
+  REQUIRE_FALSE(cache.withValue(3, [&](const CopyCounter &) { called = true; }));
+  REQUIRE_FALSE(called);
+
+  // withValue 算一次访问：1 变成最近使用，插入 3 时淘汰 2
+  cache.put(3, CopyCounter(30));
+  CopyCounter out;
+  REQUIRE(cache.get(1, out));
+  REQUIRE_FALSE(cache.get(2, out));
+}
+
+TEST_CASE("LRU: rvalue put and emplace do not copy the value",
+          "[lru][move]") {
+  LruCache<int, CopyCounter> cache(2);
+  CopyCounter::copies = 0;
+
+  cache.put(1, CopyCounter(10));
+  cache.emplace(2, 20);
+  cache.emplace(2, 21); // 已存在：原地覆盖
+  REQUIRE(CopyCounter::copies == 0);
+
+  int seen = 0;
+  REQUIRE(cache.withValue(2, [&](const CopyCounter &v) { seen = v.payload; }));
+  REQUIRE(seen == 21);
+}
+
+TEST_CASE("LRU: string keys can be looked up by string_view",
+          "[lru][heterogeneous]") {
+  LruCache<std::string, int> cache(4);
+  cache.put(std::string("alpha"), 1);
+  cache.emplace("beta", 2);
+
+  const std::string_view alpha = "alpha";
+  int out = 0;
+  REQUIRE(cache.get(alpha, out));
+  REQUIRE(out == 1);
+  REQUIRE(cache.get("beta", out));
+  REQUIRE(out == 2);
+  REQUIRE_FALSE(cache.get(std::string_view("gamma"), out));
+  REQUIRE(cache.withValue(alpha, [&](int v) { out = v * 10; }));
+  REQUIRE(out == 10);
+}
+
+TEST_CASE("LRU-K: rvalue put moves through history into the main cache",
+          "[lruk][move]") {
+  LruKCache<int, CopyCounter> cache(/*capacity*/ 2, /*historyCapacity*/ 8,
+                                    /*k*/ 2);
+  CopyCounter::copies = 0;
+
+  cache.put(1, CopyCounter(10)); // 第一次：只进历史
+  cache.put(1, CopyCounter(11)); // 第二次：达到 k，直接移入主缓存
+  REQUIRE(CopyCounter::copies == 0);
+  REQUIRE(cache.get(1).payload == 11);
+}
+
+TEST_CASE("LRU-K: emplace goes through admission like put", "[lruk][move]") {
+  LruKCache<int, CopyCounter> cache(2, 8, 3);
+  cache.emplace(1, 10); // 第 1 次访问：只进历史，不构造 value
+  REQUIRE(cache.size() == 0);
+  REQUIRE(cache.historySize() == 1);
+  cache.emplace(1, 11);
+  REQUIRE(cache.size() == 0);
+
+  CopyCounter::copies = 0;
+  cache.emplace(1, 12); // 第 3 次：准入
+  REQUIRE(cache.size() == 1);
+  REQUIRE(CopyCounter::copies == 0);
+  REQUIRE(cache.get(1).payload == 12);
+  cache.emplace(1, 13); // 已在主缓存：原地覆盖
+  REQUIRE(cache.get(1).payload == 13);
+}
+
+TEST_CASE("LRU-K: heterogeneous lookups count toward admission",
+          "[lruk][heterogeneous]") {
+  LruKCache<std::string, int> cache(4, 8, 3);
+  int out = 0;
+  REQUIRE_FALSE(cache.get(std::string_view("alpha"), out)); // 第 1 次
+  REQUIRE_FALSE(cache.withValue(std::string_view("alpha"),
+                                [&](int v) { out = v; })); // 第 2 次
+  REQUIRE(cache.historySize() == 1);
+  cache.put("alpha", 1); // 第 3 次：准入
+  REQUIRE(cache.get(std::string_view("alpha"), out));
+  REQUIRE(out == 1);
+  REQUIRE(cache.withValue("alpha", [&](int v) { out = v * 10; }));
+  REQUIRE(out == 10);
+  REQUIRE(cache.historySize() == 0);
+}
+
+TEST_CASE("LRU-K: bulkLoad and bulkLoadAt go through admission", "[lruk][bulk]") {
+  LruKCache<int, int> cache(8, 16, 2);
+  const std::vector<std::pair<int, int>> items{{1, 10}, {2, 20}, {3, 30}};
+  cache.bulkLoad(items); // 第 1 次：只进历史
+  REQUIRE(cache.size() == 0);
+  REQUIRE(cache.historySize() == 3);
+  cache.bulkLoad(items); // 第 2 次：准入
+  REQUIRE(cache.size() == 3);
+  REQUIRE(cache.get(2) == 20);
+
+  const std::vector<std::pair<int, int>> more{{4, 40}, {5, 50}, {6, 60}};
+  const std::vector<std::uint32_t> positions{0, 2};
+  cache.bulkLoadAt(more, positions);
+  REQUIRE(cache.size() == 3);
+  cache.bulkLoadAt(more, positions);
+  REQUIRE(cache.size() == 5);
+  int out = 0;
+  REQUIRE(cache.get(6, out));
+  REQUIRE(out == 60);
+  REQUIRE_FALSE(cache.get(5, out));
+}
+
+TEST_CASE("LRU-K: ttl writes go through admission", "[lruk][ttl]") {
+  using namespace std::chrono_literals;
+  LruKCache<int, int> cache(4, 8, 3);
+  cache.put(1, 10, 1h);
+  cache.put(1, 11, 1h);
+  REQUIRE(cache.size() == 0);
+  cache.put(1, 12, 1h); // 第 3 次：准入，并带上过期时间
+  REQUIRE(cache.size() == 1);
+
+  int out = 0;
+  TtlClock::duration ttl{};
+  REQUIRE(cache.get(1, out, ttl));
+  REQUIRE(out == 12);
+  REQUIRE(ttl > 0s);
+}
+
+TEST_CASE("LRU-K: getOrLoad and getOrLoadAsync go through admission",
+          "[lruk][single_flight]") {
+  using namespace std::chrono_literals;
+  LruKCache<int, int> cache(4, 8, 3);
+  int calls = 0;
+  auto loader = [&calls](const int &key, int &v) {
+    ++calls;
+    v = key * 10;
+    return true;
+  };
+  const LoadOptions options{1h, {}};
+
+  // 未命中和写回各记一次访问：第一次加载后只在历史里
+  REQUIRE(cache.getOrLoad(1, loader, options) == 10);
+  REQUIRE(cache.size() == 0);
+  REQUIRE(cache.getOrLoad(1, loader, options) == 10); // 第 3、4 次：准入
+  REQUIRE(cache.size() == 1);
+  REQUIRE(calls == 2);
+  int out = 0;
+  TtlClock::duration ttl{};
+  REQUIRE(cache.get(1, out, ttl));
+  REQUIRE(ttl > 0s);
+
+  REQUIRE(*cache.getOrLoadAsync(2, loader, options).get() == 20);
+  cache.drainLoads(); // 等这次加载注销，下一次才会重新加载
+  REQUIRE(cache.size() == 1);
+  REQUIRE(*cache.getOrLoadAsync(2, loader, options).get() == 20);
+  cache.drainLoads();
+  REQUIRE(cache.size() == 2);
+  REQUIRE(calls == 4);
+}
+
+TEST_CASE("LRU-K: the getOrLoad re-check does not count as another access",
+          "[lruk][single_flight]") {
+  LruKCache<int, int> cache(4, 8, 3);
+  SingleFlight<int, int> flight;
+  auto loader = [](const int &key, int &v) {
+    v = key * 10;
+    return true;
+  };
+  int out = 0;
+  REQUIRE_FALSE(cache.get(1, out)); // 第 1 次访问
+
+  // epoch 对不上，强制成为加载者后再查一次缓存；写回是第 2 次访问
+  const auto loaded = probeOrLoad<int>(cache, flight, flight.epoch() + 1, 1,
+                                       loader, LoadOptions{});
+  REQUIRE(loaded == 10);
+  REQUIRE(cache.size() == 0);
+  REQUIRE(cache.historySize() == 1);
+
+  cache.put(1, 10); // 第 3 次：准入
+  REQUIRE(cache.size() == 1);
+}
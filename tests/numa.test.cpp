@@ -0,0 +1,200 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "NumaCache.h"
+
+TEST_CASE("NumaTopology: nodes and the current node are consistent",
+          "[numa]") {
+  const NumaTopology &topology = NumaTopology::system();
+  REQUIRE(topology.nodeCount() >= 1);
+  for (std::size_t node = 0; node < topology.nodeCount(); ++node) {
+    REQUIRE_FALSE(topology.cpusOf(node).empty());
+  }
+  const int here = currentNumaNode();
+  REQUIRE(here >= 0);
+  REQUIRE(static_cast<std::size_t>(here) < topology.nodeCount());
+
+  {
+    ScopedNumaNode scoped(3);
+    REQUIRE(currentNumaNode() == 3);
+  }
+  REQUIRE(currentNumaNode() == here);
+
+  int ranOn = -1;
+  runOnNode(0, [&] { ranOn = currentNumaNode(); });
+  REQUIRE(ranOn == 0);
+
+  // 不足一页的区间不会绑定；非法节点总是失败
+  char small[16];
+  REQUIRE_FALSE(bindMemoryToNode(small, sizeof(small), 0));
+  std::vector<char> big(1 << 16);
+  REQUIRE_FALSE(bindMemoryToNode(big.data(), big.size(), 1 << 20));
+}
+
+TEST_CASE("NumaLruCaches: shards are grouped by node", "[numa]") {
+  NumaOptions options;
+  options.nodes = 2;
+  options.shardsPerNode = 3; // 取整为 4
+  NumaLruCaches<int, int> cache(800, options);
+  REQUIRE(cache.nodeCount() == 2);
+  REQUIRE(cache.shardsPerNode() == 4);
+
+  for (int i = 0; i < 400; ++i) {
+    cache.put(i, i * 2);
+  }
+  int out = 0;
+  for (int i = 0; i < 400; ++i) {
+    REQUIRE(cache.get(i, out));
+    REQUIRE(out == i * 2);
+  }
+  REQUIRE(cache.size() == 400);
+
+  const std::vector<ShardPlacement> placement = cache.placement();
+  REQUIRE(placement.size() == 8);
+  std::size_t perNode[2] = {0, 0};
+  for (const ShardPlacement &p : placement) {
+    REQUIRE(p.node == static_cast<int>(p.shard / 4));
+    REQUIRE(p.capacity == 100);
+    perNode[p.node] += p.size;
+  }
+  // 没有 affinity 时按哈希分到两个节点
+  REQUIRE(perNode[0] > 100);
+  REQUIRE(perNode[1] > 100);
+
+  // 逻辑节点 1 超出实际节点时不绑定内存
+  if (NumaTopology::system().nodeCount() == 1) {
+    REQUIRE_FALSE(placement[4].memoryBound);
+  }
+}
+
+TEST_CASE("NumaLruCaches: key affinity keeps accesses on the local node",
+          "[numa][stats]") {
+  NumaOptions options;
+  options.nodes = 2;
+  options.shardsPerNode = 2;
+  // 偶数 key 属于节点 0，奇数属于节点 1
+  NumaLruCaches<int, int, AtomicStats> cache(
+      1000, options, [](const int &key) { return key & 1; });
+
+  auto worker = [&cache](int node) {
+    ScopedNumaNode scoped(node);
+    int out = 0;
+    for (int i = node; i < 200; i += 2) {
+      cache.put(i, i);
+      cache.get(i, out);
+    }
+  };
+  std::thread a(worker, 0);
+  std::thread b(worker, 1);
+  a.join();
+  b.join();
+
+  std::uint64_t local = 0;
+  std::uint64_t remote = 0;
+  for (const ShardPlacement &p : cache.placement()) {
+    local += p.localAccesses;
+    remote += p.remoteAccesses;
+    if (p.size > 0) {
+      REQUIRE(p.localAccesses > 0);
+    }
+  }
+  REQUIRE(local == 400);
+  REQUIRE(remote == 0);
+
+  {
+    ScopedNumaNode scoped(0);
+    cache.get(1); // 奇数 key 在节点 1 上
+  }
+  std::uint64_t remoteAfter = 0;
+  for (const ShardPlacement &p : cache.placement()) {
+    remoteAfter += p.remoteAccesses;
+  }
+  REQUIRE(remoteAfter == 1);
+  REQUIRE(cache.stats().hits == 201);
+}
+
+TEST_CASE("NumaLruCaches: replicated mode reads the local replica",
+          "[numa][replica]") {
+  NumaOptions options;
+  options.mode = NumaMode::Replicated;
+  options.nodes = 2;
+  options.shardsPerNode = 1;
+  NumaLruCaches<int, std::string, AtomicStats> cache(3, options);
+  ScopedNumaNode writer(0); // 写入都从节点 0 发起
+
+  cache.put(1, "a");
+  cache.put(2, "b");
+  cache.put(3, "c");
+  for (int node = 0; node < 2; ++node) {
+    ScopedNumaNode scoped(node);
+    REQUIRE(cache.size() == 3); // 每个副本容量都是 3
+    REQUIRE(cache.get(2) == "b");
+  }
+
+  // 每个副本按本节点的访问淘汰：节点 0 访问过 1，节点 1 没有
+  {
+    ScopedNumaNode scoped(0);
+    REQUIRE(cache.get(1) == "a");
+  }
+  cache.put(4, "d");
+  std::string out;
+  {
+    ScopedNumaNode scoped(0);
+    REQUIRE(cache.get(1, out));
+    REQUIRE_FALSE(cache.get(3, out));
+  }
+  {
+    ScopedNumaNode scoped(1);
+    REQUIRE_FALSE(cache.get(1, out));
+    REQUIRE(cache.get(3, out));
+  }
+
+  cache.remove(4); // 从所有副本删除
+  for (int node = 0; node < 2; ++node) {
+    ScopedNumaNode scoped(node);
+    REQUIRE_FALSE(cache.get(4, out));
+  }
+
+  // 读全部落在本节点的副本上；节点 0 发起的 5 次写入在节点 1 的副本上是远端访问
+  const std::vector<ShardPlacement> placement = cache.placement();
+  REQUIRE(placement.size() == 2);
+  REQUIRE(placement[0].capacity == 3);
+  REQUIRE(placement[0].remoteAccesses == 0);
+  REQUIRE(placement[1].remoteAccesses == 5);
+  REQUIRE(placement[1].localAccesses == 4);
+}
+
+TEST_CASE("NumaLruCaches: concurrent readers and writers", "[numa][replica]") {
+  NumaOptions options;
+  options.mode = NumaMode::Replicated;
+  options.nodes = 2;
+  options.shardsPerNode = 2;
+  NumaLruCaches<int, int> cache(64, options);
+  std::atomic<bool> wrong{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, &wrong, t] {
+      ScopedNumaNode scoped(t % 2);
+      int out = 0;
+      for (int i = 0; i < 5000; ++i) {
+        const int key = (i * 7 + t) % 128;
+        if (i % 4 == 0)
+          cache.put(key, key + 1);
+        else if (cache.get(key, out) && out != key + 1)
+          wrong = true;
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  REQUIRE_FALSE(wrong);
+  for (const ShardPlacement &p : cache.placement()) {
+    REQUIRE(p.size <= p.capacity);
+  }
+}
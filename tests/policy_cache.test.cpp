@@ -0,0 +1,163 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Cache.h"
+
+TEST_CASE("Cache<LruEviction>: evicts the least recently used key",
+          "[policy_cache]") {
+  Cache<int, std::string, LruEviction> cache(3);
+  cache.put(1, "a");
+  cache.put(2, "b");
+  cache.put(3, "c");
+  REQUIRE(cache.get(1) == "a"); // 2 成为最久未访问
+
+  cache.put(4, "d");
+  std::string out;
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.get(1) == "a");
+  REQUIRE(cache.get(3) == "c");
+  REQUIRE(cache.get(4) == "d");
+  REQUIRE(cache.size() == 3);
+
+  REQUIRE(cache.remove(3));
+  REQUIRE_FALSE(cache.remove(3));
+  cache.put(5, "e"); // 删除腾出了位置，不淘汰
+  REQUIRE(cache.size() == 3);
+  REQUIRE(cache.get(1) == "a");
+}
+
+TEST_CASE("Cache<LfuEviction>: evicts the least frequently used key",
+          "[policy_cache]") {
+  Cache<int, int, LfuEviction, AlwaysAdmit<int>, NoLock> cache(3);
+  cache.put(1, 10);
+  cache.put(2, 20);
+  cache.put(3, 30);
+  for (int i = 0; i < 3; ++i) {
+    cache.get(1);
+    cache.get(3);
+  }
+  cache.get(2);
+
+  cache.put(4, 40); // 2 只访问过 1 次
+  int out = 0;
+  REQUIRE_FALSE(cache.get(2, out));
+  cache.put(5, 50); // 4 与 5 之间，4 先进入频次 1
+  REQUIRE_FALSE(cache.get(4, out));
+  REQUIRE(cache.get(1) == 10);
+  REQUIRE(cache.get(3) == 30);
+  REQUIRE(cache.get(5) == 50);
+}
+
+TEST_CASE("Cache<ArcEviction>: ghost hits adapt the T1 target",
+          "[policy_cache][arc]") {
+  Cache<int, int, ArcEviction> cache(4);
+  for (int i = 0; i < 4; ++i) {
+    cache.put(i, i);
+  }
+  cache.get(0); // 0 进入 T2
+  cache.put(4, 4); // 淘汰 T1 最旧的 1，进入 B1
+  int out = 0;
+  REQUIRE_FALSE(cache.get(1, out));
+  REQUIRE(cache.eviction().target() == 0);
+
+  cache.put(1, 1); // 命中 B1：p 增大，1 直接进 T2
+  REQUIRE(cache.eviction().target() == 1);
+  REQUIRE(cache.get(0) == 0);
+  REQUIRE(cache.get(1) == 1);
+
+  // 一次性扫描只冲刷 T1，T2 的热点留下
+  for (int i = 100; i < 120; ++i) {
+    cache.put(i, i);
+  }
+  REQUIRE(cache.get(0, out));
+  REQUIRE(cache.get(1, out));
+}
+
+TEST_CASE("Cache with TinyLfuAdmission: cold keys cannot displace hot ones",
+          "[policy_cache][admission]") {
+  Cache<int, int, LruEviction, TinyLfuAdmission<int>> cache(2);
+  cache.put(1, 1);
+  cache.put(2, 2);
+  for (int i = 0; i < 5; ++i) {
+    cache.get(1);
+    cache.get(2);
+  }
+
+  cache.put(3, 3); // 只出现过一次，不如 victim 热
+  int out = 0;
+  REQUIRE_FALSE(cache.get(3, out));
+  REQUIRE(cache.get(1, out));
+  REQUIRE(cache.get(2, out));
+
+  // 足够热之后可以进入
+  for (int i = 0; i < 10; ++i) {
+    cache.get(3, out);
+  }
+  cache.put(3, 3);
+  REQUIRE(cache.get(3, out));
+  REQUIRE(cache.size() == 2);
+}
+
+TEST_CASE("Cache with LruKAdmission: admitted on the K-th access",
+          "[policy_cache][admission]") {
+  Cache<int, int, LruEviction, LruKAdmission<int, 3>> cache(4);
+  int out = 0;
+  cache.put(1, 10); // 第 1 次
+  REQUIRE_FALSE(cache.get(1, out)); // 第 2 次(未命中也算)
+  cache.put(1, 10); // 第 3 次，准入
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == 10);
+}
+
+TEST_CASE("Cache: stats and SpinLock under concurrency",
+          "[policy_cache][concurrency]") {
+  Cache<int, int, LruEviction, AlwaysAdmit<int>, SpinLock, AtomicStats> cache(
+      128);
+  std::atomic<bool> wrong{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, &wrong, t] {
+      int out = 0;
+      for (int i = 0; i < 5000; ++i) {
+        const int key = (i * 31 + t) % 256;
+        if (!cache.get(key, out))
+          cache.put(key, key);
+        else if (out != key)
+          wrong = true;
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  REQUIRE_FALSE(wrong);
+
+  const CacheStats stats = cache.stats();
+  REQUIRE(stats.hits + stats.misses == 20000);
+  REQUIRE(stats.inserts - stats.evictions == cache.size());
+  REQUIRE(cache.size() == 128);
+}
+
+TEST_CASE("CachePolicyAdaptor: static engines behind ICachePolicy",
+          "[policy_cache]") {
+  std::unique_ptr<ICachePolicy<int, int>> policies[] = {
+      std::make_unique<CachePolicyAdaptor<Cache<int, int, LruEviction>>>(2),
+      std::make_unique<CachePolicyAdaptor<Cache<int, int, LfuEviction>>>(2),
+      std::make_unique<CachePolicyAdaptor<Cache<int, int, ArcEviction>>>(2),
+  };
+  for (auto &policy : policies) {
+    policy->put(1, 10);
+    policy->put(2, 20);
+    policy->get(1);
+    policy->put(3, 30); // 三种策略都淘汰 2
+    int out = 0;
+    REQUIRE_FALSE(policy->get(2, out));
+    REQUIRE(policy->get(1) == 10);
+    REQUIRE(policy->get(3) == 30);
+  }
+}
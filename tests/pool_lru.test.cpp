@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <string>
+#include <unordered_map>
+
+#include "PoolLruCache.h"
+
+TEST_CASE("PoolLRU: put/get basic hit-miss", "[pool-lru]") {
+  PoolLruCache<int, std::string> cache(2);
+
+  std::string out;
+  REQUIRE_FALSE(cache.get(1, out));
+
+  cache.put(1, "a");
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == "a");
+
+  cache.put(2, "b");
+  REQUIRE(cache.get(2, out));
+  REQUIRE(out == "b");
+}
+
+TEST_CASE("PoolLRU: eviction reuses the least recently used slot",
+          "[pool-lru]") {
+  PoolLruCache<int, std::string> cache(2);
+
+  cache.put(1, "a");
+  cache.put(2, "b");
+
+  // get(1) => 2 成为 LRU
+  std::string out;
+  REQUIRE(cache.get(1, out));
+
+  cache.put(3, "c"); // 应该淘汰 2
+  REQUIRE(cache.size() == 2);
+
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == "a");
+  REQUIRE(cache.get(3, out));
+  REQUIRE(out == "c");
+}
+
+TEST_CASE("PoolLRU: put existing key updates value and refreshes recency",
+          "[pool-lru]") {
+  PoolLruCache<int, std::string> cache(2);
+
+  cache.put(1, "a");
+  cache.put(2, "b");
+  cache.put(1, "a2"); // 2 成为 LRU
+  cache.put(3, "c");
+
+  std::string out;
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == "a2");
+}
+
+TEST_CASE("PoolLRU: remove frees a slot for reuse", "[pool-lru]") {
+  PoolLruCache<int, std::string> cache(2);
+
+  cache.put(1, "a");
+  cache.put(2, "b");
+  cache.remove(1);
+  REQUIRE(cache.size() == 1);
+
+  // 有空闲槽位，不应淘汰 2
+  cache.put(3, "c");
+  std::string out;
+  REQUIRE(cache.get(2, out));
+  REQUIRE(cache.get(3, out));
+  REQUIRE_FALSE(cache.get(1, out));
+}
+
+TEST_CASE("PoolLRU: zero capacity stores nothing", "[pool-lru]") {
+  PoolLruCache<int, std::string> cache(0);
+
+  cache.put(1, "a");
+  REQUIRE(cache.get(1).empty());
+}
+
+// 与一个简单的参考模型对拍，覆盖哈希桶冲突链的摘除/复用
+TEST_CASE("PoolLRU: matches reference LRU on random workload",
+          "[pool-lru][smoke]") {
+  constexpr int CAP = 64;
+  PoolLruCache<int, int> cache(CAP);
+
+  std::unordered_map<int, std::pair<int, long>> model; // key -> (value, stamp)
+  long clock = 0;
+
+  std::mt19937 gen(7);
+  for (int op = 0; op < 50000; ++op) {
+    const int key = static_cast<int>(gen() % 256) * 1024; // 制造桶冲突
+    if (gen() % 3 == 0) {
+      cache.put(key, op);
+      auto it = model.find(key);
+      if (it == model.end() && model.size() == CAP) {
+        auto victim = model.begin();
+        for (auto m = model.begin(); m != model.end(); ++m) {
+          if (m->second.second < victim->second.second)
+            victim = m;
+        }
+        model.erase(victim);
+      }
+      model[key] = {op, ++clock};
+    } else {
+      int out = -1;
+      const bool hit = cache.get(key, out);
+      auto it = model.find(key);
+      REQUIRE(hit == (it != model.end()));
+      if (hit) {
+        REQUIRE(out == it->second.first);
+        it->second.second = ++clock;
+      }
+    }
+  }
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "ReadBuffer.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("ReadBuffer: drains in order and drops records once full",
+          "[read_buffer]") {
+  ReadBuffer buffer(1);
+  REQUIRE(buffer.stripeCount() == 1);
+
+  bool full = false;
+  for (ReadBuffer::Index i = 0; i < ReadBuffer::kRingSize + 4; ++i) {
+    full = buffer.record(i);
+  }
+  REQUIRE(full);
+
+  std::vector<ReadBuffer::Index> seen;
+  buffer.drain([&](ReadBuffer::Index i) { seen.push_back(i); });
+  REQUIRE(seen.size() == ReadBuffer::kRingSize); // 满了之后的记录被丢弃
+  for (std::size_t i = 0; i < seen.size(); ++i) {
+    REQUIRE(seen[i] == i);
+  }
+
+  // drain 之后条带重新可用
+  REQUIRE_FALSE(buffer.record(42));
+  seen.clear();
+  buffer.drain([&](ReadBuffer::Index i) { seen.push_back(i); });
+  REQUIRE(seen == std::vector<ReadBuffer::Index>{42});
+}
+
+TEST_CASE("LruCache buffered: hits are applied before the next eviction",
+          "[read_buffer][lru]") {
+  LruCache<int, int> cache(3);
+  cache.setBufferedRecency(true, 1);
+  cache.put(1, 10);
+  cache.put(2, 20);
+  cache.put(3, 30);
+
+  int out = 0;
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == 10);
+
+  cache.put(4, 40); // 写入前先补上对 1 的访问，淘汰的是 2
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.get(1) == 10);
+  REQUIRE(cache.get(3) == 30);
+  REQUIRE(cache.get(4) == 40);
+
+  // 关闭时补上剩余的访问，之后回到普通模式
+  cache.setBufferedRecency(false);
+  cache.put(5, 50);
+  REQUIRE_FALSE(cache.get(1, out));
+}
+
+TEST_CASE("LruCache buffered: expired entries are misses", "[read_buffer][ttl]") {
+  LruCache<int, int> cache(4);
+  cache.setBufferedRecency(true);
+  cache.put(1, 10, 20ms);
+  cache.put(2, 20);
+
+  int out = 0;
+  REQUIRE(cache.get(1, out));
+  std::this_thread::sleep_for(40ms);
+  REQUIRE_FALSE(cache.get(1, out));
+  REQUIRE(cache.get(2, out));
+  REQUIRE(out == 20);
+}
+
+TEST_CASE("LfuCache buffered: hits count towards frequency after a drain",
+          "[read_buffer][lfu]") {
+  LfuCache<int, int> cache(2);
+  cache.setBufferedRecency(true, 1);
+  cache.put(1, 10);
+  cache.put(2, 20);
+
+  int out = 0;
+  for (int i = 0; i < 3; ++i) {
+    REQUIRE(cache.get(1, out));
+  }
+  REQUIRE(cache.get(2, out));
+
+  cache.put(3, 30); // 1 的频次更高，淘汰 2
+  REQUIRE(cache.get(1) == 10);
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.get(3) == 30);
+}
+
+TEST_CASE("KHashLruCaches buffered: concurrent readers and writers",
+          "[read_buffer][concurrency]") {
+  constexpr int kKeys = 512;
+  KHashLruCaches<int, int> cache(256, 4);
+  cache.setBufferedRecency(true);
+
+  std::atomic<bool> wrong{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      int out = 0;
+      for (int i = 0; i < 20000; ++i) {
+        const int key = (i * 7 + t * 13) % kKeys;
+        if (i % 8 == 0) {
+          cache.put(key, key * 2);
+        } else if (cache.get(key, out) && out != key * 2) {
+          wrong = true;
+        }
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  REQUIRE_FALSE(wrong);
+
+  std::size_t total = 0;
+  for (std::size_t used : cache.occupancy()) {
+    total += used;
+  }
+  REQUIRE(total <= 256);
+}
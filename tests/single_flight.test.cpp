@@ -0,0 +1,253 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "SingleFlight.h"
+#include "arc/ArcCache.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// 模拟慢后端：每次加载睡一会儿，记录被调用的次数
+struct SlowBackend {
+  std::atomic<int> calls{0};
+
+  bool operator()(const int &key, std::string &value) {
+    ++calls;
+    std::this_thread::sleep_for(50ms);
+    value = "v" + std::to_string(key);
+    return true;
+  }
+};
+
+// 多个线程同时对同一个 key 调 getOrLoad，返回拿到正确值的线程数
+template <typename Cache> int stampede(Cache &cache, SlowBackend &backend) {
+  constexpr int kThreads = 16;
+  std::atomic<int> ok{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&] {
+      std::string value;
+      if (cache.getOrLoad(7, value, std::ref(backend)) && value == "v7")
+        ++ok;
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  return ok.load();
+}
+
+// 第一次查询未命中，但在返回前让另一次加载写回同一个 key，
+// 模拟“查缓存之后、成为加载者之前”有别的加载完成
+struct RacingCache {
+  explicit RacingCache(SingleFlight<int, int> &f) : flight(f) {}
+
+  SingleFlight<int, int> &flight;
+  std::unordered_map<int, int> map;
+  bool raced = false;
+
+  bool get(const int &key, int &value) {
+    if (!raced) {
+      raced = true;
+      flight.run(key, [&] {
+        map[key] = 42;
+        return std::optional<int>(42);
+      });
+      return false;
+    }
+    auto it = map.find(key);
+    if (it == map.end())
+      return false;
+    value = it->second;
+    return true;
+  }
+  void put(const int &key, const int &value) { map[key] = value; }
+};
+
+} // namespace
+
+TEST_CASE("getOrLoad: concurrent misses run the loader once",
+          "[single_flight]") {
+  SlowBackend backend;
+  LruCache<int, std::string> cache(16);
+  REQUIRE(stampede(cache, backend) == 16);
+  REQUIRE(backend.calls == 1);
+
+  // 之后的读直接命中
+  REQUIRE(cache.getOrLoad(7, std::ref(backend)) == "v7");
+  REQUIRE(backend.calls == 1);
+}
+
+TEST_CASE("getOrLoad: sharded wrappers coalesce per key", "[single_flight]") {
+  SlowBackend lfuBackend, arcBackend;
+  KHashLfuCache<int, std::string> lfu(64, 4);
+  KHashArcCache<int, std::string> arc(64, 4);
+  REQUIRE(stampede(lfu, lfuBackend) == 16);
+  REQUIRE(stampede(arc, arcBackend) == 16);
+  REQUIRE(lfuBackend.calls == 1);
+  REQUIRE(arcBackend.calls == 1);
+  REQUIRE(lfu.get(7) == "v7");
+  REQUIRE(arc.get(7) == "v7");
+}
+
+TEST_CASE("getOrLoad: a failed load is not cached", "[single_flight]") {
+  LfuCache<int, int> cache(4);
+  int calls = 0;
+  auto missing = [&calls](const int &, int &) {
+    ++calls;
+    return false;
+  };
+  int out = -1;
+  REQUIRE_FALSE(cache.getOrLoad(1, out, missing));
+  REQUIRE(cache.getOrLoad(1, missing) == 0);
+  REQUIRE(calls == 2);
+  REQUIRE(cache.size() == 0);
+}
+
+TEST_CASE("getOrLoad: loader exceptions reach every waiter and are retried",
+          "[single_flight]") {
+  LruCache<int, int> cache(4);
+  std::atomic<int> calls{0};
+  auto failing = [&calls](const int &, int &) -> bool {
+    ++calls;
+    std::this_thread::sleep_for(30ms);
+    throw std::runtime_error("backend down");
+  };
+
+  std::atomic<int> errors{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      try {
+        cache.getOrLoad(1, failing);
+      } catch (const std::runtime_error &) {
+        ++errors;
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  REQUIRE(errors == 4);
+  REQUIRE(calls >= 1);
+
+  // 失败不会留在缓存里，下一次重新加载
+  REQUIRE(cache.getOrLoad(1, [](const int &, int &v) {
+    v = 5;
+    return true;
+  }) == 5);
+}
+
+TEST_CASE("getOrLoadAsync: hits are ready, misses load in the background",
+          "[single_flight]") {
+  SlowBackend backend;
+  LruCache<int, std::string> cache(16);
+  cache.put(1, "cached");
+
+  auto hit = cache.getOrLoadAsync(1, std::ref(backend));
+  REQUIRE(hit.wait_for(0s) == std::future_status::ready);
+  REQUIRE(*hit.get() == "cached");
+
+  auto first = cache.getOrLoadAsync(2, std::ref(backend));
+  auto second = cache.getOrLoadAsync(2, std::ref(backend)); // 合并到同一次加载
+  REQUIRE(*first.get() == "v2");
+  REQUIRE(*second.get() == "v2");
+  REQUIRE(backend.calls == 1);
+  REQUIRE(cache.get(2) == "v2");
+}
+
+TEST_CASE("getOrLoad: refresh-ahead reloads before the entry expires",
+          "[single_flight][ttl]") {
+  LruCache<int, int> cache(4);
+  std::atomic<int> version{0};
+  auto loader = [&version](const int &, int &v) {
+    v = ++version;
+    return true;
+  };
+  const LoadOptions options{300ms, 250ms};
+
+  REQUIRE(cache.getOrLoad(1, loader, options) == 1);
+  REQUIRE(cache.getOrLoad(1, loader, options) == 1); // 离过期还早，不刷新
+  REQUIRE(version == 1);
+
+  std::this_thread::sleep_for(100ms);
+  // 进入提前刷新窗口：先返回旧值，后台重新加载
+  REQUIRE(cache.getOrLoad(1, loader, options) == 1);
+  cache.drainLoads(); // 等后台刷新完成
+  REQUIRE(version == 2);
+  REQUIRE(cache.get(1) == 2);
+
+  // 刷新后 ttl 重新计时，过了原来的过期时间也还在
+  std::this_thread::sleep_for(220ms);
+  int out = 0;
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == 2);
+}
+
+TEST_CASE("getOrLoad: a new leader re-checks the cache before loading",
+          "[single_flight]") {
+  SingleFlight<int, int> flight;
+  RacingCache cache(flight);
+  int calls = 0;
+  auto loader = [&calls](const int &, int &v) {
+    ++calls;
+    v = 7;
+    return true;
+  };
+  int out = 0;
+  REQUIRE(loadThrough(cache, flight, 1, out, loader, LoadOptions{}));
+  REQUIRE(out == 42);
+  REQUIRE(calls == 0);
+  REQUIRE(flight.inflight() == 0);
+}
+
+TEST_CASE("getOrLoadAsync: background loads run on a bounded pool",
+          "[single_flight]") {
+  LruCache<int, int> cache(64);
+  std::atomic<int> running{0};
+  std::atomic<int> peak{0};
+  auto loader = [&](const int &key, int &v) {
+    const int now = ++running;
+    int seen = peak.load();
+    while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+    }
+    std::this_thread::sleep_for(10ms);
+    --running;
+    v = key;
+    return true;
+  };
+
+  std::vector<SingleFlight<int, int>::Future> futures;
+  for (int k = 0; k < 32; ++k) {
+    futures.push_back(cache.getOrLoadAsync(k, loader));
+  }
+  for (int k = 0; k < 32; ++k) {
+    REQUIRE(*futures[k].get() == k);
+  }
+  REQUIRE(peak >= 1);
+  REQUIRE(peak <= static_cast<int>(SingleFlight<int, int>::kMaxWorkers));
+}
+
+TEST_CASE("getOrLoadAsync: destroying the cache waits for background loads",
+          "[single_flight]") {
+  SlowBackend backend;
+  SingleFlight<int, std::string>::Future pending;
+  {
+    LruCache<int, std::string> cache(16);
+    pending = cache.getOrLoadAsync(1, std::ref(backend));
+  }
+  REQUIRE(pending.wait_for(0s) == std::future_status::ready);
+  REQUIRE(*pending.get() == "v1");
+  REQUIRE(backend.calls == 1);
+}
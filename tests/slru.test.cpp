@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+#include "CacheStats.h"
+#include "SlruCache.h"
+
+TEST_CASE("SLRU: basic put/get/update/remove", "[slru]") {
+  SlruCache<int, std::string> cache(4);
+  cache.put(1, "a");
+  cache.put(2, "b");
+  REQUIRE(cache.get(1) == "a");
+
+  cache.put(1, "A"); // 覆盖
+  std::string out;
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == "A");
+
+  cache.remove(2);
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.size() == 1);
+}
+
+TEST_CASE("SLRU: a second access promotes into the protected segment",
+          "[slru]") {
+  SlruCache<int, int, AtomicStats> cache(10, /*protectedRatio*/ 0.5);
+  for (int k = 0; k < 4; ++k) {
+    cache.put(k, k);
+  }
+  REQUIRE(cache.probationSize() == 4);
+  REQUIRE(cache.protectedSize() == 0);
+
+  int out = 0;
+  for (int k = 0; k < 4; ++k) {
+    REQUIRE(cache.get(k, out));
+  }
+  REQUIRE(cache.probationSize() == 0);
+  REQUIRE(cache.protectedSize() == 4);
+  REQUIRE(cache.stats().promotions == 4);
+
+  // 保护段上限 5：超出的最久未访问结点降回试用段
+  for (int k = 4; k < 8; ++k) {
+    cache.put(k, k);
+    REQUIRE(cache.get(k, out));
+  }
+  REQUIRE(cache.protectedSize() == 5);
+  REQUIRE(cache.probationSize() == 3);
+  REQUIRE(cache.size() == 8);
+}
+
+TEST_CASE("SLRU: a scan does not flush the hot set", "[slru]") {
+  SlruCache<int, int> cache(100);
+  int out = 0;
+  for (int k = 0; k < 50; ++k) { // 热点：访问两次进入保护段
+    cache.put(k, k);
+    REQUIRE(cache.get(k, out));
+  }
+
+  for (int k = 1000; k < 11000; ++k) { // 一次性扫描
+    cache.put(k, k);
+  }
+
+  for (int k = 0; k < 50; ++k) {
+    REQUIRE(cache.get(k, out));
+    REQUIRE(out == k);
+  }
+  REQUIRE(cache.size() == 100);
+}
+
+TEST_CASE("SLRU: keys returning from A1out go straight to protected",
+          "[slru]") {
+  SlruCache<int, int, AtomicStats> cache(4, 0.5, /*ghostRatio*/ 1.0);
+  for (int k = 0; k < 8; ++k) { // 0..3 被淘汰，指纹进 A1out
+    cache.put(k, k);
+  }
+  REQUIRE(cache.ghostSize() == 4);
+  REQUIRE(cache.protectedSize() == 0);
+
+  cache.put(2, 2);
+  REQUIRE(cache.stats().ghostHits == 1);
+  REQUIRE(cache.protectedSize() == 1);
+
+  // A1out 有上限
+  for (int k = 100; k < 200; ++k) {
+    cache.put(k, k);
+  }
+  REQUIRE(cache.ghostSize() == 4);
+}
+
+TEST_CASE("SLRU: zero protected ratio degrades to plain LRU", "[slru]") {
+  SlruCache<int, int> cache(2, 0.0, 0.0);
+  int out = 0;
+  cache.put(1, 1);
+  cache.put(2, 2);
+  REQUIRE(cache.get(1, out)); // 1 成为最近访问
+  cache.put(3, 3);            // 淘汰 2
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.get(1, out));
+  REQUIRE(cache.get(3, out));
+  REQUIRE(cache.protectedSize() == 0);
+  REQUIRE(cache.ghostSize() == 0);
+}
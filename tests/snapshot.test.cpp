@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "CacheStats.h"
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "SnapshotFile.h"
+#include "arc/ArcCache.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// 每个用例一个临时文件，结束时删除
+struct TempPath {
+  std::string path;
+  explicit TempPath(const char *name)
+      : path((std::filesystem::temp_directory_path() / name).string()) {
+    std::remove(path.c_str());
+  }
+  ~TempPath() { std::remove(path.c_str()); }
+};
+
+} // namespace
+
+TEST_CASE("Snapshot: LRU keeps recency order and truncates to capacity",
+          "[snapshot]") {
+  TempPath file("cpp_cache_lru.snap");
+  LruCache<int, std::string> cache(3);
+  cache.put(1, "one");
+  cache.put(2, "two");
+  cache.put(3, "three");
+  std::string out;
+  REQUIRE(cache.get(1, out)); // 从新到旧：1 3 2
+  REQUIRE(saveSnapshot(cache, file.path));
+
+  LruCache<int, std::string> same(3);
+  REQUIRE(loadSnapshot(same, file.path));
+  REQUIRE(same.size() == 3);
+  same.put(4, "four"); // 淘汰最旧的 2
+  REQUIRE_FALSE(same.get(2, out));
+  REQUIRE(same.get(1, out));
+  REQUIRE(out == "one");
+
+  // 容量更小时只保留最新的条目
+  LruCache<int, std::string> smaller(2);
+  REQUIRE(loadSnapshot(smaller, file.path));
+  REQUIRE(smaller.size() == 2);
+  REQUIRE(smaller.get(1, out));
+  REQUIRE(smaller.get(3, out));
+  REQUIRE_FALSE(smaller.get(2, out));
+}
+
+TEST_CASE("Snapshot: remaining TTL is carried over", "[snapshot][ttl]") {
+  TempPath file("cpp_cache_ttl.snap");
+  LruCache<int, int> cache(8);
+  cache.put(1, 10, 30ms);
+  cache.put(2, 20);
+  cache.put(3, 30, 10min);
+  REQUIRE(saveSnapshot(cache, file.path));
+
+  LruCache<int, int> restored(8);
+  REQUIRE(loadSnapshot(restored, file.path));
+  int out = 0;
+  REQUIRE(restored.get(1, out));
+  REQUIRE(restored.get(3, out)); // 剩余时间仍接近 10 分钟
+
+  std::this_thread::sleep_for(80ms);
+  REQUIRE_FALSE(restored.get(1, out));
+  REQUIRE(restored.get(2, out));
+  REQUIRE(restored.get(3, out));
+}
+
+TEST_CASE("Snapshot: LFU keeps access frequencies", "[snapshot]") {
+  TempPath file("cpp_cache_lfu.snap");
+  LfuCache<int, int> cache(2);
+  cache.put(1, 10);
+  cache.put(2, 20);
+  int out = 0;
+  for (int i = 0; i < 5; ++i) {
+    REQUIRE(cache.get(1, out));
+  }
+  REQUIRE(saveSnapshot(cache, file.path));
+
+  LfuCache<int, int> restored(2);
+  REQUIRE(loadSnapshot(restored, file.path));
+  restored.put(3, 30); // 频次低的 2 被淘汰
+  REQUIRE_FALSE(restored.get(2, out));
+  REQUIRE(restored.get(1, out));
+  REQUIRE(out == 10);
+}
+
+TEST_CASE("Snapshot: ARC restores both parts and the ghost lists",
+          "[snapshot][arc]") {
+  TempPath file("cpp_cache_arc.snap");
+  ArcCache<int, int, AtomicStats> cache(4);
+  for (int k = 0; k < 64; ++k) {
+    cache.put(k, k);
+  }
+  REQUIRE(saveSnapshot(cache, file.path));
+
+  ArcCache<int, int, AtomicStats> restored(4);
+  REQUIRE(loadSnapshot(restored, file.path));
+  REQUIRE(restored.size() == cache.size());
+  int out = 0;
+  REQUIRE(restored.get(63, out));
+  REQUIRE(out == 63);
+
+  // 恢复出来的幽灵链表仍能命中
+  restored.put(59, 59);
+  REQUIRE(restored.stats().ghostHits == 1);
+}
+
+TEST_CASE("Snapshot: sharded caches restore per shard", "[snapshot]") {
+  TempPath file("cpp_cache_sharded.snap");
+  KHashLruCaches<int, int> cache(64, 4);
+  for (int k = 0; k < 40; ++k) {
+    cache.put(k, k * 2);
+  }
+  REQUIRE(saveSnapshot(cache, file.path));
+
+  KHashLruCaches<int, int> restored(64, 4);
+  REQUIRE(loadSnapshot(restored, file.path));
+  for (int k = 0; k < 40; ++k) {
+    REQUIRE(restored.get(k) == k * 2);
+  }
+
+  KHashLruCaches<int, int> otherShards(64, 2); // 分片数不同
+  REQUIRE_FALSE(loadSnapshot(otherShards, file.path));
+
+  TempPath arcFile("cpp_cache_sharded_arc.snap");
+  KHashArcCache<int, int> arc(64, 4);
+  for (int k = 0; k < 40; ++k) {
+    arc.put(k, k);
+  }
+  REQUIRE(saveSnapshot(arc, arcFile.path));
+  KHashArcCache<int, int> arcRestored(64, 4);
+  REQUIRE(loadSnapshot(arcRestored, arcFile.path));
+  REQUIRE(arcRestored.get(39) == 39);
+}
+
+TEST_CASE("Snapshot: rejects corrupt, mismatched and non-empty targets",
+          "[snapshot]") {
+  TempPath file("cpp_cache_bad.snap");
+  LruCache<int, int> cache(8);
+  for (int k = 0; k < 8; ++k) {
+    cache.put(k, k);
+  }
+  REQUIRE(saveSnapshot(cache, file.path));
+
+  LfuCache<int, int> otherPolicy(8);
+  REQUIRE_FALSE(loadSnapshot(otherPolicy, file.path));
+  LruCache<int, long long> otherValue(8);
+  REQUIRE_FALSE(loadSnapshot(otherValue, file.path));
+
+  LruCache<int, int> notEmpty(8);
+  notEmpty.put(100, 100);
+  REQUIRE_FALSE(loadSnapshot(notEmpty, file.path));
+  REQUIRE(notEmpty.size() == 1);
+
+  { // 改掉最后一个字节，校验失败
+    std::fstream f(file.path, std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(-1, std::ios::end);
+    f.put('\x7f');
+  }
+  LruCache<int, int> target(8);
+  REQUIRE_FALSE(loadSnapshot(target, file.path));
+  REQUIRE(target.size() == 0);
+
+  REQUIRE_FALSE(loadSnapshot(target, file.path + ".missing"));
+}
+
+TEST_CASE("Snapshot: background save", "[snapshot]") {
+  TempPath file("cpp_cache_async.snap");
+  LruCache<std::string, std::string> cache(100);
+  for (int k = 0; k < 100; ++k) {
+    cache.put("key" + std::to_string(k), std::string(32, 'a' + k % 26));
+  }
+  auto saved = saveSnapshotAsync(cache, file.path);
+  cache.get("key0"); // 写快照期间缓存照常可用
+  REQUIRE(saved.get());
+
+  LruCache<std::string, std::string> restored(100);
+  REQUIRE(loadSnapshot(restored, file.path));
+  REQUIRE(restored.size() == 100);
+  REQUIRE(restored.get("key42") == std::string(32, 'a' + 42 % 26));
+}
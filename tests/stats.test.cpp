@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CacheStats.h"
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "arc/ArcCache.h"
+
+TEST_CASE("Stats: NullStats reports zeros", "[stats]") {
+  LruCache<int, int> cache(2);
+  int out = 0;
+  cache.put(1, 1);
+  cache.get(1, out);
+  cache.get(2, out);
+
+  const CacheStats s = cache.stats();
+  REQUIRE(s.hits == 0);
+  REQUIRE(s.misses == 0);
+  REQUIRE(s.lockAcquires == 0);
+}
+
+TEST_CASE("Stats: LRU counts hits, misses, inserts and evictions",
+          "[stats][lru]") {
+  LruCache<int, std::string, AtomicStats> cache(2);
+  std::string out;
+
+  cache.put(1, "a");
+  cache.put(2, "b");
+  cache.put(1, "aa"); // 覆盖不算插入
+  REQUIRE(cache.get(1, out));
+  REQUIRE_FALSE(cache.get(9, out));
+  cache.put(3, "c"); // 淘汰 2
+  REQUIRE(cache.withValue(3, [](const std::string &) {}));
+
+  const CacheStats s = cache.stats();
+  REQUIRE(s.hits == 2);
+  REQUIRE(s.misses == 1);
+  REQUIRE(s.inserts == 3);
+  REQUIRE(s.evictions == 1);
+  REQUIRE(s.hitRatio() > 0.66);
+  REQUIRE(s.lockAcquires >= 6);
+}
+
+TEST_CASE("Stats: LRU-K records promotions", "[stats][lru]") {
+  LruKCache<int, int, AtomicStats> cache(4, 8, 2);
+  cache.put(1, 10); // 第一次访问只进历史
+  REQUIRE(cache.stats().promotions == 0);
+  cache.put(1, 11); // 第二次访问达到 k，晋升到主缓存
+  REQUIRE(cache.stats().promotions == 1);
+  REQUIRE(cache.get(1) == 11);
+  REQUIRE(cache.stats().hits >= 1);
+}
+
+TEST_CASE("Stats: LFU counts hits, misses, inserts and evictions",
+          "[stats][lfu]") {
+  LfuCache<int, int, AtomicStats> cache(2);
+  int out = 0;
+
+  cache.put(1, 1);
+  cache.put(2, 2);
+  REQUIRE(cache.get(1, out));
+  cache.put(3, 3); // 淘汰频率最低的 2
+  REQUIRE_FALSE(cache.get(2, out));
+
+  const CacheStats s = cache.stats();
+  REQUIRE(s.hits == 1);
+  REQUIRE(s.misses == 1);
+  REQUIRE(s.inserts == 3);
+  REQUIRE(s.evictions == 1);
+}
+
+TEST_CASE("Stats: ARC records migrations and ghost hits", "[stats][arc]") {
+  ArcCache<int, int, AtomicStats> cache(2, 2);
+  int out = 0;
+
+  cache.put(1, 1);
+  REQUIRE(cache.get(1, out)); // 达到门槛，迁移到 LFU 部分
+  CacheStats s = cache.stats();
+  REQUIRE(s.migrations == 1);
+  REQUIRE(s.inserts == 1);
+
+  cache.put(2, 2);
+  cache.put(3, 3);
+  cache.put(4, 4); // LRU 部分满，2 进入幽灵链表
+  s = cache.stats();
+  REQUIRE(s.inserts == 4);
+  REQUIRE(s.evictions >= 1);
+
+  REQUIRE_FALSE(cache.get(2, out));
+  s = cache.stats();
+  REQUIRE(s.ghostHits == 1);
+  REQUIRE(s.pAdjustments == 1);
+  REQUIRE(s.misses == 1);
+}
+
+TEST_CASE("Stats: sharded caches aggregate per-shard counters",
+          "[stats][khash]") {
+  KHashLruCaches<int, int, std::hash<int>, AtomicStats> lru(64, 4);
+  KHashLfuCache<int, int, std::hash<int>, AtomicStats> lfu(64, 4);
+  KHashArcCache<int, int, std::hash<int>, AtomicStats> arc(64, 4);
+  int out = 0;
+
+  for (int i = 0; i < 32; ++i) {
+    lru.put(i, i);
+    lfu.put(i, i);
+    arc.put(i, i);
+  }
+  for (int i = 0; i < 40; ++i) {
+    lru.get(i, out);
+    lfu.get(i, out);
+    arc.get(i, out);
+  }
+
+  REQUIRE(lru.stats().inserts == 32);
+  REQUIRE(lru.stats().hits + lru.stats().misses == 40);
+  REQUIRE(lfu.stats().inserts == 32);
+  REQUIRE(lfu.stats().hits + lfu.stats().misses == 40);
+  REQUIRE(arc.stats().hits + arc.stats().misses == 40);
+}
+
+TEST_CASE("Stats: lock acquisitions are counted across threads",
+          "[stats][concurrency]") {
+  LruCache<int, int, AtomicStats> cache(128);
+  constexpr int kThreads = 4;
+  constexpr int kOps = 2000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&cache, t] {
+      int out = 0;
+      for (int i = 0; i < kOps; ++i) {
+        cache.put(t * kOps + i, i);
+        cache.get(t * kOps + i, out);
+      }
+    });
+  }
+  for (auto &th : threads) {
+    th.join();
+  }
+
+  const CacheStats s = cache.stats();
+  REQUIRE(s.lockAcquires == 2u * kThreads * kOps);
+  REQUIRE(s.lockContended <= s.lockAcquires);
+  REQUIRE(s.hits + s.misses == static_cast<std::uint64_t>(kThreads * kOps));
+}
@@ -1,7 +1,11 @@
 #include "../include/arc/ArcCache.h"
+#include "ClockCache.h"
 #include "ICachePolicy.h"
 #include "LfuCache.h"
 #include "LruCache.h"
+#include "LfuDaCache.h"
+#include "SlruCache.h"
+#include "TinyLfuCache.h"
 
 #include <array>
 #include <chrono>
@@ -44,6 +48,17 @@ void printResults(const std::string &testName, int capacity,
     names = {"LRU", "LFU", "ARC", "LRU-K"};
   } else if (hits.size() == 5) {
     names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging"};
+  } else if (hits.size() == 6) {
+    names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging", "CLOCK"};
+  } else if (hits.size() == 7) {
+    names = {"LRU",       "LFU",   "ARC",      "LRU-K",
+             "LFU-Aging", "CLOCK", "W-TinyLFU"};
+  } else if (hits.size() == 8) {
+    names = {"LRU",   "LFU",       "ARC", "LRU-K", "LFU-Aging",
+             "CLOCK", "W-TinyLFU", "SLRU"};
+  } else if (hits.size() == 9) {
+    names = {"LRU",   "LFU",       "ARC",  "LRU-K", "LFU-Aging",
+             "CLOCK", "W-TinyLFU", "SLRU", "LFU-DA"};
   }
 
   for (std::size_t i = 0; i < hits.size(); ++i) {
@@ -101,9 +116,13 @@ void testHotDataAccess() {
 
   // LFU-Aging（你原来传了两个参数）
   LfuCache<int, std::string> lfuAging(CAPACITY, 20000);
+  ClockCache<int, std::string> clock(CAPACITY);
+  TinyLfuCache<int, std::string> tinyLfu(CAPACITY);
+  SlruCache<int, std::string> slru(CAPACITY);
+  LfuDaCache<int, std::string> lfuDa(CAPACITY);
 
-  std::array<ICachePolicy<int, std::string> *, 5> caches = {&lru, &lfu, &arc,
-                                                            &lruk, &lfuAging};
+  std::array<ICachePolicy<int, std::string> *, 9> caches = {
+      &lru, &lfu, &arc, &lruk, &lfuAging, &clock, &tinyLfu, &slru, &lfuDa};
 
   std::vector<std::uint64_t> hits(caches.size(), 0);
   std::vector<std::uint64_t> get_operations(caches.size(), 0);
@@ -164,9 +183,13 @@ void testLoopPattern() {
   LruKCache<int, std::string> lruk(CAPACITY, LOOP_SIZE * 2, 2);
 
   LfuCache<int, std::string> lfuAging(CAPACITY, 3000);
+  ClockCache<int, std::string> clock(CAPACITY);
+  TinyLfuCache<int, std::string> tinyLfu(CAPACITY);
+  SlruCache<int, std::string> slru(CAPACITY);
+  LfuDaCache<int, std::string> lfuDa(CAPACITY);
 
-  std::array<ICachePolicy<int, std::string> *, 5> caches = {&lru, &lfu, &arc,
-                                                            &lruk, &lfuAging};
+  std::array<ICachePolicy<int, std::string> *, 9> caches = {
+      &lru, &lfu, &arc, &lruk, &lfuAging, &clock, &tinyLfu, &slru, &lfuDa};
 
   std::vector<std::uint64_t> hits(caches.size(), 0);
   std::vector<std::uint64_t> get_operations(caches.size(), 0);
@@ -225,9 +248,13 @@ void testWorkloadShift() {
   ArcCache<int, std::string> arc(CAPACITY);
   LruKCache<int, std::string> lruk(CAPACITY, 500, 2);
   LfuCache<int, std::string> lfuAging(CAPACITY, 10000);
+  ClockCache<int, std::string> clock(CAPACITY);
+  TinyLfuCache<int, std::string> tinyLfu(CAPACITY);
+  SlruCache<int, std::string> slru(CAPACITY);
+  LfuDaCache<int, std::string> lfuDa(CAPACITY);
 
-  std::array<ICachePolicy<int, std::string> *, 5> caches = {&lru, &lfu, &arc,
-                                                            &lruk, &lfuAging};
+  std::array<ICachePolicy<int, std::string> *, 9> caches = {
+      &lru, &lfu, &arc, &lruk, &lfuAging, &clock, &tinyLfu, &slru, &lfuDa};
 
   std::vector<std::uint64_t> hits(caches.size(), 0);
   std::vector<std::uint64_t> get_operations(caches.size(), 0);
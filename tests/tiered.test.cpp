@@ -0,0 +1,190 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FlashTier.h"
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "TieredCache.h"
+#include "arc/ArcCache.h"
+
+namespace {
+
+// 测试用的临时目录，析构时删除
+struct TempDir {
+  std::filesystem::path path;
+
+  explicit TempDir(const std::string &name)
+      : path(std::filesystem::temp_directory_path() / name) {
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+  }
+  ~TempDir() { std::filesystem::remove_all(path); }
+
+  std::size_t fileCount() const {
+    return static_cast<std::size_t>(std::distance(
+        std::filesystem::directory_iterator(path),
+        std::filesystem::directory_iterator()));
+  }
+};
+
+FlashOptions smallFlash(const TempDir &dir) {
+  FlashOptions options;
+  options.directory = dir.path.string();
+  options.segmentBytes = 4096;
+  options.maxSegments = 4;
+  options.writeBatchBytes = 512;
+  return options;
+}
+
+} // namespace
+
+TEST_CASE("TieredCache: evicted entries are served from flash and promoted",
+          "[tiered]") {
+  TempDir dir("cpp_cache_tiered_promote");
+  TieredCache<int, std::string, LruCache<int, std::string>> cache(
+      smallFlash(dir), 2);
+  for (int i = 1; i <= 5; ++i) {
+    cache.put(i, "v" + std::to_string(i));
+  }
+  REQUIRE(cache.memory().size() == 2);
+  REQUIRE(cache.flash().size() == 3);
+
+  // 1 还在当前批次里(没写盘)，也能读到
+  std::string out;
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == "v1");
+  // 回填后闪存里不再有 1，内存层挤出的 4 进了闪存
+  REQUIRE(cache.flash().size() == 3);
+
+  cache.flash().flush();
+  for (int i = 1; i <= 5; ++i) {
+    REQUIRE(cache.get(i) == "v" + std::to_string(i));
+  }
+  const FlashStats stats = cache.flash().stats();
+  REQUIRE(stats.hits >= 5);
+  REQUIRE(stats.bytesWritten > 0);
+  REQUIRE(cache.get(42).empty());
+}
+
+TEST_CASE("TieredCache: a newer put hides the flash copy", "[tiered]") {
+  TempDir dir("cpp_cache_tiered_overwrite");
+  TieredCache<int, int, LfuCache<int, int>> cache(smallFlash(dir), 1);
+  cache.put(1, 10);
+  cache.put(2, 20); // 1 被淘汰到闪存
+  REQUIRE(cache.flash().size() == 1);
+
+  cache.put(1, 11); // 2 进闪存，闪存里 1 的旧值作废
+  cache.flash().flush();
+  REQUIRE(cache.get(1) == 11);
+  REQUIRE(cache.get(2) == 20);
+}
+
+TEST_CASE("FlashTier: GC reclaims old segments within the segment budget",
+          "[tiered][gc]") {
+  TempDir dir("cpp_cache_flash_gc");
+  FlashTier<int, std::string> flash(smallFlash(dir));
+  REQUIRE(flash.ok());
+
+  const std::string payload(200, 'x');
+  for (int i = 0; i < 200; ++i) {
+    flash.put(i, payload + std::to_string(i));
+  }
+  flash.flush();
+
+  REQUIRE(flash.segmentCount() <= 4);
+  REQUIRE(dir.fileCount() <= 4);
+  const FlashStats stats = flash.stats();
+  REQUIRE(stats.segmentsReclaimed > 0);
+  REQUIRE(stats.gcEvictions > 0);
+  REQUIRE(flash.size() + stats.gcEvictions == 200);
+
+  // 最早的条目随回收段丢弃，最近的还在
+  std::string out;
+  REQUIRE_FALSE(flash.get(0, out));
+  REQUIRE(flash.get(199, out));
+  REQUIRE(out == payload + "199");
+}
+
+TEST_CASE("FlashTier: least-live GC keeps the segment with live data",
+          "[tiered][gc]") {
+  TempDir dir("cpp_cache_flash_least_live");
+  FlashOptions options = smallFlash(dir);
+  options.gc = FlashGc::LeastLive;
+  FlashTier<int, std::string> flash(options);
+
+  const std::string payload(1000, 'y');
+  // 段 0：key 0..3，只有 0 一直有效；其他 key 反复覆盖，旧段几乎全是失效数据
+  for (int i = 0; i < 4; ++i) {
+    flash.put(i, payload);
+  }
+  for (int round = 0; round < 6; ++round) {
+    for (int i = 1; i < 4; ++i) {
+      flash.put(i, payload);
+    }
+  }
+  flash.flush();
+
+  std::string out;
+  REQUIRE(flash.get(0, out)); // FIFO 会先回收段 0
+  REQUIRE(flash.stats().segmentsReclaimed > 0);
+}
+
+TEST_CASE("FlashTier: erase and take remove entries", "[tiered]") {
+  TempDir dir("cpp_cache_flash_erase");
+  FlashTier<std::string, std::string> flash(smallFlash(dir));
+  flash.put("a", "1");
+  flash.put("b", "2");
+  flash.flush();
+
+  std::string out;
+  REQUIRE(flash.take("a", out));
+  REQUIRE(out == "1");
+  REQUIRE_FALSE(flash.get("a", out));
+  flash.erase("b");
+  REQUIRE_FALSE(flash.get("b", out));
+  REQUIRE(flash.size() == 0);
+}
+
+TEST_CASE("TieredCache: sharded memory tiers spill concurrently",
+          "[tiered][concurrency]") {
+  TempDir dir("cpp_cache_tiered_concurrent");
+  FlashOptions options = smallFlash(dir);
+  options.segmentBytes = 1u << 20;
+  options.maxQueuedBytes = 64u << 20;
+  TieredCache<int, int, KHashArcCache<int, int>> cache(options, 64, 4);
+
+  constexpr int kKeys = 2000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = t; i < kKeys; i += 4) {
+        cache.put(i, i * 3);
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  cache.flash().flush();
+
+  std::atomic<int> wrong{0};
+  threads.clear();
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      int out = 0;
+      for (int i = t; i < kKeys; i += 4) {
+        if (!cache.get(i, out) || out != i * 3)
+          ++wrong;
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  REQUIRE(wrong == 0);
+}
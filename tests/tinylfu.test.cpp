@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+#include "FrequencySketch.h"
+#include "TinyLfuCache.h"
+
+TEST_CASE("FrequencySketch: counts saturate at 15 and halve on reset",
+          "[tinylfu][sketch]") {
+  FrequencySketch<int> sketch(1024);
+  REQUIRE(sketch.frequency(7) == 0);
+
+  for (int i = 0; i < 5; ++i) {
+    sketch.increment(7);
+  }
+  REQUIRE(sketch.frequency(7) == 5);
+
+  for (int i = 0; i < 100; ++i) {
+    sketch.increment(7);
+  }
+  REQUIRE(sketch.frequency(7) == FrequencySketch<int>::kMaxCount);
+
+  sketch.reset();
+  REQUIRE(sketch.frequency(7) == 7);
+  REQUIRE(sketch.tableBytes() == 1024 * sizeof(std::uint64_t));
+}
+
+TEST_CASE("FrequencySketch: ages counters after the sample period",
+          "[tinylfu][sketch]") {
+  FrequencySketch<int> sketch(16);
+  for (int i = 0; i < 8; ++i) {
+    sketch.increment(1);
+  }
+  REQUIRE(sketch.frequency(1) == 8);
+
+  // 其他 key 的访问累计到采样周期后触发一次减半
+  for (std::size_t i = 0; i < sketch.sampleSize(); ++i) {
+    sketch.increment(1000 + static_cast<int>(i));
+  }
+  REQUIRE(sketch.frequency(1) <= 4);
+}
+
+TEST_CASE("TinyLFU: put/get basic hit-miss", "[tinylfu]") {
+  TinyLfuCache<int, std::string> cache(4);
+
+  std::string out;
+  REQUIRE_FALSE(cache.get(1, out));
+
+  cache.put(1, "a");
+  cache.put(2, "b");
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == "a");
+  REQUIRE(cache.get(2, out));
+  REQUIRE(out == "b");
+
+  cache.put(1, "a2");
+  REQUIRE(cache.get(1) == "a2");
+}
+
+TEST_CASE("TinyLFU: size never exceeds capacity", "[tinylfu]") {
+  TinyLfuCache<int, int> cache(100);
+  for (int i = 0; i < 10000; ++i) {
+    cache.put(i % 700, i);
+    REQUIRE(cache.size() <= 100);
+  }
+  REQUIRE(cache.size() == 100);
+}
+
+TEST_CASE("TinyLFU: frequent keys survive a scan of one-hit keys",
+          "[tinylfu]") {
+  TinyLfuCache<int, int> cache(100);
+  int out = 0;
+
+  for (int round = 0; round < 10; ++round) {
+    for (int key = 0; key < 50; ++key) {
+      cache.put(key, key);
+      cache.get(key, out);
+    }
+  }
+
+  // 只访问一次的 key 频率低于热点，进不了主缓存
+  for (int key = 1000; key < 6000; ++key) {
+    cache.put(key, key);
+  }
+
+  int survived = 0;
+  for (int key = 0; key < 50; ++key) {
+    survived += cache.get(key, out) ? 1 : 0;
+  }
+  // 最后一个热点还留在窗口里，与同样热的牺牲者打平时被替换
+  REQUIRE(survived >= 49);
+}
+
+TEST_CASE("TinyLFU: remove frees the slot", "[tinylfu]") {
+  TinyLfuCache<int, int> cache(2);
+  cache.put(1, 1);
+  cache.put(2, 2);
+  cache.remove(1);
+  REQUIRE(cache.size() == 1);
+
+  int out = 0;
+  REQUIRE_FALSE(cache.get(1, out));
+  cache.put(3, 3);
+  REQUIRE(cache.get(3, out));
+  REQUIRE(cache.size() == 2);
+}
+
+TEST_CASE("TinyLFU: capacity of one behaves like a single slot", "[tinylfu]") {
+  TinyLfuCache<int, int> cache(1);
+  int out = 0;
+  cache.put(1, 1);
+  cache.put(2, 2);
+  REQUIRE(cache.size() == 1);
+  REQUIRE(cache.get(2, out));
+  REQUIRE(out == 2);
+
+  TinyLfuCache<int, int> empty(0);
+  empty.put(1, 1);
+  REQUIRE_FALSE(empty.get(1, out));
+}
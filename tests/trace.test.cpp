@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "trace/TraceReader.h"
+
+namespace {
+
+std::string writeTemp(const std::string &name, const std::string &bytes) {
+  const auto path = std::filesystem::temp_directory_path() / name;
+  std::ofstream out(path, std::ios::binary);
+  out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  return path.string();
+}
+
+std::vector<TraceRequest> collect(const Trace &trace) {
+  std::vector<TraceRequest> reqs;
+  trace.forEach([&](const TraceRequest &r) { reqs.push_back(r); });
+  return reqs;
+}
+
+} // namespace
+
+TEST_CASE("Trace: binary u64 keys are read through the mapping",
+          "[trace]") {
+  const std::vector<std::uint64_t> keys = {7, 1ULL << 40, 7, 42};
+  const std::string path = writeTemp(
+      "cpp_cache_trace.bin",
+      std::string(reinterpret_cast<const char *>(keys.data()),
+                  keys.size() * sizeof(std::uint64_t)));
+
+  Trace trace;
+  std::string error;
+  REQUIRE(trace.load(path, TraceFormat::Binary, error));
+  const auto reqs = collect(trace);
+  REQUIRE(reqs.size() == keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(reqs[i].key == keys[i]);
+    REQUIRE_FALSE(reqs[i].isWrite);
+  }
+
+  Trace limited;
+  REQUIRE(limited.load(path, TraceFormat::Binary, error, /*limit*/ 2));
+  REQUIRE(limited.size() == 2);
+
+  // 长度不是 8 的倍数视为损坏
+  const std::string bad = writeTemp("cpp_cache_trace_bad.bin", "abc");
+  Trace broken;
+  REQUIRE_FALSE(broken.load(bad, TraceFormat::Binary, error));
+  REQUIRE_FALSE(error.empty());
+}
+
+TEST_CASE("Trace: ARC lines expand into consecutive blocks", "[trace]") {
+  const std::string path =
+      writeTemp("cpp_cache_trace.arc", "100 3 0 1\r\n# comment\n7  1 0 2\n");
+
+  Trace trace;
+  std::string error;
+  REQUIRE(trace.load(path, TraceFormat::Arc, error));
+  const auto reqs = collect(trace);
+  REQUIRE(reqs.size() == 4);
+  REQUIRE(reqs[0].key == 100);
+  REQUIRE(reqs[1].key == 101);
+  REQUIRE(reqs[2].key == 102);
+  REQUIRE(reqs[3].key == 7);
+}
+
+TEST_CASE("Trace: Twitter CSV marks writes and skips deletes", "[trace]") {
+  const std::string path = writeTemp("cpp_cache_trace.csv",
+                                     "0,user:1,6,100,3,get,0\n"
+                                     "1,user:2,6,100,3,set,3600\n"
+                                     "2,user:1,6,0,3,delete,0\n"
+                                     "3,user:1,6,100,4,gets,0\n");
+
+  Trace trace;
+  std::string error;
+  REQUIRE(trace.load(path, TraceFormat::Twitter, error));
+  const auto reqs = collect(trace);
+  REQUIRE(reqs.size() == 3);
+  REQUIRE(reqs[0].key == Trace::hashKey("user:1"));
+  REQUIRE_FALSE(reqs[0].isWrite);
+  REQUIRE(reqs[1].key == Trace::hashKey("user:2"));
+  REQUIRE(reqs[1].isWrite);
+  REQUIRE(reqs[2].key == reqs[0].key);
+}
+
+TEST_CASE("Trace: text keys parse numbers and hash the rest", "[trace]") {
+  const std::string path = writeTemp("cpp_cache_trace.txt", "12\nabc\n12\n");
+
+  Trace trace;
+  std::string error;
+  REQUIRE(trace.load(path, TraceFormat::Text, error));
+  const auto reqs = collect(trace);
+  REQUIRE(reqs.size() == 3);
+  REQUIRE(reqs[0].key == 12);
+  REQUIRE(reqs[1].key == Trace::hashKey("abc"));
+  REQUIRE(reqs[2].key == 12);
+
+  Trace missing;
+  REQUIRE_FALSE(missing.load("/nonexistent/trace", TraceFormat::Text, error));
+}
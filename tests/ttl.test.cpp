@@ -0,0 +1,189 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CacheStats.h"
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "TimingWheel.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Timer {
+  int id = 0;
+  TimerNode<Timer> node;
+};
+
+// 推进到 tick，返回这一步到期的定时器 id
+std::vector<int> advanceTo(TimingWheel<Timer> &wheel, std::uint64_t tick) {
+  std::vector<int> fired;
+  wheel.advance(tick, [&fired](Timer *t) { fired.push_back(t->id); });
+  return fired;
+}
+
+} // namespace
+
+TEST_CASE("TimingWheel: timers fire exactly at their tick across levels",
+          "[ttl][wheel]") {
+  TimingWheel<Timer> wheel;
+  const std::vector<std::uint64_t> ticks = {1,    5,     63,      64,
+                                            65,   4095,  4096,    4097,
+                                            70000, 300000, 16777300};
+  std::vector<Timer> timers(ticks.size());
+  for (std::size_t i = 0; i < ticks.size(); ++i) {
+    timers[i].id = static_cast<int>(i);
+    timers[i].node.owner = &timers[i];
+    wheel.schedule(timers[i].node, ticks[i]);
+  }
+  REQUIRE(wheel.size() == ticks.size());
+
+  for (std::size_t i = 0; i < ticks.size(); ++i) {
+    // 到期前一个 tick 不触发，到期那个 tick 恰好触发
+    REQUIRE(advanceTo(wheel, ticks[i] - 1).empty());
+    REQUIRE(advanceTo(wheel, ticks[i]) == std::vector<int>{static_cast<int>(i)});
+  }
+  REQUIRE(wheel.empty());
+}
+
+TEST_CASE("TimingWheel: cancel and reschedule", "[ttl][wheel]") {
+  TimingWheel<Timer> wheel;
+  Timer a{1, {}}, b{2, {}};
+  a.node.owner = &a;
+  b.node.owner = &b;
+
+  wheel.schedule(a.node, 10);
+  wheel.schedule(b.node, 20);
+  wheel.cancel(a.node);
+  wheel.schedule(b.node, 5000); // 重新安排到更晚
+  REQUIRE(wheel.size() == 1);
+
+  REQUIRE(advanceTo(wheel, 4999).empty());
+  REQUIRE(advanceTo(wheel, 5000) == std::vector<int>{2});
+
+  // 已经过去的时间点放到下一个 tick
+  wheel.schedule(a.node, 3);
+  REQUIRE(advanceTo(wheel, 5001) == std::vector<int>{1});
+}
+
+TEST_CASE("TimingWheel: random schedule fires everything in order",
+          "[ttl][wheel]") {
+  TimingWheel<Timer> wheel;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<std::uint64_t> dist(1, 1u << 20);
+
+  std::vector<Timer> timers(2000);
+  for (std::size_t i = 0; i < timers.size(); ++i) {
+    timers[i].id = static_cast<int>(i);
+    timers[i].node.owner = &timers[i];
+    wheel.schedule(timers[i].node, dist(gen));
+  }
+
+  std::uint64_t now = 0;
+  std::size_t fired = 0;
+  while (!wheel.empty()) {
+    now += 997;
+    wheel.advance(now, [&](Timer *t) {
+      REQUIRE(t->node.expireTick <= now);
+      REQUIRE(t->node.expireTick + 997 > now); // 不会晚于所在的那一步
+      ++fired;
+    });
+  }
+  REQUIRE(fired == timers.size());
+}
+
+TEST_CASE("TTL: LRU entries expire and free capacity first", "[ttl][lru]") {
+  LruCache<int, std::string, AtomicStats> cache(3);
+  std::string out;
+
+  cache.put(1, "short", 30ms);
+  cache.put(2, "live");
+  cache.put(3, "long", 10s);
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == "short");
+
+  std::this_thread::sleep_for(80ms);
+  REQUIRE_FALSE(cache.get(1, out));
+
+  // 过期的 1 已经让出位置，写入 4 不淘汰未过期的 2(最久未访问)
+  cache.put(4, "new");
+  REQUIRE(cache.get(2, out));
+  REQUIRE(cache.get(3, out));
+  REQUIRE(cache.get(4, out));
+  REQUIRE(cache.stats().expirations == 1);
+  REQUIRE(cache.stats().evictions == 0);
+}
+
+TEST_CASE("TTL: plain put clears an existing expiry", "[ttl][lru]") {
+  LruCache<int, int> cache(4);
+  int out = 0;
+
+  cache.put(1, 1, 30ms);
+  cache.put(1, 2); // 不带 ttl 的覆盖
+  cache.put(2, 2, 30ms);
+  cache.remove(2); // 删除时同时取消定时器
+  std::this_thread::sleep_for(80ms);
+  cache.purgeExpired();
+
+  REQUIRE(cache.get(1, out));
+  REQUIRE(out == 2);
+  REQUIRE(cache.size() == 1);
+}
+
+TEST_CASE("TTL: LFU entries expire before frequent ones are evicted",
+          "[ttl][lfu]") {
+  LfuCache<int, int, AtomicStats> cache(2);
+  int out = 0;
+
+  cache.put(1, 1, 30ms);
+  for (int i = 0; i < 5; ++i) {
+    cache.get(1, out); // 频次高也照样过期
+  }
+  cache.put(2, 2);
+  std::this_thread::sleep_for(80ms);
+
+  cache.put(3, 3);
+  REQUIRE_FALSE(cache.get(1, out));
+  REQUIRE(cache.get(2, out));
+  REQUIRE(cache.get(3, out));
+  REQUIRE(cache.stats().expirations == 1);
+  REQUIRE(cache.stats().evictions == 0);
+}
+
+TEST_CASE("TTL: sharded caches reclaim with a background reaper",
+          "[ttl][khash]") {
+  KHashLruCaches<int, int> lru(64, 4);
+  KHashLfuCache<int, int> lfu(64, 4);
+  for (int i = 0; i < 32; ++i) {
+    lru.put(i, i, 30ms);
+    lfu.put(i, i, 30ms);
+  }
+  lru.put(100, 100);
+  lfu.put(100, 100);
+
+  lru.startReaper(10ms);
+  lfu.startReaper(10ms);
+  std::this_thread::sleep_for(150ms);
+  lru.stopReaper();
+  lfu.stopReaper();
+
+  auto total = [](const std::vector<std::size_t> &occupancy) {
+    std::size_t n = 0;
+    for (std::size_t c : occupancy) {
+      n += c;
+    }
+    return n;
+  };
+  REQUIRE(total(lru.occupancy()) == 1);
+  REQUIRE(total(lfu.occupancy()) == 1);
+  int out = 0;
+  REQUIRE(lru.get(100, out));
+  REQUIRE(lfu.get(100, out));
+}
@@ -0,0 +1,200 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "Weigher.h"
+#include "arc/ArcCache.h"
+
+namespace {
+
+// 权重就是 value 的长度，便于精确断言
+struct LengthWeigher {
+  std::size_t operator()(int, const std::string &value) const {
+    return value.size();
+  }
+};
+
+std::size_t sum(const std::vector<std::size_t> &values) {
+  return std::accumulate(values.begin(), values.end(), std::size_t{0});
+}
+
+} // namespace
+
+TEST_CASE("Weigher: SizeofWeigher counts heap buffers of contiguous containers",
+          "[weigher]") {
+  SizeofWeigher weigher;
+  REQUIRE(weigher(1, 2) == sizeof(int) * 2);
+
+  std::vector<int> values(100);
+  REQUIRE(weigher(1, values) >=
+          sizeof(int) + sizeof(values) + 100 * sizeof(int));
+}
+
+TEST_CASE("Weigher: LRU evicts until the total weight fits", "[weigher][lru]") {
+  LruCache<int, std::string, NullStats, LengthWeigher> cache(10);
+  cache.put(1, std::string(4, 'a'));
+  cache.put(2, std::string(4, 'b'));
+  REQUIRE(cache.weight() == 8);
+
+  // 再放 6 个单位：需要淘汰最旧的两个
+  cache.put(3, std::string(6, 'c'));
+  std::string out;
+  REQUIRE_FALSE(cache.get(1, out));
+  REQUIRE(cache.get(2, out));
+  REQUIRE(cache.get(3, out));
+  REQUIRE(cache.weight() == 10);
+
+  // 单个条目超过整个容量：不缓存，也不影响已有条目
+  cache.put(4, std::string(11, 'd'));
+  REQUIRE_FALSE(cache.get(4, out));
+  REQUIRE(cache.size() == 2);
+  REQUIRE(cache.weight() == 10);
+}
+
+TEST_CASE("Weigher: updating a value re-weighs the entry", "[weigher][lru]") {
+  LruCache<int, std::string, NullStats, LengthWeigher> cache(10);
+  cache.put(1, "aa");
+  cache.put(2, "bb");
+  cache.put(3, "cc");
+
+  // key 3 变重后，从最旧的一端淘汰，刚更新的 key 保留
+  cache.put(3, std::string(7, 'c'));
+  std::string out;
+  REQUIRE_FALSE(cache.get(1, out));
+  REQUIRE(cache.get(2, out));
+  REQUIRE(cache.get(3, out));
+  REQUIRE(cache.weight() == 9);
+
+  // 变轻同样计入
+  cache.put(3, "c");
+  REQUIRE(cache.weight() == 3);
+
+  // 更新成超过容量的值：条目被移除
+  cache.put(2, std::string(20, 'b'));
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE(cache.weight() == 1);
+}
+
+TEST_CASE("Weigher: an oversized update is rejected, not evicted",
+          "[weigher]") {
+  LruCache<int, std::string, AtomicStats, LengthWeigher> lru(10);
+  LfuCache<int, std::string, AtomicStats, LengthWeigher> lfu(10);
+  int evicted = 0;
+  lru.setEvictionListener([&](const int &, const std::string &) { ++evicted; });
+  lfu.setEvictionListener([&](const int &, const std::string &) { ++evicted; });
+  lru.put(1, "a");
+  lfu.put(1, "a");
+
+  // 条目被移除，但既不计淘汰也不通知监听者
+  lru.put(1, std::string(11, 'a'));
+  lfu.put(1, std::string(11, 'a'));
+  REQUIRE(lru.size() == 0);
+  REQUIRE(lfu.size() == 0);
+  REQUIRE(lru.stats().evictions == 0);
+  REQUIRE(lfu.stats().evictions == 0);
+  REQUIRE(evicted == 0);
+}
+
+TEST_CASE("Weigher: default unit weight keeps count-based capacity",
+          "[weigher]") {
+  LruCache<int, std::string> lru(3);
+  LfuCache<int, std::string> lfu(3);
+  for (int i = 0; i < 10; ++i) {
+    lru.put(i, std::string(1000, 'x'));
+    lfu.put(i, std::string(1000, 'x'));
+  }
+  REQUIRE(lru.size() == 3);
+  REQUIRE(lru.weight() == 3);
+  REQUIRE(lfu.size() == 3);
+  REQUIRE(lfu.weight() == 3);
+}
+
+TEST_CASE("Weigher: LFU evicts the least frequent until the weight fits",
+          "[weigher][lfu]") {
+  LfuCache<int, std::string, NullStats, LengthWeigher> cache(10);
+  std::string out;
+  cache.put(1, std::string(3, 'a'));
+  cache.put(2, std::string(3, 'b'));
+  cache.put(3, std::string(3, 'c'));
+  cache.get(1, out);
+  cache.get(3, out);
+
+  // 5 个单位放不下：先淘汰频次最低的 key 2，仍不够再淘汰频次相同里最早的 key 1
+  cache.put(4, std::string(5, 'd'));
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE_FALSE(cache.get(1, out));
+  REQUIRE(cache.get(3, out));
+  REQUIRE(cache.get(4, out));
+  REQUIRE(cache.weight() == 8);
+
+  cache.put(5, std::string(11, 'e'));
+  REQUIRE_FALSE(cache.get(5, out));
+  REQUIRE(cache.weight() == 8);
+}
+
+TEST_CASE("Weigher: ARC parts and ghost shifts are measured in weight",
+          "[weigher][arc]") {
+  ArcCache<int, std::string, NullStats, LengthWeigher> cache(10, 2);
+  cache.put(1, std::string(6, 'a'));
+  cache.put(2, std::string(6, 'b')); // LRU 部分只能放下一个，key 1 进幽灵
+  REQUIRE(cache.size() == 1);
+  REQUIRE(cache.weight() == 6);
+  REQUIRE(cache.capacity() == 20);
+
+  // 命中 LRU 幽灵：按该条目的权重(6)把容量从 LFU 部分挪到 LRU 部分
+  cache.put(1, std::string(6, 'a'));
+  REQUIRE(cache.capacity() == 20);
+  std::string out;
+  REQUIRE(cache.get(1, out));
+  REQUIRE(cache.get(2, out));
+  REQUIRE(cache.weight() == 12);
+}
+
+TEST_CASE("Weigher: an oversized update in either ARC part is rejected",
+          "[weigher][arc]") {
+  ArcCache<int, std::string, AtomicStats, LengthWeigher> cache(10, 2);
+  int evicted = 0;
+  cache.setEvictionListener(
+      [&](const int &, const std::string &) { ++evicted; });
+  std::string out;
+  cache.put(1, "aa");
+  cache.put(2, "bb");
+  cache.put(3, "cc");
+  cache.get(3, out); // 达到门槛，迁到 LFU 部分
+  cache.put(4, "dd");
+  cache.get(4, out);
+
+  // 只移除被更新的条目，同一侧的其他条目不受影响
+  cache.put(2, std::string(11, 'b')); // LRU 部分
+  cache.put(4, std::string(11, 'd')); // LFU 部分
+  REQUIRE(cache.size() == 2);
+  REQUIRE(cache.weight() == 4);
+  REQUIRE(cache.get(1, out));
+  REQUIRE(cache.get(3, out));
+  REQUIRE_FALSE(cache.get(2, out));
+  REQUIRE_FALSE(cache.get(4, out));
+  REQUIRE(cache.stats().evictions == 0);
+  REQUIRE(evicted == 0);
+}
+
+TEST_CASE("Weigher: sharded caches split the budget per shard",
+          "[weigher][lru][lfu]") {
+  KHashLruCaches<int, std::string, std::hash<int>, NullStats, LengthWeigher>
+      lru(/*capacity*/ 400, /*sliceNum*/ 4);
+  KHashLfuCache<int, std::string, std::hash<int>, NullStats, LengthWeigher>
+      lfu(/*capacity*/ 400, /*sliceNum*/ 4);
+  for (int i = 0; i < 1000; ++i) {
+    const std::string value(static_cast<std::size_t>(1 + i % 20), 'v');
+    lru.put(i, value);
+    lfu.put(i, value);
+    REQUIRE(lru.weight() <= 400);
+    REQUIRE(lfu.weight() <= 400);
+  }
+  // 每个分片 100 个单位，最重的条目 20：每个分片至少用掉 80
+  REQUIRE(lru.weight() >= 4 * 80);
+  REQUIRE(sum(lru.occupancy()) < 1000);
+}
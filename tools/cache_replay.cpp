@@ -0,0 +1,324 @@
+// 用真实访问 trace 回放各缓存策略，输出缺失率曲线(MRC)和单次操作延迟。
+//
+// 每个 (策略, 容量) 组合是一个独立任务，按 --jobs 并行执行；trace 只加载一次，
+// 所有任务共享只读数据。读请求未命中时按需回填(get 失败后 put)，
+// 写请求直接 put。结果按 CSV 输出到标准输出或 --out 指定的文件。
+//
+// 用法示例：
+//   cache_replay --trace=web.bin --format=binary --policies=lru,arc,clock
+//   cache_replay --trace=cluster52.csv --format=twitter --capacities=1e4,1e5
+#include "AdaptiveCache.h"
+#include "ClockCache.h"
+#include "ICachePolicy.h"
+#include "LfuCache.h"
+#include "LruCache.h"
+#include "PoolLruCache.h"
+#include "LfuDaCache.h"
+#include "SlruCache.h"
+#include "TinyLfuCache.h"
+#include "arc/ArcCache.h"
+#include "trace/TraceReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using Key = std::uint64_t;
+using Value = std::uint32_t;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kSampleEvery = 16; // 每隔多少个请求计一次时
+
+struct Options {
+  std::string tracePath;
+  TraceFormat format = TraceFormat::Binary;
+  std::vector<std::string> policies = {"lru", "lfu", "arc", "lruk", "clock"};
+  std::vector<std::size_t> capacities; // 为空时按 trace 的去重 key 数自动选取
+  std::size_t points = 8;              // 自动选取时的 MRC 点数
+  std::size_t limit = 0;               // 只回放前 limit 个请求
+  unsigned jobs = 0;                   // 并行任务数，0 表示硬件线程数
+  std::string outPath;
+};
+
+struct Result {
+  std::string policy;
+  std::size_t capacity = 0;
+  std::size_t requests = 0;
+  std::size_t reads = 0;
+  std::size_t misses = 0;
+  double seconds = 0;
+  double p50 = 0, p99 = 0, p999 = 0;
+};
+
+std::unique_ptr<ICachePolicy<Key, Value>> makePolicy(const std::string &name,
+                                                     std::size_t capacity) {
+  const int cap = static_cast<int>(capacity);
+  if (name == "lru")
+    return std::make_unique<LruCache<Key, Value>>(cap);
+  if (name == "pool-lru")
+    return std::make_unique<PoolLruCache<Key, Value>>(cap);
+  if (name == "lfu")
+    return std::make_unique<LfuCache<Key, Value>>(cap);
+  if (name == "lfu-aging")
+    return std::make_unique<LfuCache<Key, Value>>(cap, 10000);
+  if (name == "arc")
+    return std::make_unique<ArcCache<Key, Value>>(capacity);
+  if (name == "lruk")
+    return std::make_unique<LruKCache<Key, Value>>(cap, cap, 2);
+  if (name == "clock")
+    return std::make_unique<ClockCache<Key, Value>>(cap);
+  if (name == "tinylfu")
+    return std::make_unique<TinyLfuCache<Key, Value>>(cap);
+  if (name == "slru")
+    return std::make_unique<SlruCache<Key, Value>>(cap);
+  if (name == "lfu-da")
+    return std::make_unique<LfuDaCache<Key, Value>>(cap);
+  if (name == "adaptive")
+    return std::make_unique<AdaptiveCache<Key, Value>>(capacity);
+  return nullptr;
+}
+
+double percentile(std::vector<std::uint32_t> &samples, double q) {
+  if (samples.empty())
+    return 0;
+  const std::size_t idx = std::min(
+      samples.size() - 1,
+      static_cast<std::size_t>(q * static_cast<double>(samples.size())));
+  std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+  return samples[idx];
+}
+
+Result replay(const Trace &trace, const std::string &policy,
+              std::size_t capacity) {
+  Result r;
+  r.policy = policy;
+  r.capacity = capacity;
+
+  auto cache = makePolicy(policy, capacity);
+  std::vector<std::uint32_t> samples;
+  samples.reserve(trace.size() / kSampleEvery + 1);
+
+  Value out = 0;
+  const auto begin = Clock::now();
+  trace.forEach([&](const TraceRequest &req) {
+    const bool sample = r.requests % kSampleEvery == 0;
+    const auto start = sample ? Clock::now() : Clock::time_point{};
+    if (req.isWrite) {
+      cache->put(req.key, 0);
+    } else {
+      ++r.reads;
+      if (!cache->get(req.key, out)) {
+        ++r.misses;
+        cache->put(req.key, 0); // 按需回填
+      }
+    }
+    if (sample) {
+      samples.push_back(static_cast<std::uint32_t>(std::min<std::int64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                               start)
+              .count(),
+          UINT32_MAX)));
+    }
+    ++r.requests;
+  });
+  r.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+  r.p50 = percentile(samples, 0.50);
+  r.p99 = percentile(samples, 0.99);
+  r.p999 = percentile(samples, 0.999);
+  return r;
+}
+
+// 在 [去重key数/1000, 去重key数] 区间按对数等距取 points 个容量
+std::vector<std::size_t> defaultCapacities(const Trace &trace,
+                                           std::size_t points) {
+  std::unordered_set<Key> unique;
+  trace.forEach([&](const TraceRequest &req) { unique.insert(req.key); });
+  const double hi = static_cast<double>(std::max<std::size_t>(unique.size(), 1));
+  const double lo = std::max(1.0, hi / 1000.0);
+
+  std::vector<std::size_t> caps;
+  for (std::size_t i = 0; i < points; ++i) {
+    const double t =
+        points > 1 ? static_cast<double>(i) / static_cast<double>(points - 1)
+                   : 1.0;
+    const auto cap = static_cast<std::size_t>(std::llround(lo * std::pow(hi / lo, t)));
+    if (caps.empty() || caps.back() != cap)
+      caps.push_back(cap);
+  }
+  return caps;
+}
+
+template <typename T> std::vector<T> parseList(const std::string &s) {
+  std::vector<T> items;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty())
+      continue;
+    if constexpr (std::is_same_v<T, std::string>) {
+      items.push_back(item);
+    } else {
+      items.push_back(static_cast<T>(std::stod(item)));
+    }
+  }
+  return items;
+}
+
+bool parseFormat(const std::string &s, TraceFormat &format) {
+  if (s == "binary")
+    format = TraceFormat::Binary;
+  else if (s == "arc")
+    format = TraceFormat::Arc;
+  else if (s == "twitter")
+    format = TraceFormat::Twitter;
+  else if (s == "text")
+    format = TraceFormat::Text;
+  else
+    return false;
+  return true;
+}
+
+void usage() {
+  std::cerr
+      << "usage: cache_replay --trace=<file> [--format=binary|arc|twitter|text]\n"
+         "                    [--policies=lru,lfu,arc,lruk,clock]\n"
+         "                    [--capacities=1e3,1e4 | --points=8] "
+         "[--limit=N]\n"
+         "                    [--jobs=N] [--out=mrc.csv]\n"
+         "policies: lru pool-lru lfu lfu-aging arc lruk clock tinylfu slru lfu-da\n"
+         "          adaptive\n";
+}
+
+bool parseArgs(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const auto eq = arg.find('=');
+    const std::string key = arg.substr(0, eq);
+    const std::string val = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+    if (key == "--trace")
+      opt.tracePath = val;
+    else if (key == "--format") {
+      if (!parseFormat(val, opt.format)) {
+        std::cerr << "unknown format: " << val << "\n";
+        return false;
+      }
+    } else if (key == "--policies")
+      opt.policies = parseList<std::string>(val);
+    else if (key == "--capacities")
+      opt.capacities = parseList<std::size_t>(val);
+    else if (key == "--points")
+      opt.points = static_cast<std::size_t>(std::stoul(val));
+    else if (key == "--limit")
+      opt.limit = static_cast<std::size_t>(std::stod(val));
+    else if (key == "--jobs")
+      opt.jobs = static_cast<unsigned>(std::stoul(val));
+    else if (key == "--out")
+      opt.outPath = val;
+    else
+      return false;
+  }
+  return !opt.tracePath.empty();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    usage();
+    return 1;
+  }
+  for (const auto &policy : opt.policies) {
+    if (!makePolicy(policy, 1)) {
+      std::cerr << "unknown policy: " << policy << "\n";
+      return 1;
+    }
+  }
+
+  Trace trace;
+  std::string error;
+  if (!trace.load(opt.tracePath, opt.format, error, opt.limit)) {
+    std::cerr << error << "\n";
+    return 1;
+  }
+  if (opt.capacities.empty())
+    opt.capacities = defaultCapacities(trace, opt.points);
+  std::cerr << "loaded " << trace.size() << " requests, running "
+            << opt.policies.size() * opt.capacities.size() << " replays\n";
+
+  // 任务按 (策略, 容量) 展开，工作线程从原子计数器领取
+  struct Task {
+    std::string policy;
+    std::size_t capacity;
+  };
+  std::vector<Task> tasks;
+  for (const auto &policy : opt.policies) {
+    for (std::size_t capacity : opt.capacities) {
+      tasks.push_back({policy, capacity});
+    }
+  }
+
+  std::vector<Result> results(tasks.size());
+  std::atomic<std::size_t> next{0};
+  std::mutex logMutex;
+  const unsigned jobs =
+      opt.jobs > 0 ? opt.jobs
+                   : std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::thread> workers;
+  for (unsigned j = 0; j < std::min<std::size_t>(jobs, tasks.size()); ++j) {
+    workers.emplace_back([&] {
+      for (std::size_t i = next.fetch_add(1); i < tasks.size();
+           i = next.fetch_add(1)) {
+        results[i] = replay(trace, tasks[i].policy, tasks[i].capacity);
+        std::lock_guard<std::mutex> lock(logMutex);
+        std::cerr << "  done " << tasks[i].policy
+                  << " capacity=" << tasks[i].capacity << "\n";
+      }
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+
+  std::ofstream file;
+  if (!opt.outPath.empty()) {
+    file.open(opt.outPath);
+    if (!file) {
+      std::cerr << "cannot write " << opt.outPath << "\n";
+      return 1;
+    }
+  }
+  std::ostream &out = opt.outPath.empty() ? std::cout : file;
+
+  out << "policy,capacity,requests,reads,misses,miss_ratio,ns_per_op,p50_ns,"
+         "p99_ns,p999_ns\n";
+  for (const Result &r : results) {
+    const double missRatio =
+        r.reads == 0 ? 0.0
+                     : static_cast<double>(r.misses) / static_cast<double>(r.reads);
+    const double nsPerOp =
+        r.requests == 0 ? 0.0 : r.seconds * 1e9 / static_cast<double>(r.requests);
+    out << r.policy << ',' << r.capacity << ',' << r.requests << ',' << r.reads
+        << ',' << r.misses << ',' << std::fixed << std::setprecision(6)
+        << missRatio << ',' << std::setprecision(1) << nsPerOp << ','
+        << std::setprecision(0) << r.p50 << ',' << r.p99 << ',' << r.p999
+        << '\n';
+  }
+  return 0;
+}